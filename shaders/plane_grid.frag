@@ -8,9 +8,6 @@ uniform float u_cellSize;
 uniform float u_lineThickness;
 uniform vec3 u_color;
 uniform float u_opacity;
-uniform int u_numBlackHoles;
-uniform vec3 u_blackHolePositions[8];
-uniform float u_blackHoleMasses[8];
 
 void main() {
     float cell = max(0.0001, u_cellSize);
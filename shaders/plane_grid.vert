@@ -6,25 +6,8 @@ uniform mat4 uVP;
 uniform float u_planeY;
 
 const float EPSILON = 1e-2f;
-const float SOLAR_MASS = 1.989e30f;
-
-// Black holes
-const int MAX_BLACK_HOLES = 8;
-uniform int u_numBlackHoles;
-uniform vec3 u_blackHolePositions[MAX_BLACK_HOLES];
-uniform float u_blackHoleMasses[MAX_BLACK_HOLES];
-
-// Spheres
-const int MAX_SPHERES = 16;
-uniform int u_numSpheres;
-uniform vec3 u_spherePositions[MAX_SPHERES];
-uniform float u_sphereMasses[MAX_SPHERES];
-
-// Meshes
-const int MAX_MESHES = 8;
-uniform int u_numMeshes;
-uniform vec3 u_meshPositions[MAX_MESHES];
-uniform float u_meshMasses[MAX_MESHES];
+
+#include "scene_bodies.glsl"
 
 out vec3 vWorldPos;
 out float vDispplacement;
@@ -65,20 +48,20 @@ void main() {
     float displacement = 0.0f;
 
     for (int i = 0; i < u_numBlackHoles; ++i) {
-        vec3 relPos = p - u_blackHolePositions[i];
-        float geometricMass = u_blackHoleMasses[i] * 1.0f / SOLAR_MASS;
+        vec3 relPos = p - blackHolePosition(i);
+        float geometricMass = blackHoleMass(i);
         displacement += calculateSpacetimeCurvatureBlackHole(relPos, geometricMass);
     }
 
     for (int i = 0; i < u_numSpheres; ++i) {
-        vec3 relPos = p - u_spherePositions[i];
-        float geometricMass = u_sphereMasses[i] * 1.0f / SOLAR_MASS;
+        vec3 relPos = p - spherePosition(i);
+        float geometricMass = sphereMass(i);
         displacement += calculateSpacetimeCurvatureSphere(relPos, geometricMass);
     }
 
     for (int i = 0; i < u_numMeshes; ++i) {
-        vec3 relPos = p - u_meshPositions[i];
-        float geometricMass = u_meshMasses[i] * 1.0f / SOLAR_MASS;
+        vec3 relPos = p - meshPosition(i);
+        float geometricMass = meshMass(i);
         displacement += calculateSpacetimeCurvatureSphere(relPos, geometricMass);
     }
     
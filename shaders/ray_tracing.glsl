@@ -1,13 +1,5 @@
 uniform sampler2D u_skyboxTexture;
 
-const int MAX_BLACK_HOLES = 8;
-uniform int u_numBlackHoles;
-uniform vec3 u_blackHolePositions[MAX_BLACK_HOLES];
-uniform float u_blackHoleMasses[MAX_BLACK_HOLES];
-uniform float u_blackHoleSpins[MAX_BLACK_HOLES];
-uniform vec3 u_blackHoleSpinAxes[MAX_BLACK_HOLES];
-uniform float u_blackHoleCharges[MAX_BLACK_HOLES];
-
 uniform int u_renderBlackHoles = 1;
 uniform int u_renderSpheres = 1;
 uniform int u_accretionDiskEnabled = 1;
@@ -35,9 +27,9 @@ bool isInInfluenceZone(vec3 pos, out int closestBHIndex, out float distanceToBH,
     if (u_renderBlackHoles == 0) return false;
 
     for (int j = 0; j < u_numBlackHoles; j++) {
-        vec3 relativePos = pos - u_blackHolePositions[j];
+        vec3 relativePos = pos - blackHolePosition(j);
         float dist = length(relativePos);
-        float r_s = calculateEventHorizonRadius(u_blackHoleMasses[j]);
+        float r_s = calculateEventHorizonRadius(blackHoleMass(j));
         float r_i = calculateInfluenceRadius(r_s);
 
         if (dist < r_i && dist < distanceToBH) {
@@ -63,7 +55,7 @@ HitRecord rayTraceNormalSpace(vec3 rayOrigin, vec3 rayDir, float maxDistance) {
     if (u_renderSpheres == 1) {
         for (int i = 0; i < u_numSpheres; i++) {
             float t;
-            if (intersectSphere(rayOrigin, rayDir, u_spherePositions[i], u_sphereRadii[i], t)) {
+            if (intersectSphere(rayOrigin, rayDir, spherePosition(i), sphereRadius(i), t)) {
                 if (t < record.t) {
                     record.hit = true;
                     record.t = t;
@@ -117,7 +109,7 @@ vec3 rayMarchInfluenceZone(int closestHole, vec3 rayOrigin, vec3 rayDirection, o
     float adaptiveStepRate = u_adaptiveStepRate;
     vec3 lightDir = normalize(vec3(1.0, 1.0, 1.0));
 
-    float mass = u_blackHoleMasses[closestHole];
+    float mass = blackHoleMass(closestHole);
     /*stepSize *= 1.0f * mass;
     maxSteps *= 1.0f * mass;
     adaptiveStepRate *= 1.0f * mass;*/
@@ -137,19 +129,19 @@ vec3 rayMarchInfluenceZone(int closestHole, vec3 rayOrigin, vec3 rayDirection, o
             return color;
         }
 
-        vec3 relativePos = newOrigin - u_blackHolePositions[closestBH];
+        vec3 relativePos = newOrigin - blackHolePosition(closestBH);
 
         // Calculate orbital angular momentum
         vec3 orbitalAngMomentum = cross(relativePos, newDirection);
         vec3 bhAngMomentum = calculateAngularMomentumFromSpin(
-            u_blackHoleSpins[closestBH],
-            u_blackHoleSpinAxes[closestBH],
-            u_blackHoleMasses[closestBH]
+            blackHoleSpin(closestBH),
+            blackHoleSpinAxis(closestBH),
+            blackHoleMass(closestBH)
         );
         vec3 totalAngMomentum = orbitalAngMomentum + bhAngMomentum * 0.1;
         float angMomSqrd = dot(totalAngMomentum, totalAngMomentum);
 
-        float r_s = calculateEventHorizonRadius(u_blackHoleMasses[closestBH]);
+        float r_s = calculateEventHorizonRadius(blackHoleMass(closestBH));
 
         // Adaptive step size
         float currentStepSize = stepSize * min(adaptiveStepRate, distToBH / r_s);
@@ -162,7 +154,7 @@ vec3 rayMarchInfluenceZone(int closestHole, vec3 rayOrigin, vec3 rayDirection, o
 
         if (u_accretionDiskEnabled == 1) {
             // Get optical depth from the accretion disk at this position
-            float opticalDepth = adiskColor(vec4(0.0, toSpherical(relativePos)), color, alpha, r_s, newOrigin, u_blackHoleMasses[closestBH]);
+            float opticalDepth = adiskColor(vec4(0.0, toSpherical(relativePos)), color, alpha, r_s, newOrigin, blackHoleMass(closestBH));
 
             // Apply volumetric absorption using Beer-Lambert law
             if (opticalDepth > 0.0) {
@@ -229,9 +221,9 @@ vec3 hybridRayTrace(vec3 rayOrigin, vec3 rayDirection) {
 
             if (u_renderBlackHoles == 1) {
                 for (int j = 0; j < u_numBlackHoles; j++) {
-                    vec3 toCenter = u_blackHolePositions[j] - currentOrigin;
+                    vec3 toCenter = blackHolePosition(j) - currentOrigin;
                     float distToCenter = length(toCenter);
-                    float r_s = calculateEventHorizonRadius(u_blackHoleMasses[j]);
+                    float r_s = calculateEventHorizonRadius(blackHoleMass(j));
                     float r_i = calculateInfluenceRadius(r_s);
 
                     float distToInfluence = abs(distToCenter - r_i);
@@ -296,7 +288,7 @@ vec3 rk4RayMarching(vec3 rayOrigin, vec3 rayDirection) {
     vec3 colorValue = vec3(0.0f);
     float alpha = 1.0f;
 
-    if (u_blackHoleMasses[0] == 0.0f)
+    if (u_numBlackHoles == 0 || blackHoleMass(0) == 0.0f)
     return texture(u_skyboxTexture, directionToSpherical(rayDirection)).rgb;
 
     // ray position and direction (Cartesian)
@@ -309,14 +301,14 @@ vec3 rk4RayMarching(vec3 rayOrigin, vec3 rayDirection) {
     float adaptiveStepRate = u_adaptiveStepRate;
 
     // position relative to black hole
-    vec3 relativePosCart = pos - u_blackHolePositions[0];
+    vec3 relativePosCart = pos - blackHolePosition(0);
 
     // convert to spherical coordinates
     vec4 relativePosSph = vec4(0.0f, toSpherical(relativePosCart));
     vec4 relativeDirSph = vec4(1.0f, vel_cartesian_to_spherical(relativePosCart, dir));
 
     // compute event horizon radius
-    float r_s = calculateEventHorizonRadius(u_blackHoleMasses[0]);
+    float r_s = calculateEventHorizonRadius(blackHoleMass(0));
 
     // main loop
     for (int i = 0; i < maxSteps; i++) {
@@ -324,7 +316,7 @@ vec3 rk4RayMarching(vec3 rayOrigin, vec3 rayDirection) {
         float dist = relativePosSph.y;
 
         if (u_accretionDiskEnabled == 1) {
-            float dAlpha = adiskColor(relativePosSph, colorValue, alpha, r_s, rayOrigin, u_blackHoleMasses[0]);
+            float dAlpha = adiskColor(relativePosSph, colorValue, alpha, r_s, rayOrigin, blackHoleMass(0));
             alpha *= (1.0f - clamp(dAlpha, 0.0f, 1.0f));
             if (alpha < 0.01f) {
                 return colorValue;
@@ -351,15 +343,15 @@ vec3 rk4RayMarching(vec3 rayOrigin, vec3 rayDirection) {
         }
 
         // calculate specific angular momentum from spin parameter
-        float a = u_blackHoleSpins[0] * calculateEventHorizonRadius(u_blackHoleMasses[0]) / 2.0f;
+        float a = blackHoleSpin(0) * calculateEventHorizonRadius(blackHoleMass(0)) / 2.0f;
 
-        // set charge
-        float Q = u_blackHoleCharges[0];
+        // set charge (not part of the scene bodies, black holes are uncharged)
+        float Q = 0.0f;
 
         // geodesic integration (RK4)
-        relativeDirSph = normalize4Velocity(relativePosSph, relativeDirSph, u_blackHoleMasses[0]);
-        rk4_step(relativePosSph, relativeDirSph, stepSize, u_blackHoleMasses[0], a, Q);
-        relativeDirSph = normalize4Velocity(relativePosSph, relativeDirSph, u_blackHoleMasses[0]);
+        relativeDirSph = normalize4Velocity(relativePosSph, relativeDirSph, blackHoleMass(0));
+        rk4_step(relativePosSph, relativeDirSph, stepSize, blackHoleMass(0), a, Q);
+        relativeDirSph = normalize4Velocity(relativePosSph, relativeDirSph, blackHoleMass(0));
     }
 
     dir = vel_spherical_to_cartesian(relativePosSph.yzw, relativeDirSph.yzw);
@@ -0,0 +1,29 @@
+// ------------------------------------------------------------------------------------------------------------
+// Section Scene Bodies
+// ------------------------------------------------------------------------------------------------------------
+// Uploaded once per frame by SceneBodyBuffer: black holes first, then spheres, then meshes
+struct Body {
+    vec4 positionMass; // xyz position, w mass in solar masses
+    vec4 data;         // black hole: spin axis, spin | sphere: color, radius | mesh: unused
+};
+
+layout(std430, binding = 3) readonly buffer SceneBodies {
+    int u_numBlackHoles;
+    int u_numSpheres;
+    int u_numMeshes;
+    int u_sceneBodiesPadding;
+    Body u_bodies[];
+};
+
+vec3 blackHolePosition(int i) { return u_bodies[i].positionMass.xyz; }
+float blackHoleMass(int i) { return u_bodies[i].positionMass.w; }
+float blackHoleSpin(int i) { return u_bodies[i].data.w; }
+vec3 blackHoleSpinAxis(int i) { return u_bodies[i].data.xyz; }
+
+vec3 spherePosition(int i) { return u_bodies[u_numBlackHoles + i].positionMass.xyz; }
+float sphereMass(int i) { return u_bodies[u_numBlackHoles + i].positionMass.w; }
+vec3 sphereColor(int i) { return u_bodies[u_numBlackHoles + i].data.rgb; }
+float sphereRadius(int i) { return u_bodies[u_numBlackHoles + i].data.w; }
+
+vec3 meshPosition(int i) { return u_bodies[u_numBlackHoles + u_numSpheres + i].positionMass.xyz; }
+float meshMass(int i) { return u_bodies[u_numBlackHoles + u_numSpheres + i].positionMass.w; }
@@ -1,10 +1,3 @@
-const int MAX_SPHERES = 16;
-uniform int u_numSpheres;
-uniform vec3 u_spherePositions[MAX_SPHERES];
-uniform float u_sphereRadii[MAX_SPHERES];
-uniform vec4 u_sphereColors[MAX_SPHERES];
-uniform float u_sphereMasses[MAX_SPHERES];
-
 // ------------------------------------------------------------------------------------------------------------
 // Section Sphere
 // ------------------------------------------------------------------------------------------------------------
@@ -31,11 +24,11 @@ bool intersectSphere(vec3 rayOrigin, vec3 rayDir, vec3 sphereCenter, float radiu
     return false;
 }
 vec3 renderSphere(vec3 hitPoint, vec3 rayDir, int sphereIndex, vec3 lightDir) {
-    vec3 sphereCenter = u_spherePositions[sphereIndex];
+    vec3 sphereCenter = spherePosition(sphereIndex);
     vec3 normal = normalize(hitPoint - sphereCenter);
 
-    vec3 baseColor = u_sphereColors[sphereIndex].rgb;
-    float mass = u_sphereMasses[sphereIndex];
+    vec3 baseColor = sphereColor(sphereIndex);
+    float mass = sphereMass(sphereIndex);
 
     if (mass > 0.0) {
         float temp = getTemperatureFromMass(mass);
@@ -62,6 +62,33 @@ constexpr float SEPARATOR_HEIGHT = 1.0f;
 constexpr auto NODE_BG_COLOR = ImVec4(0.13f, 0.14f, 0.15f, 1.0f);
 constexpr auto SEPARATOR_COLOR = ImVec4(0.4f, 0.4f, 0.4f, 1.0f);
 
+// Math nodes offered for batch values, in menu order
+constexpr std::pair<const char *, AnimationGraph::PinType> BATCH_MATH_TYPES[] = {
+    {"Float[]", AnimationGraph::PinType::F1Array}, {"Vec3[]", AnimationGraph::PinType::F3Array}
+};
+constexpr std::pair<const char *, AnimationGraph::NodeSubType> BATCH_MATH_OPERATIONS[] = {
+    {"Add", AnimationGraph::NodeSubType::Add}, {"Subtract", AnimationGraph::NodeSubType::Sub},
+    {"Multiply", AnimationGraph::NodeSubType::Mul}, {"Divide", AnimationGraph::NodeSubType::Div},
+    {"Min", AnimationGraph::NodeSubType::Min}, {"Max", AnimationGraph::NodeSubType::Max},
+    {"Negate", AnimationGraph::NodeSubType::Negate}, {"Sqrt", AnimationGraph::NodeSubType::Sqrt},
+    {"Lerp", AnimationGraph::NodeSubType::Lerp}, {"Clamp", AnimationGraph::NodeSubType::Clamp},
+    {"Sin", AnimationGraph::NodeSubType::Sin}, {"Cos", AnimationGraph::NodeSubType::Cos},
+    {"Length", AnimationGraph::NodeSubType::Length}, {"Distance", AnimationGraph::NodeSubType::Distance}
+};
+
+bool IsBatchOperationAvailable(AnimationGraph::NodeSubType subType, AnimationGraph::PinType type) {
+    switch (subType) {
+        case AnimationGraph::NodeSubType::Sin:
+        case AnimationGraph::NodeSubType::Cos:
+            return type == AnimationGraph::PinType::F1Array;
+        case AnimationGraph::NodeSubType::Length:
+        case AnimationGraph::NodeSubType::Distance:
+            return type == AnimationGraph::PinType::F3Array;
+        default:
+            return true;
+    }
+}
+
 ImVec4 GetNodeColor(AnimationGraph::NodeType type, const std::string &name) {
     switch (type) {
         case AnimationGraph::NodeType::Event: return EVENT_COLOR;
@@ -81,9 +108,11 @@ ImVec4 GetPinColor(AnimationGraph::PinType type) {
     switch (type) {
         case AnimationGraph::PinType::Flow: return FLOW_COLOR;
         case AnimationGraph::PinType::Bool: return BOOL_COLOR;
-        case AnimationGraph::PinType::F1: return F1_COLOR;
+        case AnimationGraph::PinType::F1:
+        case AnimationGraph::PinType::F1Array: return F1_COLOR;
         case AnimationGraph::PinType::F2: return F2_COLOR;
-        case AnimationGraph::PinType::F3: return F3_COLOR;
+        case AnimationGraph::PinType::F3:
+        case AnimationGraph::PinType::F3Array: return F3_COLOR;
         case AnimationGraph::PinType::F4: return F4_COLOR;
         case AnimationGraph::PinType::I1: return I1_COLOR;
         case AnimationGraph::PinType::I2: return I2_COLOR;
@@ -96,7 +125,8 @@ ImVec4 GetPinColor(AnimationGraph::PinType type) {
         case AnimationGraph::PinType::String: return STRING_COLOR;
         case AnimationGraph::PinType::BlackHole: return BLACKHOLE_COLOR;
         case AnimationGraph::PinType::Star: return STAR_COLOR;
-        case AnimationGraph::PinType::Object: return OBJECT_COLOR;
+        case AnimationGraph::PinType::Object:
+        case AnimationGraph::PinType::ObjectBatch: return OBJECT_COLOR;
         case AnimationGraph::PinType::Camera: return CAMERA_COLOR;
         case AnimationGraph::PinType::Function: return FUNCTION_PIN_COLOR;
         default: return ImVec4(1.0f, 1.0f, 1.0f, 1.0f);
@@ -153,6 +183,13 @@ void DrawPinIcon(AnimationGraph::PinType type, const ImVec4 &color) {
                                       ImColor(0.0f, 0.0f, 0.0f, 1.0f));
             ImGui::Dummy(ImVec2(radius * 2, radius * 2));
             break;
+        case AnimationGraph::PinType::F1Array:
+        case AnimationGraph::PinType::F3Array:
+            // Outlined triangle: one value per object of a batch
+            drawList->AddTriangle(ImVec2(pos.x + radius, pos.y), ImVec2(pos.x, pos.y + radius * 2),
+                                  ImVec2(pos.x + radius * 2, pos.y + radius * 2), ImColor(color), 2.0f);
+            ImGui::Dummy(ImVec2(radius * 2, radius * 2));
+            break;
         case AnimationGraph::PinType::Star:
             // Draw a star-like shape (simplified)
             drawList->AddCircleFilled(ImVec2(pos.x + radius, pos.y + radius), radius, ImColor(color));
@@ -213,6 +250,7 @@ void AnimationGraph::Render() {
                 if (!inputPinUsed && startPin && endPin && ArePinsCompatible(startPin->Type, endPin->Type)) {
                     if (ed::AcceptNewItem()) {
                         m_Links.push_back({ed::LinkId(GenerateRandomId()), startPinId, endPinId});
+                        MarkModified();
                     }
                 } else {
                     ed::RejectNewItem(ImColor(255, 0, 0, 255), 2.0f);
@@ -230,6 +268,7 @@ void AnimationGraph::Render() {
             if (it != m_Links.end()) {
                 if (ed::AcceptDeletedItem()) {
                     m_Links.erase(it, m_Links.end());
+                    MarkModified();
                 }
             }
         }
@@ -253,6 +292,7 @@ void AnimationGraph::Render() {
                                        }),
                         m_Links.end());
                     m_Nodes.erase(it);
+                    MarkModified();
                 }
             }
         }
@@ -264,6 +304,7 @@ void AnimationGraph::Render() {
         ImGui::OpenPopup("node_create_popup");
     }
 
+    const size_t nodeCountBeforePopup = m_Nodes.size();
     if (ImGui::BeginPopup("node_create_popup")) {
         auto openPopupPosition = ImGui::GetMousePosOnOpeningCurrentPopup();
         ImVec2 mousePos = ed::ScreenToCanvas(openPopupPosition);
@@ -429,6 +470,30 @@ void AnimationGraph::Render() {
                 ed::SetNodePosition(m_Nodes.back().Id, mousePos);
             }
 
+            // Batch
+            for (const char *className: {"Sphere", "BlackHole", "Mesh"}) {
+                std::string getName = std::string("Get Each ") + className;
+                std::string setName = std::string("Set Each ") + className;
+                if (matchesSearch(getName) && ImGui::MenuItem(getName.c_str())) {
+                    m_Nodes.push_back(CreateForEachGetNode(GenerateRandomId(), className));
+                    ed::SetNodePosition(m_Nodes.back().Id, mousePos);
+                }
+                if (matchesSearch(setName) && ImGui::MenuItem(setName.c_str())) {
+                    m_Nodes.push_back(CreateForEachSetNode(GenerateRandomId(), className));
+                    ed::SetNodePosition(m_Nodes.back().Id, mousePos);
+                }
+            }
+            for (const auto &[name, type]: BATCH_MATH_TYPES) {
+                for (const auto &[opName, subType]: BATCH_MATH_OPERATIONS) {
+                    if (!IsBatchOperationAvailable(subType, type)) continue;
+                    std::string itemName = std::string(opName) + " " + name;
+                    if (matchesSearch(itemName) && ImGui::MenuItem(itemName.c_str())) {
+                        m_Nodes.push_back(CreateMathNode(GenerateRandomId(), subType, type));
+                        ed::SetNodePosition(m_Nodes.back().Id, mousePos);
+                    }
+                }
+            }
+
             // Logic
             if (matchesSearch("And") && ImGui::MenuItem("And")) {
                 m_Nodes.push_back(CreateMathNode(GenerateRandomId(), NodeSubType::And, PinType::Bool));
@@ -787,6 +852,36 @@ void AnimationGraph::Render() {
                 ImGui::EndMenu();
             }
 
+            // Batch
+            if (ImGui::BeginMenu("Batch")) {
+                for (const char *className: {"Sphere", "BlackHole", "Mesh"}) {
+                    if (ImGui::BeginMenu(className)) {
+                        if (ImGui::MenuItem((std::string("Get Each ") + className).c_str())) {
+                            m_Nodes.push_back(CreateForEachGetNode(GenerateRandomId(), className));
+                            ed::SetNodePosition(m_Nodes.back().Id, mousePos);
+                        }
+                        if (ImGui::MenuItem((std::string("Set Each ") + className).c_str())) {
+                            m_Nodes.push_back(CreateForEachSetNode(GenerateRandomId(), className));
+                            ed::SetNodePosition(m_Nodes.back().Id, mousePos);
+                        }
+                        ImGui::EndMenu();
+                    }
+                }
+                for (const auto &[name, type]: BATCH_MATH_TYPES) {
+                    if (ImGui::BeginMenu((std::string("Math ") + name).c_str())) {
+                        for (const auto &[opName, subType]: BATCH_MATH_OPERATIONS) {
+                            if (!IsBatchOperationAvailable(subType, type)) continue;
+                            if (ImGui::MenuItem((std::string(opName) + " " + name).c_str())) {
+                                m_Nodes.push_back(CreateMathNode(GenerateRandomId(), subType, type));
+                                ed::SetNodePosition(m_Nodes.back().Id, mousePos);
+                            }
+                        }
+                        ImGui::EndMenu();
+                    }
+                }
+                ImGui::EndMenu();
+            }
+
             // Utility
             if (ImGui::BeginMenu("Utility")) {
                 if (ImGui::MenuItem("Print")) {
@@ -831,6 +926,9 @@ void AnimationGraph::Render() {
 
         ImGui::EndPopup();
     }
+    if (m_Nodes.size() != nodeCountBeforePopup) {
+        MarkModified();
+    }
     ed::Resume();
 
     ed::End();
@@ -838,7 +936,14 @@ void AnimationGraph::Render() {
 }
 
 bool AnimationGraph::ArePinsCompatible(PinType a, PinType b) {
-    return a == b;
+    if (a == b) return true;
+
+    // Scalars broadcast into batch inputs; a float array scales a vec3 array per object
+    switch (b) {
+        case PinType::F1Array: return a == PinType::F1;
+        case PinType::F3Array: return a == PinType::F3 || a == PinType::F1 || a == PinType::F1Array;
+        default: return false;
+    }
 }
 
 AnimationGraph::Node AnimationGraph::CreateEventNode(int id) {
@@ -918,10 +1023,19 @@ AnimationGraph::Node AnimationGraph::CreateMathNode(int id, NodeSubType subType,
             break;
         case PinType::Bool: typeName = "Bool";
             break;
+        case PinType::F1Array: typeName = "Float[]";
+            break;
+        case PinType::F3Array: typeName = "Vec3[]";
+            break;
         default: typeName = "";
             break;
     }
 
+    // Batch variants of scalar-only functions keep operating per element
+    const bool isBatch = valueType == PinType::F1Array || valueType == PinType::F3Array;
+    const PinType scalarType = isBatch ? PinType::F1Array : PinType::F1;
+    const std::string batchSuffix = isBatch ? " " + typeName : "";
+
     switch (subType) {
         case NodeSubType::Add:
             node.Name = "Add " + typeName;
@@ -977,19 +1091,19 @@ AnimationGraph::Node AnimationGraph::CreateMathNode(int id, NodeSubType subType,
             node.Outputs = {{ed::PinId(id * 10 + 1), "Result", valueType, false}};
             break;
         case NodeSubType::Sin:
-            node.Name = "Sin";
-            node.Inputs = {{ed::PinId(id * 10 + 0), "Value", PinType::F1, true}};
-            node.Outputs = {{ed::PinId(id * 10 + 1), "Result", PinType::F1, false}};
+            node.Name = "Sin" + batchSuffix;
+            node.Inputs = {{ed::PinId(id * 10 + 0), "Value", scalarType, true}};
+            node.Outputs = {{ed::PinId(id * 10 + 1), "Result", scalarType, false}};
             break;
         case NodeSubType::Cos:
-            node.Name = "Cos";
-            node.Inputs = {{ed::PinId(id * 10 + 0), "Value", PinType::F1, true}};
-            node.Outputs = {{ed::PinId(id * 10 + 1), "Result", PinType::F1, false}};
+            node.Name = "Cos" + batchSuffix;
+            node.Inputs = {{ed::PinId(id * 10 + 0), "Value", scalarType, true}};
+            node.Outputs = {{ed::PinId(id * 10 + 1), "Result", scalarType, false}};
             break;
         case NodeSubType::Tan:
-            node.Name = "Tan";
-            node.Inputs = {{ed::PinId(id * 10 + 0), "Value", PinType::F1, true}};
-            node.Outputs = {{ed::PinId(id * 10 + 1), "Result", PinType::F1, false}};
+            node.Name = "Tan" + batchSuffix;
+            node.Inputs = {{ed::PinId(id * 10 + 0), "Value", scalarType, true}};
+            node.Outputs = {{ed::PinId(id * 10 + 1), "Result", scalarType, false}};
             break;
         case NodeSubType::Sqrt:
             node.Name = "Sqrt " + typeName;
@@ -999,7 +1113,7 @@ AnimationGraph::Node AnimationGraph::CreateMathNode(int id, NodeSubType subType,
         case NodeSubType::Length:
             node.Name = "Length " + typeName;
             node.Inputs = {{ed::PinId(id * 10 + 0), "Vector", valueType, true}};
-            node.Outputs = {{ed::PinId(id * 10 + 1), "Length", PinType::F1, false}};
+            node.Outputs = {{ed::PinId(id * 10 + 1), "Length", scalarType, false}};
             break;
         case NodeSubType::Distance:
             node.Name = "Distance " + typeName;
@@ -1007,14 +1121,14 @@ AnimationGraph::Node AnimationGraph::CreateMathNode(int id, NodeSubType subType,
                 {ed::PinId(id * 10 + 0), "A", valueType, true},
                 {ed::PinId(id * 10 + 1), "B", valueType, true}
             };
-            node.Outputs = {{ed::PinId(id * 10 + 2), "Distance", PinType::F1, false}};
+            node.Outputs = {{ed::PinId(id * 10 + 2), "Distance", scalarType, false}};
             break;
         case NodeSubType::Lerp:
             node.Name = "Lerp " + typeName;
             node.Inputs = {
                 {ed::PinId(id * 10 + 0), "A", valueType, true},
                 {ed::PinId(id * 10 + 1), "B", valueType, true},
-                {ed::PinId(id * 10 + 2), "T", PinType::F1, true}
+                {ed::PinId(id * 10 + 2), "T", scalarType, true}
             };
             node.Outputs = {{ed::PinId(id * 10 + 3), "Result", valueType, false}};
             break;
@@ -1409,6 +1523,47 @@ AnimationGraph::Node AnimationGraph::CreateSphereSetterNode(int id) {
     return node;
 }
 
+AnimationGraph::Node AnimationGraph::CreateForEachGetNode(int id, const std::string &className) {
+    Node node;
+    node.Id = ed::NodeId(id);
+    node.Name = "Get Each " + className;
+    node.Type = NodeType::Other;
+    node.SubType = NodeSubType::ForEachGet;
+    node.Value = className;
+    node.Inputs = {};
+    node.Outputs = {
+        {ed::PinId(id * 10 + 0), "Objects", PinType::ObjectBatch, false},
+        {ed::PinId(id * 10 + 1), "Count", PinType::I1, false},
+        {ed::PinId(id * 10 + 2), "Position", PinType::F3Array, false},
+        {ed::PinId(id * 10 + 3), "Velocity", PinType::F3Array, false},
+        {ed::PinId(id * 10 + 4), "Mass", PinType::F1Array, false},
+        {ed::PinId(id * 10 + 5), "Radius", PinType::F1Array, false}
+    };
+    return node;
+}
+
+AnimationGraph::Node AnimationGraph::CreateForEachSetNode(int id, const std::string &className) {
+    Node node;
+    node.Id = ed::NodeId(id);
+    node.Name = "Set Each " + className;
+    node.Type = NodeType::Setter;
+    node.SubType = NodeSubType::ForEachSet;
+    node.Value = className;
+    node.Inputs = {
+        {ed::PinId(id * 10 + 0), "Flow", PinType::Flow, true},
+        {ed::PinId(id * 10 + 1), "Objects", PinType::ObjectBatch, true},
+        {ed::PinId(id * 10 + 2), "Position", PinType::F3Array, true},
+        {ed::PinId(id * 10 + 3), "Velocity", PinType::F3Array, true},
+        {ed::PinId(id * 10 + 4), "Mass", PinType::F1Array, true},
+        {ed::PinId(id * 10 + 5), "Radius", PinType::F1Array, true}
+    };
+    node.Outputs = {
+        {ed::PinId(id * 10 + 6), "Flow", PinType::Flow, false},
+        {ed::PinId(id * 10 + 7), "Objects", PinType::ObjectBatch, false}
+    };
+    return node;
+}
+
 AnimationGraph::Node AnimationGraph::CreateVariableGetNode(int id, PinType varType, const std::string &varName) {
     Node node;
     node.Id = ed::NodeId(id);
@@ -1573,6 +1728,7 @@ void AnimationGraph::Deserialize(const YAML::Node &node) {
     m_Nodes.clear();
     m_Links.clear();
     m_Variables.clear();
+    MarkModified();
 
     if (!node["animation_graph"]) return;
     auto graph = node["animation_graph"];
@@ -1727,6 +1883,7 @@ void AnimationGraph::RenderNodeInspector(ed::NodeId selectedNodeId) {
                 bool isSelected = (currentIdx == static_cast<int>(i));
                 if (ImGui::Selectable(m_Variables[i].Name.c_str(), isSelected)) {
                     node->VariableName = m_Variables[i].Name;
+                    MarkModified();
                 }
                 if (isSelected) {
                     ImGui::SetItemDefaultFocus();
@@ -1798,6 +1955,7 @@ void AnimationGraph::RenderNodeInspector(ed::NodeId selectedNodeId) {
                 m_Variables.push_back({newVarName, newVarType});
                 if (node && node->Type == NodeType::Variable) {
                     node->VariableName = newVarName;
+                    MarkModified();
                 }
             }
             newVarBuffer[0] = '\0';
@@ -1872,17 +2030,17 @@ void AnimationGraph::UpdateSceneObjects(Scene *scene) {
     size_t sphereCount = 0;
 
     for (const auto& obj : scene->objects) {
-        if (obj.HasClass("BlackHole")) {
+        if (obj.HasClass(ObjectClasses::BlackHole)) {
             bhCount++;
             m_SceneObjects.push_back("Black Hole #" + std::to_string(bhCount));
-        }  else if (obj.HasClass("Mesh")) {
+        }  else if (obj.HasClass(ObjectClasses::Mesh)) {
             meshCount++;
             ParameterHandle nameHandle("Entity.Name");
             auto nameValue = obj.GetParameter(nameHandle);
             std::string name = std::holds_alternative<std::string>(nameValue) ?
                              std::get<std::string>(nameValue) : "Mesh #" + std::to_string(meshCount);
             m_SceneObjects.push_back(name);
-        } else if (obj.HasClass("Sphere")) {
+        } else if (obj.HasClass(ObjectClasses::Sphere)) {
             sphereCount++;
             ParameterHandle nameHandle("Entity.Name");
             auto nameValue = obj.GetParameter(nameHandle);
@@ -1,5 +1,6 @@
 #pragma once
 #include <imgui_node_editor.h>
+#include <cstdint>
 #include <vector>
 #include <memory>
 #include <string>
@@ -31,7 +32,10 @@ public:
         Function,
         BlackHole,
         Mesh,
-        Sphere
+        Sphere,
+        ObjectBatch,
+        F1Array,
+        F3Array
     };
     enum class NodeType {
         Event,
@@ -75,7 +79,10 @@ public:
         Blackhole, Star, Mesh, Sphere, Camera, Object,
 
         // Variable
-        VariableGet, VariableSet
+        VariableGet, VariableSet,
+
+        // Batch access to every object of a class
+        ForEachGet, ForEachSet
     };
     struct Pin {
         ed::PinId Id;
@@ -139,6 +146,9 @@ public:
     static Node CreateMeshSetterNode(int id);
     static Node CreateSphereSetterNode(int id);
 
+    static Node CreateForEachGetNode(int id, const std::string& className);
+    static Node CreateForEachSetNode(int id, const std::string& className);
+
     static Node CreateVariableGetNode(int id, PinType varType, const std::string& varName = "");
     static Node CreateVariableSetNode(int id, PinType varType, const std::string& varName = "");
 
@@ -160,6 +170,10 @@ public:
     const std::vector<Node>& GetNodes() const { return m_Nodes; }
     const std::vector<Link>& GetLinks() const { return m_Links; }
 
+    // Bumped whenever nodes, links or variable bindings change, so executors know to recompile
+    uint64_t GetRevision() const { return m_Revision; }
+    void MarkModified() { m_Revision++; }
+
 private:
     std::unique_ptr<ed::EditorContext, void(*)(ed::EditorContext*)> m_Context;
     std::vector<Node> m_Nodes;
@@ -167,6 +181,7 @@ private:
     std::mt19937 m_RandomGenerator;
     std::vector<Variable> m_Variables;
     std::vector<std::string> m_SceneObjects;
+    uint64_t m_Revision = 0;
 
     int GenerateRandomId();
 };
@@ -4,9 +4,11 @@
 #include <filesystem>
 #include <chrono>
 #include <thread>
+#include <stdexcept>
 #include "LinuxGtkInit.h"
 #include "Parameters.h"
 #include "Renderer/PhysicsDebugRenderer.h"
+#include "Renderer/VideoSegments.h"
 #include "imgui.h"
 #include "imgui_internal.h"
 
@@ -79,7 +81,7 @@ bool Application::Initialize() {
         }
 
         m_initialized = true;
-        m_lastFrameTime = glfwGetTime();
+        m_lastFrameTime = GetClockTime();
 
         spdlog::info("Application initialized successfully");
         return true;
@@ -99,7 +101,7 @@ void Application::Run() {
     spdlog::info("Starting main application loop");
 
     while (!ShouldClose() && m_running) {
-        double currentTime = glfwGetTime();
+        double currentTime = GetClockTime();
         m_deltaTime = static_cast<float>(currentTime - m_lastFrameTime);
         m_lastFrameTime = currentTime;
         m_totalTime += m_deltaTime;
@@ -114,10 +116,10 @@ void Application::Run() {
     spdlog::info("Application loop ended");
 }
 
-void Application::RunHeadless() {
+bool Application::RunHeadless() {
     if (!m_initialized) {
         spdlog::error("Cannot run application - not initialized");
-        return;
+        return false;
     }
 
     spdlog::info("Starting headless mode");
@@ -127,13 +129,13 @@ void Application::RunHeadless() {
 
     if (!exportImagePath.has_value() && !exportVideoPath.has_value()) {
         spdlog::error("Headless mode requires --export-image or --export-video argument");
-        return;
+        return false;
     }
 
     auto scene = m_simulation.GetScene();
     if (!scene) {
         spdlog::error("No scene loaded for export");
-        return;
+        return false;
     }
 
     int width = m_args.GetValueInt("width", 1920);
@@ -145,9 +147,17 @@ void Application::RunHeadless() {
         ExportRenderer::ImageConfig config;
         config.width = width;
         config.height = height;
+        config.cpuRayTracer = m_cpuRendering;
+        config.tileSize = m_args.GetValueInt("tile-size", config.tileSize);
+        config.hdr = m_args.HasFlag("hdr");
 
         m_exportRenderer.StartImageExport(config, exportImagePath.value(), scene);
     } else if (exportVideoPath.has_value()) {
+        if (m_cpuRendering) {
+            spdlog::error("Video export needs OpenGL, only --export-image works with the CPU ray tracer");
+            return false;
+        }
+
         float videoLength = m_args.GetValueFloat("video-length", 10.0f);
         int videoFps = m_args.GetValueInt("video-fps", 60);
 
@@ -161,6 +171,17 @@ void Application::RunHeadless() {
         config.framerate = videoFps;
         config.tickrate = videoFps;
 
+        if (auto frameRange = m_args.GetValue("frame-range")) {
+            // One worker of a split export, see ExportWorkers
+            auto range = VideoSegments::ParseFrameRange(frameRange.value());
+            if (!range) {
+                spdlog::error("Invalid --frame-range '{}', expected start:end", frameRange.value());
+                return false;
+            }
+            config.firstFrame = range->begin;
+            config.endFrame = range->end;
+        }
+
         if (m_args.HasFlag("use-custom-ray-settings")) {
             config.useCustomRaySettings = true;
             config.customRayStepSize = m_args.GetValueFloat("ray-step-size", 0.01f);
@@ -170,16 +191,25 @@ void Application::RunHeadless() {
         m_exportRenderer.StartVideoExport(config, exportVideoPath.value(), scene);
     }
 
+    // Checkpoints written here let a re-run with --frame-range (a resumed or split export) skip the replay
+    auto checkpointDir = m_args.GetValue("checkpoint-dir");
+    const auto savedCheckpointDir = Params().Get(Params::PhysicsCheckpointDirectory, std::string(""));
+    if (checkpointDir.has_value()) {
+        Params().Set(Params::PhysicsCheckpointDirectory, checkpointDir.value());
+    }
+
     // Main export loop
     m_running = true;
-    m_lastFrameTime = glfwGetTime();
+    m_lastFrameTime = GetClockTime();
 
     while (m_running && m_exportRenderer.IsExporting()) {
-        double currentTime = glfwGetTime();
+        double currentTime = GetClockTime();
         m_deltaTime = static_cast<float>(currentTime - m_lastFrameTime);
         m_lastFrameTime = currentTime;
 
-        glfwPollEvents();
+        if (!m_cpuRendering) {
+            glfwPollEvents();
+        }
 
         m_exportRenderer.Update();
 
@@ -196,17 +226,26 @@ void Application::RunHeadless() {
         std::this_thread::sleep_for(std::chrono::milliseconds(10));
     }
 
+    bool succeeded = false;
     if (m_exportRenderer.IsExporting()) {
         spdlog::warn("Export loop ended but export is still in progress");
+    } else if (m_exportRenderer.HasFailed()) {
+        spdlog::error("Export failed: {}", m_exportRenderer.GetCurrentTask());
     } else {
         spdlog::info("Export completed successfully");
+        succeeded = true;
     }
 
     if (m_args.ShouldExitOnComplete()) {
         spdlog::info("Exiting as requested by --exit-on-complete flag");
     }
 
+    if (checkpointDir.has_value()) {
+        Params().Set(Params::PhysicsCheckpointDirectory, savedCheckpointDir);
+    }
+
     spdlog::info("Headless mode finished");
+    return succeeded;
 }
 
 void Application::Shutdown() {
@@ -218,7 +257,10 @@ void Application::Shutdown() {
 
     UpdateWindowState();
 
-    m_state.SaveState();
+    // Export workers run side by side and must not race on the shared state file
+    if (!m_args.GetValue("frame-range").has_value()) {
+        m_state.SaveState();
+    }
 
     m_renderer.Shutdown();
 
@@ -344,9 +386,31 @@ void Application::UnregisterRenderCallback(const std::string& name) {
     m_renderCallbacks.erase(name);
 }
 
+double Application::GetClockTime() const {
+    // GLFW is never initialized when rendering on the CPU
+    if (m_cpuRendering) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+    return glfwGetTime();
+}
+
 void Application::InitializeRenderer() {
     bool headless = m_args.IsHeadless();
-    m_renderer.Init(headless);
+
+    if (headless && m_args.ShouldUseCpuRenderer()) {
+        spdlog::info("CPU rendering requested, skipping OpenGL initialization");
+        m_cpuRendering = true;
+        return;
+    }
+
+    if (!m_renderer.Init(headless)) {
+        if (!headless) {
+            throw std::runtime_error("Failed to initialize renderer");
+        }
+        spdlog::warn("No OpenGL context available, falling back to the CPU ray tracer");
+        m_cpuRendering = true;
+        return;
+    }
 
     if (auto window = m_renderer.GetWindow()) {
         if (!headless) {
@@ -32,7 +32,7 @@ public:
     bool Initialize();
     bool Initialize(int argc, char* argv[]);
     void Run();
-    void RunHeadless();
+    bool RunHeadless();  // False when the export could not start or failed
     void Shutdown();
 
     void Update(float deltaTime);
@@ -81,6 +81,7 @@ private:
 
     bool m_initialized = false;
     bool m_running = false;
+    bool m_cpuRendering = false;  // Headless without an OpenGL context, exports go through CpuRayTracer
     float m_deltaTime = 0.0f;
     float m_totalTime = 0.0f;
     double m_lastFrameTime = 0.0;
@@ -89,6 +90,7 @@ private:
     std::unordered_map<std::string, RenderCallback> m_renderCallbacks;
 
     void InitializeRenderer();
+    double GetClockTime() const;  // Seconds for frame timing, glfwGetTime() unless rendering on the CPU
     void InitializeSimulation();
     void UpdateWindowState();
 
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <optional>
+
+/**
+ * @brief Blocking FIFO with a fixed capacity connecting the stages of a producer / consumer pipeline
+ *
+ * Push() waits while the queue is full and Pop() while it is empty, so a fast stage is throttled by
+ * the slowest one instead of piling up work. Close() wakes every waiter: pushes fail from then on,
+ * pops drain what is left and then return nullopt.
+ */
+template<typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity) : m_Capacity(capacity) {}
+
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+    bool Push(T value) {
+        std::unique_lock lock(m_Mutex);
+        m_NotFull.wait(lock, [this] { return m_Closed || m_Items.size() < m_Capacity; });
+        if (m_Closed) return false;
+        m_Items.push_back(std::move(value));
+        lock.unlock();
+        m_NotEmpty.notify_one();
+        return true;
+    }
+
+    std::optional<T> Pop() {
+        std::unique_lock lock(m_Mutex);
+        m_NotEmpty.wait(lock, [this] { return m_Closed || !m_Items.empty(); });
+        return PopLocked(lock);
+    }
+
+    std::optional<T> TryPop() {
+        std::unique_lock lock(m_Mutex);
+        return PopLocked(lock);
+    }
+
+    void Close() {
+        {
+            std::lock_guard lock(m_Mutex);
+            m_Closed = true;
+        }
+        m_NotEmpty.notify_all();
+        m_NotFull.notify_all();
+    }
+
+private:
+    std::optional<T> PopLocked(std::unique_lock<std::mutex>& lock) {
+        if (m_Items.empty()) return std::nullopt;
+        T value = std::move(m_Items.front());
+        m_Items.pop_front();
+        lock.unlock();
+        m_NotFull.notify_one();
+        return value;
+    }
+
+    const size_t m_Capacity;
+    std::mutex m_Mutex;
+    std::condition_variable m_NotEmpty;
+    std::condition_variable m_NotFull;
+    std::deque<T> m_Items;
+    bool m_Closed = false;
+};
@@ -20,6 +20,11 @@ public:
     bool ShouldShowIntro() const { return !HasFlag("no-flashscreen"); }
     bool IsHeadless() const { return HasFlag("headless"); }
     bool ShouldExitOnComplete() const { return HasFlag("exit-on-complete"); }
+    bool ShouldRunKerrBenchmark() const { return HasFlag("benchmark-kerr-lut"); }
+    bool ShouldRunUniformBenchmark() const { return HasFlag("benchmark-uniforms"); }
+    bool ShouldRunFrameConversionBenchmark() const { return HasFlag("benchmark-frame-conversion"); }
+    bool ShouldRunGraphBatchCheck() const { return HasFlag("check-graph-batch"); }
+    bool ShouldUseCpuRenderer() const { return HasFlag("cpu-render"); }
 
     const std::vector<std::string>& GetPositionalArgs() const { return m_positionalArgs; }
 
@@ -0,0 +1,54 @@
+#include "CpuFeatures.h"
+#include <spdlog/spdlog.h>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+namespace {
+CpuFeatures DetectCpuFeatures() {
+    CpuFeatures features;
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    int info[4] = {};
+    __cpuid(info, 0);
+    const int maxLeaf = info[0];
+
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool fma = (info[2] & (1 << 12)) != 0;
+    if (!osxsave || maxLeaf < 7) {
+        return features;
+    }
+
+    // XCR0: SSE + AVX state (bits 1-2), AVX-512 opmask + upper ZMM state (bits 5-7)
+    const unsigned long long xcr0 = _xgetbv(0);
+    const bool osAvx = (xcr0 & 0x6) == 0x6;
+    const bool osAvx512 = (xcr0 & 0xE6) == 0xE6;
+
+    __cpuidex(info, 7, 0);
+    features.avx2 = osAvx && (info[1] & (1 << 5)) != 0;
+    features.fma = osAvx && fma;
+    features.avx512f = osAvx512 && (info[1] & (1 << 16)) != 0;
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    // libgcc checks the XCR0 state bits as well
+    __builtin_cpu_init();
+    features.avx2 = __builtin_cpu_supports("avx2");
+    features.fma = __builtin_cpu_supports("fma");
+    features.avx512f = __builtin_cpu_supports("avx512f");
+#endif
+
+    return features;
+}
+}
+
+const CpuFeatures& CpuFeatures::Get() {
+    static const CpuFeatures s_Features = [] {
+        const CpuFeatures features = DetectCpuFeatures();
+        spdlog::info("CPU features: AVX2 {}, FMA {}, AVX-512F {}",
+                     features.avx2 ? "yes" : "no", features.fma ? "yes" : "no", features.avx512f ? "yes" : "no");
+        return features;
+    }();
+    return s_Features;
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+/**
+ * @brief Instruction set extensions usable on this machine, detected once at first use
+ *
+ * SIMD kernels are compiled into separate translation units with per-file ISA flags and
+ * selected at runtime from these bits, so one binary runs on any x86-64 CPU. Every flag
+ * also requires OS support for the corresponding register state (XSAVE/XCR0).
+ */
+struct CpuFeatures {
+    bool avx2 = false;
+    bool fma = false;
+    bool avx512f = false;
+
+    static const CpuFeatures& Get();
+};
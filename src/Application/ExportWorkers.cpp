@@ -0,0 +1,233 @@
+#include "ExportWorkers.h"
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <spdlog/spdlog.h>
+
+#include "CommandLineArgs.h"
+#include "Renderer/VideoSegments.h"
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <spawn.h>
+#include <sys/wait.h>
+extern char** environ;
+#endif
+
+namespace ExportWorkers {
+
+namespace {
+#ifdef _WIN32
+// Quotes one argument the way CommandLineToArgvW and the MSVC runtime split it again
+std::string quoteArgument(const std::string& argument) {
+    if (!argument.empty() && argument.find_first_of(" \t\n\v\"") == std::string::npos) {
+        return argument;
+    }
+    std::string quoted = "\"";
+    size_t backslashes = 0;
+    for (const char c : argument) {
+        if (c == '\\') {
+            ++backslashes;
+            continue;
+        }
+        // Backslashes only escape when they precede a quote
+        quoted.append(c == '"' ? backslashes * 2 + 1 : backslashes, '\\');
+        backslashes = 0;
+        quoted += c;
+    }
+    quoted.append(backslashes * 2, '\\');
+    quoted += '"';
+    return quoted;
+}
+#endif
+
+// Runs argv[0] with the given arguments without a shell and waits for it, -1 if it could not run
+int runProcess(const std::vector<std::string>& arguments) {
+#ifdef _WIN32
+    std::string commandLine;
+    for (const std::string& argument : arguments) {
+        if (!commandLine.empty()) commandLine += ' ';
+        commandLine += quoteArgument(argument);
+    }
+    STARTUPINFOA startupInfo{};
+    startupInfo.cb = sizeof(startupInfo);
+    PROCESS_INFORMATION processInfo{};
+    if (!CreateProcessA(nullptr, commandLine.data(), nullptr, nullptr, FALSE, 0, nullptr, nullptr, &startupInfo, &processInfo)) {
+        spdlog::error("CreateProcess failed for {} (error {})", arguments[0], GetLastError());
+        return -1;
+    }
+    WaitForSingleObject(processInfo.hProcess, INFINITE);
+    DWORD exitCode = 0;
+    const bool haveExitCode = GetExitCodeProcess(processInfo.hProcess, &exitCode);
+    CloseHandle(processInfo.hThread);
+    CloseHandle(processInfo.hProcess);
+    return haveExitCode ? static_cast<int>(exitCode) : -1;
+#else
+    std::vector<char*> argv;
+    for (const std::string& argument : arguments) {
+        argv.push_back(const_cast<char*>(argument.c_str()));
+    }
+    argv.push_back(nullptr);
+    pid_t pid = 0;
+    const int spawnError = posix_spawnp(&pid, argv[0], nullptr, nullptr, argv.data(), environ);
+    if (spawnError != 0) {
+        spdlog::error("posix_spawn failed for {}: {}", arguments[0], std::strerror(spawnError));
+        return -1;
+    }
+    int status = 0;
+    while (waitpid(pid, &status, 0) < 0) {
+        if (errno != EINTR) return -1;
+    }
+    return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+#endif
+}
+
+// Options the coordinator sets per worker, dropped from the forwarded command line
+bool isCoordinatorOption(const std::string& name) {
+    return name == "export-workers" || name == "export-video" || name == "frame-range";
+}
+
+// The coordinator's own command line minus its per-worker options, parsed the way CommandLineArgs does
+std::vector<std::string> forwardedArguments(int argc, char* argv[]) {
+    std::vector<std::string> forwarded;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg.starts_with("--")) {
+            const size_t equalPos = arg.find('=');
+            std::string name = arg.substr(2, equalPos == std::string::npos ? std::string::npos : equalPos - 2);
+            for (char& c : name) {
+                if (c == '_') c = '-';
+            }
+            const bool valueFollows = equalPos == std::string::npos && i + 1 < argc && !std::string(argv[i + 1]).starts_with("-");
+            if (isCoordinatorOption(name)) {
+                if (valueFollows) ++i;
+                continue;
+            }
+            forwarded.push_back(arg);
+            if (valueFollows) {
+                forwarded.emplace_back(argv[++i]);
+            }
+        } else {
+            forwarded.push_back(arg);
+        }
+    }
+    return forwarded;
+}
+}
+
+int RunVideoExport(const CommandLineArgs& args, int argc, char* argv[]) {
+    const std::string outputPath = args.GetValue("export-video", "");
+    const int workerCount = args.GetValueInt("export-workers", 1);
+    // Same frame count as ExportRenderer::StartVideoExport
+    const float videoLength = args.GetValueFloat("video-length", 10.0f);
+    const int videoFps = args.GetValueInt("video-fps", 60);
+    const int totalFrames = static_cast<int>(videoLength * videoFps);
+
+    const std::vector<VideoSegments::FrameRange> ranges = VideoSegments::SplitFrames(totalFrames, workerCount);
+    spdlog::info("Splitting video export of {} frames across {} worker processes -> {}", totalFrames, ranges.size(), outputPath);
+
+    std::vector<std::string> baseArguments{argv[0]};
+    for (std::string& arg : forwardedArguments(argc, argv)) {
+        baseArguments.push_back(std::move(arg));
+    }
+    if (!args.IsHeadless()) {
+        baseArguments.emplace_back("--headless");
+    }
+
+    // Image sequence workers write their frames under the final names, only video segments are joined.
+    // Segments left over from an earlier run must not pass for this run's output.
+    const bool imageSequence = VideoSegments::IsImageSequence(outputPath);
+    std::vector<std::string> segments;
+    for (size_t i = 0; i < ranges.size() && !imageSequence; ++i) {
+        segments.push_back(VideoSegments::SegmentPath(outputPath, static_cast<int>(i)));
+        std::error_code error;
+        std::filesystem::remove(segments.back(), error);
+        if (error) {
+            spdlog::error("Cannot remove stale segment {}: {}", segments.back(), error.message());
+            return -1;
+        }
+    }
+
+    std::vector<int> exitCodes(ranges.size(), 0);
+    std::vector<std::thread> workers;
+    const auto tStart = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < ranges.size(); ++i) {
+        std::vector<std::string> arguments = baseArguments;
+        arguments.emplace_back("--frame-range");
+        arguments.push_back(std::to_string(ranges[i].begin) + ":" + std::to_string(ranges[i].end));
+        arguments.emplace_back("--export-video");
+        arguments.push_back(imageSequence ? outputPath : segments[i]);
+
+        std::string command;
+        for (const std::string& argument : arguments) {
+            command += (command.empty() ? "" : " ") + argument;
+        }
+        spdlog::info("Worker {}: frames [{}, {})", i, ranges[i].begin, ranges[i].end);
+        spdlog::debug("Worker {}: {}", i, command);
+        workers.emplace_back([&exitCodes, i, arguments = std::move(arguments)] {
+            exitCodes[i] = runProcess(arguments);
+        });
+    }
+
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    bool failed = false;
+    for (size_t i = 0; i < ranges.size(); ++i) {
+        if (exitCodes[i] != 0 || (!imageSequence && !std::filesystem::exists(segments[i]))) {
+            spdlog::error("Worker {} failed (exit code {}), segments are kept for inspection", i, exitCodes[i]);
+            failed = true;
+        }
+    }
+    if (failed) {
+        return -1;
+    }
+
+    const double renderSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - tStart).count();
+    spdlog::info("All workers finished in {:.1f} s ({:.2f} frames/s)", renderSeconds, totalFrames / renderSeconds);
+    if (imageSequence) {
+        spdlog::info("Frames exported successfully to: {}", VideoSegments::SequenceFramePath(outputPath, 0));
+        return 0;
+    }
+
+    try {
+        VideoSegments::ConcatenateSegments(segments, outputPath);
+    } catch (const std::exception& e) {
+        spdlog::error("Failed to concatenate segments: {}", e.what());
+        return -1;
+    }
+
+    for (const std::string& segment : segments) {
+        std::error_code error;
+        std::filesystem::remove(segment, error);
+    }
+    spdlog::info("Video exported successfully to: {}", outputPath);
+    return 0;
+}
+
+int Concatenate(const CommandLineArgs& args) {
+    const std::string outputPath = args.GetValue("concat-video", "");
+    try {
+        VideoSegments::ConcatenateSegments(args.GetPositionalArgs(), outputPath);
+    } catch (const std::exception& e) {
+        spdlog::error("Failed to concatenate segments: {}", e.what());
+        return -1;
+    }
+    return 0;
+}
+
+} // namespace ExportWorkers
@@ -0,0 +1,25 @@
+#pragma once
+
+class CommandLineArgs;
+
+/**
+ * Headless video export split across worker processes.
+ *
+ * With --export-workers N the process does not open a window itself: it divides the frames of the
+ * video into N contiguous ranges, runs one headless copy of itself per range
+ * (--frame-range start:end, writing <output>.partNNN.<ext>), waits for all of them and joins the
+ * segments without re-encoding. Each worker steps the simulation to its first frame on its own,
+ * so the workers share nothing and the export scales with the number of GPUs / cores available.
+ *
+ * To spread the work over several machines, run the workers by hand with --frame-range and join
+ * their files with --concat-video <output> <segment>...
+ */
+namespace ExportWorkers {
+
+// Coordinates --export-workers; returns the process exit code
+int RunVideoExport(const CommandLineArgs& args, int argc, char* argv[]);
+
+// --concat-video <output> with the segments as positional arguments; returns the process exit code
+int Concatenate(const CommandLineArgs& args);
+
+} // namespace ExportWorkers
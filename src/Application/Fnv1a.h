@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+constexpr uint64_t FnvOffsetBasis = 14695981039346656037ull;
+constexpr uint64_t FnvPrime = 1099511628211ull;
+
+template<size_t N>
+consteval uint64_t ConstexprFnv1a(const char (&str)[N]) {
+    uint64_t h = FnvOffsetBasis;
+    for (std::size_t i = 0; i < N - 1; ++i) {
+        h ^= static_cast<uint8_t>(str[i]);
+        h *= FnvPrime;
+    }
+    return h;
+}
+
+inline uint64_t RuntimeFnv1a(const std::string_view s) {
+    uint64_t h = FnvOffsetBasis;
+    for (unsigned char c: s) {
+        h ^= c;
+        h *= FnvPrime;
+    }
+    return h;
+}
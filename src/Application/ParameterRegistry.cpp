@@ -1,5 +1,6 @@
 #include "ParameterRegistry.h"
 #include <spdlog/spdlog.h>
+#include <algorithm>
 #include <stdexcept>
 #include <fstream>
 
@@ -8,6 +9,110 @@ ParameterRegistry &ParameterRegistry::Instance() noexcept {
     return s_Instance;
 }
 
+ParameterRegistry::ParameterRegistry() {
+    std::lock_guard lock(m_Mutex);
+    PublishLocked();
+}
+
+bool ParameterRegistry::StoreValueLocked(const uint64_t id, const ParameterValue &value) {
+    const auto [it, inserted] = m_SlotTable.try_emplace(id, static_cast<uint32_t>(m_Values.size()));
+    const uint32_t slot = it->second;
+    if (inserted) {
+        const auto metaIt = m_Meta.find(id);
+        m_Values.push_back(value);
+        m_SlotVersions.push_back(0);
+        m_SlotGroups.push_back(metaIt != m_Meta.end() ? GroupBit(metaIt->second.group) : 0);
+        m_PublishedSlots.reset();
+    } else if (m_Values[slot] == value) {
+        return false;
+    } else {
+        m_Values[slot] = value;
+    }
+
+    // Stamped with the version of the snapshot that will carry the new value
+    const uint64_t version = m_Version + 1;
+    m_SlotVersions[slot] = version;
+    for (size_t g = 0; g < ParameterGroupCount; g++) {
+        if (m_SlotGroups[slot] & (1u << g)) {
+            m_GroupVersions[g] = version;
+        }
+    }
+    return true;
+}
+
+void ParameterRegistry::PublishLocked() {
+    // The slot table only changes on registration, so consecutive snapshots usually share it
+    if (!m_PublishedSlots) {
+        m_PublishedSlots = std::make_shared<const ParameterSnapshot::SlotTable>(m_SlotTable);
+    }
+
+    auto snapshot = std::make_shared<ParameterSnapshot>();
+    snapshot->m_Version = ++m_Version;
+    snapshot->m_Slots = m_PublishedSlots;
+    snapshot->m_Values = m_Values;
+    snapshot->m_SlotVersions = m_SlotVersions;
+    snapshot->m_SlotGroups = m_SlotGroups;
+    snapshot->m_GroupVersions = m_GroupVersions;
+    m_Snapshot.store(std::move(snapshot), std::memory_order_release);
+    m_SnapshotVersion.store(m_Version, std::memory_order_release);
+}
+
+const std::shared_ptr<const ParameterSnapshot> &ParameterRegistry::ThreadSnapshot() const noexcept {
+    // There is only one registry, so one cached snapshot per thread
+    thread_local std::shared_ptr<const ParameterSnapshot> t_Snapshot;
+    if (!t_Snapshot || t_Snapshot->GetVersion() != m_SnapshotVersion.load(std::memory_order_acquire)) {
+        t_Snapshot = m_Snapshot.load(std::memory_order_acquire);
+    }
+    return t_Snapshot;
+}
+
+std::shared_ptr<const ParameterSnapshot> ParameterRegistry::Snapshot() const noexcept {
+    return ThreadSnapshot();
+}
+
+ParameterSlot ParameterRegistry::Resolve(const ParameterHandle &handle) const noexcept {
+    return ThreadSnapshot()->Resolve(handle);
+}
+
+ParameterSubscription ParameterRegistry::Subscribe(const std::initializer_list<ParameterGroup> groups) noexcept {
+    ParameterGroupMask mask = 0;
+    for (const ParameterGroup group : groups) {
+        mask |= GroupBit(group);
+    }
+    return ParameterSubscription(mask);
+}
+
+uint64_t ParameterSnapshot::GetGroupVersion(const ParameterGroupMask groups) const noexcept {
+    uint64_t version = 0;
+    for (size_t g = 0; g < ParameterGroupCount; g++) {
+        if (groups & (1u << g)) {
+            version = std::max(version, m_GroupVersions[g]);
+        }
+    }
+    return version;
+}
+
+size_t ParameterSnapshot::CountChangedSince(const uint64_t version, const ParameterGroupMask groups) const noexcept {
+    size_t count = 0;
+    for (size_t i = 0; i < m_SlotVersions.size(); i++) {
+        if (m_SlotVersions[i] > version && (m_SlotGroups[i] & groups)) {
+            count++;
+        }
+    }
+    return count;
+}
+
+bool ParameterSubscription::Poll(const ParameterSnapshot &snapshot) noexcept {
+    const bool first = m_SeenVersion == 0;
+    if (!first && snapshot.GetGroupVersion(m_Groups) <= m_SeenVersion) {
+        return false;
+    }
+
+    m_ChangedCount = first ? 0 : snapshot.CountChangedSince(m_SeenVersion, m_Groups);
+    m_SeenVersion = snapshot.GetVersion();
+    return true;
+}
+
 ParameterType ParameterRegistry::ParseType(const std::string &typeStr) {
     if (typeStr == "bool") return ParameterType::Bool;
     if (typeStr == "int") return ParameterType::Int;
@@ -84,9 +189,9 @@ void ParameterRegistry::LoadDefinitionsFromYaml(const std::filesystem::path &pat
                 meta.type = ParseType(entry["type"].as<std::string>());
                 meta.group = entry["group"] ? ParseGroup(entry["group"].as<std::string>()) : ParameterGroup::Application;
 
-                if (entry["defaultValue"]) {
+                const bool hasDefault = entry["defaultValue"].IsDefined();
+                if (hasDefault) {
                     meta.defaultValue = ParseValueNode(entry["defaultValue"], meta.type);
-                    m_Values[id] = meta.defaultValue;
                 }
 
                 if (entry["minValue"]) meta.minValue = entry["minValue"].as<float>();
@@ -112,6 +217,9 @@ void ParameterRegistry::LoadDefinitionsFromYaml(const std::filesystem::path &pat
                 }
 
                 m_Meta[id] = meta;
+                if (hasDefault) {
+                    StoreValueLocked(id, meta.defaultValue);
+                }
                 appParamCount++;
             }
         }
@@ -130,9 +238,9 @@ void ParameterRegistry::LoadDefinitionsFromYaml(const std::filesystem::path &pat
                 meta.type = ParseType(entry["type"].as<std::string>());
                 meta.group = entry["group"] ? ParseGroup(entry["group"].as<std::string>()) : ParameterGroup::Simulation;
 
-                if (entry["defaultValue"]) {
+                const bool hasDefault = entry["defaultValue"].IsDefined();
+                if (hasDefault) {
                     meta.defaultValue = ParseValueNode(entry["defaultValue"], meta.type);
-                    m_Values[id] = meta.defaultValue;
                 }
 
                 if (entry["minValue"]) meta.minValue = entry["minValue"].as<float>();
@@ -158,6 +266,9 @@ void ParameterRegistry::LoadDefinitionsFromYaml(const std::filesystem::path &pat
                 }
 
                 m_Meta[id] = meta;
+                if (hasDefault) {
+                    StoreValueLocked(id, meta.defaultValue);
+                }
                 sceneParamCount++;
             }
         }
@@ -167,6 +278,7 @@ void ParameterRegistry::LoadDefinitionsFromYaml(const std::filesystem::path &pat
     } catch (const std::exception &e) {
         spdlog::error("Failed to load parameter definitions from {}: {}", path.string(), e.what());
     }
+    PublishLocked();
 }
 
 void ParameterRegistry::LoadValuesFromYaml(const std::filesystem::path &path) {
@@ -195,7 +307,7 @@ void ParameterRegistry::LoadValuesFromYaml(const std::filesystem::path &path) {
             }
 
             try {
-                m_Values[id] = ParseValueNode(kv.second, metaIt->second.type);
+                StoreValueLocked(id, ParseValueNode(kv.second, metaIt->second.type));
                 loadedCount++;
             } catch (const std::exception &e) {
                 spdlog::warn("Failed to parse value for parameter {}: {}", name, e.what());
@@ -206,6 +318,7 @@ void ParameterRegistry::LoadValuesFromYaml(const std::filesystem::path &path) {
     } catch (const std::exception &e) {
         spdlog::error("Failed to load parameter values from {}: {}", path.string(), e.what());
     }
+    PublishLocked();
 }
 
 YAML::Node ParameterRegistry::ValueToYamlNode(const ParameterValue &value) {
@@ -247,11 +360,11 @@ void ParameterRegistry::SaveValuesToYaml(const std::filesystem::path &path) cons
         YAML::Node root;
         YAML::Node params;
 
-        for (const auto &[id, value] : m_Values) {
+        for (const auto &[id, slot] : m_SlotTable) {
             auto metaIt = m_Meta.find(id);
             if (metaIt == m_Meta.end()) continue;
 
-            params[metaIt->second.name] = ValueToYamlNode(value);
+            params[metaIt->second.name] = ValueToYamlNode(m_Values[slot]);
         }
 
         root["parameters"] = params;
@@ -293,21 +406,23 @@ void ParameterRegistry::RegisterParameter(const ParameterMetadata &meta) {
     std::lock_guard lock(m_Mutex);
     if (!m_Meta.contains(meta.id)) {
         m_Meta[meta.id] = meta;
-        m_Values[meta.id] = meta.defaultValue;
+        StoreValueLocked(meta.id, meta.defaultValue);
+        PublishLocked();
     } else {
         spdlog::warn("Parameter id {} already registered, skipping", meta.id);
     }
 }
 
 bool ParameterRegistry::Has(const ParameterHandle &handle) const noexcept {
-    std::lock_guard lock(m_Mutex);
-    return m_Values.contains(handle.m_Id);
+    return ThreadSnapshot()->Has(handle);
 }
 
 template<typename T>
 void ParameterRegistry::Set(const ParameterHandle &handle, const T &value) {
     std::lock_guard lock(m_Mutex);
-    m_Values[handle.m_Id] = value;
+    if (StoreValueLocked(handle.m_Id, value)) {
+        PublishLocked();
+    }
 }
 
 template void ParameterRegistry::Set<bool>(const ParameterHandle &, const bool &);
@@ -327,10 +442,7 @@ template void ParameterRegistry::Set<std::vector<std::string> >(const ParameterH
 
 template<typename T>
 T ParameterRegistry::Get(const ParameterHandle &handle, const T &fallback) const {
-    std::lock_guard lock(m_Mutex);
-    auto it = m_Values.find(handle.m_Id);
-    if (it == m_Values.end()) return fallback;
-    return std::get<T>(it->second);
+    return ThreadSnapshot()->Get(handle, fallback);
 }
 
 template bool ParameterRegistry::Get<bool>(const ParameterHandle &, const bool &) const;
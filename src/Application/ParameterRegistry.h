@@ -5,7 +5,11 @@
 #include <variant>
 #include <vector>
 #include <unordered_map>
+#include <array>
+#include <atomic>
 #include <filesystem>
+#include <initializer_list>
+#include <memory>
 #include <mutex>
 #include <optional>
 #include <cstdint>
@@ -13,30 +17,15 @@
 #include <glm/gtc/quaternion.hpp>
 #include <yaml-cpp/yaml.h>
 
-constexpr uint64_t FnvOffsetBasis = 14695981039346656037ull;
-constexpr uint64_t FnvPrime = 1099511628211ull;
-
-template<size_t N>
-consteval uint64_t ConstexprFnv1a(const char (&str)[N]) {
-    uint64_t h = FnvOffsetBasis;
-    for (std::size_t i = 0; i < N - 1; ++i) {
-        h ^= static_cast<uint8_t>(str[i]);
-        h *= FnvPrime;
-    }
-    return h;
-}
-
-inline uint64_t RuntimeFnv1a(const std::string_view s) {
-    uint64_t h = FnvOffsetBasis;
-    for (unsigned char c: s) {
-        h ^= c;
-        h *= FnvPrime;
-    }
-    return h;
-}
+#include "Fnv1a.h"
 
 struct ParameterHandle {
+    static constexpr uint32_t UNRESOLVED = 0xFFFFFFFFu;
+
     uint64_t m_Id = 0;
+    // Registry slot of m_Id, filled in by the first lookup. Slots never move, so the constant
+    // handles in Parameters.h find their value with one array load from then on.
+    mutable std::atomic<uint32_t> m_Slot{UNRESOLVED};
 
     constexpr ParameterHandle() noexcept = default;
 
@@ -50,6 +39,15 @@ struct ParameterHandle {
     explicit ParameterHandle(const std::string_view str) noexcept : m_Id(RuntimeFnv1a(str)) {
     }
 
+    constexpr ParameterHandle(const ParameterHandle &o) noexcept : m_Id(o.m_Id) {
+    }
+
+    ParameterHandle &operator=(const ParameterHandle &o) noexcept {
+        m_Id = o.m_Id;
+        m_Slot.store(o.m_Slot.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        return *this;
+    }
+
     constexpr bool IsValid() const noexcept { return m_Id != 0; }
     constexpr bool operator==(const ParameterHandle &o) const noexcept { return m_Id == o.m_Id; }
 };
@@ -72,6 +70,15 @@ enum class ParameterGroup {
     GeneralRelativity
 };
 
+constexpr size_t ParameterGroupCount = static_cast<size_t>(ParameterGroup::GeneralRelativity) + 1;
+
+// Set of ParameterGroups, one bit per group
+using ParameterGroupMask = uint32_t;
+
+constexpr ParameterGroupMask GroupBit(const ParameterGroup group) noexcept {
+    return 1u << static_cast<uint32_t>(group);
+}
+
 enum class ParameterType {
     Bool,
     Int,
@@ -108,6 +115,114 @@ struct ParameterMetadata {
     bool showInUI = true;
 };
 
+// Dense index of a parameter in every ParameterSnapshot, fixed when the parameter is registered
+struct ParameterSlot {
+    static constexpr uint32_t INVALID = 0xFFFFFFFFu;
+
+    uint32_t index = INVALID;
+
+    constexpr bool IsValid() const noexcept { return index != INVALID; }
+};
+
+/**
+ * @brief Immutable copy of every parameter value at one point in time
+ *
+ * Snapshots are never modified after they are published, so a reader can hold one for a whole
+ * frame and read it from any thread without locking. Values are stored densely by slot: reads
+ * through a ParameterSlot are a plain array load, and so are reads through a handle once the
+ * handle has cached its slot; only its first read looks the id up in the slot table.
+ *
+ * Every slot and every group records the snapshot version in which its value last changed, so
+ * consumers can tell exactly what changed between two snapshots.
+ */
+class ParameterSnapshot {
+public:
+    using SlotTable = std::unordered_map<uint64_t, uint32_t>;
+
+    uint64_t GetVersion() const noexcept { return m_Version; }
+
+    ParameterSlot Resolve(const ParameterHandle &handle) const noexcept {
+        uint32_t slot = handle.m_Slot.load(std::memory_order_relaxed);
+        if (slot == ParameterHandle::UNRESOLVED) {
+            const auto it = m_Slots->find(handle.m_Id);
+            if (it == m_Slots->end()) return {};
+            slot = it->second;
+            handle.m_Slot.store(slot, std::memory_order_relaxed);
+        }
+        // A snapshot published before the parameter was registered does not have its slot yet
+        return slot < m_Values.size() ? ParameterSlot{slot} : ParameterSlot{};
+    }
+
+    bool Has(const ParameterHandle &handle) const noexcept { return Resolve(handle).IsValid(); }
+
+    template<typename T>
+    T Get(const ParameterSlot slot, const T &fallback) const {
+        return slot.IsValid() && slot.index < m_Values.size() ? std::get<T>(m_Values[slot.index]) : fallback;
+    }
+
+    template<typename T>
+    T Get(const ParameterHandle &handle, const T &fallback) const {
+        return Get(Resolve(handle), fallback);
+    }
+
+    uint64_t GetSlotVersion(const ParameterSlot slot) const noexcept {
+        return slot.IsValid() && slot.index < m_SlotVersions.size() ? m_SlotVersions[slot.index] : 0;
+    }
+    uint64_t GetGroupVersion(const ParameterGroup group) const noexcept {
+        return m_GroupVersions[static_cast<size_t>(group)];
+    }
+    uint64_t GetGroupVersion(ParameterGroupMask groups) const noexcept;
+
+    // Number of parameters in the given groups whose value changed after the given version
+    size_t CountChangedSince(uint64_t version, ParameterGroupMask groups) const noexcept;
+
+private:
+    friend class ParameterRegistry;
+
+    uint64_t m_Version = 0;
+    std::shared_ptr<const SlotTable> m_Slots;
+    std::vector<ParameterValue> m_Values;
+    std::vector<uint64_t> m_SlotVersions;
+    std::vector<ParameterGroupMask> m_SlotGroups;
+    std::array<uint64_t, ParameterGroupCount> m_GroupVersions{};
+};
+
+/**
+ * @brief Change notification for a set of parameter groups
+ *
+ * Polled by its owner against the snapshot it is about to use, typically once per frame, so
+ * notifications arrive on the consumer's thread without any callbacks into it.
+ */
+class ParameterSubscription {
+public:
+    ParameterSubscription() = default;
+    explicit ParameterSubscription(ParameterGroupMask groups) noexcept : m_Groups(groups) {}
+
+    // True on the first poll and whenever a subscribed group changed since the previous poll
+    bool Poll(const ParameterSnapshot &snapshot) noexcept;
+
+    // Forces the next poll to report a change, e.g. after the consumer lost its state
+    void Invalidate() noexcept { m_SeenVersion = 0; }
+
+    // Parameters that changed between the last two successful polls
+    size_t GetChangedCount() const noexcept { return m_ChangedCount; }
+
+private:
+    ParameterGroupMask m_Groups = 0;
+    uint64_t m_SeenVersion = 0;
+    size_t m_ChangedCount = 0;
+};
+
+/**
+ * @brief Global parameter store
+ *
+ * Writers serialize on a mutex, update the authoritative values and publish a new snapshot.
+ * Readers never take the mutex. Every thread keeps the last snapshot it read and only reloads it
+ * after a writer published a newer version; that reload goes through an atomic shared_ptr, which
+ * libstdc++ and MSVC implement with a lock. In between, Get() and Has() cost one atomic version
+ * load and the handle's cached slot. Hot paths grab Snapshot() once per frame or step and read
+ * the whole frame from that one consistent set of values.
+ */
 class ParameterRegistry {
 public:
     static ParameterRegistry &Instance() noexcept;
@@ -126,6 +241,14 @@ public:
     template<typename T>
     T Get(const ParameterHandle &handle, const T &fallback) const;
 
+    // Latest published values; hold on to it to read a consistent set of parameters
+    std::shared_ptr<const ParameterSnapshot> Snapshot() const noexcept;
+
+    // Slots never move once assigned, so resolved slots stay valid for every later snapshot
+    ParameterSlot Resolve(const ParameterHandle &handle) const noexcept;
+
+    static ParameterSubscription Subscribe(std::initializer_list<ParameterGroup> groups) noexcept;
+
     std::optional<ParameterMetadata> GetMetadata(const ParameterHandle &handle) const;
 
     const std::unordered_map<uint64_t, ParameterMetadata>& GetAllMetadata() const noexcept;
@@ -136,9 +259,25 @@ public:
     static YAML::Node ValueToYamlNode(const ParameterValue &value);
 
 private:
-    ParameterRegistry() = default;
+    ParameterRegistry();
+
+    // Both expect m_Mutex to be held; StoreValueLocked returns whether the value changed
+    bool StoreValueLocked(uint64_t id, const ParameterValue &value);
+    void PublishLocked();
+
+    // This thread's copy of the latest snapshot, reloaded only when a newer one was published
+    const std::shared_ptr<const ParameterSnapshot> &ThreadSnapshot() const noexcept;
 
     mutable std::mutex m_Mutex;
-    std::unordered_map<uint64_t, ParameterValue> m_Values;
+    ParameterSnapshot::SlotTable m_SlotTable;
+    std::vector<ParameterValue> m_Values;
+    std::vector<uint64_t> m_SlotVersions;
+    std::vector<ParameterGroupMask> m_SlotGroups;
+    std::array<uint64_t, ParameterGroupCount> m_GroupVersions{};
     std::unordered_map<uint64_t, ParameterMetadata> m_Meta;
+    std::shared_ptr<const ParameterSnapshot::SlotTable> m_PublishedSlots;
+    uint64_t m_Version = 0;
+
+    std::atomic<std::shared_ptr<const ParameterSnapshot>> m_Snapshot;
+    std::atomic<uint64_t> m_SnapshotVersion{0};  // Version of m_Snapshot, stored after it
 };
@@ -64,6 +64,18 @@ namespace Params {
     inline constexpr ParameterHandle GRGravitationalRedshiftEnabled("GeneralRelativity.GravitationalRedshiftEnabled");
     inline constexpr ParameterHandle GRMetricType("GeneralRelativity.MetricType");
 
+    // Physics Parameters
+    inline constexpr ParameterHandle PhysicsGravityOpeningAngle("Physics.GravityOpeningAngle");
+    inline constexpr ParameterHandle PhysicsIntegrator("Physics.Integrator");
+    inline constexpr ParameterHandle PhysicsFixedTimestepEnabled("Physics.FixedTimestepEnabled");
+    inline constexpr ParameterHandle PhysicsFixedTimestep("Physics.FixedTimestep");
+    inline constexpr ParameterHandle PhysicsMaxSubSteps("Physics.MaxSubSteps");
+    inline constexpr ParameterHandle PhysicsWorkerThreads("Physics.WorkerThreads");
+    inline constexpr ParameterHandle PhysicsAsyncSimulation("Physics.AsyncSimulation");
+    inline constexpr ParameterHandle PhysicsCheckpointInterval("Physics.CheckpointInterval");
+    inline constexpr ParameterHandle PhysicsCheckpointMemoryMB("Physics.CheckpointMemoryMB");
+    inline constexpr ParameterHandle PhysicsCheckpointDirectory("Physics.CheckpointDirectory");
+
     // Application Parameters
     inline constexpr ParameterHandle AppLastOpenScene("App.LastOpenScene");
     inline constexpr ParameterHandle AppRecentScenes("App.RecentScenes");
@@ -0,0 +1,169 @@
+#include "ThreadPool.h"
+#include <algorithm>
+#include <exception>
+#include <limits>
+#include <spdlog/spdlog.h>
+
+namespace {
+    constexpr size_t NoWorker = std::numeric_limits<size_t>::max();
+
+    thread_local const ThreadPool* t_OwnerPool = nullptr;
+    thread_local size_t t_WorkerIndex = NoWorker;
+}
+
+ThreadPool::ThreadPool(unsigned int threadCount) {
+    if (threadCount == 0) {
+        const unsigned int hardwareThreads = std::thread::hardware_concurrency();
+        threadCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+    }
+
+    m_Queues.reserve(threadCount);
+    for (unsigned int i = 0; i < threadCount; i++) {
+        m_Queues.push_back(std::make_unique<WorkQueue>());
+    }
+
+    m_Workers.reserve(threadCount);
+    for (unsigned int i = 0; i < threadCount; i++) {
+        m_Workers.emplace_back([this, i] { WorkerLoop(i); });
+    }
+
+    spdlog::info("Thread pool started with {} workers", threadCount);
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard lock(m_WakeMutex);
+        m_Stopping = true;
+    }
+    m_WakeCondition.notify_all();
+
+    for (auto& worker : m_Workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+ThreadPool& ThreadPool::Global() {
+    static ThreadPool s_Instance;
+    return s_Instance;
+}
+
+void ThreadPool::Push(size_t queueIndex, Task task) {
+    m_PendingTasks.fetch_add(1, std::memory_order_release);
+    {
+        std::lock_guard lock(m_Queues[queueIndex]->mutex);
+        m_Queues[queueIndex]->tasks.push_back(std::move(task));
+    }
+    {
+        // Empty critical section so a worker between its predicate check and wait() cannot miss the notify
+        std::lock_guard lock(m_WakeMutex);
+    }
+    m_WakeCondition.notify_one();
+}
+
+void ThreadPool::Submit(Task task) {
+    // Workers keep their own follow-up work local, everyone else spreads round-robin
+    const size_t queueIndex = (t_OwnerPool == this && t_WorkerIndex != NoWorker)
+        ? t_WorkerIndex
+        : m_NextQueue.fetch_add(1, std::memory_order_relaxed) % m_Queues.size();
+    Push(queueIndex, std::move(task));
+}
+
+bool ThreadPool::TryPop(size_t queueIndex, Task& task) {
+    WorkQueue& queue = *m_Queues[queueIndex];
+    std::lock_guard lock(queue.mutex);
+    if (queue.tasks.empty()) {
+        return false;
+    }
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    m_PendingTasks.fetch_sub(1, std::memory_order_acq_rel);
+    return true;
+}
+
+bool ThreadPool::TrySteal(size_t startIndex, Task& task) {
+    const size_t queueCount = m_Queues.size();
+    for (size_t offset = 0; offset < queueCount; offset++) {
+        WorkQueue& queue = *m_Queues[(startIndex + offset) % queueCount];
+        std::lock_guard lock(queue.mutex);
+        if (queue.tasks.empty()) {
+            continue;
+        }
+        task = std::move(queue.tasks.front());
+        queue.tasks.pop_front();
+        m_PendingTasks.fetch_sub(1, std::memory_order_acq_rel);
+        return true;
+    }
+    return false;
+}
+
+void ThreadPool::WorkerLoop(size_t index) {
+    t_OwnerPool = this;
+    t_WorkerIndex = index;
+
+    while (true) {
+        Task task;
+        if (TryPop(index, task) || TrySteal(index + 1, task)) {
+            task();
+            continue;
+        }
+
+        std::unique_lock lock(m_WakeMutex);
+        m_WakeCondition.wait(lock, [this] {
+            return m_Stopping || m_PendingTasks.load(std::memory_order_acquire) > 0;
+        });
+        if (m_Stopping && m_PendingTasks.load(std::memory_order_acquire) == 0) {
+            return;
+        }
+    }
+}
+
+void ThreadPool::ParallelFor(size_t begin, size_t end, size_t grainSize,
+                             const std::function<void(size_t, size_t)>& fn) {
+    if (begin >= end) {
+        return;
+    }
+    grainSize = std::max<size_t>(grainSize, 1);
+
+    const size_t chunkCount = (end - begin + grainSize - 1) / grainSize;
+    if (chunkCount == 1) {
+        fn(begin, end);
+        return;
+    }
+
+    std::atomic<size_t> remaining{chunkCount};
+    std::exception_ptr firstError;
+    std::mutex errorMutex;
+
+    for (size_t chunk = 0; chunk < chunkCount; chunk++) {
+        const size_t chunkBegin = begin + chunk * grainSize;
+        const size_t chunkEnd = std::min(end, chunkBegin + grainSize);
+        Submit([&, chunkBegin, chunkEnd] {
+            try {
+                fn(chunkBegin, chunkEnd);
+            } catch (...) {
+                std::lock_guard lock(errorMutex);
+                if (!firstError) {
+                    firstError = std::current_exception();
+                }
+            }
+            remaining.fetch_sub(1, std::memory_order_acq_rel);
+        });
+    }
+
+    // Help out instead of blocking; this also keeps nested ParallelFor calls from deadlocking
+    const size_t stealStart = (t_OwnerPool == this && t_WorkerIndex != NoWorker) ? t_WorkerIndex : 0;
+    while (remaining.load(std::memory_order_acquire) > 0) {
+        Task task;
+        if (TrySteal(stealStart, task)) {
+            task();
+        } else {
+            std::this_thread::yield();
+        }
+    }
+
+    if (firstError) {
+        std::rethrow_exception(firstError);
+    }
+}
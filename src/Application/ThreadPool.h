@@ -0,0 +1,64 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Work-stealing thread pool for CPU-heavy batch jobs (LUT generation, N-body, exports)
+ *
+ * Every worker owns a task deque. Workers pop from the back of their own deque and steal
+ * from the front of the others when they run dry, so uneven chunks (e.g. geodesics that
+ * orbit many times next to ones that escape immediately) still keep all cores busy.
+ */
+class ThreadPool {
+public:
+    using Task = std::function<void()>;
+
+    // threadCount == 0 uses hardware_concurrency() - 1 workers, the calling thread being the last one
+    explicit ThreadPool(unsigned int threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    static ThreadPool& Global();
+
+    unsigned int GetThreadCount() const { return static_cast<unsigned int>(m_Workers.size()); }
+
+    void Submit(Task task);
+
+    /**
+     * @brief Runs fn(chunkBegin, chunkEnd) over [begin, end) split into chunks of at most grainSize
+     *
+     * The calling thread executes chunks as well and only returns once all of them finished.
+     * The first exception thrown by a chunk is rethrown on the calling thread.
+     */
+    void ParallelFor(size_t begin, size_t end, size_t grainSize,
+                     const std::function<void(size_t, size_t)>& fn);
+
+private:
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    bool TryPop(size_t queueIndex, Task& task);
+    bool TrySteal(size_t startIndex, Task& task);
+    void Push(size_t queueIndex, Task task);
+    void WorkerLoop(size_t index);
+
+    std::vector<std::unique_ptr<WorkQueue>> m_Queues;
+    std::vector<std::thread> m_Workers;
+    std::mutex m_WakeMutex;
+    std::condition_variable m_WakeCondition;
+    std::atomic<size_t> m_PendingTasks{0};
+    std::atomic<size_t> m_NextQueue{0};
+    bool m_Stopping = false;
+};
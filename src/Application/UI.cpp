@@ -690,6 +690,13 @@ void UI::RenderImageExportSettings() {
     ImGui::Separator();
     ImGui::Spacing();
 
+    ImGui::Checkbox("Linear HDR (16-bit PNG)", &m_imageConfig.hdr);
+    ImGui::TextDisabled("EXR files are always written as linear half floats");
+
+    ImGui::Spacing();
+    ImGui::Separator();
+    ImGui::Spacing();
+
     ImGui::Text("Preview:");
     ImGui::Text("Resolution: %dx%d", m_imageConfig.width, m_imageConfig.height);
     float aspectRatio = (float)m_imageConfig.width / (float)m_imageConfig.height;
@@ -699,15 +706,16 @@ void UI::RenderImageExportSettings() {
     ImGui::Separator();
     ImGui::Spacing();
 
-    if (ImGui::Button("Export Image (PNG)...", ImVec2(-1, 40))) {
+    if (ImGui::Button("Export Image (PNG/EXR)...", ImVec2(-1, 40))) {
         nfdchar_t* outPath = nullptr;
         nfdfilteritem_t filterItems[] = {
-            { "PNG Image", "png" }
+            { "PNG Image", "png" },
+            { "OpenEXR Image", "exr" }
         };
 
         const std::string fallbackPath = ".";
         std::string defaultPath = Application::Params().Get(Params::UIDefaultExportPath, fallbackPath);
-        nfdresult_t result = NFD_SaveDialog(&outPath, filterItems, 1, defaultPath.c_str(), "export.png");
+        nfdresult_t result = NFD_SaveDialog(&outPath, filterItems, 2, defaultPath.c_str(), "export.png");
 
         if (result == NFD_OKAY && outPath) {
             auto& app = Application::Instance();
@@ -716,6 +724,7 @@ void UI::RenderImageExportSettings() {
             ExportRenderer::ImageConfig config;
             config.width = m_imageConfig.width;
             config.height = m_imageConfig.height;
+            config.hdr = m_imageConfig.hdr;
 
             exportRenderer.StartImageExport(config, std::string(outPath), app.GetSimulation().GetScene());
 
@@ -790,15 +799,17 @@ void UI::RenderVideoExportSettings() {
     ImGui::Separator();
     ImGui::Spacing();
 
-    if (ImGui::Button("Export Video (MP4)...", ImVec2(-1, 40))) {
+    if (ImGui::Button("Export Video (MP4/EXR/PNG)...", ImVec2(-1, 40))) {
         nfdchar_t* outPath = nullptr;
         nfdfilteritem_t filterItems[] = {
-            { "MP4 Video", "mp4" }
+            { "MP4 Video", "mp4" },
+            { "OpenEXR Sequence", "exr" },
+            { "16-bit PNG Sequence", "png" }
         };
 
         const std::string fallbackPath = ".";
         std::string defaultPath = Application::Params().Get(Params::UIDefaultExportPath, fallbackPath);
-        nfdresult_t result = NFD_SaveDialog(&outPath, filterItems, 1, defaultPath.c_str(), "export.mp4");
+        nfdresult_t result = NFD_SaveDialog(&outPath, filterItems, 3, defaultPath.c_str(), "export.mp4");
 
         if (result == NFD_OKAY && outPath) {
             auto& app = Application::Instance();
@@ -821,6 +832,7 @@ void UI::RenderVideoExportSettings() {
     }
 
     ImGui::TextDisabled("Click to choose output location and start export");
+    ImGui::TextDisabled("EXR and PNG write linear HDR frames: name.00000.exr, name.00001.exr, ...");
 }
 
 void UI::RenderExportProgress() {
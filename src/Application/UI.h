@@ -116,6 +116,7 @@ private:
     struct {
         int width = 1920;
         int height = 1080;
+        bool hdr = false;
     } m_imageConfig;
 
     struct {
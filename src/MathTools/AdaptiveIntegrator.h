@@ -0,0 +1,151 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace MoleHole {
+
+/**
+ * @brief Tolerances and limits for one adaptive integration
+ *
+ * The error of a step is measured per component against absTolerance + relTolerance * |y|
+ * and the step is accepted when the RMS of those ratios is <= 1.
+ */
+struct AdaptiveStepControl {
+    double relTolerance = 1e-6;
+    double absTolerance = 1e-8;
+    double initialStep = 0.1;
+    double minStep = 1e-6;
+    double maxStep = 10.0;
+    double maxParameter = 500.0;  // Stop once the independent variable exceeds this
+    int maxSteps = 10000;         // Accepted + rejected steps
+};
+
+struct AdaptiveIntegrationStats {
+    int acceptedSteps = 0;
+    int rejectedSteps = 0;
+    int derivativeEvaluations = 0;
+    bool diverged = false;  // Stopped on a non-finite step at the minimum step size
+};
+
+/**
+ * @brief Dormand-Prince 5(4) tableau and step size controller constants
+ *
+ * Shared with the SIMD-batched geodesic kernels, which run the same scheme lane-wise.
+ */
+struct DormandPrince54Coefficients {
+    static constexpr double Safety = 0.9;
+    static constexpr double MinShrink = 0.2;
+    static constexpr double MaxGrowth = 5.0;
+
+    // Dormand-Prince 5(4) Butcher tableau
+    static constexpr double C2 = 1.0 / 5.0, C3 = 3.0 / 10.0, C4 = 4.0 / 5.0, C5 = 8.0 / 9.0;
+    static constexpr double A21 = 1.0 / 5.0;
+    static constexpr double A31 = 3.0 / 40.0, A32 = 9.0 / 40.0;
+    static constexpr double A41 = 44.0 / 45.0, A42 = -56.0 / 15.0, A43 = 32.0 / 9.0;
+    static constexpr double A51 = 19372.0 / 6561.0, A52 = -25360.0 / 2187.0, A53 = 64448.0 / 6561.0, A54 = -212.0 / 729.0;
+    static constexpr double A61 = 9017.0 / 3168.0, A62 = -355.0 / 33.0, A63 = 46732.0 / 5247.0, A64 = 49.0 / 176.0, A65 = -5103.0 / 18656.0;
+    static constexpr double B1 = 35.0 / 384.0, B3 = 500.0 / 1113.0, B4 = 125.0 / 192.0, B5 = -2187.0 / 6784.0, B6 = 11.0 / 84.0;
+    // Difference between the 5th and embedded 4th order weights
+    static constexpr double E1 = 71.0 / 57600.0, E3 = -71.0 / 16695.0, E4 = 71.0 / 1920.0,
+                            E5 = -17253.0 / 339200.0, E6 = 22.0 / 525.0, E7 = -1.0 / 40.0;
+};
+
+/**
+ * @brief Allocation-free Dormand-Prince 5(4) integrator with FSAL and error-based step size control
+ *
+ * The state is a fixed-size std::array, all stages live on the stack. The derivative functor
+ * has the signature void(double t, const State& y, State& dydt).
+ */
+template<size_t N>
+class DormandPrince54 : private DormandPrince54Coefficients {
+public:
+    using State = std::array<double, N>;
+
+    explicit DormandPrince54(const AdaptiveStepControl& control) : m_Control(control) {}
+
+    /**
+     * @brief Integrate from (t, y) until the observer returns false or a limit is hit
+     *
+     * The observer is called with (t, y, tPrev, yPrev) after every accepted step, so it can
+     * detect events (horizon crossing, periapsis) inside the last interval.
+     */
+    template<typename Derivatives, typename Observer>
+    AdaptiveIntegrationStats Integrate(Derivatives&& derivatives, double& t, State& y, Observer&& observer) const {
+        AdaptiveIntegrationStats stats;
+
+        State k1{}, k2{}, k3{}, k4{}, k5{}, k6{}, k7{};
+        State yStage{}, yNext{};
+
+        derivatives(t, y, k1);
+        stats.derivativeEvaluations++;
+
+        double h = std::clamp(m_Control.initialStep, m_Control.minStep, m_Control.maxStep);
+
+        while (stats.acceptedSteps + stats.rejectedSteps < m_Control.maxSteps && t < m_Control.maxParameter) {
+            h = std::min(h, m_Control.maxParameter - t);
+
+            for (size_t i = 0; i < N; i++) yStage[i] = y[i] + h * (A21 * k1[i]);
+            derivatives(t + C2 * h, yStage, k2);
+            for (size_t i = 0; i < N; i++) yStage[i] = y[i] + h * (A31 * k1[i] + A32 * k2[i]);
+            derivatives(t + C3 * h, yStage, k3);
+            for (size_t i = 0; i < N; i++) yStage[i] = y[i] + h * (A41 * k1[i] + A42 * k2[i] + A43 * k3[i]);
+            derivatives(t + C4 * h, yStage, k4);
+            for (size_t i = 0; i < N; i++) yStage[i] = y[i] + h * (A51 * k1[i] + A52 * k2[i] + A53 * k3[i] + A54 * k4[i]);
+            derivatives(t + C5 * h, yStage, k5);
+            for (size_t i = 0; i < N; i++) yStage[i] = y[i] + h * (A61 * k1[i] + A62 * k2[i] + A63 * k3[i] + A64 * k4[i] + A65 * k5[i]);
+            derivatives(t + h, yStage, k6);
+            for (size_t i = 0; i < N; i++) yNext[i] = y[i] + h * (B1 * k1[i] + B3 * k3[i] + B4 * k4[i] + B5 * k5[i] + B6 * k6[i]);
+            derivatives(t + h, yNext, k7);
+            stats.derivativeEvaluations += 6;
+
+            double errorSum = 0.0;
+            bool finite = true;
+            for (size_t i = 0; i < N; i++) {
+                const double error = h * (E1 * k1[i] + E3 * k3[i] + E4 * k4[i] + E5 * k5[i] + E6 * k6[i] + E7 * k7[i]);
+                const double scale = m_Control.absTolerance + m_Control.relTolerance * std::max(std::abs(y[i]), std::abs(yNext[i]));
+                const double ratio = error / scale;
+                errorSum += ratio * ratio;
+                finite = finite && std::isfinite(yNext[i]);
+            }
+            const double errorNorm = finite ? std::sqrt(errorSum / static_cast<double>(N)) : HUGE_VAL;
+
+            if (!finite && h <= m_Control.minStep) {
+                // Cannot shrink any further: give up, keeping the last finite state as the result
+                stats.rejectedSteps++;
+                stats.diverged = true;
+                break;
+            }
+
+            if (errorNorm <= 1.0 || h <= m_Control.minStep) {
+                const double tPrev = t;
+                const State yPrev = y;
+                t += h;
+                y = yNext;
+                k1 = k7;  // First same as last
+                stats.acceptedSteps++;
+
+                if (!observer(t, y, tPrev, yPrev)) {
+                    break;
+                }
+            } else {
+                stats.rejectedSteps++;
+            }
+
+            // Classic 5th order controller with safety factor, growth limited to [0.2, 5]
+            const double factor = errorNorm == 0.0 ? MaxGrowth
+                : std::clamp(Safety * std::pow(errorNorm, -0.2), MinShrink, MaxGrowth);
+            h = std::clamp(h * factor, m_Control.minStep, m_Control.maxStep);
+        }
+
+        return stats;
+    }
+
+private:
+    AdaptiveStepControl m_Control;
+};
+
+} // namespace MoleHole
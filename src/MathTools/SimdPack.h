@@ -0,0 +1,135 @@
+#pragma once
+
+#include <immintrin.h>
+#include <cstdint>
+
+/**
+ * Thin operator wrappers around AVX2 / AVX-512 double vectors for runtime-dispatched kernels.
+ *
+ * Only include this from translation units compiled with the matching ISA flags (see the
+ * per-file compile options in CMakeLists.txt). Everything lives in an anonymous namespace so
+ * an AVX-512 compiled copy of an inline function can never be merged by the linker into a
+ * kernel that runs on an AVX2-only CPU.
+ */
+namespace MoleHole::Simd {
+namespace {
+
+#if defined(__AVX2__)
+struct MaskAVX2 {
+    __m256d m;
+
+    uint32_t Bits() const { return static_cast<uint32_t>(_mm256_movemask_pd(m)); }
+    bool Any() const { return Bits() != 0; }
+
+    friend MaskAVX2 operator&(MaskAVX2 a, MaskAVX2 b) { return {_mm256_and_pd(a.m, b.m)}; }
+    friend MaskAVX2 operator|(MaskAVX2 a, MaskAVX2 b) { return {_mm256_or_pd(a.m, b.m)}; }
+    friend MaskAVX2 operator~(MaskAVX2 a) {
+        return {_mm256_xor_pd(a.m, _mm256_castsi256_pd(_mm256_set1_epi64x(-1)))};
+    }
+
+    // Lane i is set when bit i of bits is set
+    static MaskAVX2 FromBits(uint32_t bits) {
+        const __m256i laneBits = _mm256_set_epi64x(8, 4, 2, 1);
+        const __m256i selected = _mm256_and_si256(_mm256_set1_epi64x(bits), laneBits);
+        return {_mm256_castsi256_pd(_mm256_cmpeq_epi64(selected, laneBits))};
+    }
+};
+
+struct DoubleAVX2 {
+    static constexpr int Width = 4;
+    using Mask = MaskAVX2;
+
+    __m256d v;
+
+    static DoubleAVX2 Broadcast(double x) { return {_mm256_set1_pd(x)}; }
+    static DoubleAVX2 Load(const double* p) { return {_mm256_load_pd(p)}; }
+    void Store(double* p) const { _mm256_store_pd(p, v); }
+
+    friend DoubleAVX2 operator+(DoubleAVX2 a, DoubleAVX2 b) { return {_mm256_add_pd(a.v, b.v)}; }
+    friend DoubleAVX2 operator-(DoubleAVX2 a, DoubleAVX2 b) { return {_mm256_sub_pd(a.v, b.v)}; }
+    friend DoubleAVX2 operator*(DoubleAVX2 a, DoubleAVX2 b) { return {_mm256_mul_pd(a.v, b.v)}; }
+    friend DoubleAVX2 operator/(DoubleAVX2 a, DoubleAVX2 b) { return {_mm256_div_pd(a.v, b.v)}; }
+    friend DoubleAVX2 operator-(DoubleAVX2 a) { return {_mm256_xor_pd(a.v, _mm256_set1_pd(-0.0))}; }
+
+    friend Mask operator<(DoubleAVX2 a, DoubleAVX2 b) { return {_mm256_cmp_pd(a.v, b.v, _CMP_LT_OQ)}; }
+    friend Mask operator<=(DoubleAVX2 a, DoubleAVX2 b) { return {_mm256_cmp_pd(a.v, b.v, _CMP_LE_OQ)}; }
+    friend Mask operator>(DoubleAVX2 a, DoubleAVX2 b) { return {_mm256_cmp_pd(a.v, b.v, _CMP_GT_OQ)}; }
+    friend Mask operator>=(DoubleAVX2 a, DoubleAVX2 b) { return {_mm256_cmp_pd(a.v, b.v, _CMP_GE_OQ)}; }
+    friend Mask operator==(DoubleAVX2 a, DoubleAVX2 b) { return {_mm256_cmp_pd(a.v, b.v, _CMP_EQ_OQ)}; }
+
+    friend DoubleAVX2 Min(DoubleAVX2 a, DoubleAVX2 b) { return {_mm256_min_pd(a.v, b.v)}; }
+    friend DoubleAVX2 Max(DoubleAVX2 a, DoubleAVX2 b) { return {_mm256_max_pd(a.v, b.v)}; }
+    friend DoubleAVX2 Abs(DoubleAVX2 a) { return {_mm256_andnot_pd(_mm256_set1_pd(-0.0), a.v)}; }
+    friend DoubleAVX2 Sqrt(DoubleAVX2 a) { return {_mm256_sqrt_pd(a.v)}; }
+
+    // Per lane: mask ? ifTrue : ifFalse
+    friend DoubleAVX2 Select(Mask mask, DoubleAVX2 ifTrue, DoubleAVX2 ifFalse) {
+        return {_mm256_blendv_pd(ifFalse.v, ifTrue.v, mask.m)};
+    }
+
+    // x = Mantissa(x) * 2^Exponent(x) with Mantissa in [1, 2), for positive normal x
+    friend DoubleAVX2 Exponent(DoubleAVX2 x) {
+        // Biased exponent placed in the mantissa of 2^52, then the 2^52 and the bias are removed
+        const __m256i biased = _mm256_srli_epi64(_mm256_castpd_si256(x.v), 52);
+        const __m256d asDouble = _mm256_castsi256_pd(_mm256_or_si256(biased, _mm256_castpd_si256(_mm256_set1_pd(4503599627370496.0))));
+        return {_mm256_sub_pd(asDouble, _mm256_set1_pd(4503599627370496.0 + 1023.0))};
+    }
+    friend DoubleAVX2 Mantissa(DoubleAVX2 x) {
+        const __m256i mantissaBits = _mm256_and_si256(_mm256_castpd_si256(x.v), _mm256_set1_epi64x(0x000FFFFFFFFFFFFFll));
+        return {_mm256_castsi256_pd(_mm256_or_si256(mantissaBits, _mm256_castpd_si256(_mm256_set1_pd(1.0))))};
+    }
+};
+#endif
+
+#if defined(__AVX512F__)
+struct MaskAVX512 {
+    __mmask8 m;
+
+    uint32_t Bits() const { return static_cast<uint32_t>(m); }
+    bool Any() const { return m != 0; }
+
+    friend MaskAVX512 operator&(MaskAVX512 a, MaskAVX512 b) { return {static_cast<__mmask8>(a.m & b.m)}; }
+    friend MaskAVX512 operator|(MaskAVX512 a, MaskAVX512 b) { return {static_cast<__mmask8>(a.m | b.m)}; }
+    friend MaskAVX512 operator~(MaskAVX512 a) { return {static_cast<__mmask8>(~a.m)}; }
+
+    static MaskAVX512 FromBits(uint32_t bits) { return {static_cast<__mmask8>(bits)}; }
+};
+
+struct DoubleAVX512 {
+    static constexpr int Width = 8;
+    using Mask = MaskAVX512;
+
+    __m512d v;
+
+    static DoubleAVX512 Broadcast(double x) { return {_mm512_set1_pd(x)}; }
+    static DoubleAVX512 Load(const double* p) { return {_mm512_load_pd(p)}; }
+    void Store(double* p) const { _mm512_store_pd(p, v); }
+
+    friend DoubleAVX512 operator+(DoubleAVX512 a, DoubleAVX512 b) { return {_mm512_add_pd(a.v, b.v)}; }
+    friend DoubleAVX512 operator-(DoubleAVX512 a, DoubleAVX512 b) { return {_mm512_sub_pd(a.v, b.v)}; }
+    friend DoubleAVX512 operator*(DoubleAVX512 a, DoubleAVX512 b) { return {_mm512_mul_pd(a.v, b.v)}; }
+    friend DoubleAVX512 operator/(DoubleAVX512 a, DoubleAVX512 b) { return {_mm512_div_pd(a.v, b.v)}; }
+    friend DoubleAVX512 operator-(DoubleAVX512 a) { return {_mm512_sub_pd(_mm512_setzero_pd(), a.v)}; }
+
+    friend Mask operator<(DoubleAVX512 a, DoubleAVX512 b) { return {_mm512_cmp_pd_mask(a.v, b.v, _CMP_LT_OQ)}; }
+    friend Mask operator<=(DoubleAVX512 a, DoubleAVX512 b) { return {_mm512_cmp_pd_mask(a.v, b.v, _CMP_LE_OQ)}; }
+    friend Mask operator>(DoubleAVX512 a, DoubleAVX512 b) { return {_mm512_cmp_pd_mask(a.v, b.v, _CMP_GT_OQ)}; }
+    friend Mask operator>=(DoubleAVX512 a, DoubleAVX512 b) { return {_mm512_cmp_pd_mask(a.v, b.v, _CMP_GE_OQ)}; }
+    friend Mask operator==(DoubleAVX512 a, DoubleAVX512 b) { return {_mm512_cmp_pd_mask(a.v, b.v, _CMP_EQ_OQ)}; }
+
+    friend DoubleAVX512 Min(DoubleAVX512 a, DoubleAVX512 b) { return {_mm512_min_pd(a.v, b.v)}; }
+    friend DoubleAVX512 Max(DoubleAVX512 a, DoubleAVX512 b) { return {_mm512_max_pd(a.v, b.v)}; }
+    friend DoubleAVX512 Abs(DoubleAVX512 a) { return {_mm512_abs_pd(a.v)}; }
+    friend DoubleAVX512 Sqrt(DoubleAVX512 a) { return {_mm512_sqrt_pd(a.v)}; }
+
+    friend DoubleAVX512 Select(Mask mask, DoubleAVX512 ifTrue, DoubleAVX512 ifFalse) {
+        return {_mm512_mask_blend_pd(mask.m, ifFalse.v, ifTrue.v)};
+    }
+
+    friend DoubleAVX512 Exponent(DoubleAVX512 x) { return {_mm512_getexp_pd(x.v)}; }
+    friend DoubleAVX512 Mantissa(DoubleAVX512 x) { return {_mm512_getmant_pd(x.v, _MM_MANT_NORM_1_2, _MM_MANT_SIGN_src)}; }
+};
+#endif
+
+} // namespace
+} // namespace MoleHole::Simd
@@ -1,4 +1,5 @@
 #include "AccelerationLUTGenerator.h"
+#include "LUTCache.h"
 #include <cmath>
 #include <algorithm>
 
@@ -48,5 +49,14 @@ std::vector<float> AccelerationLUTGenerator::generateLUT() {
     return lutData;
 }
 
+uint64_t AccelerationLUTGenerator::cacheKey() {
+    return LUTCacheKey("AccelerationLUT", GENERATOR_VERSION)
+        .Add(R_MIN).Add(R_MAX)
+        .Add(ANG_MOM_MIN).Add(ANG_MOM_MAX)
+        .Add(LUT_WIDTH).Add(LUT_HEIGHT)
+        .Add(EPSILON)
+        .Value();
+}
+
 } // namespace MoleHole
 
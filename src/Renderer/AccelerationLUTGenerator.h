@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <vector>
 #include <cmath>
 #include <algorithm>
@@ -21,6 +22,12 @@ public:
     // Generate the LUT data (returns scalar factors in row-major order)
     // The actual acceleration is: factor * relPos, where factor is the LUT value
     static std::vector<float> generateLUT();
+
+    // Bump whenever generateLUT() changes its output for the same constants
+    static constexpr uint32_t GENERATOR_VERSION = 1;
+
+    // LUT cache key over the version and every constant above
+    static uint64_t cacheKey();
     
 private:
     static float calculateAccelerationFactor(float angMomentumSqrd, float rSqrd);
@@ -2,6 +2,7 @@
 #include <glad/gl.h>
 #include <spdlog/spdlog.h>
 #include <glm/gtc/type_ptr.hpp>
+#include <chrono>
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/gtc/quaternion.hpp>
 #include <glm/gtx/quaternion.hpp>
@@ -12,6 +13,7 @@
 #include "BlackbodyLUTGenerator.h"
 #include "AccelerationLUTGenerator.h"
 #include "HRDiagramLUTGenerator.h"
+#include "LUTCache.h"
 #include "GLTFMesh.h"
 
 
@@ -62,6 +64,9 @@ void BlackHoleRenderer::Init(int width, int height) {
     CreateBloomTextures();
     CreateFullscreenQuad();
     CreateMeshBuffers();
+    ResolveParamSlots();
+    m_computeParamsSubscription = ParameterRegistry::Subscribe({ParameterGroup::Rendering, ParameterGroup::GeneralRelativity});
+    m_displayParamsSubscription = ParameterRegistry::Subscribe({ParameterGroup::Rendering, ParameterGroup::Debug});
     LoadSkybox();
     GenerateBlackbodyLUT();
     GenerateAccelerationLUT();
@@ -71,6 +76,35 @@ void BlackHoleRenderer::Init(int width, int height) {
     spdlog::info("BlackHoleRenderer initialized with {}x{} resolution", width, height);
 }
 
+void BlackHoleRenderer::ResolveParamSlots() {
+    const auto& registry = Application::Params();
+    m_paramSlots.kerrPhysics = registry.Resolve(Params::GRKerrPhysicsEnabled);
+    m_paramSlots.debugMode = registry.Resolve(Params::RenderingDebugMode);
+    m_paramSlots.thirdPerson = registry.Resolve(Params::RenderingThirdPerson);
+    m_paramSlots.cameraObject = registry.Resolve(Params::CameraObject);
+    m_paramSlots.thirdPersonDistance = registry.Resolve(Params::ThirdPersonDistance);
+    m_paramSlots.thirdPersonHeight = registry.Resolve(Params::ThirdPersonHeight);
+    m_paramSlots.lensing = registry.Resolve(Params::GRGravitationalLensingEnabled);
+    m_paramSlots.accretionDisk = registry.Resolve(Params::RenderingAccretionDiskEnabled);
+    m_paramSlots.accretionDiskVolumetric = registry.Resolve(Params::RenderingAccretionDiskVolumetric);
+    m_paramSlots.blackHoles = registry.Resolve(Params::RenderingBlackHolesEnabled);
+    m_paramSlots.redshift = registry.Resolve(Params::GRGravitationalRedshiftEnabled);
+    m_paramSlots.dopplerBeaming = registry.Resolve(Params::RenderingDopplerBeamingEnabled);
+    m_paramSlots.accDiskHeight = registry.Resolve(Params::RenderingAccDiskHeight);
+    m_paramSlots.accDiskNoiseScale = registry.Resolve(Params::RenderingAccDiskNoiseScale);
+    m_paramSlots.accDiskNoiseLOD = registry.Resolve(Params::RenderingAccDiskNoiseLOD);
+    m_paramSlots.accDiskSpeed = registry.Resolve(Params::RenderingAccDiskSpeed);
+    m_paramSlots.bloomEnabled = registry.Resolve(Params::RenderingBloomEnabled);
+    m_paramSlots.bloomThreshold = registry.Resolve(Params::RenderingBloomThreshold);
+    m_paramSlots.bloomBlurPasses = registry.Resolve(Params::RenderingBloomBlurPasses);
+    m_paramSlots.bloomIntensity = registry.Resolve(Params::RenderingBloomIntensity);
+    m_paramSlots.bloomDebug = registry.Resolve(Params::RenderingBloomDebug);
+    m_paramSlots.lensFlareEnabled = registry.Resolve(Params::RenderingLensFlareEnabled);
+    m_paramSlots.lensFlareIntensity = registry.Resolve(Params::RenderingLensFlareIntensity);
+    m_paramSlots.lensFlareThreshold = registry.Resolve(Params::RenderingLensFlareThreshold);
+    m_paramSlots.antiAliasing = registry.Resolve(Params::RenderingAntiAliasingEnabled);
+}
+
 void BlackHoleRenderer::LoadSkybox() {
     const std::string path = Application::Params().Get(Params::AppBackgroundImage, std::string("space.hdr"));
     m_skyboxTexture = std::unique_ptr<Image>(Image::LoadHDR("../assets/backgrounds/" + path));
@@ -83,8 +117,10 @@ void BlackHoleRenderer::GenerateBlackbodyLUT() {
                  m_blackbodyLUTGenerator->LUT_WIDTH, 
                  m_blackbodyLUTGenerator->LUT_HEIGHT);
     
-    // Generate the LUT data
-    auto lutData = m_blackbodyLUTGenerator->generateLUT();
+    // Generate the LUT data (or map it from the on-disk LUT cache)
+    auto lutData = LUTCache::LoadOrGenerate("blackbody", BlackbodyLUTGenerator::cacheKey(),
+                                            BlackbodyLUTGenerator::LUT_WIDTH * BlackbodyLUTGenerator::LUT_HEIGHT * 3,
+                                            [] { return BlackbodyLUTGenerator::generateLUT(); });
     
     // Create and upload the OpenGL texture
     if (m_blackbodyLUT) {
@@ -96,7 +132,7 @@ void BlackHoleRenderer::GenerateBlackbodyLUT() {
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB32F, 
                  BlackbodyLUTGenerator::LUT_WIDTH, 
                  BlackbodyLUTGenerator::LUT_HEIGHT, 
-                 0, GL_RGB, GL_FLOAT, lutData.data());
+                 0, GL_RGB, GL_FLOAT, lutData.Data());
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
@@ -112,8 +148,10 @@ void BlackHoleRenderer::GenerateAccelerationLUT() {
                  AccelerationLUTGenerator::LUT_WIDTH, 
                  AccelerationLUTGenerator::LUT_HEIGHT);
     
-    // Generate the LUT data
-    auto lutData = AccelerationLUTGenerator::generateLUT();
+    // Generate the LUT data (or map it from the on-disk LUT cache)
+    auto lutData = LUTCache::LoadOrGenerate("acceleration", AccelerationLUTGenerator::cacheKey(),
+                                            AccelerationLUTGenerator::LUT_WIDTH * AccelerationLUTGenerator::LUT_HEIGHT,
+                                            [] { return AccelerationLUTGenerator::generateLUT(); });
     
     // Create and upload the OpenGL texture
     if (m_accelerationLUT) {
@@ -125,7 +163,7 @@ void BlackHoleRenderer::GenerateAccelerationLUT() {
     glTexImage2D(GL_TEXTURE_2D, 0, GL_R32F, 
                  AccelerationLUTGenerator::LUT_WIDTH, 
                  AccelerationLUTGenerator::LUT_HEIGHT, 
-                 0, GL_RED, GL_FLOAT, lutData.data());
+                 0, GL_RED, GL_FLOAT, lutData.Data());
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
@@ -140,8 +178,10 @@ void BlackHoleRenderer::GenerateHRDiagramLUT() {
     spdlog::info("Generating HR diagram LUT ({} samples)...", 
                  HRDiagramLUTGenerator::LUT_SIZE);
     
-    // Generate the LUT data
-    auto lutData = HRDiagramLUTGenerator::generateLUT();
+    // Generate the LUT data (or map it from the on-disk LUT cache)
+    auto lutData = LUTCache::LoadOrGenerate("hr_diagram", HRDiagramLUTGenerator::cacheKey(),
+                                            HRDiagramLUTGenerator::LUT_SIZE * 3,
+                                            [] { return HRDiagramLUTGenerator::generateLUT(); });
     
     // Create and upload the OpenGL texture (1D texture for mass lookup)
     if (m_hrDiagramLUT) {
@@ -154,7 +194,7 @@ void BlackHoleRenderer::GenerateHRDiagramLUT() {
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB32F, 
                  HRDiagramLUTGenerator::LUT_SIZE, 
                  1, 
-                 0, GL_RGB, GL_FLOAT, lutData.data());
+                 0, GL_RGB, GL_FLOAT, lutData.Data());
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
@@ -168,8 +208,24 @@ void BlackHoleRenderer::GenerateKerrGeodesicLUTs() {
 
     spdlog::info("Generating Kerr geodesic LUTs...");
 
-    // Generate deflection LUT (3D: spin x inclination x impact parameter)
-    auto deflectionData = KerrGeodesicLUTGenerator::generateDeflectionLUT();
+    constexpr size_t geodesicSampleCount = static_cast<size_t>(KerrGeodesicLUTGenerator::LUT_SPIN_SAMPLES) *
+                                           KerrGeodesicLUTGenerator::LUT_INCLINATION_SAMPLES *
+                                           KerrGeodesicLUTGenerator::LUT_IMPACT_PARAM_SAMPLES;
+    const uint64_t kerrCacheKey = KerrGeodesicLUTGenerator::cacheKey();
+
+    // Deflection and redshift LUTs (3D: spin x inclination x impact parameter) share one integration pass,
+    // so they are only regenerated together
+    auto deflectionData = LUTCache::Load("kerr_deflection", kerrCacheKey, geodesicSampleCount);
+    auto redshiftData = LUTCache::Load("kerr_redshift", kerrCacheKey, geodesicSampleCount);
+    if (deflectionData && redshiftData) {
+        spdlog::info("Loaded Kerr geodesic LUTs from cache");
+    } else {
+        auto geodesicLUTs = KerrGeodesicLUTGenerator::generateGeodesicLUTs();
+        LUTCache::Store("kerr_deflection", kerrCacheKey, geodesicLUTs.deflection);
+        LUTCache::Store("kerr_redshift", kerrCacheKey, geodesicLUTs.redshift);
+        deflectionData = LUTData(std::move(geodesicLUTs.deflection));
+        redshiftData = LUTData(std::move(geodesicLUTs.redshift));
+    }
 
     if (m_kerrDeflectionLUT) {
         glDeleteTextures(1, &m_kerrDeflectionLUT);
@@ -181,7 +237,7 @@ void BlackHoleRenderer::GenerateKerrGeodesicLUTs() {
                  KerrGeodesicLUTGenerator::LUT_IMPACT_PARAM_SAMPLES,
                  KerrGeodesicLUTGenerator::LUT_INCLINATION_SAMPLES,
                  KerrGeodesicLUTGenerator::LUT_SPIN_SAMPLES,
-                 0, GL_RED, GL_FLOAT, deflectionData.data());
+                 0, GL_RED, GL_FLOAT, deflectionData->Data());
     glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
@@ -190,9 +246,7 @@ void BlackHoleRenderer::GenerateKerrGeodesicLUTs() {
 
     spdlog::info("Kerr deflection LUT uploaded to GPU");
 
-    // Generate redshift LUT (3D)
-    auto redshiftData = KerrGeodesicLUTGenerator::generateRedshiftLUT();
-
+    // Redshift LUT (3D)
     if (m_kerrRedshiftLUT) {
         glDeleteTextures(1, &m_kerrRedshiftLUT);
     }
@@ -203,7 +257,7 @@ void BlackHoleRenderer::GenerateKerrGeodesicLUTs() {
                  KerrGeodesicLUTGenerator::LUT_IMPACT_PARAM_SAMPLES,
                  KerrGeodesicLUTGenerator::LUT_INCLINATION_SAMPLES,
                  KerrGeodesicLUTGenerator::LUT_SPIN_SAMPLES,
-                 0, GL_RED, GL_FLOAT, redshiftData.data());
+                 0, GL_RED, GL_FLOAT, redshiftData->Data());
     glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
@@ -213,7 +267,10 @@ void BlackHoleRenderer::GenerateKerrGeodesicLUTs() {
     spdlog::info("Kerr redshift LUT uploaded to GPU");
 
     // Generate photon sphere LUT (2D)
-    auto photonSphereData = KerrGeodesicLUTGenerator::generatePhotonSphereLUT();
+    auto photonSphereData = LUTCache::LoadOrGenerate("kerr_photon_sphere", kerrCacheKey,
+                                                     KerrGeodesicLUTGenerator::LUT_SPIN_SAMPLES *
+                                                     KerrGeodesicLUTGenerator::LUT_INCLINATION_SAMPLES,
+                                                     [] { return KerrGeodesicLUTGenerator::generatePhotonSphereLUT(); });
 
     if (m_kerrPhotonSphereLUT) {
         glDeleteTextures(1, &m_kerrPhotonSphereLUT);
@@ -224,7 +281,7 @@ void BlackHoleRenderer::GenerateKerrGeodesicLUTs() {
     glTexImage2D(GL_TEXTURE_2D, 0, GL_R32F,
                  KerrGeodesicLUTGenerator::LUT_INCLINATION_SAMPLES,
                  KerrGeodesicLUTGenerator::LUT_SPIN_SAMPLES,
-                 0, GL_RED, GL_FLOAT, photonSphereData.data());
+                 0, GL_RED, GL_FLOAT, photonSphereData.Data());
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
@@ -233,7 +290,9 @@ void BlackHoleRenderer::GenerateKerrGeodesicLUTs() {
     spdlog::info("Kerr photon sphere LUT uploaded to GPU");
 
     // Generate ISCO LUT (1D, stored as 2D texture with height=1)
-    auto iscoData = KerrGeodesicLUTGenerator::generateISCOLUT();
+    auto iscoData = LUTCache::LoadOrGenerate("kerr_isco", kerrCacheKey,
+                                             KerrGeodesicLUTGenerator::LUT_SPIN_SAMPLES,
+                                             [] { return KerrGeodesicLUTGenerator::generateISCOLUT(); });
 
     if (m_kerrISCOLUT) {
         glDeleteTextures(1, &m_kerrISCOLUT);
@@ -244,7 +303,7 @@ void BlackHoleRenderer::GenerateKerrGeodesicLUTs() {
     glTexImage2D(GL_TEXTURE_2D, 0, GL_R32F,
                  KerrGeodesicLUTGenerator::LUT_SPIN_SAMPLES,
                  1,
-                 0, GL_RED, GL_FLOAT, iscoData.data());
+                 0, GL_RED, GL_FLOAT, iscoData.Data());
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
@@ -338,6 +397,7 @@ void BlackHoleRenderer::CreateFullscreenQuad() {
 }
 
 void BlackHoleRenderer::Render(const Scene& scene, const std::unordered_map<std::string, std::shared_ptr<GLTFMesh>>& meshCache, const Camera& camera, float time) {
+    m_params = Application::Params().Snapshot();
     UpdateUniforms(scene, meshCache, camera, time);
     // UpdateMeshBuffers(scene, meshCache);
 
@@ -411,22 +471,16 @@ void BlackHoleRenderer::Render(const Scene& scene, const std::unordered_map<std:
     }
 
     // Enable Kerr physics if all LUTs are loaded AND user has enabled it
-    bool kerrPhysicsEnabled = Application::Params().Get(Params::GRKerrPhysicsEnabled, true);
+    bool kerrPhysicsEnabled = m_params->Get(m_paramSlots.kerrPhysics, true);
     bool useKerrPhysics = kerrPhysicsEnabled &&
                           (m_kerrDeflectionLUT && m_kerrRedshiftLUT &&
                            m_kerrPhotonSphereLUT && m_kerrISCOLUT);
     m_computeShader->SetInt("u_useKerrPhysics", useKerrPhysics ? 1 : 0);
 
-    bool hasBlackHoles = false;
-    for (const auto& obj : scene.objects) {
-        if (obj.HasClass("BlackHole")) {
-            hasBlackHoles = true;
-            break;
-        }
-    }
+    const bool hasBlackHoles = !scene.ObjectsOf(ObjectClasses::BlackHole).empty();
 
     if (hasBlackHoles) {
-        m_computeShader->SetInt("u_debugMode", Application::Params().Get(Params::RenderingDebugMode, 0));
+        m_computeShader->SetInt("u_debugMode", m_params->Get(m_paramSlots.debugMode, 0));
     }
 
     unsigned int groupsX = (m_width + 15) / 16;
@@ -447,7 +501,7 @@ void BlackHoleRenderer::Render(const Scene& scene, const std::unordered_map<std:
 
 void BlackHoleRenderer::ApplyBloom() {
     // Check if bloom is enabled
-    bool bloomEnabled = Application::Params().Get(Params::RenderingBloomEnabled, true);
+    bool bloomEnabled = m_params->Get(m_paramSlots.bloomEnabled, true);
     if (!bloomEnabled) {
         return;
     }
@@ -458,7 +512,7 @@ void BlackHoleRenderer::ApplyBloom() {
     // Step 1: Extract bright areas
     m_bloomExtractShader->Bind();
     
-    float bloomThreshold = Application::Params().Get(Params::RenderingBloomThreshold, 1.0f);
+    float bloomThreshold = m_params->Get(m_paramSlots.bloomThreshold, 1.0f);
     m_bloomExtractShader->SetFloat("u_bloomThreshold", bloomThreshold);
     
     glBindImageTexture(0, m_computeTexture, 0, GL_FALSE, 0, GL_READ_ONLY, GL_RGBA32F);
@@ -472,7 +526,7 @@ void BlackHoleRenderer::ApplyBloom() {
     // Step 2: Apply Gaussian blur (ping-pong between two textures)
     m_bloomBlurShader->Bind();
     
-    int blurPasses = Application::Params().Get(Params::RenderingBloomBlurPasses, 5);
+    int blurPasses = m_params->Get(m_paramSlots.bloomBlurPasses, 5);
 
     bool horizontal = true;
     unsigned int srcTexture = m_bloomBrightTexture;
@@ -501,7 +555,7 @@ void BlackHoleRenderer::ApplyBloom() {
 
 void BlackHoleRenderer::ApplyLensFlare() {
     // Check if lens flare is enabled
-    bool lensFlareEnabled = Application::Params().Get(Params::RenderingLensFlareEnabled, true);
+    bool lensFlareEnabled = m_params->Get(m_paramSlots.lensFlareEnabled, true);
     if (!lensFlareEnabled || !m_lensFlareShader) {
         return;
     }
@@ -511,8 +565,8 @@ void BlackHoleRenderer::ApplyLensFlare() {
 
     m_lensFlareShader->Bind();
 
-    float flareIntensity = Application::Params().Get(Params::RenderingLensFlareIntensity, 0.3f);
-    float flareThreshold = Application::Params().Get(Params::RenderingLensFlareThreshold, 2.0f);
+    float flareIntensity = m_params->Get(m_paramSlots.lensFlareIntensity, 0.3f);
+    float flareThreshold = m_params->Get(m_paramSlots.lensFlareThreshold, 2.0f);
 
     m_lensFlareShader->SetFloat("u_flareIntensity", flareIntensity);
     m_lensFlareShader->SetFloat("u_flareThreshold", flareThreshold);
@@ -540,27 +594,27 @@ void BlackHoleRenderer::UpdateUniforms(const Scene& scene, const std::unordered_
     m_computeShader->SetVec3("u_cameraFront", cameraFront);
     m_computeShader->SetVec3("u_cameraUp", cameraUp);
     m_computeShader->SetVec3("u_cameraRight", cameraRight);
+    // For a tile of a larger image the aspect is the full view's: the tile covers viewWindow.zw of it
+    const glm::vec4& viewWindow = camera.GetViewWindow();
     m_computeShader->SetFloat("u_fov", camera.GetFov());
-    m_computeShader->SetInt("u_enableThirdPerson", Application::Params().Get(Params::RenderingThirdPerson, false) ? 1 : 0);
-    m_computeShader->SetFloat("u_aspect", static_cast<float>(m_width) / static_cast<float>(m_height));
+    m_computeShader->SetFloat("u_aspect", static_cast<float>(m_width) / static_cast<float>(m_height) * viewWindow.w / viewWindow.z);
+    m_computeShader->SetVec4("u_viewWindow", viewWindow);
     m_computeShader->SetFloat("u_time", time);
 
     // Third-person camera object uniforms
-    if (Application::Params().Get(Params::RenderingThirdPerson, false)) {
-        std::string selectedObjectName = Application::Params().Get(Params::CameraObject, std::string(""));
+    if (m_params->Get(m_paramSlots.thirdPerson, false)) {
+        std::string selectedObjectName = m_params->Get(m_paramSlots.cameraObject, std::string(""));
 
         // Find the selected mesh object
         bool foundObject = false;
-        for (const auto& obj : scene.objects) {
-            if (obj.HasClass("Mesh")) {
-                ParameterHandle nameHandle("Entity.Name");
-                auto nameValue = obj.GetParameter(nameHandle);
-                if (std::holds_alternative<std::string>(nameValue) && std::get<std::string>(nameValue) == selectedObjectName) {
-                    m_computeShader->SetFloat("u_thirdPersonDistance", Application::Params().Get(Params::ThirdPersonDistance, 10.0f));
-                    m_computeShader->SetFloat("u_thirdPersonHeight", Application::Params().Get(Params::ThirdPersonHeight, 3.0f));
-                    foundObject = true;
-                    break;
-                }
+        for (const uint32_t index : scene.ObjectsOf(ObjectClasses::Mesh)) {
+            const auto& obj = scene.objects[index];
+            const auto* name = obj.Find<std::string>(HotField::Name);
+            if (name && *name == selectedObjectName) {
+                m_computeShader->SetFloat("u_thirdPersonDistance", m_params->Get(m_paramSlots.thirdPersonDistance, 10.0f));
+                m_computeShader->SetFloat("u_thirdPersonHeight", m_params->Get(m_paramSlots.thirdPersonHeight, 3.0f));
+                foundObject = true;
+                break;
             }
         }
 
@@ -572,106 +626,72 @@ void BlackHoleRenderer::UpdateUniforms(const Scene& scene, const std::unordered_
         }
     }
 
-    // Rendering settings from AppState
-    m_computeShader->SetInt("u_gravitationalLensingEnabled", Application::Params().Get(Params::GRGravitationalLensingEnabled, true) ? 1 : 0);
-    m_computeShader->SetInt("u_accretionDiskEnabled", Application::Params().Get(Params::RenderingAccretionDiskEnabled, true) ? 1 : 0);
-    m_computeShader->SetInt("u_accretionDiskVolumetric", Application::Params().Get(Params::RenderingAccretionDiskVolumetric, false) ? 1 : 0);
-    m_computeShader->SetInt("u_renderBlackHoles", Application::Params().Get(Params::RenderingBlackHolesEnabled, true) ? 1 : 0);
-    m_computeShader->SetFloat("u_accDiskHeight", Application::Params().Get(Params::RenderingAccDiskHeight, 0.1f));
-    m_computeShader->SetFloat("u_accDiskNoiseScale", Application::Params().Get(Params::RenderingAccDiskNoiseScale, 1.0f));
-    m_computeShader->SetFloat("u_accDiskNoiseLOD", Application::Params().Get(Params::RenderingAccDiskNoiseLOD, 3.0f));
-    m_computeShader->SetFloat("u_accDiskSpeed", Application::Params().Get(Params::RenderingAccDiskSpeed, 1.0f));
-    m_computeShader->SetFloat("u_dopplerBeamingEnabled", Application::Params().Get(Params::RenderingDopplerBeamingEnabled, true) ? 1.0f : 0.0f);
-    m_computeShader->SetFloat("u_accDiskTemp", 2000.0f);
-    m_computeShader->SetInt("u_gravitationalRedshiftEnabled", Application::Params().Get(Params::GRGravitationalRedshiftEnabled, true) ? 1 : 0);
+    // Rendering settings from AppState; uniforms keep their values, so they are only re-sent when a setting changed
+    if (m_computeParamsSubscription.Poll(*m_params)) {
+        if (m_computeParamsSubscription.GetChangedCount() > 0) {
+            spdlog::debug("[BlackHoleRenderer] {} rendering parameters changed, updating uniforms", m_computeParamsSubscription.GetChangedCount());
+        }
+        m_computeShader->SetInt("u_enableThirdPerson", m_params->Get(m_paramSlots.thirdPerson, false) ? 1 : 0);
+        m_computeShader->SetInt("u_gravitationalLensingEnabled", m_params->Get(m_paramSlots.lensing, true) ? 1 : 0);
+        m_computeShader->SetInt("u_accretionDiskEnabled", m_params->Get(m_paramSlots.accretionDisk, true) ? 1 : 0);
+        m_computeShader->SetInt("u_accretionDiskVolumetric", m_params->Get(m_paramSlots.accretionDiskVolumetric, false) ? 1 : 0);
+        m_computeShader->SetInt("u_renderBlackHoles", m_params->Get(m_paramSlots.blackHoles, true) ? 1 : 0);
+        m_computeShader->SetFloat("u_accDiskHeight", m_params->Get(m_paramSlots.accDiskHeight, 0.1f));
+        m_computeShader->SetFloat("u_accDiskNoiseScale", m_params->Get(m_paramSlots.accDiskNoiseScale, 1.0f));
+        m_computeShader->SetFloat("u_accDiskNoiseLOD", m_params->Get(m_paramSlots.accDiskNoiseLOD, 3.0f));
+        m_computeShader->SetFloat("u_accDiskSpeed", m_params->Get(m_paramSlots.accDiskSpeed, 1.0f));
+        m_computeShader->SetFloat("u_dopplerBeamingEnabled", m_params->Get(m_paramSlots.dopplerBeaming, true) ? 1.0f : 0.0f);
+        m_computeShader->SetFloat("u_accDiskTemp", 2000.0f);
+        m_computeShader->SetInt("u_gravitationalRedshiftEnabled", m_params->Get(m_paramSlots.redshift, true) ? 1 : 0);
+    }
 
     if (m_isPhysicallyAccurate)
     {
         m_computeShader->SetInt("u_isPhysicallyAccurate", 1);
     }
 
-    int numBlackHoles = 0;
-    constexpr int MAX_BLACKHOLES = 8;
-    for (const auto& obj : scene.objects) {
-        if (numBlackHoles >= MAX_BLACKHOLES) break;
-        if (obj.HasClass("BlackHole")) {
-            ParameterHandle posHandle("Entity.Position");
-            ParameterHandle massHandle("Physics.Mass");
-            ParameterHandle spinHandle("BlackHole.Spin");
-            ParameterHandle spinAxisHandle("BlackHole.SpinAxis");
-
-            auto pos = obj.GetParameter(posHandle);
-            auto mass = obj.GetParameter(massHandle);
-            auto spin = obj.GetParameter(spinHandle);
-            auto spinAxis = obj.GetParameter(spinAxisHandle);
+    // Body positions, masses, spins and colors come from the SceneBodyBuffer bound by the Renderer
+    m_computeShader->SetInt("u_renderSpheres", 1);
 
-            if (std::holds_alternative<glm::vec3>(pos) && std::holds_alternative<float>(mass)) {
-                std::string posUniform = "u_blackHolePositions[" + std::to_string(numBlackHoles) + "]";
-                std::string massUniform = "u_blackHoleMasses[" + std::to_string(numBlackHoles) + "]";
-                std::string spinUniform = "u_blackHoleSpins[" + std::to_string(numBlackHoles) + "]";
-                std::string spinAxisUniform = "u_blackHoleSpinAxes[" + std::to_string(numBlackHoles) + "]";
+    m_computeShader->Unbind();
+}
 
-                m_computeShader->SetVec3(posUniform, std::get<glm::vec3>(pos));
-                m_computeShader->SetFloat(massUniform, std::get<float>(mass) / Physics::SOLAR_MASS);
-                m_computeShader->SetFloat(spinUniform, std::holds_alternative<float>(spin) ? std::get<float>(spin) : 0.0f);
+void BlackHoleRenderer::RunUniformBenchmark(const Scene& scene, const std::unordered_map<std::string, std::shared_ptr<GLTFMesh>>& meshCache, const Camera& camera) {
+    using Clock = std::chrono::steady_clock;
+    constexpr int WARMUP_ITERATIONS = 100;
+    constexpr int ITERATIONS = 20000;
 
-                glm::vec3 axis = std::holds_alternative<glm::vec3>(spinAxis) ? std::get<glm::vec3>(spinAxis) : glm::vec3(0.0f, 1.0f, 0.0f);
-                m_computeShader->SetVec3(spinAxisUniform, glm::normalize(axis));
+    m_params = Application::Params().Snapshot();
 
-                numBlackHoles++;
-            }
+    const auto measure = [&](const bool driverLookup) {
+        Shader::SetDriverLookup(driverLookup);
+        for (int i = 0; i < WARMUP_ITERATIONS; i++) {
+            UpdateUniforms(scene, meshCache, camera, 0.0f);
         }
-    }
-    m_computeShader->SetInt("u_numBlackHoles", numBlackHoles);
+        glFinish();
 
-    m_computeShader->SetInt("u_renderSpheres", 1);
-    int numSpheres = 0;
-    constexpr int MAX_SPHERES = 16;
-    for (const auto& obj : scene.objects) {
-        if (numSpheres >= MAX_SPHERES) break;
-        if (obj.HasClass("Sphere")) {
-            ParameterHandle posHandle("Entity.Position");
-            ParameterHandle radiusHandle("Sphere.Radius");
-            ParameterHandle colorHandle("Sphere.Color");
-            ParameterHandle massHandle("Physics.Mass");
-
-            auto pos = obj.GetParameter(posHandle);
-            auto radius = obj.GetParameter(radiusHandle);
-            auto color = obj.GetParameter(colorHandle);
-            auto mass = obj.GetParameter(massHandle);
-
-            if (std::holds_alternative<glm::vec3>(pos) && std::holds_alternative<float>(radius)) {
-                std::string posUniform = "u_spherePositions[" + std::to_string(numSpheres) + "]";
-                std::string radiusUniform = "u_sphereRadii[" + std::to_string(numSpheres) + "]";
-                std::string colorUniform = "u_sphereColors[" + std::to_string(numSpheres) + "]";
-                std::string massUniform = "u_sphereMasses[" + std::to_string(numSpheres) + "]";
-
-                m_computeShader->SetVec3(posUniform, std::get<glm::vec3>(pos));
-                m_computeShader->SetFloat(radiusUniform, std::get<float>(radius));
-
-                glm::vec4 col = glm::vec4(1.0f);
-                if (std::holds_alternative<glm::vec3>(color)) {
-                    glm::vec3 c = std::get<glm::vec3>(color);
-                    col = glm::vec4(c.x, c.y, c.z, 1.0f);
-                }
-                m_computeShader->SetVec4(colorUniform, col);
-
-                float massInSolarMasses = 0.0f;
-                if (std::holds_alternative<float>(mass)) {
-                    massInSolarMasses = std::get<float>(mass) / 1.989e30f;
-                }
-                m_computeShader->SetFloat(massUniform, massInSolarMasses);
-
-                numSpheres++;
-            }
+        const auto tStart = Clock::now();
+        for (int i = 0; i < ITERATIONS; i++) {
+            UpdateUniforms(scene, meshCache, camera, static_cast<float>(i));
         }
-    }
-    m_computeShader->SetInt("u_numSpheres", numSpheres);
+        glFinish();
+        return std::chrono::duration<double, std::micro>(Clock::now() - tStart).count() / ITERATIONS;
+    };
 
-    m_computeShader->Unbind();
+    const double driverUs = measure(true);
+    const double tableUs = measure(false);
+    Shader::SetDriverLookup(false);
+
+    spdlog::info("UpdateUniforms benchmark ({} iterations, {} scene objects)", ITERATIONS, scene.objects.size());
+    spdlog::info("  glGetUniformLocation: {:.3f} us/call", driverUs);
+    spdlog::info("  Location table:       {:.3f} us/call ({:.1f}x)", tableUs, driverUs / tableUs);
 }
 
 void BlackHoleRenderer::RenderToScreen() {
+    if (!m_params) {
+        m_params = Application::Params().Snapshot();
+    }
+
     m_displayShader->Bind();
 
     glActiveTexture(GL_TEXTURE0);
@@ -688,23 +708,25 @@ void BlackHoleRenderer::RenderToScreen() {
     glBindTexture(GL_TEXTURE_2D, m_lensFlareTexture);
     m_displayShader->SetInt("u_lensFlareImage", 2);
 
-    // Set bloom parameters
-    bool bloomEnabled = Application::Params().Get(Params::RenderingBloomEnabled, true);
-    float bloomIntensity = Application::Params().Get(Params::RenderingBloomIntensity, 5.0f);
-    bool bloomDebug = Application::Params().Get(Params::RenderingBloomDebug, false);
-    m_displayShader->SetInt("u_bloomEnabled", bloomEnabled ? 1 : 0);
-    m_displayShader->SetFloat("u_bloomIntensity", bloomIntensity);
-    m_displayShader->SetInt("u_bloomDebug", bloomDebug ? 1 : 0);
-
-    // Set lens flare parameters
-    bool lensFlareEnabled = Application::Params().Get(Params::RenderingLensFlareEnabled, true);
-    float lensFlareIntensity = Application::Params().Get(Params::RenderingLensFlareIntensity, 1.0f);
-    m_displayShader->SetInt("u_lensFlareEnabled", lensFlareEnabled ? 1 : 0);
-    m_displayShader->SetFloat("u_lensFlareIntensity", lensFlareIntensity);
-
-    // Set FXAA parameters
-    bool fxaaEnabled = Application::Params().Get(Params::RenderingAntiAliasingEnabled, false);
-    m_displayShader->SetInt("u_fxaaEnabled", fxaaEnabled ? 1 : 0);
+    if (m_displayParamsSubscription.Poll(*m_params)) {
+        // Set bloom parameters
+        bool bloomEnabled = m_params->Get(m_paramSlots.bloomEnabled, true);
+        float bloomIntensity = m_params->Get(m_paramSlots.bloomIntensity, 5.0f);
+        bool bloomDebug = m_params->Get(m_paramSlots.bloomDebug, false);
+        m_displayShader->SetInt("u_bloomEnabled", bloomEnabled ? 1 : 0);
+        m_displayShader->SetFloat("u_bloomIntensity", bloomIntensity);
+        m_displayShader->SetInt("u_bloomDebug", bloomDebug ? 1 : 0);
+
+        // Set lens flare parameters
+        bool lensFlareEnabled = m_params->Get(m_paramSlots.lensFlareEnabled, true);
+        float lensFlareIntensity = m_params->Get(m_paramSlots.lensFlareIntensity, 1.0f);
+        m_displayShader->SetInt("u_lensFlareEnabled", lensFlareEnabled ? 1 : 0);
+        m_displayShader->SetFloat("u_lensFlareIntensity", lensFlareIntensity);
+
+        // Set FXAA parameters
+        bool fxaaEnabled = m_params->Get(m_paramSlots.antiAliasing, false);
+        m_displayShader->SetInt("u_fxaaEnabled", fxaaEnabled ? 1 : 0);
+    }
     m_displayShader->SetFloat("rt_w", static_cast<float>(m_width));
     m_displayShader->SetFloat("rt_h", static_cast<float>(m_height));
 
@@ -760,9 +782,9 @@ void BlackHoleRenderer::UpdateMeshBuffers(const Scene& scene, const std::unorder
     int totalTriangles = 0;
     int meshCount = 0;
 
-    for (const auto& obj : scene.objects) {
+    for (const uint32_t index : scene.ObjectsOf(ObjectClasses::Mesh)) {
         if (meshCount >= MAX_MESHES) break;
-        if (!obj.HasClass("Mesh")) continue;
+        const auto& obj = scene.objects[index];
 
         ParameterHandle pathHandle("Mesh.FilePath");
         ParameterHandle posHandle("Entity.Position");
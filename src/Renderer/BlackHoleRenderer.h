@@ -9,6 +9,7 @@
 #include "KerrGeodesicLUTGenerator.h"
 #include "Shader.h"
 #include "Image.h"
+#include "Application/ParameterRegistry.h"
 
 class GLTFMesh;
 class Scene;
@@ -33,6 +34,14 @@ public:
     bool IsPhysicallyAccurate() const { return m_isPhysicallyAccurate; }
 
     void LoadSkybox();
+
+    /**
+     * @brief Times UpdateUniforms with the reflected location table against glGetUniformLocation
+     *
+     * Run with --benchmark-uniforms. Both variants send the same uniforms; the difference is the
+     * per-setter name lookup.
+     */
+    void RunUniformBenchmark(const Scene& scene, const std::unordered_map<std::string, std::shared_ptr<GLTFMesh>>& meshCache, const Camera& camera);
     
 private:
     void CreateComputeTexture();
@@ -47,6 +56,7 @@ private:
     void UpdateUniforms(const Scene& scene, const std::unordered_map<std::string, std::shared_ptr<GLTFMesh>>& meshCache, const Camera& camera, float time);
     void UpdateMeshBuffers(const Scene& scene, const std::unordered_map<std::string, std::shared_ptr<GLTFMesh>>& meshCache);
     void CreateMeshBuffers();
+    void ResolveParamSlots();
 
     std::unique_ptr<Shader> m_computeShader;
     std::unique_ptr<Shader> m_displayShader;
@@ -81,6 +91,18 @@ private:
 
     bool m_isPhysicallyAccurate = false;
 
+    // Registry slots of the parameters read every frame, resolved once in Init()
+    struct ParamSlots {
+        ParameterSlot kerrPhysics, debugMode, thirdPerson, cameraObject, thirdPersonDistance, thirdPersonHeight;
+        ParameterSlot lensing, accretionDisk, accretionDiskVolumetric, blackHoles, redshift, dopplerBeaming;
+        ParameterSlot accDiskHeight, accDiskNoiseScale, accDiskNoiseLOD, accDiskSpeed;
+        ParameterSlot bloomEnabled, bloomThreshold, bloomBlurPasses, bloomIntensity, bloomDebug;
+        ParameterSlot lensFlareEnabled, lensFlareIntensity, lensFlareThreshold, antiAliasing;
+    } m_paramSlots;
+    std::shared_ptr<const ParameterSnapshot> m_params; // Taken once per Render()
+    ParameterSubscription m_computeParamsSubscription;  // Setting uniforms of m_computeShader
+    ParameterSubscription m_displayParamsSubscription;  // Setting uniforms of m_displayShader
+
     static constexpr float G = 6.67430e-11f;
     static constexpr float c = 299792458.0f;
 };
@@ -1,4 +1,5 @@
 #include "BlackbodyLUTGenerator.h"
+#include "LUTCache.h"
 #include <cmath>
 #include <algorithm>
 
@@ -111,4 +112,16 @@ std::vector<float> BlackbodyLUTGenerator::generateLUT() {
     return lutData;
 }
 
+uint64_t BlackbodyLUTGenerator::cacheKey() {
+    return LUTCacheKey("BlackbodyLUT", GENERATOR_VERSION)
+        .Add(TEMP_MIN).Add(TEMP_MAX)
+        .Add(REDSHIFT_MIN).Add(REDSHIFT_MAX)
+        .Add(LUT_WIDTH).Add(LUT_HEIGHT)
+        .Add(LightSpeed).Add(BoltzmannConstant).Add(PlanckConstant)
+        .Add(Min_cY).Add(Max_cY)
+        .Add(matchingFunctionsX).Add(matchingFunctionsY).Add(matchingFunctionsZ)
+        .Add(rec2020)
+        .Value();
+}
+
 } // namespace MoleHole
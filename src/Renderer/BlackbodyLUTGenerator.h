@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <vector>
 #include <cmath>
 #include <algorithm>
@@ -41,8 +42,14 @@ public:
         float r, g, b;
     };
     
+    // Bump whenever generateLUT() changes its output for the same constants
+    static constexpr uint32_t GENERATOR_VERSION = 1;
+
     // Generate the LUT data (returns RGB floats in row-major order)
     static std::vector<float> generateLUT();
+
+    // LUT cache key over the version and every constant above
+    static uint64_t cacheKey();
     
 private:
     static RGB convertToRGB(float cX, float cY, float cZ, float normalized_cY);
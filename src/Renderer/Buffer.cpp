@@ -1,5 +1,7 @@
 #include <glad/gl.h>
 #include "Buffer.h"
+#include <algorithm>
+#include <spdlog/spdlog.h>
 
 static GLenum ToGL(BufferUsage usage) {
     switch (usage) {
@@ -69,3 +71,92 @@ void VertexArray::EnableAttrib(unsigned int index, int size, int type, bool norm
     glEnableVertexAttribArray(index);
     glVertexAttribPointer(index, size, type, normalized ? GL_TRUE : GL_FALSE, stride, pointer);
 }
+
+PersistentRingBuffer::PersistentRingBuffer(unsigned int target, size_t regionSize, unsigned int regionCount)
+    : m_Target(target), m_Fences(std::max(1u, regionCount), nullptr) {
+    GLint alignment = 1;
+    glGetIntegerv(target == GL_UNIFORM_BUFFER ? GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT : GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    m_Alignment = static_cast<size_t>(std::max(1, alignment));
+    Allocate(regionSize);
+}
+
+PersistentRingBuffer::~PersistentRingBuffer() {
+    Release();
+}
+
+void* PersistentRingBuffer::Map(size_t size) {
+    // Everything reading the current region has been issued by now
+    Fence(m_Current);
+
+    if (size > m_RegionSize) {
+        Allocate(std::max(size, m_RegionSize * 2));
+    }
+
+    m_Current = (m_Current + 1) % static_cast<unsigned int>(m_Fences.size());
+    Wait(m_Current);
+    return m_Mapped + m_Current * m_RegionSize;
+}
+
+void PersistentRingBuffer::BindRange(unsigned int index, size_t size) const {
+    glBindBufferRange(m_Target, index, m_ID, static_cast<GLintptr>(m_Current * m_RegionSize), static_cast<GLsizeiptr>(size));
+}
+
+void PersistentRingBuffer::Allocate(size_t regionSize) {
+    // Regions in flight keep the old storage alive until the GPU is done with it
+    Release();
+
+    m_RegionSize = (std::max<size_t>(regionSize, 1) + m_Alignment - 1) / m_Alignment * m_Alignment;
+    const GLsizeiptr totalSize = static_cast<GLsizeiptr>(m_RegionSize * m_Fences.size());
+    constexpr GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+    glGenBuffers(1, &m_ID);
+    glBindBuffer(m_Target, m_ID);
+    glBufferStorage(m_Target, totalSize, nullptr, flags);
+    m_Mapped = static_cast<char*>(glMapBufferRange(m_Target, 0, totalSize, flags));
+    glBindBuffer(m_Target, 0);
+    m_Current = 0;
+
+    if (!m_Mapped) {
+        spdlog::error("Failed to map persistent buffer of {} bytes", totalSize);
+    }
+}
+
+void PersistentRingBuffer::Release() {
+    for (void*& fence : m_Fences) {
+        if (fence) {
+            glDeleteSync(static_cast<GLsync>(fence));
+            fence = nullptr;
+        }
+    }
+    if (m_ID) {
+        glBindBuffer(m_Target, m_ID);
+        glUnmapBuffer(m_Target);
+        glBindBuffer(m_Target, 0);
+        glDeleteBuffers(1, &m_ID);
+        m_ID = 0;
+        m_Mapped = nullptr;
+    }
+}
+
+void PersistentRingBuffer::Fence(unsigned int region) {
+    if (m_Fences[region]) {
+        glDeleteSync(static_cast<GLsync>(m_Fences[region]));
+    }
+    m_Fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+void PersistentRingBuffer::Wait(unsigned int region) {
+    GLsync fence = static_cast<GLsync>(m_Fences[region]);
+    if (!fence) return;
+
+    constexpr GLuint64 TIMEOUT_NS = 1'000'000;
+    GLenum result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, TIMEOUT_NS);
+    while (result == GL_TIMEOUT_EXPIRED) {
+        result = glClientWaitSync(fence, 0, TIMEOUT_NS);
+    }
+    if (result == GL_WAIT_FAILED) {
+        spdlog::warn("Waiting for persistent buffer region {} failed", region);
+    }
+    glDeleteSync(fence);
+    m_Fences[region] = nullptr;
+}
@@ -1,4 +1,6 @@
 #pragma once
+#include <cstddef>
+#include <vector>
 
 enum class BufferUsage {
     StaticDraw,
@@ -40,3 +42,33 @@ public:
 private:
     unsigned int m_ID;
 };
+
+// Persistently mapped buffer split into regions that are written in turn, one per frame in flight.
+// A region is fenced once the commands reading it are issued and is only rewritten after that fence
+// signalled, so the CPU never stalls on or overwrites data the GPU is still reading.
+class PersistentRingBuffer {
+public:
+    PersistentRingBuffer(unsigned int target, size_t regionSize, unsigned int regionCount = 3);
+    ~PersistentRingBuffer();
+    PersistentRingBuffer(const PersistentRingBuffer&) = delete;
+    PersistentRingBuffer& operator=(const PersistentRingBuffer&) = delete;
+
+    // Moves on to the next region and returns its mapped memory; the buffer grows when size does not fit
+    void* Map(size_t size);
+    // Binds the first size bytes of the current region to an indexed binding point of the target
+    void BindRange(unsigned int index, size_t size) const;
+    unsigned int GetID() const { return m_ID; }
+private:
+    void Allocate(size_t regionSize);
+    void Release();
+    void Fence(unsigned int region);
+    void Wait(unsigned int region);
+
+    unsigned int m_Target;
+    unsigned int m_ID = 0;
+    size_t m_Alignment = 1;
+    size_t m_RegionSize = 0;
+    unsigned int m_Current = 0;
+    char* m_Mapped = nullptr;
+    std::vector<void*> m_Fences; // GLsync of every region, null while the region is free
+};
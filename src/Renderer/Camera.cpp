@@ -22,6 +22,10 @@ void Camera::SetAspect(float a) {
     aspect = a;
 }
 
+void Camera::SetViewWindow(const glm::vec4& window) {
+    viewWindow = window;
+}
+
 void Camera::ProcessKeyboard(float forward, float rightMove, float upMove, float deltaTime) {
     float velocity = 5.0f * deltaTime;
     position += front * forward * velocity;
@@ -62,7 +66,17 @@ glm::mat4 Camera::GetViewMatrix() const {
 }
 
 glm::mat4 Camera::GetProjectionMatrix() const {
-    return glm::perspective(glm::radians(fov), aspect, nearPlane, farPlane);
+    glm::mat4 projection = glm::perspective(glm::radians(fov), aspect, nearPlane, farPlane);
+    if (viewWindow != glm::vec4(0.0f, 0.0f, 1.0f, 1.0f)) {
+        // Maps the window to the full NDC range: x' = (x - cx * w) / hx, likewise for y
+        glm::mat4 crop(1.0f);
+        crop[0][0] = 1.0f / viewWindow.z;
+        crop[1][1] = 1.0f / viewWindow.w;
+        crop[3][0] = -viewWindow.x / viewWindow.z;
+        crop[3][1] = -viewWindow.y / viewWindow.w;
+        projection = crop * projection;
+    }
+    return projection;
 }
 
 glm::mat4 Camera::GetViewProjectionMatrix() const {
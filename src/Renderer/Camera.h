@@ -17,6 +17,10 @@ public:
     float GetYaw() const;
     float GetPitch() const;
     void SetAspect(float aspect);
+    // Part of the image plane that is rendered, as NDC center xy and half extent zw; (0, 0, 1, 1) is
+    // the whole view. Tiled exports render sub-frusta of one camera through this.
+    void SetViewWindow(const glm::vec4& window);
+    const glm::vec4& GetViewWindow() const { return viewWindow; }
     float GetFov() const;
     void SetFov(float newFov);
     glm::vec3 GetFront() const;
@@ -34,4 +38,5 @@ private:
     float aspect;
     float nearPlane;
     float farPlane;
+    glm::vec4 viewWindow = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
 };
@@ -0,0 +1,849 @@
+#include "CpuRayTracer.h"
+#include <spdlog/spdlog.h>
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <string>
+
+#include "Simulation/Scene.h"
+#include "Camera.h"
+#include "Application/Application.h"
+#include "Application/Parameters.h"
+#include "Application/ThreadPool.h"
+#include "Application/Profiler.h"
+#include "BlackbodyLUTGenerator.h"
+#include "AccelerationLUTGenerator.h"
+#include "HRDiagramLUTGenerator.h"
+
+// The functions below mirror the GLSL in shaders/ (names in the comments) and have to be kept
+// in sync with it; they work in float like the shader so both paths round alike.
+namespace {
+
+constexpr float EPSILON = 0.00005f;
+constexpr float PI = 3.1415926535f;
+
+// Defaults of u_rayStepSize, u_maxRaySteps and u_adaptiveStepRate, which BlackHoleRenderer never overrides
+constexpr float RAY_STEP_SIZE = 0.01f;
+constexpr int MAX_RAY_STEPS = 50000;
+constexpr float ADAPTIVE_STEP_RATE = 0.8f;
+
+// LUT ranges, must match the generators and lut_loader.glsl
+constexpr float LUT_TEMP_MIN = 1000.0f;
+constexpr float LUT_TEMP_MAX = 40000.0f;
+constexpr float LUT_REDSHIFT_MIN = 0.1f;
+constexpr float LUT_REDSHIFT_MAX = 3.0f;
+constexpr float ACC_LUT_R_MIN = 0.01f;
+constexpr float ACC_LUT_R_MAX = 50.0f;
+constexpr float ACC_LUT_ANG_MOM_MIN = 0.0f;
+constexpr float ACC_LUT_ANG_MOM_MAX = 100.0f;
+constexpr float HR_MASS_MIN = 0.08f;
+constexpr float HR_MASS_MAX = 100.0f;
+
+constexpr int TILE_SIZE = 16;
+constexpr int PACKET_SIZE = 8;
+
+/**
+ * @brief Bilinear, GL_LINEAR-style lookup into a float texture kept in CPU memory
+ *
+ * Texel centers sit at (i + 0.5) / size. U wraps for GL_REPEAT textures and clamps otherwise,
+ * V always clamps (GL_CLAMP_TO_EDGE). Channels past the stored ones read as 0.
+ */
+struct Texture2D {
+    const float* data = nullptr;
+    int width = 0;
+    int height = 0;
+    int channels = 0;
+    bool repeatU = false;
+
+    glm::vec3 Sample(float u, float v) const {
+        if (!data || width <= 0 || height <= 0) {
+            return glm::vec3(0.0f);
+        }
+
+        const float x = u * static_cast<float>(width) - 0.5f;
+        const float y = v * static_cast<float>(height) - 0.5f;
+        const float fx = std::floor(x);
+        const float fy = std::floor(y);
+        const float tx = x - fx;
+        const float ty = y - fy;
+
+        int x0 = static_cast<int>(fx);
+        int x1 = x0 + 1;
+        if (repeatU) {
+            x0 = ((x0 % width) + width) % width;
+            x1 = ((x1 % width) + width) % width;
+        } else {
+            x0 = std::clamp(x0, 0, width - 1);
+            x1 = std::clamp(x1, 0, width - 1);
+        }
+        const int y0 = std::clamp(static_cast<int>(fy), 0, height - 1);
+        const int y1 = std::clamp(static_cast<int>(fy) + 1, 0, height - 1);
+
+        const glm::vec3 bottom = glm::mix(Texel(x0, y0), Texel(x1, y0), tx);
+        const glm::vec3 top = glm::mix(Texel(x0, y1), Texel(x1, y1), tx);
+        return glm::mix(bottom, top, ty);
+    }
+
+    glm::vec3 Texel(int x, int y) const {
+        const float* texel = data + (static_cast<size_t>(y) * width + x) * channels;
+        glm::vec3 result(0.0f);
+        for (int c = 0; c < std::min(channels, 3); ++c) {
+            result[c] = texel[c];
+        }
+        return result;
+    }
+};
+
+struct BlackHoleData {
+    glm::vec3 position;
+    float mass;           // Solar masses
+    float spin;
+    glm::vec3 spinAxis;   // Normalized
+};
+
+struct SphereData {
+    glm::vec3 position;
+    float radius;
+    glm::vec3 color;
+    float mass;           // Solar masses
+};
+
+/**
+ * @brief Everything BlackHoleRenderer::UpdateUniforms hands to the compute shader
+ */
+struct FrameState {
+    int width = 0;
+    int height = 0;
+
+    glm::vec3 cameraPos;
+    glm::vec3 cameraFront;
+    glm::vec3 cameraUp;
+    glm::vec3 cameraRight;
+    float tanHalfFov = 0.0f;
+    float aspect = 1.0f;
+    float time = 0.0f;
+
+    bool gravitationalLensing = true;
+    bool accretionDisk = true;
+    bool accretionDiskVolumetric = false;
+    bool renderBlackHoles = true;
+    bool dopplerBeaming = true;
+    float accDiskHeight = 0.1f;
+    float accDiskNoiseScale = 1.0f;
+    float accDiskNoiseLOD = 3.0f;
+    float accDiskSpeed = 1.0f;
+
+    std::vector<BlackHoleData> blackHoles;
+    std::vector<SphereData> spheres;
+
+    Texture2D skybox;
+    Texture2D blackbodyLUT;
+    Texture2D accelerationLUT;
+    Texture2D hrDiagramLUT;
+};
+
+// physics.glsl -------------------------------------------------------------------------------
+
+float EventHorizonRadius(float mass) {
+    return 2.0f * mass;  // G = c = 1
+}
+
+float InfluenceRadius(float eventHorizonRadius) {
+    return 8.0f * eventHorizonRadius;
+}
+
+glm::vec3 ToSpherical(const glm::vec3& pos) {
+    float r = glm::length(pos);
+    if (r < EPSILON) r = EPSILON;
+
+    float theta = std::acos(std::clamp(pos.y / r, -1.0f, 1.0f));
+    theta = std::clamp(theta, EPSILON, PI - EPSILON);
+
+    const float phi = std::atan2(pos.z, pos.x);
+    return glm::vec3(r, theta, phi);
+}
+
+glm::vec3 ToCartesian(const glm::vec3& spherical) {
+    const float r = spherical.x;
+    const float theta = spherical.y;
+    const float phi = spherical.z;
+    return glm::vec3(r * std::sin(theta) * std::cos(phi),
+                     r * std::cos(theta),
+                     r * std::sin(theta) * std::sin(phi));
+}
+
+glm::vec3 SampleSkybox(const FrameState& frame, const glm::vec3& direction) {
+    // directionToSpherical
+    const glm::vec3 d = glm::normalize(direction);
+    const float u = (std::atan2(d.z, d.x) + PI) / (2.0f * PI);
+    const float v = (std::asin(std::clamp(d.y, -1.0f, 1.0f)) + PI * 0.5f) / PI;
+    return frame.skybox.Sample(u, v);
+}
+
+// lut_loader.glsl ----------------------------------------------------------------------------
+
+glm::vec3 AccelerationFromLUT(const FrameState& frame, float angMomentumSqrd, const glm::vec3& relPos) {
+    static const float logRMin = std::log(ACC_LUT_R_MIN);
+    static const float logRMax = std::log(ACC_LUT_R_MAX);
+
+    const float r = glm::length(relPos);
+
+    float angMomNorm = (angMomentumSqrd - ACC_LUT_ANG_MOM_MIN) / (ACC_LUT_ANG_MOM_MAX - ACC_LUT_ANG_MOM_MIN);
+    angMomNorm = std::clamp(angMomNorm, 0.0f, 1.0f);
+
+    float rNorm = (std::log(std::max(r, ACC_LUT_R_MIN)) - logRMin) / (logRMax - logRMin);
+    rNorm = std::clamp(rNorm, 0.0f, 1.0f);
+
+    const float factor = frame.accelerationLUT.Sample(angMomNorm, rNorm).x;
+    return factor * relPos;
+}
+
+float TemperatureFromMass(const FrameState& frame, float mass) {
+    static const float logMassMin = std::log(HR_MASS_MIN);
+    static const float logMassMax = std::log(HR_MASS_MAX);
+
+    const float logMass = std::log(std::clamp(mass, HR_MASS_MIN, HR_MASS_MAX));
+    const float massNorm = std::clamp((logMass - logMassMin) / (logMassMax - logMassMin), 0.0f, 1.0f);
+    return frame.hrDiagramLUT.Sample(massNorm, 0.5f).x;
+}
+
+// sphere.glsl --------------------------------------------------------------------------------
+
+bool IntersectSphere(const glm::vec3& rayOrigin, const glm::vec3& rayDir, const glm::vec3& center, float radius, float& t) {
+    const glm::vec3 oc = rayOrigin - center;
+    const float b = glm::dot(oc, rayDir);
+    const float c = glm::dot(oc, oc) - radius * radius;
+    const float discriminant = b * b - c;
+    if (discriminant < 0.0f) return false;
+
+    const float sqrtD = std::sqrt(discriminant);
+    const float t0 = -b - sqrtD;
+    const float t1 = -b + sqrtD;
+    if (t0 > EPSILON) {
+        t = t0;
+        return true;
+    }
+    if (t1 > EPSILON) {
+        t = t1;
+        return true;
+    }
+    return false;
+}
+
+glm::vec3 SphereColor(const FrameState& frame, int sphereIndex) {
+    const SphereData& sphere = frame.spheres[sphereIndex];
+    if (sphere.mass > 0.0f) {
+        const float temp = TemperatureFromMass(frame, sphere.mass);
+        if (temp > 0.0f) {
+            const float tempNorm = std::clamp((temp - LUT_TEMP_MIN) / (LUT_TEMP_MAX - LUT_TEMP_MIN), 0.0f, 1.0f);
+            const float redshiftNorm = std::clamp((1.0f - LUT_REDSHIFT_MIN) / (LUT_REDSHIFT_MAX - LUT_REDSHIFT_MIN), 0.0f, 1.0f);
+            return frame.blackbodyLUT.Sample(tempNorm, redshiftNorm);
+        }
+    }
+    return sphere.color;
+}
+
+// noise.glsl / sdf.glsl ----------------------------------------------------------------------
+
+glm::vec3 Fract(const glm::vec3& v) {
+    return v - glm::floor(v);
+}
+
+float Hash(const glm::ivec3& p) {
+    uint32_t x = static_cast<uint32_t>(p.x) * 1664525u + 1013904223u;
+    uint32_t y = static_cast<uint32_t>(p.y) * 1664525u + 1013904223u;
+    uint32_t z = static_cast<uint32_t>(p.z) * 1664525u + 1013904223u;
+
+    x += y * z;
+    y += z * x;
+    z += x * y;
+    x ^= x >> 16u;
+    y ^= y >> 16u;
+    z ^= z >> 16u;
+    x += y * z;
+    y += z * x;
+    z += x * y;
+
+    return static_cast<float>(x) / 4294967295.0f;
+}
+
+glm::vec3 Hash33(glm::vec3 p3) {
+    p3 = Fract(p3 * glm::vec3(0.1031f, 0.11369f, 0.13787f));
+    p3 += glm::dot(p3, glm::vec3(p3.y, p3.x, p3.z) + 19.19f);
+    return -1.0f + 2.0f * Fract(glm::vec3((p3.x + p3.y) * p3.z, (p3.x + p3.z) * p3.y, (p3.y + p3.z) * p3.x));
+}
+
+float Worley(const glm::vec3& p, float scale) {
+    const glm::vec3 id = glm::floor(p * scale);
+    const glm::vec3 fd = Fract(p * scale);
+    float minimalDist = 1.0f;
+
+    for (float x = -1.0f; x <= 1.0f; x++) {
+        for (float y = -1.0f; y <= 1.0f; y++) {
+            for (float z = -1.0f; z <= 1.0f; z++) {
+                const glm::vec3 coord(x, y, z);
+                const glm::vec3 cell = id + coord;
+                const glm::vec3 wrapped = cell - scale * glm::floor(cell / scale);  // GLSL mod()
+                const glm::vec3 rId = Hash33(wrapped) * 0.5f + 0.5f;
+                const glm::vec3 r = coord + rId - fd;
+                minimalDist = std::min(minimalDist, glm::dot(r, r));
+            }
+        }
+    }
+    return 1.0f - minimalDist;
+}
+
+float SmoothMin(float a, float b, float k) {
+    const float h = std::max(k - std::abs(a - b), 0.0f) / k;
+    return std::min(a, b) - h * h * k * 0.25f;
+}
+
+float SmoothMax(float a, float b, float k) {
+    return -SmoothMin(-a, -b, k);
+}
+
+float SdBase(const glm::vec3& p) {
+    const glm::vec3 floored = glm::floor(p);
+    const glm::ivec3 i(static_cast<int>(floored.x), static_cast<int>(floored.y), static_cast<int>(floored.z));
+    const glm::vec3 f = p - floored;
+
+    float d = 1e10f;
+    for (int c = 0; c < 8; ++c) {
+        const glm::ivec3 corner((c >> 2) & 1, (c >> 1) & 1, c & 1);
+        const float radius = 0.5f * Hash(i + corner);
+        d = std::min(d, glm::length(f - glm::vec3(corner)) - radius);
+    }
+    return d;
+}
+
+float SdFbm(glm::vec3 p, float d) {
+    float s = 1.0f;
+    for (int i = 0; i < 7; i++) {
+        float n = s * SdBase(p);
+        n = SmoothMax(n, d - 0.1f * s, 0.3f * s);
+        d = SmoothMin(n, d, 0.3f * s);
+
+        // Column-major mat3 from sdf.glsl
+        p = glm::vec3(-1.60f * p.y - 1.20f * p.z,
+                      1.60f * p.x + 0.72f * p.y - 0.96f * p.z,
+                      1.20f * p.x - 0.96f * p.y + 1.28f * p.z);
+        s = 0.5f * s;
+    }
+    return d;
+}
+
+// doppler.glsl / disk.glsl -------------------------------------------------------------------
+
+float DopplerEffect(const glm::vec3& pos, const glm::vec3& viewDir) {
+    const float r = glm::length(pos);
+    if (r < 1.0f) return 1.0f;
+    const float safeR = std::max(r, 1.0f + 1e-6f);
+
+    const float velMag = -std::sqrt(1.0f / (2.0f * (safeR - 1.0f)));
+    const glm::vec3 velDir = glm::normalize(glm::cross(glm::vec3(0.0f, 1.0f, 0.0f), pos));
+    const glm::vec3 vel = velDir * velMag;
+
+    const float gamma = 1.0f / std::sqrt(std::max(1e-12f, 1.0f - glm::dot(vel, vel)));
+    const float dopplerShift = gamma * (1.0f + glm::dot(vel, glm::normalize(viewDir)));
+    return std::max(0.0001f, dopplerShift);
+}
+
+// adiskColor: accumulates emission into color and returns the optical depth at posSph (r, theta, phi)
+float DiskColor(const FrameState& frame, const glm::vec3& posSph, glm::vec3& color, float alpha,
+                float eventHorizonRadius, const glm::vec3& rayOrigin) {
+    const float iscoRadius = 2.4f * eventHorizonRadius;
+    const float outerRadius = 6.7f * eventHorizonRadius;
+    const float rSph = posSph.x;
+    const float thetaSph = posSph.y;
+    const float phiSph = posSph.z;
+
+    if (rSph < iscoRadius || rSph > outerRadius) return 0.0f;
+
+    const glm::vec3 posCart = ToCartesian(posSph);
+
+    float density;
+    if (frame.accretionDiskVolumetric) {
+        const glm::vec3 diskPos = posCart / outerRadius;
+        const float animatedTheta = phiSph + frame.time * frame.accDiskSpeed;
+        const float rCyl = glm::length(glm::vec2(diskPos.x, diskPos.z));
+        const glm::vec3 animatedPos = glm::vec3(rCyl * std::cos(animatedTheta), 0.0f, rCyl * std::sin(animatedTheta)) *
+                                      frame.accDiskNoiseScale * 2.0f;
+        const float d = std::abs(diskPos.y / frame.accDiskHeight) - 0.5f;
+        density = std::max(0.0f, -SdFbm(animatedPos, d)) * 0.3f;
+    } else {
+        density = std::max(0.0f, 1.0f - glm::length(posCart / glm::vec3(outerRadius, frame.accDiskHeight, outerRadius)));
+    }
+
+    if (density < EPSILON) return 0.0f;
+
+    const float rCyl = rSph * std::sin(thetaSph);
+
+    float noise = 1.0f;
+    if (!frame.accretionDiskVolumetric) {
+        const int lod = static_cast<int>(frame.accDiskNoiseLOD);
+        for (int i = 0; i < lod; i++) {
+            const float animatedTheta = (i % 2 == 0) ? phiSph + frame.time * frame.accDiskSpeed
+                                                     : phiSph - frame.time * frame.accDiskSpeed;
+            const float octave = static_cast<float>(std::max(1, i));
+            const glm::vec3 noiseCoord = glm::vec3(rCyl * std::cos(animatedTheta),
+                                                   rSph * std::cos(thetaSph),
+                                                   rCyl * std::sin(animatedTheta)) * (octave * octave) * frame.accDiskNoiseScale;
+            noise *= 0.5f * Worley(noiseCoord, 1.0f) + 0.3f;
+        }
+    } else {
+        noise = 0.7f + 0.3f * Worley(posCart * frame.accDiskNoiseScale * 5.0f, 5.0f);
+    }
+
+    // The shader replaces the blackbody LUT colour with this fixed tint right after looking it up,
+    // so the temperature / redshift lookup is skipped here; only the doppler beaming survives.
+    float beamingFactor = 10.0f;
+    if (frame.dopplerBeaming) {
+        const glm::vec3 viewDir = glm::normalize(rayOrigin - (posCart + frame.cameraPos));
+        const float doppler = DopplerEffect(posCart / std::max(1e-6f, eventHorizonRadius), viewDir);
+        beamingFactor = std::pow(std::max(0.1f, doppler), 3.0f);
+    }
+
+    static const glm::vec3 bbColor(std::pow(1.0f, 1.0f / 2.2f), std::pow(0.5f, 1.0f / 2.2f), std::pow(0.2f, 1.0f / 2.2f));
+    const float contrastNoise = noise * noise * noise * 3.5f;
+
+    color += bbColor * contrastNoise * beamingFactor * alpha * 0.9f;
+    return density * 2.0f;
+}
+
+// ray_tracing.glsl ---------------------------------------------------------------------------
+
+bool FindInfluenceZone(const FrameState& frame, const glm::vec3& pos, int& closestBHIndex, float& distanceToBH) {
+    closestBHIndex = -1;
+    distanceToBH = 1e10f;
+    if (!frame.renderBlackHoles) return false;
+
+    for (int j = 0; j < static_cast<int>(frame.blackHoles.size()); j++) {
+        const float dist = glm::length(pos - frame.blackHoles[j].position);
+        if (dist < InfluenceRadius(EventHorizonRadius(frame.blackHoles[j].mass)) && dist < distanceToBH) {
+            closestBHIndex = j;
+            distanceToBH = dist;
+        }
+    }
+    return closestBHIndex >= 0;
+}
+
+// rayTraceNormalSpace: closest sphere hit within maxDistance
+bool TraceNormalSpace(const FrameState& frame, const glm::vec3& rayOrigin, const glm::vec3& rayDir, float maxDistance,
+                      glm::vec3& hitColor) {
+    float closestT = maxDistance;
+    int hitSphere = -1;
+    for (int i = 0; i < static_cast<int>(frame.spheres.size()); i++) {
+        float t;
+        if (IntersectSphere(rayOrigin, rayDir, frame.spheres[i].position, frame.spheres[i].radius, t) && t < closestT) {
+            closestT = t;
+            hitSphere = i;
+        }
+    }
+    if (hitSphere < 0) return false;
+
+    hitColor = SphereColor(frame, hitSphere);
+    return true;
+}
+
+glm::vec3 MarchInfluenceZone(const FrameState& frame, const glm::vec3& rayOrigin, const glm::vec3& rayDirection,
+                             bool& hitEventHorizon, bool& exitedZone, glm::vec3& newOrigin, glm::vec3& newDirection) {
+    hitEventHorizon = false;
+    exitedZone = false;
+    glm::vec3 color(0.0f);
+    float alpha = 1.0f;
+
+    newOrigin = rayOrigin;
+    newDirection = rayDirection;
+
+    const float stepSize = RAY_STEP_SIZE * 10.0f;
+    const int maxSteps = MAX_RAY_STEPS / 50;
+
+    for (int i = 0; i < maxSteps; i++) {
+        int closestBH;
+        float distToBH;
+        if (!FindInfluenceZone(frame, newOrigin, closestBH, distToBH)) {
+            exitedZone = true;
+            return color;
+        }
+
+        const BlackHoleData& blackHole = frame.blackHoles[closestBH];
+        const glm::vec3 relativePos = newOrigin - blackHole.position;
+
+        const glm::vec3 orbitalAngMomentum = glm::cross(relativePos, newDirection);
+        const glm::vec3 bhAngMomentum = blackHole.spin * blackHole.mass * blackHole.spinAxis;
+        const glm::vec3 totalAngMomentum = orbitalAngMomentum + bhAngMomentum * 0.1f;
+        const float angMomSqrd = glm::dot(totalAngMomentum, totalAngMomentum);
+
+        const float r_s = EventHorizonRadius(blackHole.mass);
+        const float currentStepSize = stepSize * std::min(ADAPTIVE_STEP_RATE, distToBH / r_s);
+
+        if (frame.gravitationalLensing) {
+            newDirection = glm::normalize(newDirection + AccelerationFromLUT(frame, angMomSqrd, relativePos) * currentStepSize);
+        }
+
+        if (frame.accretionDisk) {
+            const float opticalDepth = DiskColor(frame, ToSpherical(relativePos), color, alpha, r_s, newOrigin);
+            if (opticalDepth > 0.0f) {
+                alpha *= std::exp(-opticalDepth * currentStepSize);  // beerLambert
+                if (alpha < 0.01f) {
+                    return color;
+                }
+            }
+        }
+
+        glm::vec3 hitColor;
+        if (TraceNormalSpace(frame, newOrigin, newDirection, currentStepSize, hitColor)) {
+            return color + hitColor;
+        }
+
+        if (distToBH < r_s) {
+            hitEventHorizon = true;
+            return color;
+        }
+        newOrigin += newDirection * currentStepSize;
+    }
+    return color;
+}
+
+/**
+ * @brief Up to PACKET_SIZE neighbouring rays traced in lockstep through hybridRayTrace
+ *
+ * Every outer iteration advances each live ray by exactly one hybridRayTrace iteration. The
+ * straight-line stages (influence zone classification, distance to the zone boundaries, sphere
+ * intersection) run over the whole packet in SoA form with branch-free lane loops the compiler
+ * vectorizes; marching through an influence zone diverges per ray and runs lane by lane.
+ */
+struct RayPacket {
+    int count = 0;
+    alignas(32) float originX[PACKET_SIZE];
+    alignas(32) float originY[PACKET_SIZE];
+    alignas(32) float originZ[PACKET_SIZE];
+    alignas(32) float dirX[PACKET_SIZE];
+    alignas(32) float dirY[PACKET_SIZE];
+    alignas(32) float dirZ[PACKET_SIZE];
+    glm::vec3 color[PACKET_SIZE];
+    bool live[PACKET_SIZE];
+
+    glm::vec3 Origin(int lane) const { return glm::vec3(originX[lane], originY[lane], originZ[lane]); }
+    glm::vec3 Direction(int lane) const { return glm::vec3(dirX[lane], dirY[lane], dirZ[lane]); }
+
+    void SetRay(int lane, const glm::vec3& origin, const glm::vec3& dir) {
+        originX[lane] = origin.x;
+        originY[lane] = origin.y;
+        originZ[lane] = origin.z;
+        dirX[lane] = dir.x;
+        dirY[lane] = dir.y;
+        dirZ[lane] = dir.z;
+    }
+
+    void Advance(int lane, float distance) {
+        originX[lane] += dirX[lane] * distance;
+        originY[lane] += dirY[lane] * distance;
+        originZ[lane] += dirZ[lane] * distance;
+    }
+};
+
+void ClassifyInfluenceZones(const FrameState& frame, const RayPacket& packet, int* closestBH, float* minDistToInfluence) {
+    float closestDist[PACKET_SIZE];
+    for (int lane = 0; lane < PACKET_SIZE; ++lane) {
+        closestBH[lane] = -1;
+        closestDist[lane] = 1e10f;
+        minDistToInfluence[lane] = 1e10f;
+    }
+    if (!frame.renderBlackHoles) return;
+
+    for (int j = 0; j < static_cast<int>(frame.blackHoles.size()); j++) {
+        const glm::vec3 center = frame.blackHoles[j].position;
+        const float r_i = InfluenceRadius(EventHorizonRadius(frame.blackHoles[j].mass));
+        for (int lane = 0; lane < PACKET_SIZE; ++lane) {
+            const float dx = packet.originX[lane] - center.x;
+            const float dy = packet.originY[lane] - center.y;
+            const float dz = packet.originZ[lane] - center.z;
+            const float dist = std::sqrt(dx * dx + dy * dy + dz * dz);
+
+            const bool closer = dist < r_i && dist < closestDist[lane];
+            closestDist[lane] = closer ? dist : closestDist[lane];
+            closestBH[lane] = closer ? j : closestBH[lane];
+            minDistToInfluence[lane] = std::min(minDistToInfluence[lane], std::abs(dist - r_i));
+        }
+    }
+}
+
+void IntersectSpheres(const FrameState& frame, const RayPacket& packet, float* hitT, int* hitSphere) {
+    for (int lane = 0; lane < PACKET_SIZE; ++lane) {
+        hitT[lane] = 1e10f;
+        hitSphere[lane] = -1;
+    }
+
+    for (int i = 0; i < static_cast<int>(frame.spheres.size()); i++) {
+        const glm::vec3 center = frame.spheres[i].position;
+        const float radiusSqrd = frame.spheres[i].radius * frame.spheres[i].radius;
+        for (int lane = 0; lane < PACKET_SIZE; ++lane) {
+            const float ocX = packet.originX[lane] - center.x;
+            const float ocY = packet.originY[lane] - center.y;
+            const float ocZ = packet.originZ[lane] - center.z;
+            const float b = ocX * packet.dirX[lane] + ocY * packet.dirY[lane] + ocZ * packet.dirZ[lane];
+            const float c = ocX * ocX + ocY * ocY + ocZ * ocZ - radiusSqrd;
+            const float discriminant = b * b - c;
+
+            const float sqrtD = std::sqrt(std::max(discriminant, 0.0f));
+            const float t0 = -b - sqrtD;
+            const float t1 = -b + sqrtD;
+            const float t = t0 > EPSILON ? t0 : t1;
+
+            const bool hit = discriminant >= 0.0f && t > EPSILON && t < hitT[lane];
+            hitT[lane] = hit ? t : hitT[lane];
+            hitSphere[lane] = hit ? i : hitSphere[lane];
+        }
+    }
+}
+
+// hybridRayTrace for every ray of the packet
+void TracePacket(const FrameState& frame, RayPacket& packet) {
+    const int maxOuterIterations = std::max(50, MAX_RAY_STEPS / 200);
+
+    int liveCount = packet.count;
+    for (int lane = 0; lane < PACKET_SIZE; ++lane) {
+        packet.color[lane] = glm::vec3(0.0f);
+        packet.live[lane] = lane < packet.count;
+    }
+
+    int closestBH[PACKET_SIZE];
+    float minDistToInfluence[PACKET_SIZE];
+    float hitT[PACKET_SIZE];
+    int hitSphere[PACKET_SIZE];
+
+    for (int iter = 0; iter < maxOuterIterations && liveCount > 0; iter++) {
+        ClassifyInfluenceZones(frame, packet, closestBH, minDistToInfluence);
+        IntersectSpheres(frame, packet, hitT, hitSphere);
+
+        for (int lane = 0; lane < packet.count; ++lane) {
+            if (!packet.live[lane]) continue;
+
+            if (closestBH[lane] >= 0) {
+                bool hitHorizon, exited;
+                glm::vec3 newOrigin, newDir;
+                packet.color[lane] += MarchInfluenceZone(frame, packet.Origin(lane), packet.Direction(lane),
+                                                         hitHorizon, exited, newOrigin, newDir);
+                if (!hitHorizon && exited) {
+                    packet.SetRay(lane, newOrigin, newDir);
+                } else {
+                    packet.live[lane] = false;
+                    --liveCount;
+                }
+                continue;
+            }
+
+            if (hitSphere[lane] >= 0) {
+                if (hitT[lane] < minDistToInfluence[lane]) {
+                    packet.color[lane] += SphereColor(frame, hitSphere[lane]);
+                    packet.live[lane] = false;
+                    --liveCount;
+                } else {
+                    packet.Advance(lane, minDistToInfluence[lane] + EPSILON);
+                }
+                continue;
+            }
+
+            if (minDistToInfluence[lane] < 1e9f) {
+                packet.Advance(lane, minDistToInfluence[lane] + EPSILON);
+                continue;
+            }
+
+            packet.color[lane] += SampleSkybox(frame, packet.Direction(lane));
+            packet.live[lane] = false;
+            --liveCount;
+        }
+    }
+
+    for (int lane = 0; lane < packet.count; ++lane) {
+        if (packet.live[lane]) {
+            packet.color[lane] += SampleSkybox(frame, packet.Direction(lane));
+        }
+    }
+}
+
+unsigned char ToUnorm8(float value) {
+    return static_cast<unsigned char>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+}
+
+void RenderTile(const FrameState& frame, int tileX, int tileY, unsigned char* pixels) {
+    const int xEnd = std::min(tileX + TILE_SIZE, frame.width);
+    const int yEnd = std::min(tileY + TILE_SIZE, frame.height);
+
+    RayPacket packet;
+    for (int y = tileY; y < yEnd; ++y) {
+        for (int x = tileX; x < xEnd; x += PACKET_SIZE) {
+            packet.count = std::min(PACKET_SIZE, xEnd - x);
+
+            // Unused lanes repeat the last ray so the lockstep stages never see garbage
+            for (int lane = 0; lane < PACKET_SIZE; ++lane) {
+                const int px = x + std::min(lane, packet.count - 1);
+                const float u = ((static_cast<float>(px) + 0.5f) / static_cast<float>(frame.width) * 2.0f - 1.0f) * frame.aspect;
+                const float v = (static_cast<float>(y) + 0.5f) / static_cast<float>(frame.height) * 2.0f - 1.0f;
+                const glm::vec3 dir = glm::normalize(frame.cameraFront + frame.cameraRight * u * frame.tanHalfFov +
+                                                     frame.cameraUp * v * frame.tanHalfFov);
+                packet.SetRay(lane, frame.cameraPos, dir);
+            }
+
+            TracePacket(frame, packet);
+
+            // Row 0 is the bottom row, as in the compute texture and glReadPixels
+            unsigned char* out = pixels + (static_cast<size_t>(y) * frame.width + x) * 4;
+            for (int lane = 0; lane < packet.count; ++lane) {
+                out[lane * 4 + 0] = ToUnorm8(packet.color[lane].r);
+                out[lane * 4 + 1] = ToUnorm8(packet.color[lane].g);
+                out[lane * 4 + 2] = ToUnorm8(packet.color[lane].b);
+                out[lane * 4 + 3] = 255;
+            }
+        }
+    }
+}
+
+Texture2D MakeLUTTexture(const MoleHole::LUTData& lut, int width, int height, int channels) {
+    Texture2D texture;
+    texture.data = lut.Data();
+    texture.width = width;
+    texture.height = height;
+    texture.channels = channels;
+    return texture;
+}
+
+} // namespace
+
+bool CpuRayTracer::Init() {
+    using namespace MoleHole;
+
+    spdlog::info("Initializing CPU ray tracer");
+
+    m_blackbodyLUT = LUTCache::LoadOrGenerate("blackbody", BlackbodyLUTGenerator::cacheKey(),
+                                              BlackbodyLUTGenerator::LUT_WIDTH * BlackbodyLUTGenerator::LUT_HEIGHT * 3,
+                                              [] { return BlackbodyLUTGenerator::generateLUT(); });
+    m_accelerationLUT = LUTCache::LoadOrGenerate("acceleration", AccelerationLUTGenerator::cacheKey(),
+                                                 AccelerationLUTGenerator::LUT_WIDTH * AccelerationLUTGenerator::LUT_HEIGHT,
+                                                 [] { return AccelerationLUTGenerator::generateLUT(); });
+    m_hrDiagramLUT = LUTCache::LoadOrGenerate("hr_diagram", HRDiagramLUTGenerator::cacheKey(),
+                                              HRDiagramLUTGenerator::LUT_SIZE * 3,
+                                              [] { return HRDiagramLUTGenerator::generateLUT(); });
+
+    const std::string path = Application::Params().Get(Params::AppBackgroundImage, std::string("space.hdr"));
+    if (!Image::LoadHDRPixels("../assets/backgrounds/" + path, m_skybox)) {
+        spdlog::warn("CPU ray tracer has no skybox, escaping rays will be black");
+    }
+
+    m_initialized = true;
+    return true;
+}
+
+void CpuRayTracer::Render(const Scene& scene, const Camera& camera, int width, int height, float time,
+                          std::vector<unsigned char>& pixels) const {
+    PROFILE_FUNCTION();
+
+    if (!m_initialized) {
+        spdlog::error("CPU ray tracer used before Init()");
+        return;
+    }
+
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    // Same inputs BlackHoleRenderer::UpdateUniforms uploads
+    FrameState frame;
+    frame.width = width;
+    frame.height = height;
+    frame.cameraPos = camera.GetPosition();
+    frame.cameraFront = camera.GetFront();
+    frame.cameraUp = camera.GetUp();
+    frame.cameraRight = glm::normalize(glm::cross(frame.cameraFront, frame.cameraUp));
+    frame.tanHalfFov = std::tan(glm::radians(camera.GetFov()) * 0.5f);
+    frame.aspect = static_cast<float>(width) / static_cast<float>(height);
+    frame.time = time;
+
+    auto& params = Application::Params();
+    frame.gravitationalLensing = params.Get(Params::GRGravitationalLensingEnabled, true);
+    frame.accretionDisk = params.Get(Params::RenderingAccretionDiskEnabled, true);
+    frame.accretionDiskVolumetric = params.Get(Params::RenderingAccretionDiskVolumetric, false);
+    frame.renderBlackHoles = params.Get(Params::RenderingBlackHolesEnabled, true);
+    frame.dopplerBeaming = params.Get(Params::RenderingDopplerBeamingEnabled, true);
+    frame.accDiskHeight = params.Get(Params::RenderingAccDiskHeight, 0.1f);
+    frame.accDiskNoiseScale = params.Get(Params::RenderingAccDiskNoiseScale, 1.0f);
+    frame.accDiskNoiseLOD = params.Get(Params::RenderingAccDiskNoiseLOD, 3.0f);
+    frame.accDiskSpeed = params.Get(Params::RenderingAccDiskSpeed, 1.0f);
+
+    if (params.Get(Params::RenderingThirdPerson, false)) {
+        spdlog::warn("CPU ray tracer only supports the first-person camera, ignoring third-person view");
+    }
+
+    // Every body, like the unbounded SceneBodyBuffer the GPU path traces
+    frame.blackHoles.reserve(scene.ObjectsOf(ObjectClasses::BlackHole).size());
+    for (const uint32_t index : scene.ObjectsOf(ObjectClasses::BlackHole)) {
+        const auto& obj = scene.objects[index];
+
+        auto pos = obj.GetParameter(ParameterHandle("Entity.Position"));
+        auto mass = obj.GetParameter(ParameterHandle("Physics.Mass"));
+        auto spin = obj.GetParameter(ParameterHandle("BlackHole.Spin"));
+        auto spinAxis = obj.GetParameter(ParameterHandle("BlackHole.SpinAxis"));
+
+        if (std::holds_alternative<glm::vec3>(pos) && std::holds_alternative<float>(mass)) {
+            BlackHoleData blackHole;
+            blackHole.position = std::get<glm::vec3>(pos);
+            blackHole.mass = std::get<float>(mass) / Physics::SOLAR_MASS;
+            blackHole.spin = std::holds_alternative<float>(spin) ? std::get<float>(spin) : 0.0f;
+            glm::vec3 axis = std::holds_alternative<glm::vec3>(spinAxis) ? std::get<glm::vec3>(spinAxis) : glm::vec3(0.0f, 1.0f, 0.0f);
+            blackHole.spinAxis = glm::normalize(axis);
+            frame.blackHoles.push_back(blackHole);
+        }
+    }
+
+    frame.spheres.reserve(scene.ObjectsOf(ObjectClasses::Sphere).size());
+    for (const uint32_t index : scene.ObjectsOf(ObjectClasses::Sphere)) {
+        const auto& obj = scene.objects[index];
+
+        auto pos = obj.GetParameter(ParameterHandle("Entity.Position"));
+        auto radius = obj.GetParameter(ParameterHandle("Sphere.Radius"));
+        auto color = obj.GetParameter(ParameterHandle("Sphere.Color"));
+        auto mass = obj.GetParameter(ParameterHandle("Physics.Mass"));
+
+        if (std::holds_alternative<glm::vec3>(pos) && std::holds_alternative<float>(radius)) {
+            SphereData sphere;
+            sphere.position = std::get<glm::vec3>(pos);
+            sphere.radius = std::get<float>(radius);
+            sphere.color = std::holds_alternative<glm::vec3>(color) ? std::get<glm::vec3>(color) : glm::vec3(1.0f);
+            sphere.mass = std::holds_alternative<float>(mass) ? std::get<float>(mass) / 1.989e30f : 0.0f;
+            frame.spheres.push_back(sphere);
+        }
+    }
+
+    frame.skybox.data = m_skybox.data.empty() ? nullptr : m_skybox.data.data();
+    frame.skybox.width = m_skybox.width;
+    frame.skybox.height = m_skybox.height;
+    frame.skybox.channels = m_skybox.components;
+    frame.skybox.repeatU = true;
+    frame.blackbodyLUT = MakeLUTTexture(m_blackbodyLUT, MoleHole::BlackbodyLUTGenerator::LUT_WIDTH,
+                                        MoleHole::BlackbodyLUTGenerator::LUT_HEIGHT, 3);
+    frame.accelerationLUT = MakeLUTTexture(m_accelerationLUT, MoleHole::AccelerationLUTGenerator::LUT_WIDTH,
+                                           MoleHole::AccelerationLUTGenerator::LUT_HEIGHT, 1);
+    frame.hrDiagramLUT = MakeLUTTexture(m_hrDiagramLUT, MoleHole::HRDiagramLUTGenerator::LUT_SIZE, 1, 3);
+
+    pixels.resize(static_cast<size_t>(width) * height * 4);
+
+    const int tilesX = (width + TILE_SIZE - 1) / TILE_SIZE;
+    const int tilesY = (height + TILE_SIZE - 1) / TILE_SIZE;
+
+    // One tile per task: tiles next to a black hole cost orders of magnitude more than sky tiles,
+    // and the pool's work stealing evens that out
+    ThreadPool::Global().ParallelFor(0, static_cast<size_t>(tilesX) * tilesY, 1, [&](size_t begin, size_t end) {
+        for (size_t tile = begin; tile < end; ++tile) {
+            const int tileX = static_cast<int>(tile % tilesX) * TILE_SIZE;
+            const int tileY = static_cast<int>(tile / tilesX) * TILE_SIZE;
+            RenderTile(frame, tileX, tileY, pixels.data());
+        }
+    });
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
+    spdlog::info("CPU ray traced {}x{} frame ({} black holes, {} spheres) in {} ms",
+                 width, height, frame.blackHoles.size(), frame.spheres.size(), duration.count());
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include <vector>
+
+#include "Image.h"
+#include "LUTCache.h"
+
+struct Scene;
+class Camera;
+
+/**
+ * @brief Multithreaded CPU port of the hybrid ray tracer in black_hole_rendering.comp
+ *
+ * Traces hybridRayTrace / rayMarchInfluenceZone with the same blackbody, acceleration and HR
+ * diagram LUTs and the same skybox as BlackHoleRenderer, without an OpenGL context. The image
+ * is split into 16x16 tiles (the compute shader's work group footprint) that are scheduled on
+ * the global work-stealing ThreadPool, and each tile is traced in packets of 8 horizontal rays.
+ *
+ * Used for headless exports on machines without a GPU and as a reference for shader changes.
+ */
+class CpuRayTracer {
+public:
+    bool Init();
+    bool IsInitialized() const { return m_initialized; }
+
+    /**
+     * @brief Traces one frame of the scene as seen from camera
+     *
+     * Writes width * height RGBA8 pixels, bottom row first: the layout ExportRenderer reads back
+     * with glReadPixels, so the result goes through the same PNG / video encoding path.
+     * @param time Accretion disk animation time (u_time in the shader)
+     */
+    void Render(const Scene& scene, const Camera& camera, int width, int height, float time,
+                std::vector<unsigned char>& pixels) const;
+
+private:
+    MoleHole::LUTData m_blackbodyLUT;
+    MoleHole::LUTData m_accelerationLUT;
+    MoleHole::LUTData m_hrDiagramLUT;
+    Image::HDRPixels m_skybox;
+    bool m_initialized = false;
+};
@@ -2,39 +2,45 @@
 #include <glad/gl.h>
 #include "Simulation/Scene.h"
 #include "Camera.h"
+#include "CpuRayTracer.h"
+#include "VideoEncoder.h"
+#include "ImageWriter.h"
+#include "VideoSegments.h"
 #include "Application/Application.h"
 #include "Application/Parameters.h"
 #include <spdlog/spdlog.h>
-#include <stb_image_write.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
-
-extern "C" {
-#include <libavcodec/avcodec.h>
-#include <libavformat/avformat.h>
-#include <libavutil/opt.h>
-#include <libavutil/imgutils.h>
-#include <libswscale/swscale.h>
-}
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <utility>
 
 ExportRenderer::ExportRenderer() {
 }
 
 ExportRenderer::~ExportRenderer() {
+    m_videoEncoder.reset();
+    CleanupReadback();
     CleanupOffscreenBuffers();
 }
 
-void ExportRenderer::InitializeOffscreenBuffers(int width, int height) {
+void ExportRenderer::InitializeOffscreenBuffers(int width, int height, bool halfFloat) {
     CleanupOffscreenBuffers();
 
-    spdlog::info("Initializing offscreen buffers: {}x{}", width, height);
+    spdlog::info("Initializing offscreen buffers: {}x{}{}", width, height, halfFloat ? " (RGBA16F)" : "");
 
     glGenFramebuffers(1, &m_fbo);
     glBindFramebuffer(GL_FRAMEBUFFER, m_fbo);
 
     glGenTextures(1, &m_colorTexture);
     glBindTexture(GL_TEXTURE_2D, m_colorTexture);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    if (halfFloat) {
+        // Keeps the linear values of the float compute texture instead of clamping them to 8 bits
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, width, height, 0, GL_RGBA, GL_HALF_FLOAT, nullptr);
+    } else {
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    }
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
@@ -95,18 +101,23 @@ void ExportRenderer::CleanupOffscreenBuffers() {
     }
 }
 
-void ExportRenderer::RenderFrame(Scene* scene, int width, int height) {
+void ExportRenderer::RenderFrame(Scene* scene, int width, int height, float time) {
     auto& renderer = Application::GetRenderer();
-    renderer.RenderToFramebuffer(m_fbo, width, height, scene, m_camera.get());
+    renderer.RenderToFramebuffer(m_fbo, width, height, scene, m_camera.get(), time);
 }
 
-void ExportRenderer::CaptureFramePixels(std::vector<unsigned char>& pixels, int width, int height) {
+void ExportRenderer::CaptureFramePixels(std::vector<unsigned char>& pixels, int width, int height, bool halfFloat) {
     glBindFramebuffer(GL_FRAMEBUFFER, m_fbo);
     glPixelStorei(GL_PACK_ALIGNMENT, 1);
 
     glFlush();
 
-    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    if (halfFloat) {
+        // Packed to RGB halves on the GPU: 6 bytes per pixel instead of 16 for RGBA32F
+        glReadPixels(0, 0, width, height, GL_RGB, GL_HALF_FLOAT, pixels.data());
+    } else {
+        glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    }
 
     GLenum error = glGetError();
     if (error != GL_NO_ERROR) {
@@ -116,21 +127,95 @@ void ExportRenderer::CaptureFramePixels(std::vector<unsigned char>& pixels, int
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
-bool ExportRenderer::SaveImagePNG(const std::string& path, int width, int height, const std::vector<unsigned char>& pixels) {
-    std::vector<unsigned char> flippedPixels = pixels;
-    
-    int rowSize = width * 3;
-    std::vector<unsigned char> temp(rowSize);
-    for (int y = 0; y < height / 2; ++y) {
-        int topRow = y * rowSize;
-        int bottomRow = (height - 1 - y) * rowSize;
-        std::copy(flippedPixels.begin() + topRow, flippedPixels.begin() + topRow + rowSize, temp.begin());
-        std::copy(flippedPixels.begin() + bottomRow, flippedPixels.begin() + bottomRow + rowSize, flippedPixels.begin() + topRow);
-        std::copy(temp.begin(), temp.end(), flippedPixels.begin() + bottomRow);
+void ExportRenderer::InitializeReadback(int width, int height) {
+    CleanupReadback();
+
+    const GLsizeiptr frameBytes = static_cast<GLsizeiptr>(width) * height * 4;
+    constexpr GLbitfield mapFlags = GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+    m_readbackSlots.resize(READBACK_SLOTS);
+    m_freeReadbackSlots = std::make_unique<BoundedQueue<int>>(READBACK_SLOTS);
+    for (int i = 0; i < READBACK_SLOTS; ++i) {
+        ReadbackSlot& slot = m_readbackSlots[i];
+        glGenBuffers(1, &slot.pbo);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+        glBufferStorage(GL_PIXEL_PACK_BUFFER, frameBytes, nullptr, mapFlags | GL_CLIENT_STORAGE_BIT);
+        slot.pixels = static_cast<const unsigned char*>(glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, frameBytes, mapFlags));
+        if (!slot.pixels) {
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+            throw std::runtime_error("Could not map readback buffer");
+        }
+        m_freeReadbackSlots->Push(i);
     }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
 
-    int result = stbi_write_png(path.c_str(), width, height, 3, flippedPixels.data(), width * 3);
-    return result != 0;
+void ExportRenderer::CleanupReadback() {
+    for (ReadbackSlot& slot : m_readbackSlots) {
+        if (slot.fence) {
+            glDeleteSync(static_cast<GLsync>(slot.fence));
+        }
+        if (slot.pbo) {
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+            glDeleteBuffers(1, &slot.pbo);
+        }
+    }
+    m_readbackSlots.clear();
+    m_freeReadbackSlots.reset();
+    m_pendingReadback = -1;
+}
+
+void ExportRenderer::BeginFrameReadback(int64_t frameIndex) {
+    // Blocks while every slot is still waiting for or inside the conversion stage
+    const std::optional<int> slotIndex = m_freeReadbackSlots->Pop();
+    if (!slotIndex) {
+        throw std::runtime_error("Readback ring closed");
+    }
+
+    ReadbackSlot& slot = m_readbackSlots[*slotIndex];
+    glBindFramebuffer(GL_FRAMEBUFFER, m_fbo);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+    glReadPixels(0, 0, m_videoConfig.width, m_videoConfig.height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    slot.frameIndex = frameIndex;
+    glFlush();
+
+    // The previous frame's copy had this whole frame of GPU time to land
+    SubmitPendingReadback();
+    m_pendingReadback = *slotIndex;
+}
+
+void ExportRenderer::SubmitPendingReadback() {
+    if (m_pendingReadback < 0) {
+        return;
+    }
+    const int slotIndex = std::exchange(m_pendingReadback, -1);
+    ReadbackSlot& slot = m_readbackSlots[slotIndex];
+
+    GLsync fence = static_cast<GLsync>(std::exchange(slot.fence, nullptr));
+    constexpr GLuint64 timeoutNs = 100'000'000;
+    GLenum result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, timeoutNs);
+    while (result == GL_TIMEOUT_EXPIRED) {
+        result = glClientWaitSync(fence, 0, timeoutNs);
+    }
+    glDeleteSync(fence);
+    if (result == GL_WAIT_FAILED) {
+        m_freeReadbackSlots->Push(slotIndex);
+        throw std::runtime_error("Waiting for frame readback failed");
+    }
+
+    BoundedQueue<int>* freeSlots = m_freeReadbackSlots.get();
+    VideoEncoder::RgbaFrame frame{slot.pixels, slot.frameIndex, [freeSlots, slotIndex] { freeSlots->Push(slotIndex); }};
+    if (!m_videoEncoder->Submit(std::move(frame))) {
+        m_freeReadbackSlots->Push(slotIndex);
+        throw std::runtime_error(m_videoEncoder->GetError());
+    }
 }
 
 void ExportRenderer::StartImageExport(const ImageConfig& config, const std::string& outputPath, Scene* scene) {
@@ -140,11 +225,19 @@ void ExportRenderer::StartImageExport(const ImageConfig& config, const std::stri
     }
 
     m_isExporting = true;
+    m_failed = false;
     m_exportType = ExportType::Image;
     m_progress = 0.0f;
     m_currentTask = "Starting image export...";
     m_imageConfig = config;
     m_outputPath = outputPath;
+
+    std::string extension = std::filesystem::path(outputPath).extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    if (extension == ".exr") {
+        m_imageConfig.hdr = true;
+    }
     m_scene = scene;
     m_currentFrame = 0;
 
@@ -158,14 +251,18 @@ void ExportRenderer::StartVideoExport(const VideoConfig& config, const std::stri
     }
 
     m_isExporting = true;
+    m_failed = false;
     m_exportType = ExportType::Video;
     m_progress = 0.0f;
     m_currentTask = "Starting video export...";
     m_videoConfig = config;
-    
+    m_imageSequence = VideoSegments::IsImageSequence(outputPath);
+
     // Ensure dimensions are even numbers (required for H264 encoding)
-    m_videoConfig.width = (m_videoConfig.width / 2) * 2;
-    m_videoConfig.height = (m_videoConfig.height / 2) * 2;
+    if (!m_imageSequence) {
+        m_videoConfig.width = (m_videoConfig.width / 2) * 2;
+        m_videoConfig.height = (m_videoConfig.height / 2) * 2;
+    }
     
     if (m_videoConfig.width != config.width || m_videoConfig.height != config.height) {
         spdlog::warn("Video resolution adjusted from {}x{} to {}x{} (H264 requires even dimensions)", 
@@ -177,7 +274,17 @@ void ExportRenderer::StartVideoExport(const VideoConfig& config, const std::stri
     m_currentFrame = 0;
     m_totalFrames = static_cast<int>(m_videoConfig.length * m_videoConfig.framerate);
 
-    spdlog::info("Starting video export: {}x{} {} frames to {}", m_videoConfig.width, m_videoConfig.height, m_totalFrames, outputPath);
+    if (m_videoConfig.endFrame < 0 || m_videoConfig.endFrame > m_totalFrames) {
+        m_videoConfig.endFrame = m_totalFrames;
+    }
+    m_videoConfig.firstFrame = std::clamp(m_videoConfig.firstFrame, 0, m_videoConfig.endFrame);
+
+    if (m_videoConfig.firstFrame > 0 || m_videoConfig.endFrame < m_totalFrames) {
+        spdlog::info("Starting video export: {}x{} frames [{}, {}) of {} to {}", m_videoConfig.width, m_videoConfig.height,
+                     m_videoConfig.firstFrame, m_videoConfig.endFrame, m_totalFrames, outputPath);
+    } else {
+        spdlog::info("Starting video export: {}x{} {} frames to {}", m_videoConfig.width, m_videoConfig.height, m_totalFrames, outputPath);
+    }
 }
 
 void ExportRenderer::Update() {
@@ -197,6 +304,7 @@ void ExportRenderer::Update() {
     } catch (const std::exception& e) {
         spdlog::error("Export failed: {}", e.what());
         m_currentTask = "Failed: " + std::string(e.what());
+        m_failed = true;
         FinishExport();
     }
 }
@@ -214,54 +322,128 @@ void ExportRenderer::ProcessImageExport() {
                 (float)m_imageConfig.width / (float)m_imageConfig.height,
                 0.01f, 10000.0f
             );
-            m_camera->SetPosition(renderer.camera->GetPosition());
-            m_camera->SetYawPitch(renderer.camera->GetYaw(), renderer.camera->GetPitch());
+            if (renderer.camera) {
+                m_camera->SetPosition(renderer.camera->GetPosition());
+                m_camera->SetYawPitch(renderer.camera->GetYaw(), renderer.camera->GetPitch());
+            } else {
+                // No GL renderer (CPU ray tracing): same saved camera the renderer would start from
+                m_camera->SetPosition(Application::Params().Get(Params::CameraPosition, glm::vec3(0.0f, 0.0f, 10.0f)));
+                m_camera->SetYawPitch(Application::Params().Get(Params::CameraYaw, -90.0f), Application::Params().Get(Params::CameraPitch, 0.0f));
+            }
+
+            if (m_imageConfig.hdr && m_imageConfig.cpuRayTracer) {
+                throw std::runtime_error("HDR export needs the OpenGL renderer, the CPU ray tracer only produces 8-bit images");
+            }
 
-            m_pixelBuffer.resize(m_imageConfig.width * m_imageConfig.height * 4);
-            m_rgbBuffer.resize(m_imageConfig.width * m_imageConfig.height * 3);
+            // Opened up front so a bad path fails before any rendering
+            m_imageWriter = StripImageWriter::Open(m_outputPath, m_imageConfig.width, m_imageConfig.height,
+                                                   m_imageConfig.hdr ? StripImageWriter::PixelFormat::RGB16F
+                                                                     : StripImageWriter::PixelFormat::RGB8);
+
+            if (m_imageConfig.cpuRayTracer || m_imageConfig.tileSize <= 0) {
+                m_tileWidth = m_imageConfig.width;
+                m_tileHeight = m_imageConfig.height;
+            } else {
+                m_tileWidth = std::min(m_imageConfig.tileSize, m_imageConfig.width);
+                m_tileHeight = std::min(m_imageConfig.tileSize, m_imageConfig.height);
+            }
+            m_tileColumns = (m_imageConfig.width + m_tileWidth - 1) / m_tileWidth;
+            m_tileRows = (m_imageConfig.height + m_tileHeight - 1) / m_tileHeight;
+            m_currentTile = 0;
+
+            // Bloom blurs 8 pixels per axis and pass and FXAA then samples up to FXAA_SPAN_MAX (8) pixels plus
+            // a bilinear tap further out; beyond that a tile's pixels match the full render
+            m_tileGuard = 0;
+            if (m_tileColumns * m_tileRows > 1) {
+                if (Application::Params().Get(Params::RenderingBloomEnabled, true)) {
+                    m_tileGuard += 8 * Application::Params().Get(Params::RenderingBloomBlurPasses, 5);
+                }
+                if (Application::Params().Get(Params::RenderingAntiAliasingEnabled, false)) {
+                    m_tileGuard += 9;
+                }
+            }
+            if (m_tileColumns * m_tileRows > 1) {
+                spdlog::info("Rendering {}x{} image as {}x{} tiles of {}x{} (+{} guard pixels)", m_imageConfig.width,
+                             m_imageConfig.height, m_tileColumns, m_tileRows, m_tileWidth, m_tileHeight, m_tileGuard);
+            }
+
+            m_pixelBuffer.resize(static_cast<size_t>(std::min(m_tileWidth + 2 * m_tileGuard, m_imageConfig.width)) *
+                                 std::min(m_tileHeight + 2 * m_tileGuard, m_imageConfig.height) * (m_imageConfig.hdr ? 6 : 4));
+            m_rgbBuffer.resize(static_cast<size_t>(m_imageConfig.width) * m_tileHeight * (m_imageConfig.hdr ? 6 : 3));
 
             m_currentFrame++;
             break;
 
         case 1:
-            m_currentTask = "Setting up framebuffer...";
-            m_progress = 0.2f;
-            InitializeOffscreenBuffers(m_imageConfig.width, m_imageConfig.height);
+            if (m_imageConfig.cpuRayTracer) {
+                m_currentTask = "Loading CPU ray tracer...";
+                m_progress = 0.2f;
+                if (!m_cpuRayTracer) {
+                    m_cpuRayTracer = std::make_unique<CpuRayTracer>();
+                }
+                if (!m_cpuRayTracer->IsInitialized() && !m_cpuRayTracer->Init()) {
+                    throw std::runtime_error("CPU ray tracer initialization failed");
+                }
+            } else {
+                m_currentTask = "Setting up framebuffer...";
+                m_progress = 0.2f;
+                InitializeOffscreenBuffers(std::min(m_tileWidth + 2 * m_tileGuard, m_imageConfig.width),
+                                           std::min(m_tileHeight + 2 * m_tileGuard, m_imageConfig.height), m_imageConfig.hdr);
+            }
             m_currentFrame++;
             break;
 
         case 2:
-            m_currentTask = "Rendering frame...";
-            m_progress = 0.5f;
-            RenderFrame(m_scene, m_imageConfig.width, m_imageConfig.height);
-            m_currentFrame++;
-            break;
+            if (m_imageConfig.cpuRayTracer) {
+                m_currentTask = "Rendering frame...";
+                m_progress = 0.5f;
+                // Time 0 keeps the disk animation phase, and with it the reference image, reproducible
+                m_cpuRayTracer->Render(*m_scene, *m_camera, m_imageConfig.width, m_imageConfig.height, 0.0f, m_pixelBuffer);
+
+                // Bottom-up RGBA like a GL readback
+                const int width = m_imageConfig.width;
+                const int height = m_imageConfig.height;
+                for (int y = 0; y < height; ++y) {
+                    const unsigned char* src = m_pixelBuffer.data() + static_cast<size_t>(height - 1 - y) * width * 4;
+                    unsigned char* dst = m_rgbBuffer.data() + static_cast<size_t>(y) * width * 3;
+                    for (int x = 0; x < width; ++x) {
+                        dst[x * 3 + 0] = src[x * 4 + 0];
+                        dst[x * 3 + 1] = src[x * 4 + 1];
+                        dst[x * 3 + 2] = src[x * 4 + 2];
+                    }
+                }
+                m_imageWriter->WriteRows(m_rgbBuffer.data(), height);
+                m_currentFrame++;
+                break;
+            }
 
-        case 3:
-            m_currentTask = "Capturing pixels...";
-            m_progress = 0.7f;
-            CaptureFramePixels(m_pixelBuffer, m_imageConfig.width, m_imageConfig.height);
-
-            for (int i = 0; i < m_imageConfig.width * m_imageConfig.height; ++i) {
-                m_rgbBuffer[i * 3 + 0] = m_pixelBuffer[i * 4 + 0];
-                m_rgbBuffer[i * 3 + 1] = m_pixelBuffer[i * 4 + 1];
-                m_rgbBuffer[i * 3 + 2] = m_pixelBuffer[i * 4 + 2];
+            // One tile per update keeps the UI responsive and the progress moving
+            m_currentTask = m_tileColumns * m_tileRows > 1
+                ? "Rendering tile " + std::to_string(m_currentTile + 1) + "/" + std::to_string(m_tileColumns * m_tileRows) + "..."
+                : "Rendering frame...";
+            RenderImageTile();
+
+            if (m_currentTile % m_tileColumns == m_tileColumns - 1) {
+                const int row = m_currentTile / m_tileColumns;
+                const int rowHeight = std::min(m_tileHeight, m_imageConfig.height - row * m_tileHeight);
+                m_imageWriter->WriteRows(m_rgbBuffer.data(), rowHeight);
             }
 
-            m_currentFrame++;
+            m_currentTile++;
+            m_progress = 0.2f + 0.7f * static_cast<float>(m_currentTile) / static_cast<float>(m_tileColumns * m_tileRows);
+            if (m_currentTile == m_tileColumns * m_tileRows) {
+                m_currentFrame++;
+            }
             break;
 
-        case 4:
-            m_currentTask = "Saving PNG...";
-            m_progress = 0.9f;
+        case 3:
+            m_currentTask = "Saving image...";
+            m_progress = 0.95f;
 
-            if (SaveImagePNG(m_outputPath, m_imageConfig.width, m_imageConfig.height, m_rgbBuffer)) {
-                spdlog::info("Image exported successfully to: {}", m_outputPath);
-                m_currentTask = "Complete";
-            } else {
-                spdlog::error("Failed to save image to: {}", m_outputPath);
-                m_currentTask = "Failed to save image";
-            }
+            m_imageWriter->Finish();
+            m_imageWriter.reset();
+            spdlog::info("Image exported successfully to: {}", m_outputPath);
+            m_currentTask = "Complete";
 
             m_progress = 1.0f;
             FinishExport();
@@ -269,6 +451,76 @@ void ExportRenderer::ProcessImageExport() {
     }
 }
 
+void ExportRenderer::WriteSequenceFrame(const int frame) {
+    const int width = m_videoConfig.width;
+    const int height = m_videoConfig.height;
+    CaptureFramePixels(m_pixelBuffer, width, height, true);
+
+    // GL rows run bottom-up, the writer takes the top row first
+    const size_t rowBytes = static_cast<size_t>(width) * StripImageWriter::BytesPerPixel(StripImageWriter::PixelFormat::RGB16F);
+    for (int y = 0; y < height; ++y) {
+        std::memcpy(m_rgbBuffer.data() + static_cast<size_t>(y) * rowBytes,
+                    m_pixelBuffer.data() + static_cast<size_t>(height - 1 - y) * rowBytes, rowBytes);
+    }
+
+    // Compressed in parallel scanline blocks on the global ThreadPool
+    auto writer = StripImageWriter::Open(VideoSegments::SequenceFramePath(m_outputPath, frame), width, height,
+                                         StripImageWriter::PixelFormat::RGB16F);
+    writer->WriteRows(m_rgbBuffer.data(), height);
+    writer->Finish();
+}
+
+void ExportRenderer::RenderImageTile() {
+    const int width = m_imageConfig.width;
+    const int height = m_imageConfig.height;
+    const int column = m_currentTile % m_tileColumns;
+    const int row = m_currentTile / m_tileColumns;
+
+    // Tile interior; rows count from the top of the image, GL rows from the bottom
+    const int x0 = column * m_tileWidth;
+    const int x1 = std::min(x0 + m_tileWidth, width);
+    const int top = row * m_tileHeight;
+    const int bottom = std::min(top + m_tileHeight, height);
+    const int y0 = height - bottom;
+
+    // Rendered rectangle: interior plus guard band, clipped to the image
+    const int renderX0 = std::max(x0 - m_tileGuard, 0);
+    const int renderX1 = std::min(x1 + m_tileGuard, width);
+    const int renderY0 = std::max(y0 - m_tileGuard, 0);
+    const int renderY1 = std::min(height - top + m_tileGuard, height);
+    const int renderWidth = renderX1 - renderX0;
+    const int renderHeight = renderY1 - renderY0;
+
+    // Sub-frustum whose pixel centers coincide with the full image's
+    m_camera->SetViewWindow(glm::vec4(
+        static_cast<float>(renderX0 + renderX1) / static_cast<float>(width) - 1.0f,
+        static_cast<float>(renderY0 + renderY1) / static_cast<float>(height) - 1.0f,
+        static_cast<float>(renderWidth) / static_cast<float>(width),
+        static_cast<float>(renderHeight) / static_cast<float>(height)));
+
+    RenderFrame(m_scene, renderWidth, renderHeight);
+    CaptureFramePixels(m_pixelBuffer, renderWidth, renderHeight, m_imageConfig.hdr);
+
+    for (int y = top; y < bottom; ++y) {
+        const int renderRow = height - 1 - y - renderY0;
+        if (m_imageConfig.hdr) {
+            // Read back as RGB halves already, only the guard band is cut off
+            const unsigned char* src = m_pixelBuffer.data() + (static_cast<size_t>(renderRow) * renderWidth + (x0 - renderX0)) * 6;
+            unsigned char* dst = m_rgbBuffer.data() + (static_cast<size_t>(y - top) * width + x0) * 6;
+            std::memcpy(dst, src, static_cast<size_t>(x1 - x0) * 6);
+            continue;
+        }
+
+        const unsigned char* src = m_pixelBuffer.data() + (static_cast<size_t>(renderRow) * renderWidth + (x0 - renderX0)) * 4;
+        unsigned char* dst = m_rgbBuffer.data() + (static_cast<size_t>(y - top) * width + x0) * 3;
+        for (int x = 0; x < x1 - x0; ++x) {
+            dst[x * 3 + 0] = src[x * 4 + 0];
+            dst[x * 3 + 1] = src[x * 4 + 1];
+            dst[x * 3 + 2] = src[x * 4 + 2];
+        }
+    }
+}
+
 void ExportRenderer::ProcessVideoExport() {
     auto& renderer = Application::GetRenderer();
     auto& simulation = Application::GetSimulation();
@@ -286,76 +538,19 @@ void ExportRenderer::ProcessVideoExport() {
         m_camera->SetYawPitch(renderer.camera->GetYaw(), renderer.camera->GetPitch());
 
         spdlog::info("Initializing offscreen framebuffer at {}x{}", m_videoConfig.width, m_videoConfig.height);
-        InitializeOffscreenBuffers(m_videoConfig.width, m_videoConfig.height);
-
-        const AVCodec* codec = avcodec_find_encoder(AV_CODEC_ID_H264);
-        if (!codec) {
-            throw std::runtime_error("H264 codec not found");
+        InitializeOffscreenBuffers(m_videoConfig.width, m_videoConfig.height, m_imageSequence);
+
+        if (m_imageSequence) {
+            const size_t frameBytes = static_cast<size_t>(m_videoConfig.width) * m_videoConfig.height *
+                                      StripImageWriter::BytesPerPixel(StripImageWriter::PixelFormat::RGB16F);
+            m_pixelBuffer.resize(frameBytes);
+            m_rgbBuffer.resize(frameBytes);
+        } else {
+            m_videoEncoder = std::make_unique<VideoEncoder>();
+            m_videoEncoder->Open(m_outputPath, {m_videoConfig.width, m_videoConfig.height, m_videoConfig.framerate});
+            InitializeReadback(m_videoConfig.width, m_videoConfig.height);
         }
 
-        m_codecContext = avcodec_alloc_context3(codec);
-        m_codecContext->bit_rate = 4000000;
-        m_codecContext->width = m_videoConfig.width;
-        m_codecContext->height = m_videoConfig.height;
-        m_codecContext->time_base = AVRational{1, m_videoConfig.framerate};
-        m_codecContext->framerate = AVRational{m_videoConfig.framerate, 1};
-        m_codecContext->gop_size = 10;
-        m_codecContext->max_b_frames = 1;
-        m_codecContext->pix_fmt = AV_PIX_FMT_YUV420P;
-
-        spdlog::info("Codec context initialized: {}x{} @ {} fps", 
-                    m_codecContext->width, m_codecContext->height, m_codecContext->framerate.num);
-
-        if (avcodec_open2(m_codecContext, codec, nullptr) < 0) {
-            throw std::runtime_error("Could not open codec");
-        }
-        
-        spdlog::info("Codec opened successfully with dimensions: {}x{}", 
-                    m_codecContext->width, m_codecContext->height);
-
-        avformat_alloc_output_context2(&m_formatContext, nullptr, nullptr, m_outputPath.c_str());
-        if (!m_formatContext) {
-            throw std::runtime_error("Could not create output context");
-        }
-
-        AVStream* stream = avformat_new_stream(m_formatContext, nullptr);
-        stream->time_base = m_codecContext->time_base;
-        avcodec_parameters_from_context(stream->codecpar, m_codecContext);
-        
-        // Set sample aspect ratio to 1:1 (square pixels) to ensure correct display dimensions
-        stream->sample_aspect_ratio = AVRational{1, 1};
-        m_codecContext->sample_aspect_ratio = AVRational{1, 1};
-        
-        spdlog::info("Stream configured: {}x{}, time_base={}/{}, SAR={}/{}", 
-                    stream->codecpar->width, stream->codecpar->height,
-                    stream->time_base.num, stream->time_base.den,
-                    stream->sample_aspect_ratio.num, stream->sample_aspect_ratio.den);
-
-        if (!(m_formatContext->oformat->flags & AVFMT_NOFILE)) {
-            if (avio_open(&m_formatContext->pb, m_outputPath.c_str(), AVIO_FLAG_WRITE) < 0) {
-                throw std::runtime_error("Could not open output file");
-            }
-        }
-
-        if (avformat_write_header(m_formatContext, nullptr) < 0) {
-            throw std::runtime_error("Could not write format header");
-        }
-
-        m_avFrame = av_frame_alloc();
-        m_avFrame->format = m_codecContext->pix_fmt;
-        m_avFrame->width = m_codecContext->width;
-        m_avFrame->height = m_codecContext->height;
-        av_frame_get_buffer(m_avFrame, 0);
-
-        m_swsContext = sws_getContext(
-            m_videoConfig.width, m_videoConfig.height, AV_PIX_FMT_RGB24,
-            m_videoConfig.width, m_videoConfig.height, AV_PIX_FMT_YUV420P,
-            SWS_BILINEAR, nullptr, nullptr, nullptr
-        );
-
-        m_pixelBuffer.resize(m_videoConfig.width * m_videoConfig.height * 4);
-        m_rgbBuffer.resize(m_videoConfig.width * m_videoConfig.height * 3);
-
         // Store original ray marching settings and apply custom settings if requested
         if (m_videoConfig.useCustomRaySettings) {
             m_savedRayStepSize = Application::Params().Get(Params::RenderingRayStepSize, 0.1f);
@@ -371,14 +566,23 @@ void ExportRenderer::ProcessVideoExport() {
         simulation.Stop();
         simulation.Start();
 
-        m_currentFrame = 1;
+        // Step deterministically to the first frame of the range; frame n is rendered after n + 1 steps.
+        // With a checkpoint directory this starts from the nearest checkpoint an earlier export left behind.
+        if (m_videoConfig.firstFrame > 0) {
+            spdlog::info("Fast-forwarding the simulation to frame {}", m_videoConfig.firstFrame);
+            simulation.SeekToStep(static_cast<uint64_t>(m_videoConfig.firstFrame), 1.0f / m_videoConfig.framerate);
+        }
+
+        m_currentFrame = m_videoConfig.firstFrame + 1;
         spdlog::info("Video encoder initialized, starting frame rendering");
-    } else if (m_currentFrame <= m_totalFrames) {
+    } else if (m_currentFrame <= m_videoConfig.endFrame) {
+        const int rangeFrame = m_currentFrame - m_videoConfig.firstFrame;
+        const int rangeFrames = m_videoConfig.endFrame - m_videoConfig.firstFrame;
         m_currentTask = "Rendering frame " + std::to_string(m_currentFrame) + "/" + std::to_string(m_totalFrames);
-        m_progress = static_cast<float>(m_currentFrame - 1) / m_totalFrames;
+        m_progress = static_cast<float>(rangeFrame - 1) / rangeFrames;
 
         // Log first frame rendering dimensions
-        if (m_currentFrame == 1) {
+        if (rangeFrame == 1) {
             spdlog::info("Rendering first frame at {}x{}", m_videoConfig.width, m_videoConfig.height);
         }
 
@@ -387,82 +591,26 @@ void ExportRenderer::ProcessVideoExport() {
         float simulationTimePerFrame = 1.0f / m_videoConfig.framerate;
         simulation.Update(simulationTimePerFrame);
 
-        RenderFrame(m_scene, m_videoConfig.width, m_videoConfig.height);
-        CaptureFramePixels(m_pixelBuffer, m_videoConfig.width, m_videoConfig.height);
-
-        for (int i = 0; i < m_videoConfig.width * m_videoConfig.height; ++i) {
-            m_rgbBuffer[i * 3 + 0] = m_pixelBuffer[i * 4 + 0];
-            m_rgbBuffer[i * 3 + 1] = m_pixelBuffer[i * 4 + 1];
-            m_rgbBuffer[i * 3 + 2] = m_pixelBuffer[i * 4 + 2];
-        }
-
-        std::vector<unsigned char> flippedPixels = m_rgbBuffer;
-        int rowSize = m_videoConfig.width * 3;
-        std::vector<unsigned char> temp(rowSize);
-        for (int y = 0; y < m_videoConfig.height / 2; ++y) {
-            int topRow = y * rowSize;
-            int bottomRow = (m_videoConfig.height - 1 - y) * rowSize;
-            std::copy(flippedPixels.begin() + topRow, flippedPixels.begin() + topRow + rowSize, temp.begin());
-            std::copy(flippedPixels.begin() + bottomRow, flippedPixels.begin() + bottomRow + rowSize, flippedPixels.begin() + topRow);
-            std::copy(temp.begin(), temp.end(), flippedPixels.begin() + bottomRow);
-        }
-
-        const uint8_t* srcData[1] = { flippedPixels.data() };
-        int srcLinesize[1] = { m_videoConfig.width * 3 };
-        sws_scale(m_swsContext, srcData, srcLinesize, 0, m_videoConfig.height, m_avFrame->data, m_avFrame->linesize);
-
-        m_avFrame->pts = m_currentFrame - 1;
-
-        AVPacket* pkt = av_packet_alloc();
-        int ret = avcodec_send_frame(m_codecContext, m_avFrame);
-        while (ret >= 0) {
-            ret = avcodec_receive_packet(m_codecContext, pkt);
-            if (ret == AVERROR(EAGAIN) || ret == AVERROR_EOF) {
-                break;
-            }
-            if (ret < 0) {
-                spdlog::error("Error encoding frame");
-                break;
-            }
-            av_packet_rescale_ts(pkt, m_codecContext->time_base, m_formatContext->streams[0]->time_base);
-            pkt->stream_index = 0;
-            av_interleaved_write_frame(m_formatContext, pkt);
-            av_packet_unref(pkt);
+        // Rendering this frame overlaps with converting and encoding the previous ones.
+        // Segments are independent files, so their timestamps start at zero.
+        RenderFrame(m_scene, m_videoConfig.width, m_videoConfig.height, simulation.GetSimulationTime());
+        if (m_imageSequence) {
+            WriteSequenceFrame(m_currentFrame - 1);
+        } else {
+            BeginFrameReadback(rangeFrame - 1);
         }
-        av_packet_free(&pkt);
 
         m_currentFrame++;
     } else {
         m_currentTask = "Finalizing video...";
         m_progress = 0.95f;
 
-        avcodec_send_frame(m_codecContext, nullptr);
-        AVPacket* pkt = av_packet_alloc();
-        int ret;
-        while ((ret = avcodec_receive_packet(m_codecContext, pkt)) >= 0) {
-            av_packet_rescale_ts(pkt, m_codecContext->time_base, m_formatContext->streams[0]->time_base);
-            pkt->stream_index = 0;
-            av_interleaved_write_frame(m_formatContext, pkt);
-            av_packet_unref(pkt);
+        if (!m_imageSequence) {
+            SubmitPendingReadback();
+            m_videoEncoder->Finish();
+            m_videoEncoder.reset();
+            CleanupReadback();
         }
-        av_packet_free(&pkt);
-
-        av_write_trailer(m_formatContext);
-
-        sws_freeContext(m_swsContext);
-        av_frame_free(&m_avFrame);
-
-        if (!(m_formatContext->oformat->flags & AVFMT_NOFILE)) {
-            avio_closep(&m_formatContext->pb);
-        }
-        
-        avformat_free_context(m_formatContext);
-        avcodec_free_context(&m_codecContext);
-
-        m_swsContext = nullptr;
-        m_avFrame = nullptr;
-        m_formatContext = nullptr;
-        m_codecContext = nullptr;
 
         // Restore original ray marching settings if custom settings were used
         if (m_videoConfig.useCustomRaySettings) {
@@ -474,13 +622,22 @@ void ExportRenderer::ProcessVideoExport() {
         m_currentTask = "Complete";
         m_progress = 1.0f;
 
-        spdlog::info("Video exported successfully to: {}", m_outputPath);
+        if (m_imageSequence) {
+            spdlog::info("Frames [{}, {}) exported successfully to: {}", m_videoConfig.firstFrame, m_videoConfig.endFrame,
+                         VideoSegments::SequenceFramePath(m_outputPath, m_videoConfig.firstFrame));
+        } else {
+            spdlog::info("Video exported successfully to: {}", m_outputPath);
+        }
         FinishExport();
     }
 }
 
 void ExportRenderer::FinishExport() {
     m_camera.reset();
+    m_imageWriter.reset();  // Removes the temporary file of an image that was never finished
+    // After a failure the encoder still runs; stop it before its readback slots go away
+    m_videoEncoder.reset();
+    CleanupReadback();
     CleanupOffscreenBuffers();
     m_pixelBuffer.clear();
     m_rgbBuffer.clear();
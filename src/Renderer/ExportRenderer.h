@@ -1,24 +1,33 @@
 #pragma once
+#include <cstdint>
 #include <memory>
 #include <vector>
 #include <functional>
 #include <string>
 
+#include "Application/BoundedQueue.h"
+
 class Scene;
 class Camera;
-
-struct AVCodecContext;
-struct AVFormatContext;
-struct AVFrame;
-struct SwsContext;
+class CpuRayTracer;
+class VideoEncoder;
+class StripImageWriter;
 
 class ExportRenderer {
 public:
     struct ImageConfig {
         int width = 1920;
         int height = 1080;
+        bool cpuRayTracer = false;  // Trace with CpuRayTracer, no OpenGL context needed
+        // Largest edge rendered in one pass on the GPU; larger images are rendered tile by tile and
+        // streamed to the file a row of tiles at a time. 0 renders the whole image at once.
+        int tileSize = 2048;
+        // Linear half-float output without the 8-bit round trip: 16-bit PNG, or OpenEXR (.exr implies it)
+        bool hdr = false;
     };
 
+    // An output path ending in .exr or .png exports the video as a sequence of linear half-float
+    // frames, name.00000.exr and so on (see VideoSegments::SequenceFramePath), instead of H.264
     struct VideoConfig {
         int width = 1920;
         int height = 1080;
@@ -28,6 +37,10 @@ public:
         bool useCustomRaySettings = false;
         float customRayStepSize = 0.01f;
         int customMaxRaySteps = 1000;
+        // Half-open range of frames written to the file, for splitting an export across processes.
+        // The simulation is stepped through the frames before firstFrame without rendering them.
+        int firstFrame = 0;
+        int endFrame = -1;  // -1: the last frame of the video
     };
 
     ExportRenderer();
@@ -39,15 +52,28 @@ public:
     void Update();
 
     bool IsExporting() const { return m_isExporting; }
+    bool HasFailed() const { return m_failed; }  // The last export stopped on an error
     float GetProgress() const { return m_progress; }
     const std::string& GetCurrentTask() const { return m_currentTask; }
 
 private:
-    void InitializeOffscreenBuffers(int width, int height);
+    void InitializeOffscreenBuffers(int width, int height, bool halfFloat = false);
     void CleanupOffscreenBuffers();
-    void RenderFrame(Scene* scene, int width, int height);
-    void CaptureFramePixels(std::vector<unsigned char>& pixels, int width, int height);
-    bool SaveImagePNG(const std::string& path, int width, int height, const std::vector<unsigned char>& pixels);
+    void RenderFrame(Scene* scene, int width, int height, float time = -1.0f);
+    // halfFloat reads GL_RGB/GL_HALF_FLOAT (6 bytes per pixel) instead of GL_RGBA/GL_UNSIGNED_BYTE
+    void CaptureFramePixels(std::vector<unsigned char>& pixels, int width, int height, bool halfFloat = false);
+
+    // Asynchronous video readback: glReadPixels into a ring of persistently mapped PBOs
+    void InitializeReadback(int width, int height);
+    void CleanupReadback();
+    void BeginFrameReadback(int64_t frameIndex);
+    void SubmitPendingReadback();
+
+    // Reads back the rendered frame as RGB halves and writes it as one image of the sequence
+    void WriteSequenceFrame(int frame);
+
+    // Renders tile m_currentTile with its guard band and copies the interior into the strip buffer
+    void RenderImageTile();
 
     void ProcessImageExport();
     void ProcessVideoExport();
@@ -60,6 +86,7 @@ private:
     };
 
     bool m_isExporting = false;
+    bool m_failed = false;
     float m_progress = 0.0f;
     std::string m_currentTask;
     ExportType m_exportType = ExportType::None;
@@ -69,6 +96,7 @@ private:
     unsigned int m_depthRenderbuffer = 0;
 
     std::unique_ptr<Camera> m_camera;
+    std::unique_ptr<CpuRayTracer> m_cpuRayTracer;
 
     ImageConfig m_imageConfig;
     VideoConfig m_videoConfig;
@@ -77,14 +105,31 @@ private:
 
     int m_currentFrame = 0;
     int m_totalFrames = 0;
+    bool m_imageSequence = false;  // Video export written as HDR frames instead of encoded
+
+    struct ReadbackSlot {
+        unsigned int pbo = 0;
+        const unsigned char* pixels = nullptr;  // Persistent mapping of pbo
+        void* fence = nullptr;                  // GLsync of the pending glReadPixels
+        int64_t frameIndex = 0;
+    };
+    static constexpr int READBACK_SLOTS = 3;
 
-    AVCodecContext* m_codecContext = nullptr;
-    AVFormatContext* m_formatContext = nullptr;
-    AVFrame* m_avFrame = nullptr;
-    SwsContext* m_swsContext = nullptr;
+    std::vector<ReadbackSlot> m_readbackSlots;
+    std::unique_ptr<BoundedQueue<int>> m_freeReadbackSlots;  // Refilled by the encoder's conversion thread
+    int m_pendingReadback = -1;  // Slot read back last, handed to the encoder one frame later
+    std::unique_ptr<VideoEncoder> m_videoEncoder;
 
     std::vector<unsigned char> m_pixelBuffer;
-    std::vector<unsigned char> m_rgbBuffer;
+    std::vector<unsigned char> m_rgbBuffer;  // One row of tiles, top row first, RGB8 or RGB16F
+
+    std::unique_ptr<StripImageWriter> m_imageWriter;
+    int m_tileWidth = 0;
+    int m_tileHeight = 0;
+    int m_tileGuard = 0;  // Extra pixels rendered around each tile so screen-space effects see their neighbours
+    int m_tileColumns = 0;
+    int m_tileRows = 0;
+    int m_currentTile = 0;
     
     // Store original settings for restoration after export
     float m_savedRayStepSize = 0.01f;
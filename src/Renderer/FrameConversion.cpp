@@ -0,0 +1,196 @@
+#include "FrameConversion.h"
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <vector>
+#include <spdlog/spdlog.h>
+
+#include "Application/CpuFeatures.h"
+
+extern "C" {
+#include <libavutil/frame.h>
+#include <libswscale/swscale.h>
+}
+
+namespace MoleHole::FrameConversion {
+
+namespace {
+inline uint8_t luma(int r, int g, int b) {
+    return static_cast<uint8_t>(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+}
+
+inline uint8_t chromaU(int r, int g, int b) {
+    return static_cast<uint8_t>(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+}
+
+inline uint8_t chromaV(int r, int g, int b) {
+    return static_cast<uint8_t>(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+}
+
+// Rounded average, the same as the SIMD byte average instructions
+inline int average(int a, int b) {
+    return (a + b + 1) >> 1;
+}
+}
+
+void ConvertRowPairScalar(const uint8_t* top, const uint8_t* bottom, int beginX, int width,
+                          uint8_t* yTop, uint8_t* yBottom, uint8_t* u, uint8_t* v) {
+    const uint8_t* below = bottom ? bottom : top;
+    for (int x = beginX; x < width; x += 2) {
+        // The last column of an odd-width frame pairs with itself
+        const int x1 = std::min(x + 1, width - 1);
+        const uint8_t* t0 = top + x * 4;
+        const uint8_t* t1 = top + x1 * 4;
+        const uint8_t* b0 = below + x * 4;
+        const uint8_t* b1 = below + x1 * 4;
+
+        yTop[x] = luma(t0[0], t0[1], t0[2]);
+        if (x1 != x) yTop[x1] = luma(t1[0], t1[1], t1[2]);
+        if (bottom) {
+            yBottom[x] = luma(b0[0], b0[1], b0[2]);
+            if (x1 != x) yBottom[x1] = luma(b1[0], b1[1], b1[2]);
+        }
+
+        int rgb[3];
+        for (int c = 0; c < 3; ++c) {
+            rgb[c] = average(average(t0[c], b0[c]), average(t1[c], b1[c]));
+        }
+        u[x / 2] = chromaU(rgb[0], rgb[1], rgb[2]);
+        v[x / 2] = chromaV(rgb[0], rgb[1], rgb[2]);
+    }
+}
+
+void ConvertScalar(const uint8_t* rgba, int width, int height, uint8_t* const* planes, const int* linesizes) {
+    const size_t stride = static_cast<size_t>(width) * 4;
+    for (int y = 0; y < height; y += 2) {
+        // Output row y is source row height - 1 - y
+        const uint8_t* top = rgba + static_cast<size_t>(height - 1 - y) * stride;
+        const bool hasBottom = y + 1 < height;
+        const uint8_t* bottom = hasBottom ? top - stride : nullptr;
+        uint8_t* yTop = planes[0] + static_cast<ptrdiff_t>(y) * linesizes[0];
+        uint8_t* yBottom = hasBottom ? yTop + linesizes[0] : nullptr;
+        ConvertRowPairScalar(top, bottom, 0, width, yTop, yBottom,
+                             planes[1] + static_cast<ptrdiff_t>(y / 2) * linesizes[1],
+                             planes[2] + static_cast<ptrdiff_t>(y / 2) * linesizes[2]);
+    }
+}
+
+ConvertKernel GetBestKernel() {
+    static const ConvertKernel s_Kernel = [] {
+        // Check the CPU first, the kernel getters themselves are compiled with ISA flags
+        const CpuFeatures& cpu = CpuFeatures::Get();
+        if (cpu.avx2) {
+            return GetKernelAVX2();
+        }
+        return static_cast<ConvertKernel>(nullptr);
+    }();
+    return s_Kernel;
+}
+
+void RunBenchmark() {
+    using Clock = std::chrono::steady_clock;
+    spdlog::info("RGBA -> YUV420P frame conversion benchmark");
+
+    struct Resolution {
+        const char* name;
+        int width;
+        int height;
+        int iterations;
+    };
+    const Resolution resolutions[] = {
+        {"1080p", 1920, 1080, 60},
+        {"4K", 3840, 2160, 20},
+    };
+
+    for (const Resolution& res : resolutions) {
+        const size_t pixelCount = static_cast<size_t>(res.width) * res.height;
+
+        // Smooth gradients with some noise, roughly what a rendered frame looks like to the converter
+        std::vector<uint8_t> rgba(pixelCount * 4);
+        uint32_t seed = 12345u;
+        for (int y = 0; y < res.height; ++y) {
+            for (int x = 0; x < res.width; ++x) {
+                seed = seed * 1664525u + 1013904223u;
+                uint8_t* p = &rgba[(static_cast<size_t>(y) * res.width + x) * 4];
+                p[0] = static_cast<uint8_t>(x * 255 / res.width);
+                p[1] = static_cast<uint8_t>(y * 255 / res.height);
+                p[2] = static_cast<uint8_t>(seed >> 24);
+                p[3] = 255;
+            }
+        }
+
+        const auto allocFrame = [&] {
+            AVFrame* frame = av_frame_alloc();
+            frame->format = AV_PIX_FMT_YUV420P;
+            frame->width = res.width;
+            frame->height = res.height;
+            av_frame_get_buffer(frame, 0);
+            return frame;
+        };
+        AVFrame* reference = allocFrame();
+        AVFrame* target = allocFrame();
+
+        // Source read once plus the three planes written once
+        const size_t bytesTouched = pixelCount * 4 + pixelCount + 2 * (static_cast<size_t>((res.width + 1) / 2) * ((res.height + 1) / 2));
+        spdlog::info("  {} ({}x{}), {:.2f} MB touched per frame:", res.name, res.width, res.height, bytesTouched / (1024.0 * 1024.0));
+
+        const auto report = [&](const char* name, double ms) {
+            const double nsPerPixel = ms * 1e6 / static_cast<double>(pixelCount);
+            const double gbPerSecond = static_cast<double>(bytesTouched) / (ms * 1e6);
+            spdlog::info("    {:<10} {:.3f} ms/frame, {:.3f} ns/pixel, {:.2f} GB/s", name, ms, nsPerPixel, gbPerSecond);
+        };
+        const auto maxDeviation = [&](const AVFrame* a, const AVFrame* b) {
+            int maxDelta = 0;
+            for (int plane = 0; plane < 3; ++plane) {
+                const int planeWidth = plane == 0 ? res.width : (res.width + 1) / 2;
+                const int planeHeight = plane == 0 ? res.height : (res.height + 1) / 2;
+                for (int y = 0; y < planeHeight; ++y) {
+                    const uint8_t* rowA = a->data[plane] + static_cast<ptrdiff_t>(y) * a->linesize[plane];
+                    const uint8_t* rowB = b->data[plane] + static_cast<ptrdiff_t>(y) * b->linesize[plane];
+                    for (int x = 0; x < planeWidth; ++x) {
+                        maxDelta = std::max(maxDelta, std::abs(rowA[x] - rowB[x]));
+                    }
+                }
+            }
+            return maxDelta;
+        };
+
+        // libswscale with the flip as a negative stride, the encoder's fallback path
+        SwsContext* sws = sws_getContext(res.width, res.height, AV_PIX_FMT_RGBA,
+                                         res.width, res.height, AV_PIX_FMT_YUV420P,
+                                         SWS_BILINEAR, nullptr, nullptr, nullptr);
+        const int stride = res.width * 4;
+        const uint8_t* srcData[1] = { rgba.data() + static_cast<size_t>(res.height - 1) * stride };
+        const int srcLinesize[1] = { -stride };
+        auto tStart = Clock::now();
+        for (int i = 0; i < res.iterations; ++i) {
+            sws_scale(sws, srcData, srcLinesize, 0, res.height, target->data, target->linesize);
+        }
+        report("swscale", std::chrono::duration<double, std::milli>(Clock::now() - tStart).count() / res.iterations);
+        sws_freeContext(sws);
+        av_frame_copy(reference, target);
+
+        const std::pair<const char*, ConvertKernel> kernels[] = {
+            {"scalar", &ConvertScalar},
+            {"AVX2", CpuFeatures::Get().avx2 ? GetKernelAVX2() : nullptr},
+        };
+        for (const auto& [name, kernel] : kernels) {
+            if (!kernel) {
+                spdlog::info("    {:<10} not available", name);
+                continue;
+            }
+            tStart = Clock::now();
+            for (int i = 0; i < res.iterations; ++i) {
+                kernel(rgba.data(), res.width, res.height, target->data, target->linesize);
+            }
+            report(name, std::chrono::duration<double, std::milli>(Clock::now() - tStart).count() / res.iterations);
+            spdlog::info("    {:<10} max deviation from swscale: {}", "", maxDeviation(target, reference));
+        }
+
+        av_frame_free(&reference);
+        av_frame_free(&target);
+    }
+}
+
+} // namespace MoleHole::FrameConversion
@@ -0,0 +1,48 @@
+#pragma once
+#include <cstdint>
+
+/**
+ * RGBA readback to YUV420P conversion for the video encoder.
+ *
+ * The kernels read the tightly packed RGBA buffer straight out of the readback PBO, bottom row
+ * first as glReadPixels leaves it, and write the Y, U and V planes of the encoder frame directly:
+ * the vertical flip is folded into the row addressing and no intermediate buffer is touched.
+ * Every pair of output rows is converted in one pass so each 2x2 block is read exactly once for
+ * both its luma and its chroma sample.
+ *
+ * Coefficients are BT.601 limited range in 8-bit fixed point, the matrix libswscale uses for RGB
+ * to YUV by default. Chroma is taken from the rounded 2x2 average. The scalar and SIMD kernels
+ * produce identical output; the SIMD kernel lives in its own translation unit
+ * (FrameConversionAVX2.cpp) compiled with ISA flags.
+ */
+namespace MoleHole::FrameConversion {
+
+/**
+ * @brief Converts a bottom-up RGBA frame into YUV420P planes
+ * @param rgba width * height * 4 bytes, bottom row first
+ * @param planes Y, U, V plane pointers, e.g. AVFrame::data
+ * @param linesizes Y, U, V plane strides in bytes, e.g. AVFrame::linesize
+ */
+using ConvertKernel = void (*)(const uint8_t* rgba, int width, int height, uint8_t* const* planes, const int* linesizes);
+
+void ConvertScalar(const uint8_t* rgba, int width, int height, uint8_t* const* planes, const int* linesizes);
+
+/**
+ * @brief Converts the pixels [beginX, width) of two source rows into two luma rows and one chroma row
+ *
+ * beginX must be even. A null bottom row repeats the top row (last row of an odd-height frame).
+ * Shared by the scalar kernel and the tails of the SIMD kernels.
+ */
+void ConvertRowPairScalar(const uint8_t* top, const uint8_t* bottom, int beginX, int width,
+                          uint8_t* yTop, uint8_t* yBottom, uint8_t* u, uint8_t* v);
+
+// nullptr when the translation unit was built without the ISA flags (non-x86 targets)
+ConvertKernel GetKernelAVX2();
+
+// Fastest SIMD kernel this CPU supports, nullptr when the encoder should fall back to libswscale
+ConvertKernel GetBestKernel();
+
+// Kernel vs scalar vs libswscale at 1080p and 4K: bytes touched per frame, ns/pixel, max deviation
+void RunBenchmark();
+
+} // namespace MoleHole::FrameConversion
@@ -0,0 +1,113 @@
+// Compiled with -mavx2 / /arch:AVX2 (see CMakeLists.txt), only called after a CpuFeatures check
+#include "FrameConversion.h"
+
+#if defined(__AVX2__)
+#include <cstddef>
+#include <immintrin.h>
+
+namespace MoleHole::FrameConversion {
+
+namespace {
+inline __m256i pixelCoefficients(int r, int g, int b) {
+    return _mm256_set1_epi32(static_cast<int>((static_cast<uint32_t>(r) & 0xFF)
+                                              | ((static_cast<uint32_t>(g) & 0xFF) << 8)
+                                              | ((static_cast<uint32_t>(b) & 0xFF) << 16)));
+}
+
+// Weighted R + G + B of 8 RGBA pixels as 32-bit sums, signed coefficients repeated per pixel as {r, g, b, 0}
+inline __m256i weightedSum(__m256i pixels, __m256i coefficients) {
+    return _mm256_madd_epi16(_mm256_maddubs_epi16(pixels, coefficients), _mm256_set1_epi16(1));
+}
+
+// 16 luma bytes from two vectors of 8 pixels
+inline __m128i luma16(__m256i first, __m256i second) {
+    // The green weight 129 does not fit a signed byte: the weights become the unsigned operand and the
+    // pixels are recentred to signed by flipping their top bit, 128 * (66 + 129 + 25) is added back below
+    const __m256i coefficients = pixelCoefficients(66, 129, 25);
+    const __m256i recentre = _mm256_set1_epi8(static_cast<char>(0x80));
+    const __m256i bias = _mm256_set1_epi32(128 * (66 + 129 + 25) + 128);
+    const __m256i ones = _mm256_set1_epi16(1);
+    const __m256i sumA = _mm256_madd_epi16(_mm256_maddubs_epi16(coefficients, _mm256_xor_si256(first, recentre)), ones);
+    const __m256i sumB = _mm256_madd_epi16(_mm256_maddubs_epi16(coefficients, _mm256_xor_si256(second, recentre)), ones);
+    const __m256i offset = _mm256_set1_epi32(16);
+    const __m256i a = _mm256_add_epi32(_mm256_srai_epi32(_mm256_add_epi32(sumA, bias), 8), offset);
+    const __m256i b = _mm256_add_epi32(_mm256_srai_epi32(_mm256_add_epi32(sumB, bias), 8), offset);
+    // packs/packus work per 128-bit lane: the qwords end up as {a0-3 a4-7 ...} in 0 and {b0-3 b4-7 ...} in 2
+    const __m256i words = _mm256_permute4x64_epi64(_mm256_packs_epi32(a, b), _MM_SHUFFLE(3, 1, 2, 0));
+    const __m256i bytes = _mm256_packus_epi16(words, words);
+    return _mm256_castsi256_si128(_mm256_permute4x64_epi64(bytes, _MM_SHUFFLE(3, 1, 2, 0)));
+}
+
+// Rounded 2x2 average of 16 pixels on two rows, returned as 8 pixels
+inline __m256i average2x2(__m256i top0, __m256i top1, __m256i bottom0, __m256i bottom1) {
+    const __m256i vertical0 = _mm256_avg_epu8(top0, bottom0);
+    const __m256i vertical1 = _mm256_avg_epu8(top1, bottom1);
+    // Even pixels hold the average with their right neighbour
+    const __m256i pairs0 = _mm256_avg_epu8(vertical0, _mm256_shuffle_epi32(vertical0, _MM_SHUFFLE(3, 3, 1, 1)));
+    const __m256i pairs1 = _mm256_avg_epu8(vertical1, _mm256_shuffle_epi32(vertical1, _MM_SHUFFLE(3, 3, 1, 1)));
+    const __m256i even0 = _mm256_permutevar8x32_epi32(pairs0, _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6));
+    const __m256i even1 = _mm256_permutevar8x32_epi32(pairs1, _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6));
+    return _mm256_blend_epi32(even0, even1, 0xF0);
+}
+
+void ConvertAVX2(const uint8_t* rgba, int width, int height, uint8_t* const* planes, const int* linesizes) {
+    const __m256i uCoefficients = pixelCoefficients(-38, -74, 112);
+    const __m256i vCoefficients = pixelCoefficients(112, -94, -18);
+    const __m256i chromaBias = _mm256_set1_epi32(128);
+
+    const size_t stride = static_cast<size_t>(width) * 4;
+    const int vectorWidth = width & ~15;
+    for (int y = 0; y < height; y += 2) {
+        // Output row y is source row height - 1 - y; an odd last row is its own bottom neighbour
+        const uint8_t* top = rgba + static_cast<size_t>(height - 1 - y) * stride;
+        const bool hasBottom = y + 1 < height;
+        const uint8_t* bottom = hasBottom ? top - stride : top;
+        uint8_t* yTop = planes[0] + static_cast<ptrdiff_t>(y) * linesizes[0];
+        uint8_t* yBottom = hasBottom ? yTop + linesizes[0] : nullptr;
+        uint8_t* u = planes[1] + static_cast<ptrdiff_t>(y / 2) * linesizes[1];
+        uint8_t* v = planes[2] + static_cast<ptrdiff_t>(y / 2) * linesizes[2];
+
+        for (int x = 0; x < vectorWidth; x += 16) {
+            const __m256i top0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(top + x * 4));
+            const __m256i top1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(top + x * 4 + 32));
+            const __m256i bottom0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bottom + x * 4));
+            const __m256i bottom1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bottom + x * 4 + 32));
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(yTop + x), luma16(top0, top1));
+            if (yBottom) {
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(yBottom + x), luma16(bottom0, bottom1));
+            }
+
+            const __m256i block = average2x2(top0, top1, bottom0, bottom1);
+            const __m256i uSum = _mm256_srai_epi32(_mm256_add_epi32(weightedSum(block, uCoefficients), chromaBias), 8);
+            const __m256i vSum = _mm256_srai_epi32(_mm256_add_epi32(weightedSum(block, vCoefficients), chromaBias), 8);
+            // Words {u0-3 v0-3 | u4-7 v4-7} regrouped to {u0-7 | v0-7}, then +128 and narrowed
+            const __m256i words = _mm256_add_epi16(
+                _mm256_permute4x64_epi64(_mm256_packs_epi32(uSum, vSum), _MM_SHUFFLE(3, 1, 2, 0)),
+                _mm256_set1_epi16(128));
+            const __m256i bytes = _mm256_packus_epi16(words, words);
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(u + x / 2), _mm256_castsi256_si128(bytes));
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(v + x / 2), _mm256_extracti128_si256(bytes, 1));
+        }
+
+        if (vectorWidth < width) {
+            ConvertRowPairScalar(top, hasBottom ? bottom : nullptr, vectorWidth, width, yTop, yBottom, u, v);
+        }
+    }
+}
+}
+
+ConvertKernel GetKernelAVX2() {
+    return &ConvertAVX2;
+}
+
+} // namespace MoleHole::FrameConversion
+#else
+namespace MoleHole::FrameConversion {
+
+ConvertKernel GetKernelAVX2() {
+    return nullptr;
+}
+
+} // namespace MoleHole::FrameConversion
+#endif
@@ -1,6 +1,5 @@
 #include "GravityGridRenderer.h"
 #include "Buffer.h"
-#include "Simulation/Scene.h"
 #include <glad/gl.h>
 #include <glm/gtc/type_ptr.hpp>
 #include <algorithm>
@@ -78,7 +77,7 @@ void GravityGridRenderer::CreatePlane() {
     m_vao->Unbind();
 }
 
-void GravityGridRenderer::Render(const Scene& scene, const Camera& camera, float /*time*/) {
+void GravityGridRenderer::Render(const Scene& /*scene*/, const Camera& camera, float /*time*/) {
     if (!m_shader || m_indexCount == 0) return;
 
     glDisable(GL_DEPTH_TEST);
@@ -91,65 +90,7 @@ void GravityGridRenderer::Render(const Scene& scene, const Camera& camera, float
     m_shader->SetMat4("uVP", vp);
     m_shader->SetFloat("u_planeY", m_planeY);
 
-    int numBH = 0;
-    constexpr int MAX_BLACKHOLES = 8;
-    for (const auto& obj : scene.objects) {
-        if (numBH >= MAX_BLACKHOLES) break;
-        if (obj.HasClass("BlackHole")) {
-            ParameterHandle posHandle("Entity.Position");
-            ParameterHandle massHandle("Physics.Mass");
-
-            auto pos = obj.GetParameter(posHandle);
-            auto mass = obj.GetParameter(massHandle);
-
-            if (std::holds_alternative<glm::vec3>(pos) && std::holds_alternative<float>(mass)) {
-                m_shader->SetVec3("u_blackHolePositions[" + std::to_string(numBH) + "]", std::get<glm::vec3>(pos));
-                m_shader->SetFloat("u_blackHoleMasses[" + std::to_string(numBH) + "]", std::get<float>(mass));
-                numBH++;
-            }
-        }
-    }
-    m_shader->SetInt("u_numBlackHoles", numBH);
-
-    int numSpheres = 0;
-    constexpr int MAX_SPHERES = 128;
-    for (const auto& obj : scene.objects) {
-        if (numSpheres >= MAX_SPHERES) break;
-        if (obj.HasClass("Sphere")) {
-            ParameterHandle posHandle("Entity.Position");
-            ParameterHandle massHandle("Physics.Mass");
-
-            auto pos = obj.GetParameter(posHandle);
-            auto mass = obj.GetParameter(massHandle);
-
-            if (std::holds_alternative<glm::vec3>(pos) && std::holds_alternative<float>(mass)) {
-                m_shader->SetVec3("u_spherePositions[" + std::to_string(numSpheres) + "]", std::get<glm::vec3>(pos));
-                m_shader->SetFloat("u_sphereMasses[" + std::to_string(numSpheres) + "]", std::get<float>(mass));
-                numSpheres++;
-            }
-        }
-    }
-    m_shader->SetInt("u_numSpheres", numSpheres);
-
-    int numMeshes = 0;
-    constexpr int MAX_MESHES = 128;
-    for (const auto& obj : scene.objects) {
-        if (numMeshes >= MAX_MESHES) break;
-        if (obj.HasClass("Mesh")) {
-            ParameterHandle posHandle("Entity.Position");
-            ParameterHandle massHandle("Physics.Mass");
-
-            auto pos = obj.GetParameter(posHandle);
-            auto mass = obj.GetParameter(massHandle);
-
-            if (std::holds_alternative<glm::vec3>(pos) && std::holds_alternative<float>(mass)) {
-                m_shader->SetVec3("u_meshPositions[" + std::to_string(numMeshes) + "]", std::get<glm::vec3>(pos));
-                m_shader->SetFloat("u_meshMasses[" + std::to_string(numMeshes) + "]", std::get<float>(mass));
-                numMeshes++;
-            }
-        }
-    }
-    m_shader->SetInt("u_numMeshes", numMeshes);
+    // Bodies displacing the grid come from the SceneBodyBuffer bound by the Renderer
 
     m_shader->SetFloat("u_cellSize", m_cellSize);
     m_shader->SetFloat("u_lineThickness", m_lineThickness);
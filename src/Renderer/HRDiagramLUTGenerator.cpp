@@ -1,4 +1,5 @@
 #include "HRDiagramLUTGenerator.h"
+#include "LUTCache.h"
 #include <cmath>
 #include <algorithm>
 
@@ -100,5 +101,13 @@ std::vector<float> HRDiagramLUTGenerator::generateLUT() {
     return lutData;
 }
 
+uint64_t HRDiagramLUTGenerator::cacheKey() {
+    return LUTCacheKey("HRDiagramLUT", GENERATOR_VERSION)
+        .Add(MASS_MIN).Add(MASS_MAX).Add(LUT_SIZE)
+        .Add(TEMP_O_CLASS).Add(TEMP_B_CLASS).Add(TEMP_A_CLASS).Add(TEMP_F_CLASS)
+        .Add(TEMP_G_CLASS).Add(TEMP_K_CLASS).Add(TEMP_M_CLASS)
+        .Value();
+}
+
 } // namespace MoleHole
 
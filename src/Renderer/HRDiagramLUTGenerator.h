@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <vector>
 #include <cmath>
 #include <algorithm>
@@ -32,6 +33,12 @@ public:
     // Generate the LUT data (returns temperature, luminosity, radius)
     // Format: [temp0, lum0, rad0, temp1, lum1, rad1, ...]
     static std::vector<float> generateLUT();
+
+    // Bump whenever generateLUT() changes its output for the same constants
+    static constexpr uint32_t GENERATOR_VERSION = 1;
+
+    // LUT cache key over the version and every constant above
+    static uint64_t cacheKey();
     
 private:
     // Calculate stellar properties from mass using main sequence relationships
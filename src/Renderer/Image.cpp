@@ -51,13 +51,10 @@ inline uint64_t FileMTimeNs(const std::filesystem::path& p) {
 }
 }
 
-Image* Image::LoadHDR(const std::string& filepath) {
+bool Image::LoadHDRPixels(const std::string& filepath, HDRPixels& pixels) {
     PROFILE_FUNCTION();
     stbi_set_flip_vertically_on_load(true);
 
-    int width, height, nrComponents;
-    float* data = nullptr;
-    std::vector<float> cacheBuffer;
     std::filesystem::path srcPath(filepath);
     std::filesystem::path cachePath = srcPath;
     cachePath += ".mhdr";
@@ -71,13 +68,12 @@ Image* Image::LoadHDR(const std::string& filepath) {
                 uint64_t curSize = FileSize(srcPath);
                 uint64_t curMTime = FileMTimeNs(srcPath);
                 if (hdr.srcSize == curSize && hdr.srcMTimeNs == curMTime) {
-                    width = static_cast<int>(hdr.width);
-                    height = static_cast<int>(hdr.height);
-                    nrComponents = static_cast<int>(hdr.components);
-                    size_t count = static_cast<size_t>(width) * static_cast<size_t>(height) * static_cast<size_t>(nrComponents);
-                    cacheBuffer.resize(count);
-                    if (in.read(reinterpret_cast<char*>(cacheBuffer.data()), count * sizeof(float))) {
-                        data = cacheBuffer.data();
+                    pixels.width = static_cast<int>(hdr.width);
+                    pixels.height = static_cast<int>(hdr.height);
+                    pixels.components = static_cast<int>(hdr.components);
+                    size_t count = static_cast<size_t>(pixels.width) * static_cast<size_t>(pixels.height) * static_cast<size_t>(pixels.components);
+                    pixels.data.resize(count);
+                    if (in.read(reinterpret_cast<char*>(pixels.data.data()), count * sizeof(float))) {
                         loadedFromCache = true;
                     }
                 }
@@ -86,43 +82,20 @@ Image* Image::LoadHDR(const std::string& filepath) {
     }
 
     if (!loadedFromCache) {
-        data = stbi_loadf(filepath.c_str(), &width, &height, &nrComponents, 0);
-    }
-
-    if (!data) {
-        spdlog::error("Failed to load HDR texture: {}", filepath);
-        return nullptr;
-    }
-
-    unsigned int textureID;
-    glGenTextures(1, &textureID);
-    glBindTexture(GL_TEXTURE_2D, textureID);
+        int width, height, nrComponents;
+        float* data = stbi_loadf(filepath.c_str(), &width, &height, &nrComponents, 0);
+        if (!data) {
+            spdlog::error("Failed to load HDR texture: {}", filepath);
+            return false;
+        }
 
-    GLenum format;
-    if (nrComponents == 1)
-        format = GL_RED;
-    else if (nrComponents == 3)
-        format = GL_RGB;
-    else if (nrComponents == 4)
-        format = GL_RGBA;
-    else {
-        spdlog::error("Unsupported HDR format with {} components", nrComponents);
+        pixels.width = width;
+        pixels.height = height;
+        pixels.components = nrComponents;
+        size_t count = static_cast<size_t>(width) * static_cast<size_t>(height) * static_cast<size_t>(nrComponents);
+        pixels.data.assign(data, data + count);
         stbi_image_free(data);
-        glDeleteTextures(1, &textureID);
-        return nullptr;
-    }
-
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB16F, width, height, 0, format, GL_FLOAT, data);
-
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
-    if (!loadedFromCache) {
-        std::error_code ec;
-        uint64_t srcSize = FileSize(srcPath);
-        uint64_t srcMTime = FileMTimeNs(srcPath);
         HDRCacheHeader hdr{};
         std::memset(&hdr, 0, sizeof(hdr));
         std::memcpy(hdr.magic, "MHDR\0\0", 6);
@@ -130,27 +103,56 @@ Image* Image::LoadHDR(const std::string& filepath) {
         hdr.width = static_cast<uint32_t>(width);
         hdr.height = static_cast<uint32_t>(height);
         hdr.components = static_cast<uint32_t>(nrComponents);
-        hdr.srcSize = srcSize;
-        hdr.srcMTimeNs = srcMTime;
+        hdr.srcSize = FileSize(srcPath);
+        hdr.srcMTimeNs = FileMTimeNs(srcPath);
 
         std::ofstream out(cachePath, std::ios::binary | std::ios::trunc);
         if (out) {
             out.write(reinterpret_cast<const char*>(&hdr), sizeof(hdr));
-            size_t count = static_cast<size_t>(width) * static_cast<size_t>(height) * static_cast<size_t>(nrComponents);
-            out.write(reinterpret_cast<const char*>(data), count * sizeof(float));
+            out.write(reinterpret_cast<const char*>(pixels.data.data()), count * sizeof(float));
         }
     }
 
-    if (!loadedFromCache) {
-        stbi_image_free(data);
-    }
-    glBindTexture(GL_TEXTURE_2D, 0);
-
     if (loadedFromCache) {
-        spdlog::info("Loaded HDR texture from cache: {} ({}x{})", filepath, width, height);
+        spdlog::info("Loaded HDR texture from cache: {} ({}x{})", filepath, pixels.width, pixels.height);
     } else {
-        spdlog::info("Successfully loaded HDR texture: {} ({}x{})", filepath, width, height);
+        spdlog::info("Successfully loaded HDR texture: {} ({}x{})", filepath, pixels.width, pixels.height);
+    }
+    return true;
+}
+
+Image* Image::LoadHDR(const std::string& filepath) {
+    PROFILE_FUNCTION();
+
+    HDRPixels pixels;
+    if (!LoadHDRPixels(filepath, pixels)) {
+        return nullptr;
+    }
+
+    GLenum format;
+    if (pixels.components == 1)
+        format = GL_RED;
+    else if (pixels.components == 3)
+        format = GL_RGB;
+    else if (pixels.components == 4)
+        format = GL_RGBA;
+    else {
+        spdlog::error("Unsupported HDR format with {} components", pixels.components);
+        return nullptr;
     }
 
-    return new Image(textureID, width, height);
+    unsigned int textureID;
+    glGenTextures(1, &textureID);
+    glBindTexture(GL_TEXTURE_2D, textureID);
+
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB16F, pixels.width, pixels.height, 0, format, GL_FLOAT, pixels.data.data());
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    return new Image(textureID, pixels.width, pixels.height);
 }
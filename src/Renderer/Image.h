@@ -1,5 +1,6 @@
 #pragma once
 #include <string>
+#include <vector>
 
 class Image {
 public:
@@ -9,7 +10,17 @@ public:
     Image(int width, int height);
     ~Image();
 
+    // Decoded HDR texels, bottom row first like the uploaded texture
+    struct HDRPixels {
+        int width = 0;
+        int height = 0;
+        int components = 0;
+        std::vector<float> data;
+    };
+
     static Image* LoadHDR(const std::string& filepath);
+    // Decodes the file (or reads its .mhdr cache) without touching OpenGL
+    static bool LoadHDRPixels(const std::string& filepath, HDRPixels& pixels);
 
 private:
     Image(unsigned int textureID, int width, int height);
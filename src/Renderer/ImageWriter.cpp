@@ -0,0 +1,502 @@
+#include "ImageWriter.h"
+#include "Application/ThreadPool.h"
+#include <glm/gtc/packing.hpp>
+#include <algorithm>
+#include <bit>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+#include <zlib.h>
+
+namespace {
+    static_assert(std::endian::native == std::endian::little, "EXR and readback data are written as little endian");
+
+    void writeBigEndian(std::vector<uint8_t>& out, uint32_t value) {
+        out.push_back(static_cast<uint8_t>(value >> 24));
+        out.push_back(static_cast<uint8_t>(value >> 16));
+        out.push_back(static_cast<uint8_t>(value >> 8));
+        out.push_back(static_cast<uint8_t>(value));
+    }
+
+    template<typename T>
+    void writeLittleEndian(std::vector<uint8_t>& out, T value) {
+        const auto* bytes = reinterpret_cast<const uint8_t*>(&value);
+        out.insert(out.end(), bytes, bytes + sizeof(T));
+    }
+
+    uint8_t paeth(int a, int b, int c) {
+        const int p = a + b - c;
+        const int pa = std::abs(p - a);
+        const int pb = std::abs(p - b);
+        const int pc = std::abs(p - c);
+        if (pa <= pb && pa <= pc) return static_cast<uint8_t>(a);
+        if (pb <= pc) return static_cast<uint8_t>(b);
+        return static_cast<uint8_t>(c);
+    }
+
+    uint8_t pngPredictor(int filter, int left, int up, int upLeft) {
+        switch (filter) {
+            case 1: return static_cast<uint8_t>(left);
+            case 2: return static_cast<uint8_t>(up);
+            case 3: return static_cast<uint8_t>((left + up) / 2);
+            case 4: return paeth(left, up, upLeft);
+            default: return 0;
+        }
+    }
+
+    // Writes the filter byte and the filtered row to out, using the filter with the smallest sum of
+    // absolute residuals (the usual PNG heuristic)
+    void filterPngRow(const uint8_t* row, const uint8_t* up, size_t rowBytes, size_t bpp, uint8_t* out) {
+        int best = 0;
+        uint64_t bestScore = UINT64_MAX;
+        for (int filter = 0; filter < 5; ++filter) {
+            uint64_t score = 0;
+            for (size_t i = 0; i < rowBytes; ++i) {
+                const int left = i >= bpp ? row[i - bpp] : 0;
+                const int upLeft = i >= bpp ? up[i - bpp] : 0;
+                const auto residual = static_cast<uint8_t>(row[i] - pngPredictor(filter, left, up[i], upLeft));
+                score += residual < 128 ? residual : 256 - residual;
+            }
+            if (score < bestScore) {
+                bestScore = score;
+                best = filter;
+            }
+        }
+
+        out[0] = static_cast<uint8_t>(best);
+        for (size_t i = 0; i < rowBytes; ++i) {
+            const int left = i >= bpp ? row[i - bpp] : 0;
+            const int upLeft = i >= bpp ? up[i - bpp] : 0;
+            out[i + 1] = static_cast<uint8_t>(row[i] - pngPredictor(best, left, up[i], upLeft));
+        }
+    }
+
+    // Writes to path + ".tmp" and renames it into place on Close(), so a failed or cancelled export
+    // never truncates an existing file at path or leaves a partial image under its name
+    class FileSink {
+    public:
+        explicit FileSink(const std::string& path)
+            : m_Path(path), m_TemporaryPath(path + ".tmp"), m_File(m_TemporaryPath, std::ios::binary | std::ios::trunc) {
+            if (!m_File) {
+                throw std::runtime_error("Could not create " + m_TemporaryPath);
+            }
+        }
+
+        FileSink(const FileSink&) = delete;
+        FileSink& operator=(const FileSink&) = delete;
+
+        ~FileSink() {
+            if (!m_Closed) {
+                m_File.close();
+                std::error_code error;
+                std::filesystem::remove(m_TemporaryPath, error);
+            }
+        }
+
+        void Write(const void* data, size_t size) {
+            m_File.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+            if (!m_File) {
+                throw std::runtime_error("Failed writing " + m_TemporaryPath);
+            }
+        }
+
+        uint64_t Position() { return static_cast<uint64_t>(m_File.tellp()); }
+
+        void Seek(uint64_t position) { m_File.seekp(static_cast<std::streamoff>(position)); }
+
+        void Close() {
+            m_File.close();
+            if (!m_File) {
+                throw std::runtime_error("Failed writing " + m_TemporaryPath);
+            }
+            std::error_code error;
+            std::filesystem::rename(m_TemporaryPath, m_Path, error);
+            if (error) {
+                throw std::runtime_error("Could not move " + m_TemporaryPath + " to " + m_Path + ": " + error.message());
+            }
+            m_Closed = true;
+        }
+
+    private:
+        std::string m_Path;
+        std::string m_TemporaryPath;
+        std::ofstream m_File;
+        bool m_Closed = false;
+    };
+
+    /**
+     * PNG, 8-bit RGB or 16-bit linear RGB. The zlib stream spans all IDAT chunks but is deflated
+     * in independent segments: each ends on a byte boundary (Z_SYNC_FLUSH) and is primed with the
+     * 32 KB of filtered data before it as dictionary, so the segments compress in parallel and
+     * concatenate into one valid stream at almost no cost in ratio.
+     */
+    class PngStripWriter final : public StripImageWriter {
+    public:
+        PngStripWriter(const std::string& path, int width, int height, PixelFormat format)
+            : m_File(path), m_Format(format), m_Height(height),
+              m_BytesPerPixel(format == PixelFormat::RGB8 ? 3 : 6),
+              m_RowBytes(static_cast<size_t>(width) * m_BytesPerPixel) {
+            static constexpr uint8_t SIGNATURE[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+            m_File.Write(SIGNATURE, sizeof(SIGNATURE));
+
+            std::vector<uint8_t> header;
+            writeBigEndian(header, static_cast<uint32_t>(width));
+            writeBigEndian(header, static_cast<uint32_t>(height));
+            const uint8_t bitDepth = format == PixelFormat::RGB8 ? 8 : 16;
+            header.insert(header.end(), {bitDepth, 2, 0, 0, 0});  // RGB, deflate, adaptive filtering, no interlace
+            WriteChunk("IHDR", header.data(), header.size());
+
+            if (format == PixelFormat::RGB16F) {
+                // Samples are linear, not sRGB
+                std::vector<uint8_t> gamma;
+                writeBigEndian(gamma, 100000);
+                WriteChunk("gAMA", gamma.data(), gamma.size());
+            }
+
+            // zlib header: deflate, 32 KB window, default level
+            static constexpr uint8_t ZLIB_HEADER[2] = {0x78, 0x9C};
+            WriteChunk("IDAT", ZLIB_HEADER, sizeof(ZLIB_HEADER));
+
+            m_PreviousRow.assign(m_RowBytes, 0);
+            m_Adler = adler32(0, nullptr, 0);
+        }
+
+        void WriteRows(const void* pixels, int rowCount) override {
+            if (m_RowsWritten + rowCount > m_Height) {
+                throw std::runtime_error("More rows than the image height");
+            }
+            if (rowCount <= 0) return;
+
+            ThreadPool& pool = ThreadPool::Global();
+            const auto rows = static_cast<size_t>(rowCount);
+
+            const uint8_t* samples = static_cast<const uint8_t*>(pixels);
+            if (m_Format == PixelFormat::RGB16F) {
+                // Half floats to big-endian 16-bit, clamped to [0, 1]
+                m_Samples.resize(rows * m_RowBytes);
+                const auto* halves = static_cast<const uint16_t*>(pixels);
+                pool.ParallelFor(0, rows, 16, [&](size_t begin, size_t end) {
+                    for (size_t i = begin * m_RowBytes / 2; i < end * m_RowBytes / 2; ++i) {
+                        const float value = std::clamp(glm::unpackHalf1x16(halves[i]), 0.0f, 1.0f);
+                        const auto sample = static_cast<uint16_t>(value * 65535.0f + 0.5f);
+                        m_Samples[i * 2 + 0] = static_cast<uint8_t>(sample >> 8);
+                        m_Samples[i * 2 + 1] = static_cast<uint8_t>(sample);
+                    }
+                });
+                samples = m_Samples.data();
+            }
+
+            const size_t filteredRowBytes = m_RowBytes + 1;
+            m_Filtered.resize(rows * filteredRowBytes);
+            pool.ParallelFor(0, rows, 16, [&](size_t begin, size_t end) {
+                for (size_t row = begin; row < end; ++row) {
+                    const uint8_t* up = row == 0 ? m_PreviousRow.data() : samples + (row - 1) * m_RowBytes;
+                    filterPngRow(samples + row * m_RowBytes, up, m_RowBytes, m_BytesPerPixel,
+                                 m_Filtered.data() + row * filteredRowBytes);
+                }
+            });
+
+            const size_t segmentRows = std::max<size_t>(1, SEGMENT_SIZE / filteredRowBytes);
+            const size_t segmentCount = (rows + segmentRows - 1) / segmentRows;
+            std::vector<std::vector<uint8_t>> compressed(segmentCount);
+            std::vector<uLong> checksums(segmentCount);
+            pool.ParallelFor(0, segmentCount, 1, [&](size_t begin, size_t end) {
+                for (size_t segment = begin; segment < end; ++segment) {
+                    const size_t offset = segment * segmentRows * filteredRowBytes;
+                    const size_t size = std::min(segmentRows, rows - segment * segmentRows) * filteredRowBytes;
+                    compressed[segment] = DeflateSegment(offset, size);
+                    checksums[segment] = adler32(adler32(0, nullptr, 0), m_Filtered.data() + offset, static_cast<uInt>(size));
+                }
+            });
+
+            for (size_t segment = 0; segment < segmentCount; ++segment) {
+                const size_t size = std::min(segmentRows, rows - segment * segmentRows) * filteredRowBytes;
+                m_Adler = adler32_combine(m_Adler, checksums[segment], static_cast<z_off_t>(size));
+                WriteChunk("IDAT", compressed[segment].data(), compressed[segment].size());
+            }
+
+            std::copy_n(samples + (rows - 1) * m_RowBytes, m_RowBytes, m_PreviousRow.begin());
+            m_Window.insert(m_Window.end(), m_Filtered.end() - static_cast<ptrdiff_t>(std::min(m_Filtered.size(), WINDOW_SIZE)),
+                            m_Filtered.end());
+            if (m_Window.size() > WINDOW_SIZE) {
+                m_Window.erase(m_Window.begin(), m_Window.end() - static_cast<ptrdiff_t>(WINDOW_SIZE));
+            }
+            m_RowsWritten += rowCount;
+        }
+
+        void Finish() override {
+            if (m_RowsWritten != m_Height) {
+                throw std::runtime_error("Image incomplete: " + std::to_string(m_RowsWritten) + " of " +
+                                         std::to_string(m_Height) + " rows written");
+            }
+
+            // Empty final fixed-Huffman block, then the checksum of the whole stream
+            std::vector<uint8_t> end = {0x03, 0x00};
+            writeBigEndian(end, static_cast<uint32_t>(m_Adler));
+            WriteChunk("IDAT", end.data(), end.size());
+
+            WriteChunk("IEND", nullptr, 0);
+            m_File.Close();
+        }
+
+    private:
+        static constexpr size_t SEGMENT_SIZE = 256 * 1024;
+        static constexpr size_t WINDOW_SIZE = 32 * 1024;
+
+        // Raw deflate of m_Filtered[offset, offset + size), continuing from the data before it
+        std::vector<uint8_t> DeflateSegment(size_t offset, size_t size) const {
+            z_stream stream{};
+            if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+                throw std::runtime_error("Could not initialize zlib");
+            }
+
+            std::vector<uint8_t> dictionary;
+            if (offset < WINDOW_SIZE) {
+                dictionary.assign(m_Window.end() - static_cast<ptrdiff_t>(std::min(m_Window.size(), WINDOW_SIZE - offset)),
+                                  m_Window.end());
+            }
+            const size_t fromStrip = std::min(offset, WINDOW_SIZE);
+            dictionary.insert(dictionary.end(), m_Filtered.begin() + static_cast<ptrdiff_t>(offset - fromStrip),
+                              m_Filtered.begin() + static_cast<ptrdiff_t>(offset));
+            if (!dictionary.empty()) {
+                deflateSetDictionary(&stream, dictionary.data(), static_cast<uInt>(dictionary.size()));
+            }
+
+            // Bound plus room for the sync flush marker
+            std::vector<uint8_t> out(deflateBound(&stream, static_cast<uLong>(size)) + 16);
+            stream.next_in = const_cast<Bytef*>(m_Filtered.data() + offset);
+            stream.avail_in = static_cast<uInt>(size);
+            stream.next_out = out.data();
+            stream.avail_out = static_cast<uInt>(out.size());
+            const int result = deflate(&stream, Z_SYNC_FLUSH);
+            const bool complete = stream.avail_in == 0 && stream.avail_out > 0;
+            out.resize(out.size() - stream.avail_out);
+            deflateEnd(&stream);
+
+            if (result == Z_STREAM_ERROR || !complete) {
+                throw std::runtime_error("zlib deflate failed");
+            }
+            return out;
+        }
+
+        void WriteChunk(const char (&type)[5], const uint8_t* data, size_t size) {
+            std::vector<uint8_t> header;
+            writeBigEndian(header, static_cast<uint32_t>(size));
+            header.insert(header.end(), type, type + 4);
+
+            uLong crc = crc32(0, reinterpret_cast<const Bytef*>(type), 4);
+            if (size > 0) {
+                crc = crc32(crc, data, static_cast<uInt>(size));
+            }
+            std::vector<uint8_t> footer;
+            writeBigEndian(footer, static_cast<uint32_t>(crc));
+
+            m_File.Write(header.data(), header.size());
+            m_File.Write(data, size);
+            m_File.Write(footer.data(), footer.size());
+        }
+
+        FileSink m_File;
+        PixelFormat m_Format;
+        int m_Height;
+        size_t m_BytesPerPixel;
+        size_t m_RowBytes;
+        int m_RowsWritten = 0;
+
+        uLong m_Adler = 0;
+        std::vector<uint8_t> m_PreviousRow;  // Unfiltered samples of the last row written
+        std::vector<uint8_t> m_Window;       // Last 32 KB of filtered data, the dictionary of the next strip
+        std::vector<uint8_t> m_Samples;
+        std::vector<uint8_t> m_Filtered;
+    };
+
+    /**
+     * Scanline OpenEXR with half-float R, G, B channels and ZIP compression: blocks of 16 scanlines,
+     * each deflated on its own, so they compress in parallel. The offset table ahead of the blocks is
+     * reserved up front and filled in by Finish().
+     */
+    class ExrStripWriter final : public StripImageWriter {
+    public:
+        ExrStripWriter(const std::string& path, int width, int height)
+            : m_File(path), m_Width(width), m_Height(height), m_RowBytes(static_cast<size_t>(width) * 6),
+              m_Offsets((height + BLOCK_ROWS - 1) / BLOCK_ROWS) {
+            std::vector<uint8_t> header;
+            writeLittleEndian<uint32_t>(header, 20000630);  // Magic
+            writeLittleEndian<uint32_t>(header, 2);         // Version 2, single-part scanline
+
+            std::vector<uint8_t> channels;
+            for (const char* name : {"B", "G", "R"}) {  // Channels are stored in alphabetical order
+                channels.insert(channels.end(), name, name + 2);
+                writeLittleEndian<int32_t>(channels, 1);  // HALF
+                writeLittleEndian<uint32_t>(channels, 0);  // pLinear and reserved
+                writeLittleEndian<int32_t>(channels, 1);  // x sampling
+                writeLittleEndian<int32_t>(channels, 1);  // y sampling
+            }
+            channels.push_back(0);
+            WriteAttribute(header, "channels", "chlist", channels);
+
+            WriteAttribute(header, "compression", "compression", {3});  // ZIP_COMPRESSION
+
+            std::vector<uint8_t> window;
+            for (int32_t value : {0, 0, width - 1, height - 1}) {
+                writeLittleEndian(window, value);
+            }
+            WriteAttribute(header, "dataWindow", "box2i", window);
+            WriteAttribute(header, "displayWindow", "box2i", window);
+
+            WriteAttribute(header, "lineOrder", "lineOrder", {0});  // INCREASING_Y
+
+            std::vector<uint8_t> value;
+            writeLittleEndian(value, 1.0f);
+            WriteAttribute(header, "pixelAspectRatio", "float", value);
+            value.clear();
+            writeLittleEndian(value, 0.0f);
+            writeLittleEndian(value, 0.0f);
+            WriteAttribute(header, "screenWindowCenter", "v2f", value);
+            value.clear();
+            writeLittleEndian(value, 1.0f);
+            WriteAttribute(header, "screenWindowWidth", "float", value);
+            header.push_back(0);
+
+            m_File.Write(header.data(), header.size());
+            m_OffsetTablePosition = m_File.Position();
+            const std::vector<uint8_t> placeholder(m_Offsets.size() * sizeof(uint64_t), 0);
+            m_File.Write(placeholder.data(), placeholder.size());
+        }
+
+        void WriteRows(const void* pixels, int rowCount) override {
+            if (m_RowsWritten + m_PendingRows + rowCount > m_Height) {
+                throw std::runtime_error("More rows than the image height");
+            }
+            const auto* bytes = static_cast<const uint8_t*>(pixels);
+            m_Pending.insert(m_Pending.end(), bytes, bytes + static_cast<size_t>(rowCount) * m_RowBytes);
+            m_PendingRows += rowCount;
+
+            WriteBlocks(m_PendingRows / BLOCK_ROWS * BLOCK_ROWS);
+        }
+
+        void Finish() override {
+            WriteBlocks(m_PendingRows);
+            if (m_RowsWritten != m_Height) {
+                throw std::runtime_error("Image incomplete: " + std::to_string(m_RowsWritten) + " of " +
+                                         std::to_string(m_Height) + " rows written");
+            }
+
+            m_File.Seek(m_OffsetTablePosition);
+            m_File.Write(m_Offsets.data(), m_Offsets.size() * sizeof(uint64_t));
+            m_File.Close();
+        }
+
+    private:
+        static constexpr int BLOCK_ROWS = 16;  // Scanlines per ZIP_COMPRESSION block
+
+        static void WriteAttribute(std::vector<uint8_t>& out, const char* name, const char* type, const std::vector<uint8_t>& value) {
+            out.insert(out.end(), name, name + std::strlen(name) + 1);
+            out.insert(out.end(), type, type + std::strlen(type) + 1);
+            writeLittleEndian<int32_t>(out, static_cast<int32_t>(value.size()));
+            out.insert(out.end(), value.begin(), value.end());
+        }
+
+        // Compresses and writes the first rowCount pending rows, a whole number of blocks unless it is the last one
+        void WriteBlocks(int rowCount) {
+            if (rowCount <= 0) return;
+
+            const size_t blockCount = (rowCount + BLOCK_ROWS - 1) / BLOCK_ROWS;
+            std::vector<std::vector<uint8_t>> blocks(blockCount);
+            ThreadPool::Global().ParallelFor(0, blockCount, 1, [&](size_t begin, size_t end) {
+                for (size_t block = begin; block < end; ++block) {
+                    const int rows = std::min(BLOCK_ROWS, rowCount - static_cast<int>(block) * BLOCK_ROWS);
+                    blocks[block] = CompressBlock(m_Pending.data() + block * BLOCK_ROWS * m_RowBytes, rows);
+                }
+            });
+
+            for (size_t block = 0; block < blockCount; ++block) {
+                const int y = m_RowsWritten + static_cast<int>(block) * BLOCK_ROWS;
+                m_Offsets[y / BLOCK_ROWS] = m_File.Position();
+
+                std::vector<uint8_t> header;
+                writeLittleEndian<int32_t>(header, y);
+                writeLittleEndian<int32_t>(header, static_cast<int32_t>(blocks[block].size()));
+                m_File.Write(header.data(), header.size());
+                m_File.Write(blocks[block].data(), blocks[block].size());
+            }
+
+            m_Pending.erase(m_Pending.begin(), m_Pending.begin() + static_cast<ptrdiff_t>(rowCount * m_RowBytes));
+            m_PendingRows -= rowCount;
+            m_RowsWritten += rowCount;
+        }
+
+        std::vector<uint8_t> CompressBlock(const uint8_t* rgb, int rows) const {
+            // Each scanline holds all of its B samples, then G, then R
+            const size_t size = static_cast<size_t>(rows) * m_RowBytes;
+            std::vector<uint8_t> planar(size);
+            auto* out = reinterpret_cast<uint16_t*>(planar.data());
+            for (int row = 0; row < rows; ++row) {
+                const auto* in = reinterpret_cast<const uint16_t*>(rgb + row * m_RowBytes);
+                for (int channel = 0; channel < 3; ++channel) {
+                    for (int x = 0; x < m_Width; ++x) {
+                        *out++ = in[x * 3 + (2 - channel)];
+                    }
+                }
+            }
+
+            // ZIP predictor: low bytes first, then high bytes, delta coded
+            std::vector<uint8_t> predicted(size);
+            const size_t half = (size + 1) / 2;
+            for (size_t i = 0; i < size; ++i) {
+                predicted[(i % 2 == 0 ? 0 : half) + i / 2] = planar[i];
+            }
+            for (size_t i = size - 1; i > 0; --i) {
+                predicted[i] = static_cast<uint8_t>(predicted[i] - predicted[i - 1] + 128);
+            }
+
+            uLongf compressedSize = compressBound(static_cast<uLong>(size));
+            std::vector<uint8_t> compressed(compressedSize);
+            if (compress2(compressed.data(), &compressedSize, predicted.data(), static_cast<uLong>(size), Z_DEFAULT_COMPRESSION) != Z_OK) {
+                throw std::runtime_error("zlib compression failed");
+            }
+
+            // Blocks that do not shrink are stored raw, which readers recognize by the size
+            if (compressedSize >= size) {
+                return planar;
+            }
+            compressed.resize(compressedSize);
+            return compressed;
+        }
+
+        FileSink m_File;
+        int m_Width;
+        int m_Height;
+        size_t m_RowBytes;
+        int m_RowsWritten = 0;
+
+        std::vector<uint8_t> m_Pending;  // Rows not yet making up a whole block
+        int m_PendingRows = 0;
+        std::vector<uint64_t> m_Offsets;
+        uint64_t m_OffsetTablePosition = 0;
+    };
+}
+
+std::unique_ptr<StripImageWriter> StripImageWriter::Open(const std::string& path, int width, int height, PixelFormat format) {
+    if (width <= 0 || height <= 0) {
+        throw std::runtime_error("Invalid image size");
+    }
+
+    std::string extension = std::filesystem::path(path).extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+    if (extension == ".png") {
+        return std::make_unique<PngStripWriter>(path, width, height, format);
+    }
+    if (extension == ".exr") {
+        if (format != PixelFormat::RGB16F) {
+            throw std::runtime_error("EXR output needs half-float pixels");
+        }
+        return std::make_unique<ExrStripWriter>(path, width, height);
+    }
+    throw std::runtime_error("Unsupported image format '" + extension + "', expected .png or .exr");
+}
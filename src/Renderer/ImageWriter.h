@@ -0,0 +1,37 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+/**
+ * @brief Writes an image a strip of rows at a time, top row first
+ *
+ * Exports stream their output through this, so an image never has to exist in memory as a whole:
+ * a tiled export hands over one row of tiles at a time and only ever holds that strip. Open()
+ * picks the file format from the extension. Each strip is compressed in parallel on the global
+ * ThreadPool, in independent blocks of scanlines.
+ */
+class StripImageWriter {
+public:
+    enum class PixelFormat {
+        RGB8,    // Display-referred 8-bit RGB: 8-bit PNG
+        RGB16F,  // Linear half-float RGB as read back with GL_HALF_FLOAT: OpenEXR or 16-bit linear PNG
+    };
+
+    virtual ~StripImageWriter() = default;
+
+    // Throws std::runtime_error for unsupported extensions or when the file cannot be created
+    static std::unique_ptr<StripImageWriter> Open(const std::string& path, int width, int height,
+                                                  PixelFormat format = PixelFormat::RGB8);
+
+    static size_t BytesPerPixel(PixelFormat format) { return format == PixelFormat::RGB8 ? 3 : 6; }
+
+    // rowCount rows of tightly packed pixels in the format the writer was opened with
+    virtual void WriteRows(const void* pixels, int rowCount) = 0;
+
+    // Completes the file and moves it into place; until then the output is written next to it as
+    // path + ".tmp", which destroying an unfinished writer removes. Throws std::runtime_error
+    // unless every row was written
+    virtual void Finish() = 0;
+};
@@ -0,0 +1,61 @@
+#pragma once
+#include <cstddef>
+
+#include "MathTools/AdaptiveIntegrator.h"
+
+/**
+ * Shared pieces of the scalar and SIMD-batched equatorial geodesic integration.
+ *
+ * The batched kernels live in their own translation units (KerrGeodesicBatchAVX2.cpp,
+ * KerrGeodesicBatchAVX512.cpp) compiled with ISA flags; everything they share with scalar
+ * code is declared here and defined out of line in KerrGeodesicLUTGenerator.cpp.
+ */
+namespace MoleHole::KerrGeodesicBatch {
+
+constexpr double START_RADIUS = 50.0;    // Rays start inbound at this radius
+constexpr double ESCAPE_RADIUS = 100.0;  // Outbound rays beyond this radius have escaped
+
+/**
+ * @brief Where and how one integrated ray ended
+ */
+struct RayEnd {
+    double phi = 0.0;                       // Swept azimuth at termination
+    double lambda = 0.0;                    // Affine parameter at termination
+    double closestApproach = START_RADIUS;  // Minimum radius, periapsis interpolated inside steps
+    bool captured = false;                  // Crossed the capture radius
+    bool terminated = false;                // Reached the capture or escape radius
+    int acceptedSteps = 0;
+    int rejectedSteps = 0;
+};
+
+/**
+ * @brief Rays of one batch in SoA layout
+ *
+ * Photon state is {r, phi, p_r}, starting at (START_RADIUS, 0, initialRadialMomentum).
+ */
+struct RayBatch {
+    size_t count = 0;
+    const double* energy = nullptr;
+    const double* angularMomentum = nullptr;
+    const double* captureRadius = nullptr;          // Slightly outside the horizon
+    const double* initialRadialMomentum = nullptr;
+    RayEnd* ends = nullptr;                         // Output, one per ray
+};
+
+/**
+ * @brief Periapsis tracking and capture/escape detection after one accepted step
+ *
+ * When the ray crosses a boundary inside the step, the crossing is located on the Hermite
+ * interpolant and end.phi / end.lambda are set to it.
+ * @return false when the ray terminated
+ */
+bool ObserveStep(double angularMomentum, double captureRadius,
+                 double lambdaNow, const double* y, double lambdaPrev, const double* yPrev, RayEnd& end);
+
+using BatchKernel = void (*)(const RayBatch& batch, const AdaptiveStepControl& control);
+
+// nullptr when the translation unit was built without the ISA flags (non-x86 targets)
+BatchKernel GetKernelAVX2();
+BatchKernel GetKernelAVX512();
+
+} // namespace MoleHole::KerrGeodesicBatch
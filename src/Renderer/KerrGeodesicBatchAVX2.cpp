@@ -0,0 +1,28 @@
+// Compiled with -mavx2 / /arch:AVX2 (see CMakeLists.txt), only called after a CpuFeatures check
+#include "KerrGeodesicBatch.h"
+
+#if defined(__AVX2__)
+#include "KerrGeodesicBatchKernel.h"
+
+namespace MoleHole::KerrGeodesicBatch {
+
+namespace {
+void IntegrateAVX2(const RayBatch& batch, const AdaptiveStepControl& control) {
+    IntegrateBatch<Simd::DoubleAVX2>(batch, control);
+}
+}
+
+BatchKernel GetKernelAVX2() {
+    return &IntegrateAVX2;
+}
+
+} // namespace MoleHole::KerrGeodesicBatch
+#else
+namespace MoleHole::KerrGeodesicBatch {
+
+BatchKernel GetKernelAVX2() {
+    return nullptr;
+}
+
+} // namespace MoleHole::KerrGeodesicBatch
+#endif
@@ -0,0 +1,28 @@
+// Compiled with -mavx512f / /arch:AVX512 (see CMakeLists.txt), only called after a CpuFeatures check
+#include "KerrGeodesicBatch.h"
+
+#if defined(__AVX512F__)
+#include "KerrGeodesicBatchKernel.h"
+
+namespace MoleHole::KerrGeodesicBatch {
+
+namespace {
+void IntegrateAVX512(const RayBatch& batch, const AdaptiveStepControl& control) {
+    IntegrateBatch<Simd::DoubleAVX512>(batch, control);
+}
+}
+
+BatchKernel GetKernelAVX512() {
+    return &IntegrateAVX512;
+}
+
+} // namespace MoleHole::KerrGeodesicBatch
+#else
+namespace MoleHole::KerrGeodesicBatch {
+
+BatchKernel GetKernelAVX512() {
+    return nullptr;
+}
+
+} // namespace MoleHole::KerrGeodesicBatch
+#endif
@@ -0,0 +1,263 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+
+#include "KerrGeodesicBatch.h"
+#include "MathTools/SimdPack.h"
+
+/**
+ * Lane-parallel Dormand-Prince 5(4) integration of equatorial photon geodesics.
+ *
+ * Included only by the per-ISA translation units. Each SIMD lane integrates its own ray with
+ * its own step size, exactly like KerrGeodesicLUTGenerator::integrateGeodesic does for one ray.
+ * Lanes whose ray terminates are refilled with the next ray of the batch, so the vector stays
+ * full until the batch runs dry. Periapsis and boundary crossings are rare, those lanes go
+ * through the shared scalar ObserveStep().
+ *
+ * No standard library templates are used in here on purpose: an inline function instantiated
+ * in an ISA-flagged translation unit could be picked by the linker for scalar callers.
+ */
+namespace MoleHole::KerrGeodesicBatch {
+namespace {
+
+/**
+ * @brief Step size factor clamp(Safety * errorNorm^-0.2, MinShrink, MaxGrowth) without pow()
+ *
+ * Outside [(Safety / MaxGrowth)^5, (Safety / MinShrink)^5] the factor saturates, so errorNorm is
+ * clamped into that range first. Inside it, ln via exponent/mantissa split and an atanh series,
+ * exp via a Taylor series at a quarter of the argument, squared twice. Relative error ~1e-8,
+ * which only perturbs the next step size, never the accepted solution.
+ */
+template<typename V>
+V StepFactor(V errorNorm) {
+    using C = DormandPrince54Coefficients;
+    constexpr double growthRatio = C::Safety / C::MaxGrowth;
+    constexpr double shrinkRatio = C::Safety / C::MinShrink;
+    constexpr double minNorm = growthRatio * growthRatio * growthRatio * growthRatio * growthRatio;
+    constexpr double maxNorm = shrinkRatio * shrinkRatio * shrinkRatio * shrinkRatio * shrinkRatio;
+    constexpr double ln2 = 0.6931471805599453;
+    constexpr double sqrt2 = 1.4142135623730951;
+
+    const V one = V::Broadcast(1.0);
+    const V x = Min(Max(errorNorm, V::Broadcast(minNorm)), V::Broadcast(maxNorm));
+
+    // ln x = e * ln2 + ln m, with m folded into [sqrt(1/2), sqrt(2))
+    V exponent = Exponent(x);
+    V mantissa = Mantissa(x);
+    const auto folded = mantissa > V::Broadcast(sqrt2);
+    mantissa = Select(folded, mantissa * V::Broadcast(0.5), mantissa);
+    exponent = Select(folded, exponent + one, exponent);
+
+    // ln m = 2 atanh((m - 1) / (m + 1)), |s| < 0.172
+    const V s = (mantissa - one) / (mantissa + one);
+    const V s2 = s * s;
+    const V series = one + s2 * (V::Broadcast(1.0 / 3.0) + s2 * (V::Broadcast(1.0 / 5.0)
+                   + s2 * (V::Broadcast(1.0 / 7.0) + s2 * V::Broadcast(1.0 / 9.0))));
+    const V lnX = exponent * V::Broadcast(ln2) + V::Broadcast(2.0) * s * series;
+
+    // x^-0.2 = exp(-0.2 ln x) = exp(q)^4 with q = -0.05 ln x, |q| < 0.43
+    const V q = lnX * V::Broadcast(-0.05);
+    V expQ = one + q * (one + q * (V::Broadcast(1.0 / 2.0) + q * (V::Broadcast(1.0 / 6.0)
+           + q * (V::Broadcast(1.0 / 24.0) + q * (V::Broadcast(1.0 / 120.0) + q * (V::Broadcast(1.0 / 720.0)
+           + q * (V::Broadcast(1.0 / 5040.0) + q * V::Broadcast(1.0 / 40320.0))))))));
+    expQ = expQ * expQ;
+    expQ = expQ * expQ;
+
+    return Min(Max(V::Broadcast(C::Safety) * expQ, V::Broadcast(C::MinShrink)), V::Broadcast(C::MaxGrowth));
+}
+
+template<typename V>
+void IntegrateBatch(const RayBatch& batch, const AdaptiveStepControl& control) {
+    using C = DormandPrince54Coefficients;
+    using Mask = typename V::Mask;
+    constexpr int W = V::Width;
+
+    // Lane state, SoA. Loaded into vectors at the top of every step and stored back at the end,
+    // so refills and event handling are plain per-lane scalar code.
+    alignas(64) double r[W], phi[W], pr[W], t[W], h[W];
+    alignas(64) double k1r[W], k1phi[W], k1pr[W];
+    alignas(64) double rPrev[W], phiPrev[W], prPrev[W], tPrev[W];
+    alignas(64) double L[W], energyTerm[W], captureRadius[W], closest[W];
+    size_t laneRay[W];
+    uint32_t activeBits = 0;
+    size_t nextRay = 0;
+
+    const double initialStep = control.initialStep < control.minStep ? control.minStep
+        : (control.initialStep > control.maxStep ? control.maxStep : control.initialStep);
+
+    // Same expressions as the scalar derivative functor
+    const auto derivativeScalar = [](double rr, double ppr, double l, double eTerm, double& dr, double& dphi, double& dpr) {
+        const double rSqr = rr * rr;
+        dr = ppr;
+        dphi = l / rSqr;
+        dpr = -(rr - 1.0) / (rSqr * rSqr) * eTerm + l * l / (rSqr * rr);
+    };
+
+    const auto startLane = [&](int lane) {
+        if (nextRay >= batch.count) {
+            // Idle lane with harmless values, masked out of every decision
+            r[lane] = START_RADIUS; phi[lane] = 0.0; pr[lane] = -1.0; t[lane] = 0.0; h[lane] = initialStep;
+            L[lane] = 0.0; energyTerm[lane] = 0.0; captureRadius[lane] = 1.0; closest[lane] = START_RADIUS;
+            k1r[lane] = -1.0; k1phi[lane] = 0.0; k1pr[lane] = 0.0;
+            activeBits &= ~(1u << lane);
+            return;
+        }
+
+        const size_t ray = nextRay++;
+        laneRay[lane] = ray;
+        batch.ends[ray] = RayEnd{};
+
+        r[lane] = START_RADIUS;
+        phi[lane] = 0.0;
+        pr[lane] = batch.initialRadialMomentum[ray];
+        t[lane] = 0.0;
+        h[lane] = initialStep;
+        L[lane] = batch.angularMomentum[ray];
+        energyTerm[lane] = batch.energy[ray] * batch.energy[ray] - 1.0;
+        captureRadius[lane] = batch.captureRadius[ray];
+        closest[lane] = START_RADIUS;
+        derivativeScalar(r[lane], pr[lane], L[lane], energyTerm[lane], k1r[lane], k1phi[lane], k1pr[lane]);
+        activeBits |= 1u << lane;
+    };
+
+    for (int lane = 0; lane < W; lane++) {
+        startLane(lane);
+    }
+
+    const V zero = V::Broadcast(0.0);
+    const V one = V::Broadcast(1.0);
+    const V maxParameter = V::Broadcast(control.maxParameter);
+    const V minStep = V::Broadcast(control.minStep);
+    const V maxStep = V::Broadcast(control.maxStep);
+    const V absTolerance = V::Broadcast(control.absTolerance);
+    const V relTolerance = V::Broadcast(control.relTolerance);
+    const V escapeRadius = V::Broadcast(ESCAPE_RADIUS);
+
+    while (activeBits != 0) {
+        const Mask active = Mask::FromBits(activeBits);
+
+        const V y0 = V::Load(r), y1 = V::Load(phi), y2 = V::Load(pr);
+        const V tNow = V::Load(t);
+        const V lv = V::Load(L), eTerm = V::Load(energyTerm);
+        const V k1_0 = V::Load(k1r), k1_1 = V::Load(k1phi), k1_2 = V::Load(k1pr);
+        const V hs = Min(V::Load(h), maxParameter - tNow);
+
+        // dphi/dlambda only depends on r, so the phi stage values are never needed
+        const auto derivative = [&](V rr, V ppr, V& dr, V& dphi, V& dpr) {
+            const V rSqr = rr * rr;
+            dr = ppr;
+            dphi = lv / rSqr;
+            dpr = -(rr - one) / (rSqr * rSqr) * eTerm + lv * lv / (rSqr * rr);
+        };
+
+        V k2_0, k2_1, k2_2, k3_0, k3_1, k3_2, k4_0, k4_1, k4_2;
+        V k5_0, k5_1, k5_2, k6_0, k6_1, k6_2, k7_0, k7_1, k7_2;
+
+        derivative(y0 + hs * (V::Broadcast(C::A21) * k1_0),
+                   y2 + hs * (V::Broadcast(C::A21) * k1_2), k2_0, k2_1, k2_2);
+        derivative(y0 + hs * (V::Broadcast(C::A31) * k1_0 + V::Broadcast(C::A32) * k2_0),
+                   y2 + hs * (V::Broadcast(C::A31) * k1_2 + V::Broadcast(C::A32) * k2_2), k3_0, k3_1, k3_2);
+        derivative(y0 + hs * (V::Broadcast(C::A41) * k1_0 + V::Broadcast(C::A42) * k2_0 + V::Broadcast(C::A43) * k3_0),
+                   y2 + hs * (V::Broadcast(C::A41) * k1_2 + V::Broadcast(C::A42) * k2_2 + V::Broadcast(C::A43) * k3_2),
+                   k4_0, k4_1, k4_2);
+        derivative(y0 + hs * (V::Broadcast(C::A51) * k1_0 + V::Broadcast(C::A52) * k2_0 + V::Broadcast(C::A53) * k3_0
+                              + V::Broadcast(C::A54) * k4_0),
+                   y2 + hs * (V::Broadcast(C::A51) * k1_2 + V::Broadcast(C::A52) * k2_2 + V::Broadcast(C::A53) * k3_2
+                              + V::Broadcast(C::A54) * k4_2),
+                   k5_0, k5_1, k5_2);
+        derivative(y0 + hs * (V::Broadcast(C::A61) * k1_0 + V::Broadcast(C::A62) * k2_0 + V::Broadcast(C::A63) * k3_0
+                              + V::Broadcast(C::A64) * k4_0 + V::Broadcast(C::A65) * k5_0),
+                   y2 + hs * (V::Broadcast(C::A61) * k1_2 + V::Broadcast(C::A62) * k2_2 + V::Broadcast(C::A63) * k3_2
+                              + V::Broadcast(C::A64) * k4_2 + V::Broadcast(C::A65) * k5_2),
+                   k6_0, k6_1, k6_2);
+
+        const auto advance = [&](V y, V k1, V k3, V k4, V k5, V k6) {
+            return y + hs * (V::Broadcast(C::B1) * k1 + V::Broadcast(C::B3) * k3 + V::Broadcast(C::B4) * k4
+                             + V::Broadcast(C::B5) * k5 + V::Broadcast(C::B6) * k6);
+        };
+        const V next0 = advance(y0, k1_0, k3_0, k4_0, k5_0, k6_0);
+        const V next1 = advance(y1, k1_1, k3_1, k4_1, k5_1, k6_1);
+        const V next2 = advance(y2, k1_2, k3_2, k4_2, k5_2, k6_2);
+        derivative(next0, next2, k7_0, k7_1, k7_2);
+
+        // Same RMS error norm as DormandPrince54::Integrate
+        const auto errorRatio = [&](V y, V next, V k1, V k3, V k4, V k5, V k6, V k7) {
+            const V error = hs * (V::Broadcast(C::E1) * k1 + V::Broadcast(C::E3) * k3 + V::Broadcast(C::E4) * k4
+                                  + V::Broadcast(C::E5) * k5 + V::Broadcast(C::E6) * k6 + V::Broadcast(C::E7) * k7);
+            const V scale = absTolerance + relTolerance * Max(Abs(y), Abs(next));
+            const V ratio = error / scale;
+            return ratio * ratio;
+        };
+        const V errorSum = errorRatio(y0, next0, k1_0, k3_0, k4_0, k5_0, k6_0, k7_0)
+                           + errorRatio(y1, next1, k1_1, k3_1, k4_1, k5_1, k6_1, k7_1)
+                           + errorRatio(y2, next2, k1_2, k3_2, k4_2, k5_2, k6_2, k7_2);
+        // x - x is 0 for finite x and NaN for inf / NaN
+        const Mask finite = ((next0 - next0) == zero) & ((next1 - next1) == zero) & ((next2 - next2) == zero);
+        const V errorNorm = Select(finite, Sqrt(errorSum / V::Broadcast(3.0)), V::Broadcast(HUGE_VAL));
+
+        // Non-finite steps are never taken; at the minimum step size they end the ray instead
+        const Mask accept = active & finite & ((errorNorm <= one) | (hs <= minStep));
+        const Mask diverged = active & ~finite & (hs <= minStep);
+        const Mask periapsis = (y2 < zero) & (next2 >= zero);
+        const Mask boundary = (next0 < V::Load(captureRadius)) | ((next0 > escapeRadius) & (next2 > zero));
+        const Mask event = accept & (periapsis | boundary);
+
+        y0.Store(rPrev);
+        y1.Store(phiPrev);
+        y2.Store(prPrev);
+        tNow.Store(tPrev);
+
+        Select(accept, next0, y0).Store(r);
+        Select(accept, next1, y1).Store(phi);
+        Select(accept, next2, y2).Store(pr);
+        Select(accept, tNow + hs, tNow).Store(t);
+        Select(accept, k7_0, k1_0).Store(k1r);
+        Select(accept, k7_1, k1_1).Store(k1phi);
+        Select(accept, k7_2, k1_2).Store(k1pr);
+        const V closestNow = V::Load(closest);
+        Select(accept, Min(closestNow, next0), closestNow).Store(closest);
+        Min(Max(hs * StepFactor(errorNorm), minStep), maxStep).Store(h);
+
+        const uint32_t acceptBits = accept.Bits();
+        const uint32_t eventBits = event.Bits();
+        const uint32_t divergedBits = diverged.Bits();
+
+        for (int lane = 0; lane < W; lane++) {
+            const uint32_t laneBit = 1u << lane;
+            if ((activeBits & laneBit) == 0) {
+                continue;
+            }
+
+            RayEnd& end = batch.ends[laneRay[lane]];
+            bool done = false;
+            if (acceptBits & laneBit) {
+                end.acceptedSteps++;
+                if (eventBits & laneBit) {
+                    const double y[3] = {r[lane], phi[lane], pr[lane]};
+                    const double yPrev[3] = {rPrev[lane], phiPrev[lane], prPrev[lane]};
+                    end.closestApproach = closest[lane];
+                    done = !ObserveStep(L[lane], captureRadius[lane], t[lane], y, tPrev[lane], yPrev, end);
+                    closest[lane] = end.closestApproach;
+                }
+            } else {
+                end.rejectedSteps++;
+                done = (divergedBits & laneBit) != 0;
+            }
+
+            if (!done && (end.acceptedSteps + end.rejectedSteps >= control.maxSteps || t[lane] >= control.maxParameter)) {
+                done = true;
+            }
+            if (done) {
+                if (!end.terminated) {
+                    end.phi = phi[lane];
+                    end.lambda = t[lane];
+                }
+                end.closestApproach = closest[lane];
+                startLane(lane);
+            }
+        }
+    }
+}
+
+} // namespace
+} // namespace MoleHole::KerrGeodesicBatch
@@ -1,83 +1,201 @@
 #include "KerrGeodesicLUTGenerator.h"
 #include <cmath>
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <spdlog/spdlog.h>
 
+#include "Application/CpuFeatures.h"
+#include "Application/ThreadPool.h"
+#include "LUTCache.h"
+
 namespace MoleHole {
 
 static inline float sqr(float x) { return x * x; }
 
-std::vector<float> KerrGeodesicLUTGenerator::generateDeflectionLUT() {
-    spdlog::info("Generating Kerr geodesic deflection LUT ({}x{}x{} samples)...",
-                 LUT_SPIN_SAMPLES, LUT_INCLINATION_SAMPLES, LUT_IMPACT_PARAM_SAMPLES);
+namespace {
+// Equatorial photon state integrated per sample: {r, phi, p_r}
+using GeodesicState = DormandPrince54<3>::State;
 
-    std::vector<float> lutData;
-    lutData.reserve(LUT_SPIN_SAMPLES * LUT_INCLINATION_SAMPLES * LUT_IMPACT_PARAM_SAMPLES);
+// Cubic Hermite interpolant over one step of length h, s in [0, 1]
+double hermiteValue(double y0, double dy0, double y1, double dy1, double h, double s) {
+    const double s2 = s * s;
+    const double s3 = s2 * s;
+    return (2.0 * s3 - 3.0 * s2 + 1.0) * y0 + (s3 - 2.0 * s2 + s) * h * dy0
+         + (-2.0 * s3 + 3.0 * s2) * y1 + (s3 - s2) * h * dy1;
+}
 
-    int totalSamples = LUT_SPIN_SAMPLES * LUT_INCLINATION_SAMPLES * LUT_IMPACT_PARAM_SAMPLES;
-    int processedSamples = 0;
-    int lastPercent = 0;
+// Fraction of the step at which the Hermite interpolant of r crosses target (r0 and r1 on opposite sides)
+double hermiteCrossing(double r0, double dr0, double r1, double dr1, double h, double target) {
+    double lo = 0.0, hi = 1.0;
+    const bool rising = r1 > r0;
+    for (int i = 0; i < 40; i++) {
+        const double mid = 0.5 * (lo + hi);
+        const bool below = hermiteValue(r0, dr0, r1, dr1, h, mid) < target;
+        if (below == rising) lo = mid; else hi = mid;
+    }
+    return 0.5 * (lo + hi);
+}
 
-    for (int spinIdx = 0; spinIdx < LUT_SPIN_SAMPLES; spinIdx++) {
-        float t_spin = static_cast<float>(spinIdx) / static_cast<float>(LUT_SPIN_SAMPLES - 1);
-        float spin = SPIN_MIN + t_spin * (SPIN_MAX - SPIN_MIN);
+// Minimum of the cubic Hermite interpolant of r over one step, using dr/dlambda = p_r at both ends.
+// Adaptive steps can be long, so periapsis is located inside the step instead of at a sample point.
+double hermiteMinimum(double r0, double dr0, double r1, double dr1, double h) {
+    const double m0 = h * dr0;
+    const double m1 = h * dr1;
+    const auto evaluate = [&](double s) { return hermiteValue(r0, dr0, r1, dr1, h, s); };
+
+    double minimum = std::min(r0, r1);
+    const double a = 6.0 * r0 + 3.0 * m0 - 6.0 * r1 + 3.0 * m1;
+    const double b = -6.0 * r0 - 4.0 * m0 + 6.0 * r1 - 2.0 * m1;
+    const double c = m0;
+
+    if (std::abs(a) < 1e-12) {
+        if (std::abs(b) > 1e-12) {
+            const double s = -c / b;
+            if (s > 0.0 && s < 1.0) minimum = std::min(minimum, evaluate(s));
+        }
+        return minimum;
+    }
 
-        for (int inclIdx = 0; inclIdx < LUT_INCLINATION_SAMPLES; inclIdx++) {
-            float t_incl = static_cast<float>(inclIdx) / static_cast<float>(LUT_INCLINATION_SAMPLES - 1);
-            float inclination = INCLINATION_MIN + t_incl * (INCLINATION_MAX - INCLINATION_MIN);
+    const double discriminant = b * b - 4.0 * a * c;
+    if (discriminant < 0.0) {
+        return minimum;
+    }
+    const double sqrtDiscriminant = std::sqrt(discriminant);
+    for (const double s : {(-b - sqrtDiscriminant) / (2.0 * a), (-b + sqrtDiscriminant) / (2.0 * a)}) {
+        if (s > 0.0 && s < 1.0) minimum = std::min(minimum, evaluate(s));
+    }
+    return minimum;
+}
 
-            for (int impactIdx = 0; impactIdx < LUT_IMPACT_PARAM_SAMPLES; impactIdx++) {
-                float t_impact = static_cast<float>(impactIdx) / static_cast<float>(LUT_IMPACT_PARAM_SAMPLES - 1);
-                float impactParam = IMPACT_MIN + t_impact * (IMPACT_MAX - IMPACT_MIN);
+// Ray is captured 1% outside the outer horizon
+double captureRadius(float spin) {
+    const float r_horizon = 1.0f + std::sqrt(1.0f - spin * spin);
+    return r_horizon * 1.01f;
+}
 
-                glm::vec3 spinAxis(0.0f, 1.0f, 0.0f);
-                GeodesicResult result = integrateGeodesic(spin, impactParam, inclination, spinAxis);
+// Inbound p_r at START_RADIUS for a photon of the given energy
+double initialRadialMomentum(double energy) {
+    return -std::sqrt(std::abs(energy * energy - (1.0 - 2.0 / KerrGeodesicBatch::START_RADIUS)));
+}
+}
 
-                lutData.push_back(result.deflectionAngle);
+bool KerrGeodesicBatch::ObserveStep(double angularMomentum, double captureRadius,
+                                    double lambdaNow, const double* y, double lambdaPrev, const double* yPrev,
+                                    RayEnd& end) {
+    const double h = lambdaNow - lambdaPrev;
+    if (yPrev[2] < 0.0 && y[2] >= 0.0) {
+        end.closestApproach = std::min(end.closestApproach, hermiteMinimum(yPrev[0], yPrev[2], y[0], y[2], h));
+    }
+    end.closestApproach = std::min(end.closestApproach, y[0]);
 
-                processedSamples++;
-                int percent = (processedSamples * 100) / totalSamples;
-                if (percent > lastPercent && percent % 10 == 0) {
-                    spdlog::info("  Deflection LUT generation: {}%", percent);
-                    lastPercent = percent;
-                }
-            }
-        }
+    const bool captured = y[0] < captureRadius;
+    const bool escaped = y[0] > ESCAPE_RADIUS && y[2] > 0.0;
+    if (!captured && !escaped) {
+        return true;
     }
 
-    spdlog::info("Kerr geodesic deflection LUT generated successfully");
-    return lutData;
+    // Steps of up to maxStep would otherwise overshoot the boundary and keep accumulating phi,
+    // so cut the final step back to the exact crossing
+    const double boundary = captured ? captureRadius : ESCAPE_RADIUS;
+    const double s = hermiteCrossing(yPrev[0], yPrev[2], y[0], y[2], h, boundary);
+    const double L = angularMomentum;
+    end.phi = hermiteValue(yPrev[1], L / (yPrev[0] * yPrev[0]), y[1], L / (y[0] * y[0]), h, s);
+    end.lambda = lambdaPrev + s * h;
+    end.captured = captured;
+    end.terminated = true;
+    return false;
 }
 
-std::vector<float> KerrGeodesicLUTGenerator::generateRedshiftLUT() {
-    spdlog::info("Generating Kerr redshift LUT ({}x{}x{} samples)...",
-                 LUT_SPIN_SAMPLES, LUT_INCLINATION_SAMPLES, LUT_IMPACT_PARAM_SAMPLES);
+KerrGeodesicLUTGenerator::GeodesicLUTs KerrGeodesicLUTGenerator::generateGeodesicLUTs() {
+    constexpr size_t slabCount = static_cast<size_t>(LUT_SPIN_SAMPLES) * LUT_INCLINATION_SAMPLES;
+    constexpr size_t sampleCount = slabCount * LUT_IMPACT_PARAM_SAMPLES;
+
+    ThreadPool& pool = ThreadPool::Global();
+    const GeodesicKernel kernel = bestGeodesicKernel();
+    spdlog::info("Generating Kerr geodesic LUTs ({}x{}x{} samples) on {} threads, {} kernel...",
+                 LUT_SPIN_SAMPLES, LUT_INCLINATION_SAMPLES, LUT_IMPACT_PARAM_SAMPLES,
+                 pool.GetThreadCount() + 1, geodesicKernelName(kernel));
+    const auto tStart = std::chrono::steady_clock::now();
+
+    GeodesicLUTs luts;
+    luts.deflection.resize(sampleCount);
+    luts.redshift.resize(sampleCount);
+
+    std::atomic<size_t> completedSlabs{0};
+    std::atomic<uint64_t> integrationSteps{0};
+    std::atomic<uint64_t> rejectedSteps{0};
+
+    pool.ParallelFor(0, slabCount, 1, [&](size_t slabBegin, size_t slabEnd) {
+        for (size_t slab = slabBegin; slab < slabEnd; slab++) {
+            const AdaptiveIntegrationStats stats = generateGeodesicSlab(slab, kernel, luts);
+            integrationSteps.fetch_add(stats.acceptedSteps, std::memory_order_relaxed);
+            rejectedSteps.fetch_add(stats.rejectedSteps, std::memory_order_relaxed);
+
+            const size_t done = completedSlabs.fetch_add(1, std::memory_order_relaxed) + 1;
+            const size_t percent = done * 100 / slabCount;
+            const size_t previousPercent = (done - 1) * 100 / slabCount;
+            if (percent / 10 != previousPercent / 10) {
+                spdlog::info("  Geodesic LUT generation: {}%", percent / 10 * 10);
+            }
+        }
+    });
+
+    const auto tEnd = std::chrono::steady_clock::now();
+    const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(tEnd - tStart).count();
+    luts.integrationSteps = integrationSteps.load();
+    luts.rejectedSteps = rejectedSteps.load();
+    spdlog::info("Kerr geodesic LUTs generated successfully in {} ms ({:.1f} steps/sample, {} rejected)",
+                 ms, static_cast<double>(luts.integrationSteps) / static_cast<double>(sampleCount), luts.rejectedSteps);
+    return luts;
+}
 
-    std::vector<float> lutData;
-    lutData.reserve(LUT_SPIN_SAMPLES * LUT_INCLINATION_SAMPLES * LUT_IMPACT_PARAM_SAMPLES);
+AdaptiveIntegrationStats KerrGeodesicLUTGenerator::generateGeodesicSlab(size_t slabIndex, GeodesicKernel kernel,
+                                                                        GeodesicLUTs& luts) {
+    const int spinIdx = static_cast<int>(slabIndex / LUT_INCLINATION_SAMPLES);
+    const int inclIdx = static_cast<int>(slabIndex % LUT_INCLINATION_SAMPLES);
 
-    for (int spinIdx = 0; spinIdx < LUT_SPIN_SAMPLES; spinIdx++) {
-        float t_spin = static_cast<float>(spinIdx) / static_cast<float>(LUT_SPIN_SAMPLES - 1);
-        float spin = SPIN_MIN + t_spin * (SPIN_MAX - SPIN_MIN);
+    float t_spin = static_cast<float>(spinIdx) / static_cast<float>(LUT_SPIN_SAMPLES - 1);
+    float spin = SPIN_MIN + t_spin * (SPIN_MAX - SPIN_MIN);
 
-        for (int inclIdx = 0; inclIdx < LUT_INCLINATION_SAMPLES; inclIdx++) {
-            float t_incl = static_cast<float>(inclIdx) / static_cast<float>(LUT_INCLINATION_SAMPLES - 1);
-            float inclination = INCLINATION_MIN + t_incl * (INCLINATION_MAX - INCLINATION_MIN);
+    float t_incl = static_cast<float>(inclIdx) / static_cast<float>(LUT_INCLINATION_SAMPLES - 1);
+    float inclination = INCLINATION_MIN + t_incl * (INCLINATION_MAX - INCLINATION_MIN);
 
-            for (int impactIdx = 0; impactIdx < LUT_IMPACT_PARAM_SAMPLES; impactIdx++) {
-                float t_impact = static_cast<float>(impactIdx) / static_cast<float>(LUT_IMPACT_PARAM_SAMPLES - 1);
-                float impactParam = IMPACT_MIN + t_impact * (IMPACT_MAX - IMPACT_MIN);
+    const size_t slabOffset = slabIndex * LUT_IMPACT_PARAM_SAMPLES;
+    AdaptiveIntegrationStats slabStats;
 
-                glm::vec3 spinAxis(0.0f, 1.0f, 0.0f);
-                GeodesicResult result = integrateGeodesic(spin, impactParam, inclination, spinAxis);
+    std::array<float, LUT_IMPACT_PARAM_SAMPLES> impactParams;
+    for (int impactIdx = 0; impactIdx < LUT_IMPACT_PARAM_SAMPLES; impactIdx++) {
+        float t_impact = static_cast<float>(impactIdx) / static_cast<float>(LUT_IMPACT_PARAM_SAMPLES - 1);
+        impactParams[impactIdx] = IMPACT_MIN + t_impact * (IMPACT_MAX - IMPACT_MIN);
+    }
 
-                lutData.push_back(result.redshiftFactor);
-            }
-        }
+    std::array<GeodesicResult, LUT_IMPACT_PARAM_SAMPLES> results;
+    integrateGeodesicBatch(spin, inclination, impactParams.data(), impactParams.size(), defaultStepControl(),
+                           results.data(), kernel);
+
+    for (int impactIdx = 0; impactIdx < LUT_IMPACT_PARAM_SAMPLES; impactIdx++) {
+        const GeodesicResult& result = results[impactIdx];
+        luts.deflection[slabOffset + impactIdx] = result.deflectionAngle;
+        luts.redshift[slabOffset + impactIdx] = result.redshiftFactor;
+        slabStats.acceptedSteps += result.integrationSteps;
+        slabStats.rejectedSteps += result.rejectedSteps;
     }
 
-    spdlog::info("Kerr redshift LUT generated successfully");
-    return lutData;
+    return slabStats;
+}
+
+AdaptiveStepControl KerrGeodesicLUTGenerator::defaultStepControl() {
+    AdaptiveStepControl control;
+    control.relTolerance = RELATIVE_TOLERANCE;
+    control.absTolerance = ABSOLUTE_TOLERANCE;
+    control.initialStep = 0.1;
+    control.minStep = 1e-5;
+    control.maxStep = 10.0;
+    control.maxParameter = MAX_AFFINE_PARAMETER;
+    control.maxSteps = 10000;
+    return control;
 }
 
 std::vector<float> KerrGeodesicLUTGenerator::generatePhotonSphereLUT() {
@@ -123,88 +241,159 @@ std::vector<float> KerrGeodesicLUTGenerator::generateISCOLUT() {
 }
 
 KerrGeodesicLUTGenerator::GeodesicResult KerrGeodesicLUTGenerator::integrateGeodesic(
-    float spin, float impactParameter, float inclination, const glm::vec3& spinAxis) {
-
-    GeodesicResult result;
-    result.deflectionAngle = 0.0f;
-    result.redshiftFactor = 1.0f;
-    result.properTime = 0.0f;
-    result.capturedByHorizon = false;
-    result.orbitCount = 0;
-    result.closestApproach = 1000.0f;
+    float spin, float impactParameter, float inclination, const glm::vec3& spinAxis,
+    const AdaptiveStepControl& control) {
 
     // For very large impact parameters, use weak-field approximation
-    if (impactParameter > 10.0f) {
-        result.deflectionAngle = 4.0f / impactParameter;
-        result.redshiftFactor = 1.0f - 1.0f / impactParameter;
-        result.closestApproach = impactParameter;
-        return result;
+    if (impactParameter > WEAK_FIELD_IMPACT_PARAM) {
+        return weakFieldResult(impactParameter);
     }
 
-    const float r_start = 50.0f;
-    const float r_horizon = 1.0f + std::sqrt(1.0f - spin * spin);
-
-    float state[8];
-    state[0] = 0.0f;
-    state[1] = r_start;
-    state[2] = inclination;
-    state[3] = 0.0f;
-
     float energy, angularMomentum;
-    calculateConservedQuantities(r_start, inclination, spin, impactParameter, energy, angularMomentum);
-
-    state[4] = energy;
-    state[5] = -std::sqrt(std::abs(energy * energy - (1.0f - 2.0f / r_start)));
-    state[6] = 0.0f;
-    state[7] = angularMomentum;
-
-    const float dlambda = 0.05f;
-    const int maxSteps = 10000;
-    const float minRadius = r_horizon * 1.01f;
-    const float maxRadius = 100.0f;
+    calculateConservedQuantities(static_cast<float>(KerrGeodesicBatch::START_RADIUS), inclination, spin,
+                                 impactParameter, energy, angularMomentum);
+
+    const double E = energy;
+    const double L = angularMomentum;
+    const double minRadius = captureRadius(spin);
+
+    auto derivatives = [E, L](double, const GeodesicState& y, GeodesicState& dydt) {
+        const double r = y[0];
+        const double rSqr = r * r;
+        dydt[0] = y[2];                                                        // dr/dlambda
+        dydt[1] = L / rSqr;                                                    // dphi/dlambda
+        dydt[2] = -(r - 1.0) / (rSqr * rSqr) * (E * E - 1.0) + L * L / (rSqr * r);  // dp_r/dlambda
+    };
+
+    GeodesicState state = {KerrGeodesicBatch::START_RADIUS, 0.0, initialRadialMomentum(E)};
+    double lambda = 0.0;
+    KerrGeodesicBatch::RayEnd end;
+
+    auto observer = [&](double lambdaNow, const GeodesicState& y, double lambdaPrev, const GeodesicState& yPrev) {
+        return KerrGeodesicBatch::ObserveStep(L, minRadius, lambdaNow, y.data(), lambdaPrev, yPrev.data(), end);
+    };
+
+    const DormandPrince54<3> integrator(control);
+    const AdaptiveIntegrationStats stats = integrator.Integrate(derivatives, lambda, state, observer);
+
+    end.acceptedSteps = stats.acceptedSteps;
+    end.rejectedSteps = stats.rejectedSteps;
+    if (!end.terminated) {
+        // Ran into the affine parameter or step limit without reaching either boundary
+        end.phi = state[1];
+        end.lambda = lambda;
+    }
+    return finishGeodesic(end, minRadius);
+}
 
-    float lastPhi = state[3];
+KerrGeodesicLUTGenerator::GeodesicKernel KerrGeodesicLUTGenerator::bestGeodesicKernel() {
+    static const GeodesicKernel s_Kernel = [] {
+        // Check the CPU first, the kernel getters themselves are compiled with ISA flags
+        const CpuFeatures& cpu = CpuFeatures::Get();
+        if (cpu.avx512f && KerrGeodesicBatch::GetKernelAVX512()) {
+            return GeodesicKernel::AVX512;
+        }
+        if (cpu.avx2 && KerrGeodesicBatch::GetKernelAVX2()) {
+            return GeodesicKernel::AVX2;
+        }
+        return GeodesicKernel::Scalar;
+    }();
+    return s_Kernel;
+}
 
-    for (int steps = 0; steps < maxSteps; steps++) {
-        float r = state[1];
-        float theta = state[2];
-        float phi = state[3];
+const char* KerrGeodesicLUTGenerator::geodesicKernelName(GeodesicKernel kernel) {
+    switch (kernel) {
+        case GeodesicKernel::AVX2: return "AVX2";
+        case GeodesicKernel::AVX512: return "AVX-512";
+        default: return "scalar";
+    }
+}
 
-        result.closestApproach = std::min(result.closestApproach, r);
+void KerrGeodesicLUTGenerator::integrateGeodesicBatch(float spin, float inclination, const float* impactParameters,
+                                                      size_t count, const AdaptiveStepControl& control,
+                                                      GeodesicResult* results, GeodesicKernel kernel) {
+    KerrGeodesicBatch::BatchKernel batchKernel = nullptr;
+    if (kernel == GeodesicKernel::AVX512) {
+        batchKernel = KerrGeodesicBatch::GetKernelAVX512();
+    } else if (kernel == GeodesicKernel::AVX2) {
+        batchKernel = KerrGeodesicBatch::GetKernelAVX2();
+    }
 
-        if (r < minRadius) {
-            result.capturedByHorizon = true;
-            break;
+    if (!batchKernel) {
+        const glm::vec3 spinAxis(0.0f, 1.0f, 0.0f);
+        for (size_t i = 0; i < count; i++) {
+            results[i] = integrateGeodesic(spin, impactParameters[i], inclination, spinAxis, control);
         }
+        return;
+    }
 
-        if (r > maxRadius && state[5] > 0.0f) {
-            break;
+    // Strong-field rays are packed into SoA arrays for the kernel, weak-field ones are closed form
+    std::vector<double> energies, angularMomenta, captureRadii, radialMomenta;
+    std::vector<size_t> rayIndices;
+    energies.reserve(count);
+    angularMomenta.reserve(count);
+    captureRadii.reserve(count);
+    radialMomenta.reserve(count);
+    rayIndices.reserve(count);
+
+    const double minRadius = captureRadius(spin);
+    for (size_t i = 0; i < count; i++) {
+        if (impactParameters[i] > WEAK_FIELD_IMPACT_PARAM) {
+            results[i] = weakFieldResult(impactParameters[i]);
+            continue;
         }
 
-        float deltaPhi = phi - lastPhi;
-        if (std::abs(deltaPhi) > 6.0f) {
-            result.orbitCount++;
-        }
-        lastPhi = phi;
+        float energy, angularMomentum;
+        calculateConservedQuantities(static_cast<float>(KerrGeodesicBatch::START_RADIUS), inclination, spin,
+                                     impactParameters[i], energy, angularMomentum);
+        energies.push_back(energy);
+        angularMomenta.push_back(angularMomentum);
+        captureRadii.push_back(minRadius);
+        radialMomenta.push_back(initialRadialMomentum(energy));
+        rayIndices.push_back(i);
+    }
 
-        float rSqr = r * r;
-        float a = spin;
-        float aSqr = a * a;
+    std::vector<KerrGeodesicBatch::RayEnd> ends(rayIndices.size());
+    KerrGeodesicBatch::RayBatch batch;
+    batch.count = rayIndices.size();
+    batch.energy = energies.data();
+    batch.angularMomentum = angularMomenta.data();
+    batch.captureRadius = captureRadii.data();
+    batch.initialRadialMomentum = radialMomenta.data();
+    batch.ends = ends.data();
+    batchKernel(batch, control);
+
+    for (size_t i = 0; i < rayIndices.size(); i++) {
+        results[rayIndices[i]] = finishGeodesic(ends[i], captureRadii[i]);
+    }
+}
 
-        float dr_dlambda = state[5];
-        float V_eff_r = -(r - 1.0f) / (rSqr * rSqr) * (energy * energy - 1.0f)
-                        + angularMomentum * angularMomentum / (r * r * r);
-        float dpr_dlambda = V_eff_r;
-        float dphi_dlambda = angularMomentum / rSqr;
+KerrGeodesicLUTGenerator::GeodesicResult KerrGeodesicLUTGenerator::weakFieldResult(float impactParameter) {
+    GeodesicResult result;
+    result.deflectionAngle = 4.0f / impactParameter;
+    result.redshiftFactor = 1.0f - 1.0f / impactParameter;
+    result.properTime = 0.0f;
+    result.capturedByHorizon = false;
+    result.orbitCount = 0;
+    result.closestApproach = impactParameter;
+    result.integrationSteps = 0;
+    result.rejectedSteps = 0;
+    return result;
+}
 
-        state[1] += dr_dlambda * dlambda;
-        state[3] += dphi_dlambda * dlambda;
-        state[5] += dpr_dlambda * dlambda;
+KerrGeodesicLUTGenerator::GeodesicResult KerrGeodesicLUTGenerator::finishGeodesic(
+    const KerrGeodesicBatch::RayEnd& end, double minRadius) {
 
-        result.properTime += dlambda;
-    }
+    constexpr double twoPi = 6.283185307179586;
 
-    result.deflectionAngle = std::abs(state[3]);
+    GeodesicResult result;
+    result.properTime = static_cast<float>(end.lambda);
+    result.capturedByHorizon = end.captured;
+    result.closestApproach = static_cast<float>(end.closestApproach);
+    result.deflectionAngle = static_cast<float>(std::abs(end.phi));
+    result.orbitCount = static_cast<int>(std::abs(end.phi) / twoPi);
+    result.integrationSteps = end.acceptedSteps;
+    result.rejectedSteps = end.rejectedSteps;
 
     if (!result.capturedByHorizon && result.closestApproach > minRadius) {
         float r_close = result.closestApproach;
@@ -266,35 +455,6 @@ float KerrGeodesicLUTGenerator::calculateISCORadius(float spin) {
     return r_isco_M;
 }
 
-void KerrGeodesicLUTGenerator::rk4Step(float* state, int stateSize, float spin, float dt,
-                                       void (*derivatives)(float*, float*, float, float)) {
-    float* k1 = new float[stateSize];
-    float* k2 = new float[stateSize];
-    float* k3 = new float[stateSize];
-    float* k4 = new float[stateSize];
-    float* temp = new float[stateSize];
-
-    derivatives(state, k1, spin, 0.0f);
-    for (int i = 0; i < stateSize; i++) temp[i] = state[i] + 0.5f * dt * k1[i];
-
-    derivatives(temp, k2, spin, 0.5f * dt);
-    for (int i = 0; i < stateSize; i++) temp[i] = state[i] + 0.5f * dt * k2[i];
-
-    derivatives(temp, k3, spin, 0.5f * dt);
-    for (int i = 0; i < stateSize; i++) temp[i] = state[i] + dt * k3[i];
-
-    derivatives(temp, k4, spin, dt);
-    for (int i = 0; i < stateSize; i++) {
-        state[i] += (dt / 6.0f) * (k1[i] + 2.0f * k2[i] + 2.0f * k3[i] + k4[i]);
-    }
-
-    delete[] k1;
-    delete[] k2;
-    delete[] k3;
-    delete[] k4;
-    delete[] temp;
-}
-
 void KerrGeodesicLUTGenerator::geodesicDerivatives(float* state, float* derivatives,
                                                    float spin, float lambda) {
     float t = state[0];
@@ -336,5 +496,160 @@ void KerrGeodesicLUTGenerator::geodesicDerivatives(float* state, float* derivati
     derivatives[7] = 0.0f;
 }
 
+uint64_t KerrGeodesicLUTGenerator::cacheKey() {
+    return LUTCacheKey("KerrGeodesicLUT", GENERATOR_VERSION)
+        .Add(LUT_IMPACT_PARAM_SAMPLES).Add(LUT_SPIN_SAMPLES).Add(LUT_INCLINATION_SAMPLES)
+        .Add(SPIN_MIN).Add(SPIN_MAX)
+        .Add(IMPACT_MIN).Add(IMPACT_MAX)
+        .Add(INCLINATION_MIN).Add(INCLINATION_MAX)
+        .Add(RELATIVE_TOLERANCE).Add(ABSOLUTE_TOLERANCE).Add(MAX_AFFINE_PARAMETER)
+        .Value();
+}
+
+void KerrGeodesicLUTGenerator::runBenchmark() {
+    using Clock = std::chrono::steady_clock;
+    spdlog::info("Kerr geodesic LUT benchmark");
+
+    // Full LUT with production tolerances
+    const auto tLutStart = Clock::now();
+    const GeodesicLUTs luts = generateGeodesicLUTs();
+    const double lutMs = std::chrono::duration<double, std::milli>(Clock::now() - tLutStart).count();
+    const double sampleCount = static_cast<double>(luts.deflection.size());
+    spdlog::info("  Full LUT (DP5(4) {}, rtol={}, atol={}): {:.1f} ms, {} steps ({:.1f}/sample), {} rejected",
+                 geodesicKernelName(bestGeodesicKernel()), RELATIVE_TOLERANCE, ABSOLUTE_TOLERANCE, lutMs, luts.integrationSteps,
+                 static_cast<double>(luts.integrationSteps) / sampleCount, luts.rejectedSteps);
+
+    // Accuracy on a subset of slabs against a tight-tolerance reference, and against the
+    // fixed-step explicit Euler scheme (dlambda = 0.05) the LUT was generated with before
+    AdaptiveStepControl referenceControl = defaultStepControl();
+    referenceControl.relTolerance = 1e-11;
+    referenceControl.absTolerance = 1e-13;
+    referenceControl.maxStep = 1.0;
+    referenceControl.maxSteps = 1000000;
+
+    const auto legacyEuler = [](float impactParameter, float spin, int& steps) {
+        const float r_horizon = 1.0f + std::sqrt(1.0f - spin * spin);
+        const float minRadius = r_horizon * 1.01f;
+        const float dlambda = 0.05f;
+        const float L = impactParameter;
+        float r = 50.0f;
+        float phi = 0.0f;
+        float p_r = -std::sqrt(std::abs(1.0f - (1.0f - 2.0f / r)));
+        for (steps = 0; steps < 10000; steps++) {
+            if (r < minRadius || (r > 100.0f && p_r > 0.0f)) break;
+            const float rSqr = r * r;
+            const float dpr = L * L / (rSqr * r);
+            r += p_r * dlambda;
+            phi += L / rSqr * dlambda;
+            p_r += dpr * dlambda;
+        }
+        return std::abs(phi);
+    };
+
+    const AdaptiveStepControl control = defaultStepControl();
+    const glm::vec3 spinAxis(0.0f, 1.0f, 0.0f);
+    const int spinIndices[] = {0, LUT_SPIN_SAMPLES / 2, LUT_SPIN_SAMPLES - 1};
+    const int inclIndices[] = {0, LUT_INCLINATION_SAMPLES / 2, LUT_INCLINATION_SAMPLES - 1};
+
+    double adaptiveMaxError = 0.0, adaptiveErrorSum = 0.0, adaptiveMs = 0.0;
+    double eulerMaxError = 0.0, eulerErrorSum = 0.0, eulerMs = 0.0;
+    uint64_t adaptiveSteps = 0, eulerSteps = 0;
+    int integratedSamples = 0;
+
+    for (const int spinIdx : spinIndices) {
+        const float spin = SPIN_MIN + static_cast<float>(spinIdx) / static_cast<float>(LUT_SPIN_SAMPLES - 1) * (SPIN_MAX - SPIN_MIN);
+        for (const int inclIdx : inclIndices) {
+            const float inclination = INCLINATION_MIN + static_cast<float>(inclIdx) / static_cast<float>(LUT_INCLINATION_SAMPLES - 1) * (INCLINATION_MAX - INCLINATION_MIN);
+            for (int impactIdx = 0; impactIdx < LUT_IMPACT_PARAM_SAMPLES; impactIdx++) {
+                const float impactParam = IMPACT_MIN + static_cast<float>(impactIdx) / static_cast<float>(LUT_IMPACT_PARAM_SAMPLES - 1) * (IMPACT_MAX - IMPACT_MIN);
+                if (impactParam > WEAK_FIELD_IMPACT_PARAM) {
+                    continue;  // Weak-field closed form, nothing integrated
+                }
+
+                const GeodesicResult reference = integrateGeodesic(spin, impactParam, inclination, spinAxis, referenceControl);
+
+                const auto tAdaptive = Clock::now();
+                const GeodesicResult adaptive = integrateGeodesic(spin, impactParam, inclination, spinAxis, control);
+                adaptiveMs += std::chrono::duration<double, std::milli>(Clock::now() - tAdaptive).count();
+
+                int steps = 0;
+                const auto tEuler = Clock::now();
+                const float eulerDeflection = legacyEuler(impactParam, spin, steps);
+                eulerMs += std::chrono::duration<double, std::milli>(Clock::now() - tEuler).count();
+
+                const double adaptiveError = std::abs(adaptive.deflectionAngle - reference.deflectionAngle);
+                const double eulerError = std::abs(eulerDeflection - reference.deflectionAngle);
+                adaptiveMaxError = std::max(adaptiveMaxError, adaptiveError);
+                adaptiveErrorSum += adaptiveError;
+                eulerMaxError = std::max(eulerMaxError, eulerError);
+                eulerErrorSum += eulerError;
+                adaptiveSteps += adaptive.integrationSteps + adaptive.rejectedSteps;
+                eulerSteps += steps;
+                integratedSamples++;
+            }
+        }
+    }
+
+    if (integratedSamples == 0) {
+        return;
+    }
+    const double n = static_cast<double>(integratedSamples);
+    spdlog::info("  Subset of {} integrated samples vs reference (rtol={}):", integratedSamples, referenceControl.relTolerance);
+    spdlog::info("    DP5(4):       {:.1f} steps/sample (6 evals each), {:.3f} ms, deflection error max {:.3e} mean {:.3e}",
+                 static_cast<double>(adaptiveSteps) / n, adaptiveMs, adaptiveMaxError, adaptiveErrorSum / n);
+    spdlog::info("    Euler (0.05): {:.1f} steps/sample (1 eval each), {:.3f} ms, deflection error max {:.3e} mean {:.3e}",
+                 static_cast<double>(eulerSteps) / n, eulerMs, eulerMaxError, eulerErrorSum / n);
+
+    // Batched kernels on the same slabs, checked against the scalar path
+    std::array<float, LUT_IMPACT_PARAM_SAMPLES> impactParams;
+    for (int impactIdx = 0; impactIdx < LUT_IMPACT_PARAM_SAMPLES; impactIdx++) {
+        impactParams[impactIdx] = IMPACT_MIN + static_cast<float>(impactIdx) / static_cast<float>(LUT_IMPACT_PARAM_SAMPLES - 1) * (IMPACT_MAX - IMPACT_MIN);
+    }
+
+    const auto runSlabs = [&](GeodesicKernel kernel, std::vector<GeodesicResult>& results) {
+        results.resize(std::size(spinIndices) * std::size(inclIndices) * LUT_IMPACT_PARAM_SAMPLES);
+        GeodesicResult* out = results.data();
+        const auto tStart = Clock::now();
+        for (const int spinIdx : spinIndices) {
+            const float spin = SPIN_MIN + static_cast<float>(spinIdx) / static_cast<float>(LUT_SPIN_SAMPLES - 1) * (SPIN_MAX - SPIN_MIN);
+            for (const int inclIdx : inclIndices) {
+                const float inclination = INCLINATION_MIN + static_cast<float>(inclIdx) / static_cast<float>(LUT_INCLINATION_SAMPLES - 1) * (INCLINATION_MAX - INCLINATION_MIN);
+                integrateGeodesicBatch(spin, inclination, impactParams.data(), impactParams.size(), control, out, kernel);
+                out += LUT_IMPACT_PARAM_SAMPLES;
+            }
+        }
+        return std::chrono::duration<double, std::milli>(Clock::now() - tStart).count();
+    };
+
+    std::vector<GeodesicResult> scalarResults;
+    const double scalarMs = runSlabs(GeodesicKernel::Scalar, scalarResults);
+    spdlog::info("  Batched slabs ({} samples):", scalarResults.size());
+    spdlog::info("    scalar:  {:.3f} ms", scalarMs);
+
+    const CpuFeatures& cpu = CpuFeatures::Get();
+    const std::pair<GeodesicKernel, bool> simdKernels[] = {
+        {GeodesicKernel::AVX2, cpu.avx2 && KerrGeodesicBatch::GetKernelAVX2()},
+        {GeodesicKernel::AVX512, cpu.avx512f && KerrGeodesicBatch::GetKernelAVX512()},
+    };
+    for (const auto& [kernel, available] : simdKernels) {
+        if (!available) {
+            spdlog::info("    {}: not available", geodesicKernelName(kernel));
+            continue;
+        }
+
+        std::vector<GeodesicResult> results;
+        const double ms = runSlabs(kernel, results);
+        double maxDeflectionDelta = 0.0, maxRedshiftDelta = 0.0;
+        int captureMismatches = 0;
+        for (size_t i = 0; i < results.size(); i++) {
+            maxDeflectionDelta = std::max(maxDeflectionDelta, static_cast<double>(std::abs(results[i].deflectionAngle - scalarResults[i].deflectionAngle)));
+            maxRedshiftDelta = std::max(maxRedshiftDelta, static_cast<double>(std::abs(results[i].redshiftFactor - scalarResults[i].redshiftFactor)));
+            captureMismatches += results[i].capturedByHorizon != scalarResults[i].capturedByHorizon ? 1 : 0;
+        }
+        spdlog::info("    {}: {:.3f} ms ({:.2f}x), vs scalar: deflection max {:.3e}, redshift max {:.3e}, {} capture mismatches",
+                     geodesicKernelName(kernel), ms, scalarMs / ms, maxDeflectionDelta, maxRedshiftDelta, captureMismatches);
+    }
+}
+
 } // namespace MoleHole
 
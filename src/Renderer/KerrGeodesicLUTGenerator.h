@@ -1,7 +1,12 @@
 #pragma once
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 #include <glm/glm.hpp>
 
+#include "KerrGeodesicBatch.h"
+#include "MathTools/AdaptiveIntegrator.h"
+
 namespace MoleHole {
 
 /**
@@ -31,6 +36,19 @@ public:
     static constexpr float INCLINATION_MIN = 0.0f;      // Equatorial
     static constexpr float INCLINATION_MAX = 3.14159f;  // Polar (π radians)
 
+    // Geodesic integration tolerances (Dormand-Prince 5(4), per-sample error control)
+    static constexpr double RELATIVE_TOLERANCE = 1e-6;
+    static constexpr double ABSOLUTE_TOLERANCE = 1e-8;
+    static constexpr double MAX_AFFINE_PARAMETER = 500.0;  // Matches the old 10000 x 0.05 Euler budget
+
+    // Bump whenever integrateGeodesic() or the photon sphere / ISCO formulas change
+    static constexpr uint32_t GENERATOR_VERSION = 2;
+
+    /**
+     * @brief Code path of integrateGeodesicBatch(), SIMD paths integrate one impact parameter per lane
+     */
+    enum class GeodesicKernel { Scalar, AVX2, AVX512 };
+
     struct GeodesicResult {
         float deflectionAngle;      // Total deflection angle (radians)
         float redshiftFactor;       // Gravitational + Doppler redshift
@@ -38,19 +56,32 @@ public:
         bool capturedByHorizon;     // Whether photon was captured
         int orbitCount;             // Number of orbits before escaping/capture
         float closestApproach;      // Minimum radius achieved
+        int integrationSteps;       // Accepted integrator steps
+        int rejectedSteps;          // Steps rejected by error control
     };
 
     /**
-     * @brief Generate 3D LUT for geodesic deflection
-     * @return Flat array: [spin][inclination][impactParam] -> deflectionAngle
+     * @brief Per-sample output channels of the 3D geodesic LUTs
+     *
+     * All channels share the layout [spin][inclination][impactParam] and are filled from a
+     * single geodesic integration per sample.
      */
-    static std::vector<float> generateDeflectionLUT();
+    struct GeodesicLUTs {
+        std::vector<float> deflection;  // Total deflection angle (radians)
+        std::vector<float> redshift;    // Gravitational redshift factor
+
+        uint64_t integrationSteps = 0;  // Accepted integrator steps over all samples
+        uint64_t rejectedSteps = 0;     // Rejected integrator steps over all samples
+    };
 
     /**
-     * @brief Generate 3D LUT for redshift factors
-     * @return Flat array: [spin][inclination][impactParam] -> redshiftFactor
+     * @brief Generate all 3D geodesic LUTs in one pass
+     *
+     * Each (spin, inclination) slab of impact parameters is an independent work item that is
+     * distributed over the global work-stealing thread pool.
+     * @return Deflection and redshift channels, flat arrays [spin][inclination][impactParam]
      */
-    static std::vector<float> generateRedshiftLUT();
+    static GeodesicLUTs generateGeodesicLUTs();
 
     /**
      * @brief Generate 2D LUT for photon sphere radius
@@ -64,17 +95,75 @@ public:
      */
     static std::vector<float> generateISCOLUT();
 
+    /**
+     * @brief LUT cache key shared by all Kerr LUTs
+     * @return Hash of GENERATOR_VERSION, the LUT dimensions and the physical ranges
+     */
+    static uint64_t cacheKey();
+
+    /**
+     * @brief Time the full geodesic LUT and compare its accuracy against a tight-tolerance reference
+     *
+     * GPU-free, run with --benchmark-kerr-lut. Reports wall time and step counts of the
+     * production integrator and of the previous fixed-step Euler scheme on a sample subset.
+     */
+    static void runBenchmark();
+
 private:
+    // Beyond this impact parameter the closed-form weak-field deflection is used
+    static constexpr float WEAK_FIELD_IMPACT_PARAM = 10.0f;
+
+    /**
+     * @brief Integrate every impact parameter of one (spin, inclination) slab
+     * @param slabIndex spinIdx * LUT_INCLINATION_SAMPLES + inclIdx
+     * @param kernel Code path for the slab's impact parameters
+     * @param luts Output LUTs, only the slab's LUT_IMPACT_PARAM_SAMPLES entries are written
+     */
+    static AdaptiveIntegrationStats generateGeodesicSlab(size_t slabIndex, GeodesicKernel kernel, GeodesicLUTs& luts);
+
     /**
-     * @brief Integrate photon geodesic in Kerr spacetime using RK4
+     * @brief Widest geodesic kernel supported by both this build and the CPU, detected once
+     */
+    static GeodesicKernel bestGeodesicKernel();
+    static const char* geodesicKernelName(GeodesicKernel kernel);
+
+    /**
+     * @brief Default step control for one LUT sample
+     */
+    static AdaptiveStepControl defaultStepControl();
+
+    /**
+     * @brief Integrate photon geodesic in Kerr spacetime with adaptive Dormand-Prince 5(4)
      * @param spin Black hole spin parameter (0 to 0.998)
      * @param impactParameter Impact parameter in units of r_s
      * @param inclination Observer inclination angle (radians)
      * @param spinAxis Spin axis direction (normalized)
+     * @param control Tolerances and step limits for this sample
      * @return Geodesic integration result
      */
     static GeodesicResult integrateGeodesic(float spin, float impactParameter,
-                                           float inclination, const glm::vec3& spinAxis);
+                                           float inclination, const glm::vec3& spinAxis,
+                                           const AdaptiveStepControl& control);
+
+    /**
+     * @brief Integrate many impact parameters at one spin and inclination
+     *
+     * The SIMD kernels keep one ray per lane in SoA layout, each with its own step size, and
+     * refill lanes as rays are captured or escape. Results match integrateGeodesic() within the
+     * integration tolerance; the kernels only differ in the step size controller's pow().
+     * Falls back to integrateGeodesic() when the requested kernel is not compiled in.
+     * @param results Output, one per impact parameter
+     */
+    static void integrateGeodesicBatch(float spin, float inclination, const float* impactParameters, size_t count,
+                                       const AdaptiveStepControl& control, GeodesicResult* results,
+                                       GeodesicKernel kernel);
+
+    static GeodesicResult weakFieldResult(float impactParameter);
+
+    /**
+     * @brief Convert a finished ray into a LUT sample (deflection, redshift, orbit count)
+     */
+    static GeodesicResult finishGeodesic(const KerrGeodesicBatch::RayEnd& end, double minRadius);
 
     /**
      * @brief Calculate Kerr metric coefficients at given position
@@ -113,12 +202,6 @@ private:
      */
     static float calculateISCORadius(float spin);
 
-    /**
-     * @brief RK4 integrator for geodesic equations
-     */
-    static void rk4Step(float* state, int stateSize, float spin, float dt,
-                       void (*derivatives)(float*, float*, float, float));
-
     /**
      * @brief Geodesic equations in Boyer-Lindquist coordinates
      */
@@ -0,0 +1,285 @@
+#include "LUTCache.h"
+#include <spdlog/spdlog.h>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "Application/ParameterRegistry.h"
+
+namespace MoleHole {
+
+namespace {
+struct LUTCacheHeader {
+    char magic[8];        // "MHLUT\0\0\0"
+    uint32_t version;     // file format version
+    uint32_t reserved;
+    uint64_t key;         // LUTCacheKey::Value() of the generator
+    uint64_t floatCount;  // number of floats following the header
+};
+
+constexpr uint32_t LUT_CACHE_FORMAT_VERSION = 1;
+constexpr char LUT_CACHE_MAGIC[8] = {'M', 'H', 'L', 'U', 'T', '\0', '\0', '\0'};
+}
+
+LUTCacheKey::LUTCacheKey(std::string_view generatorTag, uint32_t generatorVersion)
+    : m_Hash(RuntimeFnv1a(generatorTag)) {
+    Add(generatorVersion);
+    Add(LUT_CACHE_FORMAT_VERSION);
+}
+
+void LUTCacheKey::AddBytes(const void* data, size_t size) {
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; i++) {
+        m_Hash ^= bytes[i];
+        m_Hash *= FnvPrime;
+    }
+}
+
+LUTData::LUTData(std::vector<float> data)
+    : m_Owned(std::move(data)) {
+    m_Data = m_Owned.data();
+    m_Count = m_Owned.size();
+}
+
+LUTData::~LUTData() {
+    Release();
+}
+
+LUTData::LUTData(LUTData&& other) noexcept {
+    *this = std::move(other);
+}
+
+LUTData& LUTData::operator=(LUTData&& other) noexcept {
+    if (this == &other) {
+        return *this;
+    }
+    Release();
+
+    m_Owned = std::move(other.m_Owned);
+    m_Count = other.m_Count;
+    m_Mapping = other.m_Mapping;
+    m_MappingSize = other.m_MappingSize;
+    m_Data = m_Mapping ? other.m_Data : m_Owned.data();
+#ifdef _WIN32
+    m_FileHandle = other.m_FileHandle;
+    m_MappingHandle = other.m_MappingHandle;
+    other.m_FileHandle = nullptr;
+    other.m_MappingHandle = nullptr;
+#endif
+
+    other.m_Data = nullptr;
+    other.m_Count = 0;
+    other.m_Mapping = nullptr;
+    other.m_MappingSize = 0;
+    return *this;
+}
+
+void LUTData::Release() {
+    if (m_Mapping) {
+#ifdef _WIN32
+        UnmapViewOfFile(m_Mapping);
+        if (m_MappingHandle) CloseHandle(m_MappingHandle);
+        if (m_FileHandle) CloseHandle(m_FileHandle);
+        m_MappingHandle = nullptr;
+        m_FileHandle = nullptr;
+#else
+        munmap(m_Mapping, m_MappingSize);
+#endif
+        m_Mapping = nullptr;
+        m_MappingSize = 0;
+    }
+    m_Owned.clear();
+    m_Data = nullptr;
+    m_Count = 0;
+}
+
+std::string LUTCache::GetCacheDir() {
+    return ".lut_cache";
+}
+
+void LUTCache::EnsureCacheDirExists() {
+    namespace fs = std::filesystem;
+    fs::path cacheDir = GetCacheDir();
+
+    if (!fs::exists(cacheDir)) {
+        std::error_code ec;
+        if (!fs::create_directories(cacheDir, ec)) {
+            spdlog::warn("Failed to create LUT cache directory: {}, error: {}", cacheDir.string(), ec.message());
+        }
+    } else if (!fs::is_directory(cacheDir)) {
+        spdlog::error("LUT cache path exists but is not a directory: {}", cacheDir.string());
+    }
+}
+
+std::string LUTCache::GetCachePath(std::string_view name, uint64_t key) {
+    std::stringstream ss;
+    ss << GetCacheDir() << "/" << name << "_" << std::hex << std::setfill('0') << std::setw(16) << key << ".bin";
+    return ss.str();
+}
+
+void LUTCache::RemoveStaleEntries(std::string_view name, uint64_t key) {
+    namespace fs = std::filesystem;
+    const std::string prefix = std::string(name) + "_";
+    const std::string current = fs::path(GetCachePath(name, key)).filename().string();
+
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator(GetCacheDir(), ec)) {
+        const std::string fileName = entry.path().filename().string();
+        // Only "<name>_<16 hex digits>.bin", so "kerr" never deletes "kerr_redshift_..." entries
+        if (fileName.size() != prefix.size() + 16 + 4 || !fileName.starts_with(prefix) ||
+            !fileName.ends_with(".bin") || fileName == current) {
+            continue;
+        }
+        std::error_code removeEc;
+        fs::remove(entry.path(), removeEc);
+        if (!removeEc) {
+            spdlog::debug("Removed stale LUT cache entry: {}", entry.path().string());
+        }
+    }
+}
+
+std::optional<LUTData> LUTCache::Load(std::string_view name, uint64_t key, size_t expectedCount) {
+    const std::string path = GetCachePath(name, key);
+    const size_t expectedSize = sizeof(LUTCacheHeader) + expectedCount * sizeof(float);
+
+    LUTData lut;
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return std::nullopt;
+    }
+    LARGE_INTEGER fileSize{};
+    if (!GetFileSizeEx(file, &fileSize) || static_cast<size_t>(fileSize.QuadPart) != expectedSize) {
+        CloseHandle(file);
+        spdlog::warn("Ignoring LUT cache entry with unexpected size: {}", path);
+        return std::nullopt;
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!view) {
+        if (mapping) CloseHandle(mapping);
+        CloseHandle(file);
+        spdlog::warn("Failed to map LUT cache entry: {}", path);
+        return std::nullopt;
+    }
+    lut.m_FileHandle = file;
+    lut.m_MappingHandle = mapping;
+    lut.m_Mapping = view;
+#else
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return std::nullopt;
+    }
+    struct stat fileStat{};
+    if (fstat(fd, &fileStat) != 0 || static_cast<size_t>(fileStat.st_size) != expectedSize) {
+        close(fd);
+        spdlog::warn("Ignoring LUT cache entry with unexpected size: {}", path);
+        return std::nullopt;
+    }
+    void* view = mmap(nullptr, expectedSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (view == MAP_FAILED) {
+        spdlog::warn("Failed to map LUT cache entry: {}", path);
+        return std::nullopt;
+    }
+    lut.m_Mapping = view;
+#endif
+    lut.m_MappingSize = expectedSize;
+
+    LUTCacheHeader hdr{};
+    std::memcpy(&hdr, lut.m_Mapping, sizeof(hdr));
+    if (std::memcmp(hdr.magic, LUT_CACHE_MAGIC, sizeof(hdr.magic)) != 0 ||
+        hdr.version != LUT_CACHE_FORMAT_VERSION || hdr.key != key || hdr.floatCount != expectedCount) {
+        spdlog::warn("Ignoring invalid LUT cache entry: {}", path);
+        return std::nullopt;
+    }
+
+    lut.m_Data = reinterpret_cast<const float*>(static_cast<const char*>(lut.m_Mapping) + sizeof(LUTCacheHeader));
+    lut.m_Count = expectedCount;
+    return lut;
+}
+
+void LUTCache::Store(std::string_view name, uint64_t key, const std::vector<float>& data) {
+    EnsureCacheDirExists();
+
+    const std::filesystem::path path = GetCachePath(name, key);
+    std::filesystem::path tempPath = path;
+    tempPath += ".tmp";
+
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            spdlog::warn("Failed to open LUT cache entry for writing: {}", tempPath.string());
+            return;
+        }
+
+        LUTCacheHeader hdr{};
+        std::memcpy(hdr.magic, LUT_CACHE_MAGIC, sizeof(hdr.magic));
+        hdr.version = LUT_CACHE_FORMAT_VERSION;
+        hdr.key = key;
+        hdr.floatCount = data.size();
+        out.write(reinterpret_cast<const char*>(&hdr), sizeof(hdr));
+        out.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size() * sizeof(float)));
+
+        if (!out) {
+            spdlog::warn("Failed to write LUT cache entry: {}", tempPath.string());
+            out.close();
+            std::error_code ec;
+            std::filesystem::remove(tempPath, ec);
+            return;
+        }
+    }
+
+    // Rename into place so concurrent batch jobs never map a half-written file
+    std::error_code ec;
+    std::filesystem::rename(tempPath, path, ec);
+    if (ec) {
+        spdlog::warn("Failed to move LUT cache entry into place: {}: {}", path.string(), ec.message());
+        std::filesystem::remove(tempPath, ec);
+        return;
+    }
+
+    RemoveStaleEntries(name, key);
+    spdlog::info("Wrote LUT cache: {} ({} floats)", path.string(), data.size());
+}
+
+LUTData LUTCache::LoadOrGenerate(std::string_view name, uint64_t key, size_t expectedCount,
+                                 const std::function<std::vector<float>()>& generate) {
+    const auto tStart = std::chrono::steady_clock::now();
+    if (auto cached = Load(name, key, expectedCount)) {
+        const auto tEnd = std::chrono::steady_clock::now();
+        const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(tEnd - tStart).count();
+        spdlog::info("Loaded {} LUT from cache in {} ms", name, ms);
+        return std::move(*cached);
+    }
+
+    std::vector<float> data = generate();
+    if (data.size() != expectedCount) {
+        spdlog::error("{} LUT generator produced {} floats, expected {}; not caching", name, data.size(), expectedCount);
+        return LUTData(std::move(data));
+    }
+
+    Store(name, key, data);
+    return LUTData(std::move(data));
+}
+
+} // namespace MoleHole
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace MoleHole {
+
+/**
+ * @brief Hash of everything a generated LUT depends on
+ *
+ * Generators feed their version tag and every constant that shapes the table (sample counts,
+ * physical ranges, spectral tables) into the key, so changing any of them invalidates the cache.
+ */
+class LUTCacheKey {
+public:
+    LUTCacheKey(std::string_view generatorTag, uint32_t generatorVersion);
+
+    template<typename T>
+        requires std::is_trivially_copyable_v<T>
+    LUTCacheKey& Add(const T& value) {
+        AddBytes(&value, sizeof(T));
+        return *this;
+    }
+
+    template<typename T>
+        requires std::is_trivially_copyable_v<T>
+    LUTCacheKey& Add(const std::vector<T>& values) {
+        Add(values.size());
+        AddBytes(values.data(), values.size() * sizeof(T));
+        return *this;
+    }
+
+    uint64_t Value() const { return m_Hash; }
+
+private:
+    void AddBytes(const void* data, size_t size);
+
+    uint64_t m_Hash;
+};
+
+/**
+ * @brief LUT contents, either freshly generated (owned) or memory-mapped from the cache file
+ */
+class LUTData {
+public:
+    LUTData() = default;
+    explicit LUTData(std::vector<float> data);
+    ~LUTData();
+
+    LUTData(LUTData&& other) noexcept;
+    LUTData& operator=(LUTData&& other) noexcept;
+    LUTData(const LUTData&) = delete;
+    LUTData& operator=(const LUTData&) = delete;
+
+    const float* Data() const { return m_Data; }
+    size_t Size() const { return m_Count; }
+    bool IsMapped() const { return m_Mapping != nullptr; }
+
+private:
+    friend class LUTCache;
+
+    void Release();
+
+    std::vector<float> m_Owned;
+    const float* m_Data = nullptr;
+    size_t m_Count = 0;
+
+    void* m_Mapping = nullptr;
+    size_t m_MappingSize = 0;
+#ifdef _WIN32
+    void* m_FileHandle = nullptr;
+    void* m_MappingHandle = nullptr;
+#endif
+};
+
+/**
+ * @brief Versioned on-disk cache for physics LUTs
+ *
+ * Works like the shader binary cache and the GLTF geometry cache: one binary file per LUT in
+ * .lut_cache/, named after the LUT and its content key. Loads are memory-mapped and uploaded
+ * straight from the mapping, so a warm start skips generation entirely.
+ */
+class LUTCache {
+public:
+    static std::optional<LUTData> Load(std::string_view name, uint64_t key, size_t expectedCount);
+    static void Store(std::string_view name, uint64_t key, const std::vector<float>& data);
+
+    static LUTData LoadOrGenerate(std::string_view name, uint64_t key, size_t expectedCount,
+                                  const std::function<std::vector<float>()>& generate);
+
+private:
+    static std::string GetCacheDir();
+    static void EnsureCacheDirExists();
+    static std::string GetCachePath(std::string_view name, uint64_t key);
+    static void RemoveStaleEntries(std::string_view name, uint64_t key);
+};
+
+} // namespace MoleHole
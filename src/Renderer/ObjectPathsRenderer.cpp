@@ -27,12 +27,10 @@ void ObjectPathsRenderer::RecordCurrentPositions(Scene* scene) {
         m_cachedScene = scene;
     }
 
-    size_t meshCount = 0;
-    size_t sphereCount = 0;
-    for (const auto& obj : scene->objects) {
-        if (obj.HasClass("Mesh")) meshCount++;
-        if (obj.HasClass("Sphere")) sphereCount++;
-    }
+    const auto& meshes = scene->ObjectsOf(ObjectClasses::Mesh);
+    const auto& spheres = scene->ObjectsOf(ObjectClasses::Sphere);
+    const size_t meshCount = meshes.size();
+    const size_t sphereCount = spheres.size();
 
     if (m_meshHistories.size() != meshCount) {
         m_meshHistories.resize(meshCount);
@@ -42,39 +40,25 @@ void ObjectPathsRenderer::RecordCurrentPositions(Scene* scene) {
         m_sphereHistories.resize(sphereCount);
     }
 
-    size_t meshIdx = 0;
-    for (const auto& obj : scene->objects) {
-        if (obj.HasClass("Mesh") && meshIdx < m_meshHistories.size()) {
-            ParameterHandle posHandle("Entity.Position");
-            auto pos = obj.GetParameter(posHandle);
-
-            if (std::holds_alternative<glm::vec3>(pos)) {
-                auto& history = m_meshHistories[meshIdx];
-                history.positions.push_back(std::get<glm::vec3>(pos));
+    for (size_t meshIdx = 0; meshIdx < meshes.size(); meshIdx++) {
+        if (const auto* pos = scene->objects[meshes[meshIdx]].Find<glm::vec3>(HotField::Position)) {
+            auto& history = m_meshHistories[meshIdx];
+            history.positions.push_back(*pos);
 
-                if (history.positions.size() > m_maxHistorySize) {
-                    history.positions.pop_front();
-                }
+            if (history.positions.size() > m_maxHistorySize) {
+                history.positions.pop_front();
             }
-            meshIdx++;
         }
     }
 
-    size_t sphereIdx = 0;
-    for (const auto& obj : scene->objects) {
-        if (obj.HasClass("Sphere") && sphereIdx < m_sphereHistories.size()) {
-            ParameterHandle posHandle("Entity.Position");
-            auto pos = obj.GetParameter(posHandle);
-
-            if (std::holds_alternative<glm::vec3>(pos)) {
-                auto& history = m_sphereHistories[sphereIdx];
-                history.positions.push_back(std::get<glm::vec3>(pos));
+    for (size_t sphereIdx = 0; sphereIdx < spheres.size(); sphereIdx++) {
+        if (const auto* pos = scene->objects[spheres[sphereIdx]].Find<glm::vec3>(HotField::Position)) {
+            auto& history = m_sphereHistories[sphereIdx];
+            history.positions.push_back(*pos);
 
-                if (history.positions.size() > m_maxHistorySize) {
-                    history.positions.pop_front();
-                }
+            if (history.positions.size() > m_maxHistorySize) {
+                history.positions.pop_front();
             }
-            sphereIdx++;
         }
     }
 }
@@ -44,13 +44,15 @@ extern "C" {
 #endif
 
 void Renderer::Init() {
-    Init(false);
+    if (!Init(false)) {
+        exit(-1);
+    }
 }
 
-void Renderer::Init(bool headless) {
+bool Renderer::Init(bool headless) {
     if (!glfwInit()) {
         spdlog::error("Failed to initialize GLFW");
-        exit(-1);
+        return false;
     }
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
@@ -65,14 +67,17 @@ void Renderer::Init(bool headless) {
     if (!window) {
         spdlog::error("Failed to create GLFW window");
         glfwTerminate();
-        exit(-1);
+        return false;
     }
     glfwMakeContextCurrent(window);
 
     int version = gladLoadGL(glfwGetProcAddress);
     if (version == 0) {
         spdlog::error("Failed to initialize GLAD");
-        exit(-1);
+        glfwDestroyWindow(window);
+        glfwTerminate();
+        window = nullptr;
+        return false;
     }
 
     spdlog::info("Loaded OpenGL {0}.{1}", GLAD_VERSION_MAJOR(version), GLAD_VERSION_MINOR(version));
@@ -114,6 +119,7 @@ void Renderer::Init(bool headless) {
 
     blackHoleRenderer = std::make_unique<BlackHoleRenderer>();
     blackHoleRenderer->Init(last_img_width, last_img_height);
+    m_sceneBodies = std::make_unique<SceneBodyBuffer>();
 
     int width, height;
     glfwGetFramebufferSize(window, &width, &height);
@@ -135,9 +141,14 @@ void Renderer::Init(bool headless) {
     m_physicsDebugRenderer->Init();
 
     InitSphereGeometry();
+    return true;
 }
 
 void Renderer::Shutdown() {
+    if (!window) {
+        return;
+    }
+
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplGlfw_Shutdown();
     ImGui::DestroyContext();
@@ -483,13 +494,23 @@ void Renderer::InitSphereGeometry() {
     glBindVertexArray(0);
 }
 
+void Renderer::RunUniformBenchmark(Scene* scene) {
+    if (!scene || !blackHoleRenderer || !camera) {
+        spdlog::error("Uniform benchmark needs an initialized renderer and a loaded scene");
+        return;
+    }
+    m_sceneBodies->Upload(*scene);
+    blackHoleRenderer->RunUniformBenchmark(*scene, m_meshCache, *camera);
+}
+
 void Renderer::Render2DRays(Scene *scene) {
     glClearColor(0.2f, 0.2f, 0.2f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT);
     if (!scene) return;
 
-    float currentTime = static_cast<float>(glfwGetTime());
+    float currentTime = AnimationTime();
 
+    m_sceneBodies->Upload(*scene);
     blackHoleRenderer->Render(*scene, m_meshCache, *camera, currentTime);
 }
 
@@ -505,18 +526,17 @@ void Renderer::Render3DSimulation(Scene *scene) {
         scene->reloadSkybox = false;
     }
 
-    float currentTime = static_cast<float>(glfwGetTime());
+    float currentTime = AnimationTime();
 
         // Pre-load meshes into cache before rendering
-    for (const auto& obj : scene->objects) {
-        if (obj.HasClass("Mesh")) {
-            ParameterHandle pathHandle("Mesh.FilePath");
-            auto pathValue = obj.GetParameter(pathHandle);
-            if (std::holds_alternative<std::string>(pathValue)) {
-                std::string meshPath = std::get<std::string>(pathValue);
-                if (!meshPath.empty() && m_meshCache.find(meshPath) == m_meshCache.end()) {
-                    GetOrLoadMesh(meshPath);
-                }
+    for (const uint32_t index : scene->ObjectsOf(ObjectClasses::Mesh)) {
+        const auto& obj = scene->objects[index];
+        ParameterHandle pathHandle("Mesh.FilePath");
+        auto pathValue = obj.GetParameter(pathHandle);
+        if (std::holds_alternative<std::string>(pathValue)) {
+            std::string meshPath = std::get<std::string>(pathValue);
+            if (!meshPath.empty() && m_meshCache.find(meshPath) == m_meshCache.end()) {
+                GetOrLoadMesh(meshPath);
             }
         }
     }
@@ -525,6 +545,7 @@ void Renderer::Render3DSimulation(Scene *scene) {
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
+    m_sceneBodies->Upload(*scene);
     blackHoleRenderer->Render(*scene, m_meshCache, *camera, currentTime);
     blackHoleRenderer->RenderToScreen();
 
@@ -710,8 +731,9 @@ void Renderer::SetViewportBounds(float x, float y, float width, float height) {
     m_viewportHeight = height;
 }
 
-void Renderer::RenderToFramebuffer(unsigned int fbo, int width, int height, Scene* scene, Camera* cam) {
+void Renderer::RenderToFramebuffer(unsigned int fbo, int width, int height, Scene* scene, Camera* cam, float time) {
     if (!cam) return;
+    m_timeOverride = time;
     
     Camera* savedCamera = camera.get();
     camera.release();
@@ -751,11 +773,17 @@ void Renderer::RenderToFramebuffer(unsigned int fbo, int width, int height, Scen
 
     camera.release();
     camera.reset(savedCamera);
+    m_timeOverride = -1.0f;
 
     glBindFramebuffer(GL_FRAMEBUFFER, oldFBO);
     glViewport(oldViewport[0], oldViewport[1], oldViewport[2], oldViewport[3]);
 }
 
+float Renderer::AnimationTime() const {
+    // Exports pass the simulation time so separately rendered frame ranges animate identically
+    return m_timeOverride >= 0.0f ? m_timeOverride : static_cast<float>(glfwGetTime());
+}
+
 void Renderer::RenderMeshes(Scene* scene) {
     if (!scene || !camera) return;
 
@@ -764,9 +792,9 @@ void Renderer::RenderMeshes(Scene* scene) {
         std::string defaultMeshName = "";
         std::string meshName = Application::Params().Get(Params::CameraObject, defaultMeshName);
 
-        for (auto& obj : scene->objects)
+        for (const uint32_t index : scene->ObjectsOf(ObjectClasses::Mesh))
         {
-            if (!obj.HasClass("Mesh")) continue;
+            auto& obj = scene->objects[index];
 
             ParameterHandle nameHandle("Entity.Name");
             auto nameValue = obj.GetParameter(nameHandle);
@@ -814,8 +842,8 @@ void Renderer::RenderMeshes(Scene* scene) {
         }
     }
 
-    for (const auto& obj : scene->objects) {
-        if (!obj.HasClass("Mesh")) continue;
+    for (const uint32_t index : scene->ObjectsOf(ObjectClasses::Mesh)) {
+        const auto& obj = scene->objects[index];
 
         ParameterHandle pathHandle("Mesh.FilePath");
         ParameterHandle posHandle("Entity.Position");
@@ -849,13 +877,7 @@ void Renderer::RenderMeshes(Scene* scene) {
 void Renderer::RenderSpheres(Scene * scene) {
     if (!scene || !camera) return;
 
-    bool hasSpheres = false;
-    for (const auto& obj : scene->objects) {
-        if (obj.HasClass("Sphere")) {
-            hasSpheres = true;
-            break;
-        }
-    }
+    const bool hasSpheres = !scene->ObjectsOf(ObjectClasses::Sphere).empty();
     if (!hasSpheres) return;
 
     if (blackHoleRenderer) {
@@ -865,27 +887,22 @@ void Renderer::RenderSpheres(Scene * scene) {
         glBindTexture(GL_TEXTURE_2D, blackHoleRenderer->GetHRDiagramLUT());
     }
     
-    for (const auto& obj : scene->objects) {
-        if (!obj.HasClass("Sphere")) continue;
+    for (const uint32_t index : scene->ObjectsOf(ObjectClasses::Sphere)) {
+        const auto& obj = scene->objects[index];
 
-        ParameterHandle posHandle("Entity.Position");
-        ParameterHandle radiusHandle("Sphere.Radius");
-        ParameterHandle colorHandle("Sphere.Color");
-        ParameterHandle massHandle("Sphere.Mass");
-
-        auto posValue = obj.GetParameter(posHandle);
-        auto radiusValue = obj.GetParameter(radiusHandle);
-        auto colorValue = obj.GetParameter(colorHandle);
-        auto massValue = obj.GetParameter(massHandle);
+        const auto* posValue = obj.Find<glm::vec3>(HotField::Position);
+        const auto* radiusValue = obj.Find<float>(HotField::Radius);
+        const auto* colorValue = obj.Find<glm::vec3>(Field::Sphere::Color);
+        const auto* massValue = obj.Find<float>(Field::Sphere::Mass);
 
-        if (!std::holds_alternative<glm::vec3>(posValue) || !std::holds_alternative<float>(radiusValue)) {
+        if (!posValue || !radiusValue) {
             continue;
         }
 
-        glm::vec3 position = std::get<glm::vec3>(posValue);
-        float radius = std::get<float>(radiusValue);
-        glm::vec3 color = std::holds_alternative<glm::vec3>(colorValue) ? std::get<glm::vec3>(colorValue) : glm::vec3(0.5f);
-        float mass = std::holds_alternative<float>(massValue) ? std::get<float>(massValue) : 1.0f;
+        glm::vec3 position = *posValue;
+        float radius = *radiusValue;
+        glm::vec3 color = colorValue ? *colorValue : glm::vec3(0.5f);
+        float mass = massValue ? *massValue : 1.0f;
 
         glm::mat4 model = glm::translate(glm::mat4(1.0f), position);
         model = glm::scale(model, glm::vec3(radius));
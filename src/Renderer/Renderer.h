@@ -12,6 +12,7 @@
 #include "Camera.h"
 #include "Input.h"
 #include "GravityGridRenderer.h"
+#include "SceneBodyBuffer.h"
 #include "ObjectPathsRenderer.h"
 
 class PhysicsDebugRenderer;
@@ -25,7 +26,8 @@ public:
         Simulation3D = 2
     };
     void Init();
-    void Init(bool headless);
+    // false when no window / OpenGL context could be created
+    bool Init(bool headless);
     void Shutdown();
     void BeginFrame();
     void EndFrame(bool clearScreen = true);
@@ -42,7 +44,11 @@ public:
     glm::vec3 ScreenToWorldRay(float mouseX, float mouseY, glm::vec3& rayOrigin, glm::vec3& rayDirection);
     void SetViewportBounds(float x, float y, float width, float height);
 
-    void RenderToFramebuffer(unsigned int fbo, int width, int height, Scene* scene, Camera* cam);
+    // time drives the shader animation; negative uses the wall clock like the viewport
+    void RenderToFramebuffer(unsigned int fbo, int width, int height, Scene* scene, Camera* cam, float time = -1.0f);
+
+    // Times BlackHoleRenderer::UpdateUniforms, run with --benchmark-uniforms
+    void RunUniformBenchmark(Scene* scene);
 
     GLFWwindow* GetWindow() const { return window; }
 
@@ -93,6 +99,7 @@ private:
     void RenderMeshes(Scene* scene);
     void RenderSpheres(Scene * scene);
     std::shared_ptr<GLTFMesh> GetOrLoadMesh(const std::string& path);
+    float AnimationTime() const;
 
     void InitSphereGeometry();
     unsigned int m_SphereVAO = 0;
@@ -100,10 +107,13 @@ private:
     unsigned int m_SphereEBO = 0;
     int m_SphereIndexCount = 0;
 
+    std::unique_ptr<SceneBodyBuffer> m_sceneBodies; // Shared by the ray tracer and the gravity grid
     std::unique_ptr<GravityGridRenderer> gravityGridRenderer;
     std::unique_ptr<ObjectPathsRenderer> objectPathsRenderer;
     std::unique_ptr<PhysicsDebugRenderer> m_physicsDebugRenderer;
 
+    float m_timeOverride = -1.0f;  // Set by RenderToFramebuffer, see AnimationTime()
+
     std::string m_gpuName;
     std::string m_gpuVendor;
     std::string m_glVersion;
@@ -0,0 +1,69 @@
+#include "SceneBodyBuffer.h"
+#include <glad/gl.h>
+#include <cstring>
+
+#include "Simulation/Scene.h"
+#include "Simulation/Physics.h"
+#include "Application/Parameters.h"
+
+namespace {
+    constexpr size_t INITIAL_BODY_CAPACITY = 256;
+}
+
+SceneBodyBuffer::SceneBodyBuffer()
+    : m_Ring(GL_SHADER_STORAGE_BUFFER, sizeof(Header) + INITIAL_BODY_CAPACITY * sizeof(Body)) {
+    m_Bodies.reserve(INITIAL_BODY_CAPACITY);
+}
+
+void SceneBodyBuffer::Upload(const Scene& scene) {
+    m_Bodies.clear();
+    m_Header = Header{};
+
+    for (const uint32_t index : scene.ObjectsOf(ObjectClasses::BlackHole)) {
+        const auto& obj = scene.objects[index];
+        const auto* pos = obj.Find<glm::vec3>(HotField::Position);
+        const auto* mass = obj.Find<float>(HotField::Mass);
+        if (!pos || !mass) continue;
+
+        const auto* spin = obj.Find<float>(Field::BlackHole::Spin);
+        const auto* spinAxis = obj.Find<glm::vec3>(Field::BlackHole::SpinAxis);
+        const glm::vec3 axis = glm::normalize(spinAxis ? *spinAxis : glm::vec3(0.0f, 1.0f, 0.0f));
+
+        m_Bodies.push_back({glm::vec4(*pos, *mass / Physics::SOLAR_MASS), glm::vec4(axis, spin ? *spin : 0.0f)});
+        m_Header.numBlackHoles++;
+    }
+
+    for (const uint32_t index : scene.ObjectsOf(ObjectClasses::Sphere)) {
+        const auto& obj = scene.objects[index];
+        const auto* pos = obj.Find<glm::vec3>(HotField::Position);
+        const auto* radius = obj.Find<float>(HotField::Radius);
+        if (!pos || !radius) continue;
+
+        const auto* mass = obj.Find<float>(HotField::Mass);
+        const auto* color = obj.Find<glm::vec3>(Field::Sphere::Color);
+
+        m_Bodies.push_back({glm::vec4(*pos, mass ? *mass / Physics::SOLAR_MASS : 0.0f), glm::vec4(color ? *color : glm::vec3(1.0f), *radius)});
+        m_Header.numSpheres++;
+    }
+
+    for (const uint32_t index : scene.ObjectsOf(ObjectClasses::Mesh)) {
+        const auto& obj = scene.objects[index];
+        const auto* pos = obj.Find<glm::vec3>(HotField::Position);
+        const auto* mass = obj.Find<float>(HotField::Mass);
+        if (!pos || !mass) continue;
+
+        m_Bodies.push_back({glm::vec4(*pos, *mass / Physics::SOLAR_MASS), glm::vec4(0.0f)});
+        m_Header.numMeshes++;
+    }
+
+    const size_t bodyBytes = m_Bodies.size() * sizeof(Body);
+    const size_t size = sizeof(Header) + bodyBytes;
+    char* mapped = static_cast<char*>(m_Ring.Map(size));
+    if (!mapped) return;
+
+    std::memcpy(mapped, &m_Header, sizeof(Header));
+    if (bodyBytes > 0) {
+        std::memcpy(mapped + sizeof(Header), m_Bodies.data(), bodyBytes);
+    }
+    m_Ring.BindRange(BINDING, size);
+}
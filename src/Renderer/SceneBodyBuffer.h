@@ -0,0 +1,48 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "Buffer.h"
+
+class Scene;
+
+/**
+ * @brief Scene bodies packed into one std430 shader storage buffer per frame
+ *
+ * Black holes, spheres and meshes are collected back to back into a CPU staging array and copied
+ * into a persistently mapped ring buffer in a single write. Shaders read them through
+ * shaders/scene_bodies.glsl, so there is no per-element uniform call and no fixed body limit.
+ */
+class SceneBodyBuffer {
+public:
+    static constexpr unsigned int BINDING = 3;  // Must match the SceneBodies block in scene_bodies.glsl
+
+    // std430 layout of struct Body in scene_bodies.glsl
+    struct Body {
+        glm::vec4 positionMass;  // xyz position, w mass in solar masses
+        glm::vec4 data;          // Black hole: spin axis and spin. Sphere: color and radius. Mesh: unused
+    };
+
+    struct Header {
+        int32_t numBlackHoles = 0;
+        int32_t numSpheres = 0;
+        int32_t numMeshes = 0;
+        int32_t padding = 0;
+    };
+
+    SceneBodyBuffer();
+
+    // Packs the scene and binds this frame's copy; call once per frame before the passes reading it
+    void Upload(const Scene& scene);
+
+    const Header& GetHeader() const { return m_Header; }
+
+private:
+    Header m_Header;
+    std::vector<Body> m_Bodies;  // Staging, reused across frames
+    PersistentRingBuffer m_Ring;
+};
+
+static_assert(sizeof(SceneBodyBuffer::Body) == 32, "Body must match the std430 layout in scene_bodies.glsl");
+static_assert(sizeof(SceneBodyBuffer::Header) == 16, "Header must keep the body array 16-byte aligned");
@@ -9,6 +9,8 @@
 #include <cstring>
 #include <filesystem>
 #include <string_view>
+#include <algorithm>
+#include <bit>
 #include <chrono>
 #include "Application/Profiler.h"
 
@@ -343,18 +345,22 @@ unsigned int Shader::CompileCompute(const std::string& computeSrc) {
 
 Shader::Shader(const std::string& vertexSrc, const std::string& fragmentSrc) {
     ID = Compile(vertexSrc, fragmentSrc);
+    ReflectUniforms();
 }
 
 Shader::Shader(const char* vertexPath, const char* fragmentPath) {
     ID = CompileWithCache(vertexPath, fragmentPath);
+    ReflectUniforms();
 }
 
 Shader::Shader(const std::string& computeSrc, bool isCompute) {
     ID = isCompute ? CompileCompute(computeSrc) : 0;
+    ReflectUniforms();
 }
 
 Shader::Shader(const char* computePath, bool isCompute) {
     ID = isCompute ? CompileComputeWithCache(computePath) : 0;
+    ReflectUniforms();
 }
 
 Shader::~Shader() {
@@ -367,27 +373,27 @@ void Shader::Unbind() const {
     glUseProgram(0);
 }
 
-void Shader::SetMat4(const std::string& name, const glm::mat4& matrix) const {
+void Shader::SetMat4(const UniformName name, const glm::mat4& matrix) const {
     glUniformMatrix4fv(GetUniformLocation(name), 1, GL_FALSE, glm::value_ptr(matrix));
 }
 
-void Shader::SetVec2(const std::string& name, const glm::vec2& vector) const {
+void Shader::SetVec2(const UniformName name, const glm::vec2& vector) const {
     glUniform2fv(GetUniformLocation(name), 1, glm::value_ptr(vector));
 }
 
-void Shader::SetVec3(const std::string& name, const glm::vec3& vector) const {
+void Shader::SetVec3(const UniformName name, const glm::vec3& vector) const {
     glUniform3fv(GetUniformLocation(name), 1, glm::value_ptr(vector));
 }
 
-void Shader::SetVec4(const std::string& name, const glm::vec4& vector) const {
+void Shader::SetVec4(const UniformName name, const glm::vec4& vector) const {
     glUniform4fv(GetUniformLocation(name), 1, glm::value_ptr(vector));
 }
 
-void Shader::SetFloat(const std::string& name, float value) const {
+void Shader::SetFloat(const UniformName name, float value) const {
     glUniform1f(GetUniformLocation(name), value);
 }
 
-void Shader::SetInt(const std::string& name, int value) const {
+void Shader::SetInt(const UniformName name, int value) const {
     glUniform1i(GetUniformLocation(name), value);
 }
 
@@ -397,6 +403,74 @@ void Shader::Dispatch(uint32_t x, uint32_t y, uint32_t z) const {
     glUseProgram(0);
 }
 
-int Shader::GetUniformLocation(const std::string& name) const {
-    return glGetUniformLocation(ID, name.c_str());
+void Shader::ReflectUniforms() {
+    m_UniformTable.clear();
+    if (ID == 0) return;
+
+    GLint activeCount = 0;
+    GLint maxNameLength = 0;
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &activeCount);
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+
+    struct Entry {
+        std::string name;
+        int location;
+    };
+    std::vector<Entry> entries;
+    const auto addEntry = [&](std::string name) {
+        // Members of uniform and storage blocks have no location
+        if (const GLint location = glGetUniformLocation(ID, name.c_str()); location >= 0) {
+            entries.push_back({std::move(name), location});
+        }
+    };
+
+    std::vector<char> nameBuffer(std::max(maxNameLength, 1));
+    for (GLint i = 0; i < activeCount; i++) {
+        GLint arraySize = 0;
+        GLenum type = 0;
+        GLsizei length = 0;
+        glGetActiveUniform(ID, static_cast<GLuint>(i), maxNameLength, &length, &arraySize, &type, nameBuffer.data());
+        std::string name(nameBuffer.data(), length);
+
+        // Arrays are reported as "name[0]"; the bare name and every element get their own entry
+        if (name.ends_with("[0]")) {
+            const std::string base = name.substr(0, name.size() - 3);
+            addEntry(base);
+            for (GLint element = 0; element < arraySize; element++) {
+                addEntry(base + "[" + std::to_string(element) + "]");
+            }
+        } else {
+            addEntry(std::move(name));
+        }
+    }
+
+    // At most half full, so a probe always ends on an empty slot
+    m_UniformTable.assign(std::bit_ceil(std::max<size_t>(entries.size() * 2, 16)), UniformSlot{});
+    const size_t mask = m_UniformTable.size() - 1;
+    for (const Entry& entry : entries) {
+        const uint64_t id = RuntimeFnv1a(entry.name);
+        size_t i = id & mask;
+        while (m_UniformTable[i].id != 0 && m_UniformTable[i].id != id) {
+            i = (i + 1) & mask;
+        }
+        if (m_UniformTable[i].id == id) {
+            spdlog::error("Uniform name hash collision in program {}: {}", ID, entry.name);
+            continue;
+        }
+        m_UniformTable[i] = {id, entry.location};
+    }
+}
+
+int Shader::GetUniformLocation(const UniformName name) const {
+    if (s_DriverLookup) {
+        return glGetUniformLocation(ID, name.m_Name);
+    }
+    if (m_UniformTable.empty()) return -1;
+
+    const size_t mask = m_UniformTable.size() - 1;
+    for (size_t i = name.m_Id & mask;; i = (i + 1) & mask) {
+        const UniformSlot& slot = m_UniformTable[i];
+        if (slot.id == name.m_Id) return slot.location;
+        if (slot.id == 0) return -1;
+    }
 }
@@ -1,8 +1,24 @@
 #pragma once
 #include <string>
+#include <vector>
 #include <glm/glm.hpp>
 #include <cstdint>
 
+#include "Application/Fnv1a.h"
+
+// Uniform name hashed at compile time when it is a string literal; the key into a Shader's location table
+struct UniformName {
+    uint64_t m_Id = 0;
+    const char* m_Name = nullptr;  // Only read when the location table is bypassed
+
+    template<size_t N>
+    consteval UniformName(const char (&str)[N]) noexcept : m_Id(ConstexprFnv1a(str)), m_Name(str) {
+    }
+
+    explicit UniformName(const std::string& str) noexcept : m_Id(RuntimeFnv1a(str)), m_Name(str.c_str()) {
+    }
+};
+
 class Shader {
 public:
     unsigned int ID;
@@ -14,15 +30,28 @@ public:
     void Bind() const;
     void Unbind() const;
     void Dispatch(uint32_t x, uint32_t y = 1, uint32_t z = 1) const;
-    void SetMat4(const std::string& name, const glm::mat4& matrix) const;
-    void SetVec2(const std::string& name, const glm::vec2& vector) const;
-    void SetVec3(const std::string& name, const glm::vec3& vector) const;
-    void SetVec4(const std::string& name, const glm::vec4& vector) const;
-    void SetFloat(const std::string& name, float value) const;
-    void SetInt(const std::string& name, int value) const;
-    int GetUniformLocation(const std::string& name) const;
+    void SetMat4(UniformName name, const glm::mat4& matrix) const;
+    void SetVec2(UniformName name, const glm::vec2& vector) const;
+    void SetVec3(UniformName name, const glm::vec3& vector) const;
+    void SetVec4(UniformName name, const glm::vec4& vector) const;
+    void SetFloat(UniformName name, float value) const;
+    void SetInt(UniformName name, int value) const;
+    int GetUniformLocation(UniformName name) const;
+
+    // Resolves every location through glGetUniformLocation again, only to compare against the table in benchmarks
+    static void SetDriverLookup(bool enabled) { s_DriverLookup = enabled; }
 
 private:
+    // Active uniforms reflected after linking, open addressing over a power-of-two table
+    struct UniformSlot {
+        uint64_t id = 0;
+        int location = -1;
+    };
+    std::vector<UniformSlot> m_UniformTable;
+    static inline bool s_DriverLookup = false;
+
+    void ReflectUniforms();
+
     static std::string ReadFile(const char* path);
     static std::string PreprocessIncludes(const std::string& source, const char* sourcePath);
     unsigned int Compile(const std::string& vertexSrc, const std::string& fragmentSrc);
@@ -0,0 +1,249 @@
+#include "VideoEncoder.h"
+#include <spdlog/spdlog.h>
+#include <stdexcept>
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+#include <libavutil/opt.h>
+#include <libavutil/imgutils.h>
+#include <libswscale/swscale.h>
+}
+
+VideoEncoder::~VideoEncoder() {
+    Abort();
+}
+
+void VideoEncoder::Open(const std::string& path, const Config& config) {
+    m_Config = config;
+
+    const AVCodec* codec = avcodec_find_encoder(AV_CODEC_ID_H264);
+    if (!codec) {
+        throw std::runtime_error("H264 codec not found");
+    }
+
+    m_CodecContext = avcodec_alloc_context3(codec);
+    m_CodecContext->bit_rate = config.bitRate;
+    m_CodecContext->width = config.width;
+    m_CodecContext->height = config.height;
+    m_CodecContext->time_base = AVRational{1, config.framerate};
+    m_CodecContext->framerate = AVRational{config.framerate, 1};
+    m_CodecContext->gop_size = 10;
+    m_CodecContext->max_b_frames = 1;
+    m_CodecContext->pix_fmt = AV_PIX_FMT_YUV420P;
+
+    spdlog::info("Codec context initialized: {}x{} @ {} fps",
+                m_CodecContext->width, m_CodecContext->height, m_CodecContext->framerate.num);
+
+    if (avcodec_open2(m_CodecContext, codec, nullptr) < 0) {
+        throw std::runtime_error("Could not open codec");
+    }
+
+    spdlog::info("Codec opened successfully with dimensions: {}x{}",
+                m_CodecContext->width, m_CodecContext->height);
+
+    avformat_alloc_output_context2(&m_FormatContext, nullptr, nullptr, path.c_str());
+    if (!m_FormatContext) {
+        throw std::runtime_error("Could not create output context");
+    }
+
+    AVStream* stream = avformat_new_stream(m_FormatContext, nullptr);
+    stream->time_base = m_CodecContext->time_base;
+    avcodec_parameters_from_context(stream->codecpar, m_CodecContext);
+
+    // Set sample aspect ratio to 1:1 (square pixels) to ensure correct display dimensions
+    stream->sample_aspect_ratio = AVRational{1, 1};
+    m_CodecContext->sample_aspect_ratio = AVRational{1, 1};
+
+    spdlog::info("Stream configured: {}x{}, time_base={}/{}, SAR={}/{}",
+                stream->codecpar->width, stream->codecpar->height,
+                stream->time_base.num, stream->time_base.den,
+                stream->sample_aspect_ratio.num, stream->sample_aspect_ratio.den);
+
+    if (!(m_FormatContext->oformat->flags & AVFMT_NOFILE)) {
+        if (avio_open(&m_FormatContext->pb, path.c_str(), AVIO_FLAG_WRITE) < 0) {
+            throw std::runtime_error("Could not open output file");
+        }
+    }
+
+    if (avformat_write_header(m_FormatContext, nullptr) < 0) {
+        throw std::runtime_error("Could not write format header");
+    }
+
+    for (size_t i = 0; i < FRAMES_IN_FLIGHT; ++i) {
+        AVFrame* frame = av_frame_alloc();
+        frame->format = m_CodecContext->pix_fmt;
+        frame->width = m_CodecContext->width;
+        frame->height = m_CodecContext->height;
+        if (av_frame_get_buffer(frame, 0) < 0) {
+            av_frame_free(&frame);
+            throw std::runtime_error("Could not allocate video frame");
+        }
+        m_FramePool.Push(frame);
+    }
+
+    // The readback is RGBA, bottom row first; both paths flip while converting, see ConvertFrame()
+    m_ConvertKernel = MoleHole::FrameConversion::GetBestKernel();
+    if (m_ConvertKernel) {
+        spdlog::info("Converting frames with the SIMD kernel");
+    } else {
+        m_SwsContext = sws_getContext(
+            config.width, config.height, AV_PIX_FMT_RGBA,
+            config.width, config.height, AV_PIX_FMT_YUV420P,
+            SWS_BILINEAR, nullptr, nullptr, nullptr
+        );
+        if (!m_SwsContext) {
+            throw std::runtime_error("Could not create color conversion context");
+        }
+        spdlog::info("Converting frames with libswscale");
+    }
+
+    m_ConvertThread = std::thread(&VideoEncoder::ConvertLoop, this);
+    m_EncodeThread = std::thread(&VideoEncoder::EncodeLoop, this);
+}
+
+bool VideoEncoder::Submit(RgbaFrame frame) {
+    if (m_Failed) return false;
+    return m_ConvertQueue.Push(std::move(frame));
+}
+
+void VideoEncoder::Finish() {
+    StopStages();
+
+    if (!m_Failed && m_CodecContext) {
+        EncodeFrame(nullptr);
+        av_write_trailer(m_FormatContext);
+    }
+    Release();
+
+    if (m_Failed) {
+        throw std::runtime_error(GetError());
+    }
+}
+
+void VideoEncoder::Abort() {
+    // Frames still queued are released without being converted or encoded
+    m_Failed = true;
+    StopStages();
+    Release();
+}
+
+std::string VideoEncoder::GetError() const {
+    std::lock_guard lock(m_ErrorMutex);
+    return m_Error;
+}
+
+void VideoEncoder::ConvertLoop() {
+    // Every frame taken from the queue is released, also after a failure, so the producer never starves
+    while (std::optional<RgbaFrame> frame = m_ConvertQueue.Pop()) {
+        if (!m_Failed) {
+            if (std::optional<AVFrame*> target = m_FramePool.Pop()) {
+                if (ConvertFrame(*frame, *target)) {
+                    m_EncodeQueue.Push(*target);
+                } else {
+                    Fail("Could not make video frame writable");
+                    m_FramePool.Push(*target);
+                }
+            }
+        }
+        if (frame->release) {
+            frame->release();
+        }
+    }
+}
+
+void VideoEncoder::EncodeLoop() {
+    while (std::optional<AVFrame*> frame = m_EncodeQueue.Pop()) {
+        if (!m_Failed) {
+            EncodeFrame(*frame);
+        }
+        m_FramePool.Push(*frame);
+    }
+}
+
+bool VideoEncoder::ConvertFrame(const RgbaFrame& frame, AVFrame* target) const {
+    // The encoder may still reference the buffers of a frame it has seen before
+    if (av_frame_make_writable(target) < 0) {
+        return false;
+    }
+
+    if (m_ConvertKernel) {
+        m_ConvertKernel(frame.pixels, m_Config.width, m_Config.height, target->data, target->linesize);
+    } else {
+        // Negative stride from the last row
+        const int stride = m_Config.width * 4;
+        const uint8_t* srcData[1] = { frame.pixels + static_cast<size_t>(m_Config.height - 1) * stride };
+        const int srcLinesize[1] = { -stride };
+        sws_scale(m_SwsContext, srcData, srcLinesize, 0, m_Config.height, target->data, target->linesize);
+    }
+    target->pts = frame.pts;
+    return true;
+}
+
+void VideoEncoder::EncodeFrame(AVFrame* frame) {
+    // A null frame flushes the encoder
+    AVPacket* pkt = av_packet_alloc();
+    int ret = avcodec_send_frame(m_CodecContext, frame);
+    if (ret < 0) {
+        Fail("Error sending frame to the encoder");
+    }
+    while (ret >= 0) {
+        ret = avcodec_receive_packet(m_CodecContext, pkt);
+        if (ret == AVERROR(EAGAIN) || ret == AVERROR_EOF) {
+            break;
+        }
+        if (ret < 0) {
+            Fail("Error encoding frame");
+            break;
+        }
+        av_packet_rescale_ts(pkt, m_CodecContext->time_base, m_FormatContext->streams[0]->time_base);
+        pkt->stream_index = 0;
+        av_interleaved_write_frame(m_FormatContext, pkt);
+        av_packet_unref(pkt);
+    }
+    av_packet_free(&pkt);
+}
+
+void VideoEncoder::Fail(const std::string& error) {
+    {
+        std::lock_guard lock(m_ErrorMutex);
+        if (m_Error.empty()) {
+            m_Error = error;
+        }
+    }
+    m_Failed = true;
+    spdlog::error("Video encoder: {}", error);
+}
+
+void VideoEncoder::StopStages() {
+    // The conversion stage drains first so everything it produced reaches the encoder
+    m_ConvertQueue.Close();
+    if (m_ConvertThread.joinable()) {
+        m_ConvertThread.join();
+    }
+    m_EncodeQueue.Close();
+    if (m_EncodeThread.joinable()) {
+        m_EncodeThread.join();
+    }
+}
+
+void VideoEncoder::Release() {
+    while (std::optional<AVFrame*> frame = m_FramePool.TryPop()) {
+        av_frame_free(&*frame);
+    }
+
+    if (m_SwsContext) {
+        sws_freeContext(m_SwsContext);
+        m_SwsContext = nullptr;
+    }
+    if (m_FormatContext) {
+        if (!(m_FormatContext->oformat->flags & AVFMT_NOFILE)) {
+            avio_closep(&m_FormatContext->pb);
+        }
+        avformat_free_context(m_FormatContext);
+        m_FormatContext = nullptr;
+    }
+    if (m_CodecContext) {
+        avcodec_free_context(&m_CodecContext);
+    }
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "Application/BoundedQueue.h"
+#include "FrameConversion.h"
+
+struct AVCodecContext;
+struct AVFormatContext;
+struct AVFrame;
+struct SwsContext;
+
+/**
+ * @brief H.264 encoder fed with OpenGL readback frames, converting and encoding on its own threads
+ *
+ * Submit() hands over a bottom-up RGBA frame and returns as soon as the conversion stage has room
+ * for it. A conversion thread turns the frame into YUV420, flipping it on the way (with the SIMD
+ * kernel of FrameConversion.h when the CPU has one, libswscale otherwise), and an encoder thread
+ * compresses and muxes it. The bounded queues between the stages hold a fixed number of
+ * frames, so rendering the next frame overlaps with converting and encoding the previous ones and
+ * the caller only waits when the slowest stage falls behind.
+ */
+class VideoEncoder {
+public:
+    struct Config {
+        int width = 1920;
+        int height = 1080;
+        int framerate = 60;
+        int64_t bitRate = 4000000;
+    };
+
+    // A frame handed to Submit(). release runs on the conversion thread once pixels are no longer read.
+    struct RgbaFrame {
+        const unsigned char* pixels = nullptr;  // width * height * 4 bytes, bottom row first
+        int64_t pts = 0;
+        std::function<void()> release;
+    };
+
+    VideoEncoder() = default;
+    ~VideoEncoder();
+
+    VideoEncoder(const VideoEncoder&) = delete;
+    VideoEncoder& operator=(const VideoEncoder&) = delete;
+
+    // Creates the codec and the output file and starts the stage threads, throws std::runtime_error
+    void Open(const std::string& path, const Config& config);
+
+    // False without calling frame.release when a stage failed, see GetError()
+    bool Submit(RgbaFrame frame);
+
+    // Drains both stages, flushes the encoder and writes the trailer; throws when a stage failed
+    void Finish();
+
+    // Stops both stages and closes the file without flushing
+    void Abort();
+
+    std::string GetError() const;
+
+private:
+    void ConvertLoop();
+    void EncodeLoop();
+    bool ConvertFrame(const RgbaFrame& frame, AVFrame* target) const;
+    void EncodeFrame(AVFrame* frame);
+    void Fail(const std::string& error);
+    void StopStages();
+    void Release();
+
+    static constexpr size_t FRAMES_IN_FLIGHT = 3;
+
+    Config m_Config;
+    AVCodecContext* m_CodecContext = nullptr;
+    AVFormatContext* m_FormatContext = nullptr;
+    MoleHole::FrameConversion::ConvertKernel m_ConvertKernel = nullptr;
+    SwsContext* m_SwsContext = nullptr;  // Fallback when there is no conversion kernel
+
+    BoundedQueue<RgbaFrame> m_ConvertQueue{FRAMES_IN_FLIGHT};
+    BoundedQueue<AVFrame*> m_EncodeQueue{FRAMES_IN_FLIGHT};
+    BoundedQueue<AVFrame*> m_FramePool{FRAMES_IN_FLIGHT};  // YUV frames not owned by either stage
+    std::thread m_ConvertThread;
+    std::thread m_EncodeThread;
+
+    std::atomic<bool> m_Failed{false};  // Set on errors and by Abort(); the stages then only release frames
+    mutable std::mutex m_ErrorMutex;
+    std::string m_Error;
+};
@@ -0,0 +1,225 @@
+#include "VideoSegments.h"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <filesystem>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <spdlog/spdlog.h>
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+}
+
+namespace VideoSegments {
+
+namespace {
+struct InputDeleter {
+    void operator()(AVFormatContext* context) const { avformat_close_input(&context); }
+};
+
+struct OutputDeleter {
+    void operator()(AVFormatContext* context) const {
+        if (!(context->oformat->flags & AVFMT_NOFILE)) {
+            avio_closep(&context->pb);
+        }
+        avformat_free_context(context);
+    }
+};
+
+struct PacketDeleter {
+    void operator()(AVPacket* packet) const { av_packet_free(&packet); }
+};
+
+using InputContext = std::unique_ptr<AVFormatContext, InputDeleter>;
+using OutputContext = std::unique_ptr<AVFormatContext, OutputDeleter>;
+
+// Removes a partially written file when concatenation fails before it was renamed into place
+class TemporaryFile {
+public:
+    explicit TemporaryFile(std::string path) : m_Path(std::move(path)) {}
+    ~TemporaryFile() {
+        if (!m_Kept) {
+            std::error_code error;
+            std::filesystem::remove(m_Path, error);
+        }
+    }
+    TemporaryFile(const TemporaryFile&) = delete;
+    TemporaryFile& operator=(const TemporaryFile&) = delete;
+
+    const std::string& Path() const { return m_Path; }
+    void Keep() { m_Kept = true; }
+
+private:
+    std::string m_Path;
+    bool m_Kept = false;
+};
+
+bool parseInt(std::string_view text, int& value) {
+    const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+    return error == std::errc() && end == text.data() + text.size();
+}
+}
+
+std::optional<FrameRange> ParseFrameRange(const std::string& text) {
+    const size_t colon = text.find(':');
+    if (colon == std::string::npos) {
+        return std::nullopt;
+    }
+
+    FrameRange range;
+    const std::string_view view(text);
+    if (!parseInt(view.substr(0, colon), range.begin) || !parseInt(view.substr(colon + 1), range.end)) {
+        return std::nullopt;
+    }
+    if (range.begin < 0 || range.end <= range.begin) {
+        return std::nullopt;
+    }
+    return range;
+}
+
+std::vector<FrameRange> SplitFrames(int totalFrames, int count) {
+    count = std::clamp(count, 1, std::max(totalFrames, 1));
+    std::vector<FrameRange> ranges;
+    ranges.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        const int begin = static_cast<int>(static_cast<int64_t>(totalFrames) * i / count);
+        const int end = static_cast<int>(static_cast<int64_t>(totalFrames) * (i + 1) / count);
+        ranges.push_back({begin, end});
+    }
+    return ranges;
+}
+
+std::string SegmentPath(const std::string& outputPath, int index) {
+    std::filesystem::path path(outputPath);
+    const std::string stem = path.stem().string();
+    const std::string extension = path.extension().string();
+    path.replace_filename(fmt::format("{}.part{:03}{}", stem, index, extension));
+    return path.string();
+}
+
+bool IsImageSequence(const std::string& outputPath) {
+    std::string extension = std::filesystem::path(outputPath).extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return extension == ".exr" || extension == ".png";
+}
+
+std::string SequenceFramePath(const std::string& outputPath, int frame) {
+    std::filesystem::path path(outputPath);
+    const std::string stem = path.stem().string();
+    const std::string extension = path.extension().string();
+    path.replace_filename(fmt::format("{}.{:05}{}", stem, frame, extension));
+    return path.string();
+}
+
+void ConcatenateSegments(const std::vector<std::string>& segments, const std::string& outputPath) {
+    if (segments.empty()) {
+        throw std::runtime_error("No segments to concatenate");
+    }
+
+    // Muxed into outputPath + ".tmp" and renamed once the trailer is written, so a failed join
+    // never leaves a truncated video behind or clobbers an earlier complete one
+    TemporaryFile temporary(outputPath + ".tmp");
+
+    AVFormatContext* rawOutput = nullptr;
+    avformat_alloc_output_context2(&rawOutput, av_guess_format(nullptr, outputPath.c_str(), nullptr), nullptr,
+                                   temporary.Path().c_str());
+    if (!rawOutput) {
+        throw std::runtime_error("Could not create output context");
+    }
+    OutputContext output(rawOutput);
+    std::unique_ptr<AVPacket, PacketDeleter> packet(av_packet_alloc());
+
+    AVStream* outStream = nullptr;
+    int64_t offset = 0;  // Start of the current segment in the output time base
+
+    for (size_t i = 0; i < segments.size(); ++i) {
+        AVFormatContext* rawInput = nullptr;
+        if (avformat_open_input(&rawInput, segments[i].c_str(), nullptr, nullptr) < 0) {
+            throw std::runtime_error("Could not open segment " + segments[i]);
+        }
+        InputContext input(rawInput);
+        if (avformat_find_stream_info(input.get(), nullptr) < 0) {
+            throw std::runtime_error("Could not read stream info of segment " + segments[i]);
+        }
+        const int streamIndex = av_find_best_stream(input.get(), AVMEDIA_TYPE_VIDEO, -1, -1, nullptr, 0);
+        if (streamIndex < 0) {
+            throw std::runtime_error("No video stream in segment " + segments[i]);
+        }
+        AVStream* inStream = input->streams[streamIndex];
+
+        if (!outStream) {
+            // The first segment defines the stream, the others have to match it
+            outStream = avformat_new_stream(output.get(), nullptr);
+            avcodec_parameters_copy(outStream->codecpar, inStream->codecpar);
+            outStream->codecpar->codec_tag = 0;
+            outStream->time_base = inStream->time_base;
+            outStream->sample_aspect_ratio = inStream->sample_aspect_ratio;
+
+            if (!(output->oformat->flags & AVFMT_NOFILE)) {
+                if (avio_open(&output->pb, temporary.Path().c_str(), AVIO_FLAG_WRITE) < 0) {
+                    throw std::runtime_error("Could not open output file");
+                }
+            }
+            if (avformat_write_header(output.get(), nullptr) < 0) {
+                throw std::runtime_error("Could not write format header");
+            }
+        } else if (inStream->codecpar->codec_id != outStream->codecpar->codec_id ||
+                   inStream->codecpar->width != outStream->codecpar->width ||
+                   inStream->codecpar->height != outStream->codecpar->height) {
+            throw std::runtime_error("Segment " + segments[i] + " does not match the format of the first segment");
+        }
+
+        // Packets may come without a duration; one frame at the stream's rate then marks the segment end
+        const AVRational frameRate = inStream->avg_frame_rate.num > 0 ? inStream->avg_frame_rate : inStream->r_frame_rate;
+        const int64_t frameDuration = frameRate.num > 0 ? av_rescale_q(1, av_inv_q(frameRate), outStream->time_base) : 0;
+
+        int64_t segmentEnd = offset;
+        int64_t packetCount = 0;
+        while (av_read_frame(input.get(), packet.get()) >= 0) {
+            if (packet->stream_index != streamIndex) {
+                av_packet_unref(packet.get());
+                continue;
+            }
+
+            av_packet_rescale_ts(packet.get(), inStream->time_base, outStream->time_base);
+            if (packet->pts != AV_NOPTS_VALUE) {
+                packet->pts += offset;
+                segmentEnd = std::max(segmentEnd, packet->pts + (packet->duration > 0 ? packet->duration : frameDuration));
+            }
+            if (packet->dts != AV_NOPTS_VALUE) {
+                packet->dts += offset;
+            }
+            packet->stream_index = outStream->index;
+            packet->pos = -1;
+
+            if (av_interleaved_write_frame(output.get(), packet.get()) < 0) {
+                throw std::runtime_error("Could not write packet of segment " + segments[i]);
+            }
+            ++packetCount;
+        }
+
+        spdlog::info("Appended segment {} ({} packets)", segments[i], packetCount);
+        offset = segmentEnd;
+    }
+
+    if (av_write_trailer(output.get()) < 0) {
+        throw std::runtime_error("Could not write format trailer");
+    }
+    output.reset();
+
+    std::error_code error;
+    std::filesystem::rename(temporary.Path(), outputPath, error);
+    if (error) {
+        throw std::runtime_error("Could not move " + temporary.Path() + " to " + outputPath + ": " + error.message());
+    }
+    temporary.Keep();
+    spdlog::info("Concatenated {} segments into {}", segments.size(), outputPath);
+}
+
+} // namespace VideoSegments
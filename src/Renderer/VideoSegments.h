@@ -0,0 +1,44 @@
+#pragma once
+#include <optional>
+#include <string>
+#include <vector>
+
+/**
+ * Splitting a video export into independently rendered segments and joining them again.
+ *
+ * Every worker renders a half-open frame range into its own file; the simulation is stepped
+ * deterministically up to the first frame, so the segments line up exactly. Each segment is a
+ * complete H.264 stream starting on a keyframe, which lets ConcatenateSegments() join them by
+ * copying packets with shifted timestamps, without decoding or re-encoding anything.
+ */
+namespace VideoSegments {
+
+// Half-open range of zero-based frame indices
+struct FrameRange {
+    int begin = 0;
+    int end = 0;
+
+    int Size() const { return end - begin; }
+};
+
+// Parses "start:end", nullopt when malformed or empty
+std::optional<FrameRange> ParseFrameRange(const std::string& text);
+
+// Splits [0, totalFrames) into at most count ranges of near-equal size
+std::vector<FrameRange> SplitFrames(int totalFrames, int count);
+
+// "out/video.mp4", 2 -> "out/video.part002.mp4"
+std::string SegmentPath(const std::string& outputPath, int index);
+
+// Video exports to .exr or .png write linear half-float frames as an image sequence instead of an
+// encoded video. Frames are named by their index in the whole video, so the frames of different
+// workers never collide and there is nothing to join.
+bool IsImageSequence(const std::string& outputPath);
+
+// "out/frames.exr", 42 -> "out/frames.00042.exr"
+std::string SequenceFramePath(const std::string& outputPath, int frame);
+
+// Joins the video streams of segments in order into outputPath, throws std::runtime_error
+void ConcatenateSegments(const std::vector<std::string>& segments, const std::string& outputPath);
+
+} // namespace VideoSegments
@@ -0,0 +1,265 @@
+#include "BarnesHut.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <numeric>
+
+#include "Application/ThreadPool.h"
+
+namespace {
+    constexpr size_t ACCELERATION_GRAIN = 256;
+
+    uint32_t Octant(float x, float y, float z, float cx, float cy, float cz) {
+        return (x >= cx ? 1u : 0u) | (y >= cy ? 2u : 0u) | (z >= cz ? 4u : 0u);
+    }
+
+    void Permute(std::vector<float>& values, const std::vector<uint32_t>& order, std::vector<float>& scratch) {
+        scratch.resize(values.size());
+        for (size_t i = 0; i < order.size(); i++) {
+            scratch[i] = values[order[i]];
+        }
+        values.swap(scratch);
+    }
+}
+
+void BarnesHutTree::Build(const float* x, const float* y, const float* z, const float* mu, const size_t count) {
+    m_X.assign(x, x + count);
+    m_Y.assign(y, y + count);
+    m_Z.assign(z, z + count);
+    m_Mu.assign(mu, mu + count);
+    m_Order.resize(count);
+    std::iota(m_Order.begin(), m_Order.end(), 0u);
+    m_Nodes.clear();
+
+    if (count <= DIRECT_SUM_MAX_BODIES) {
+        return;
+    }
+
+    float minX = m_X[0], minY = m_Y[0], minZ = m_Z[0];
+    float maxX = minX, maxY = minY, maxZ = minZ;
+    for (size_t i = 1; i < count; i++) {
+        minX = std::min(minX, m_X[i]); maxX = std::max(maxX, m_X[i]);
+        minY = std::min(minY, m_Y[i]); maxY = std::max(maxY, m_Y[i]);
+        minZ = std::min(minZ, m_Z[i]); maxZ = std::max(maxZ, m_Z[i]);
+    }
+
+    Node root;
+    root.centerX = 0.5f * (minX + maxX);
+    root.centerY = 0.5f * (minY + maxY);
+    root.centerZ = 0.5f * (minZ + maxZ);
+    // Slightly larger than the bounds so bodies on the max faces still fall inside the cube
+    const float extent = std::max({maxX - minX, maxY - minY, maxZ - minZ});
+    root.halfSize = std::max(0.5f * extent * 1.0001f, 1e-6f);
+    root.firstBody = 0;
+    root.bodyCount = static_cast<uint32_t>(count);
+
+    m_Nodes.reserve(count / 2 + 1);
+    m_Nodes.push_back(root);
+    m_Scratch.resize(count);
+    BuildNode(0, 0);
+
+    // Store bodies in tree order so leaves are contiguous runs
+    std::vector<float> scratch;
+    Permute(m_X, m_Order, scratch);
+    Permute(m_Y, m_Order, scratch);
+    Permute(m_Z, m_Order, scratch);
+    Permute(m_Mu, m_Order, scratch);
+}
+
+void BarnesHutTree::BuildNode(const uint32_t nodeIndex, const int depth) {
+    const uint32_t begin = m_Nodes[nodeIndex].firstBody;
+    const uint32_t end = begin + m_Nodes[nodeIndex].bodyCount;
+
+    if (m_Nodes[nodeIndex].bodyCount <= LEAF_MAX_BODIES || depth >= MAX_DEPTH) {
+        // Sums in double: mu * position overflows float for stellar masses at AU distances
+        double mu = 0.0, mx = 0.0, my = 0.0, mz = 0.0;
+        for (uint32_t k = begin; k < end; k++) {
+            const uint32_t i = m_Order[k];
+            mu += m_Mu[i];
+            mx += static_cast<double>(m_Mu[i]) * m_X[i];
+            my += static_cast<double>(m_Mu[i]) * m_Y[i];
+            mz += static_cast<double>(m_Mu[i]) * m_Z[i];
+        }
+
+        Node& node = m_Nodes[nodeIndex];
+        node.mu = static_cast<float>(mu);
+        if (mu > 0.0) {
+            node.comX = static_cast<float>(mx / mu);
+            node.comY = static_cast<float>(my / mu);
+            node.comZ = static_cast<float>(mz / mu);
+        } else {
+            node.comX = node.centerX;
+            node.comY = node.centerY;
+            node.comZ = node.centerZ;
+        }
+        return;
+    }
+
+    const float cx = m_Nodes[nodeIndex].centerX;
+    const float cy = m_Nodes[nodeIndex].centerY;
+    const float cz = m_Nodes[nodeIndex].centerZ;
+    const float childHalfSize = 0.5f * m_Nodes[nodeIndex].halfSize;
+
+    // Counting sort of the body range by octant
+    std::array<uint32_t, 8> counts{};
+    for (uint32_t k = begin; k < end; k++) {
+        const uint32_t i = m_Order[k];
+        counts[Octant(m_X[i], m_Y[i], m_Z[i], cx, cy, cz)]++;
+    }
+
+    std::array<uint32_t, 8> offsets{};
+    uint32_t running = begin;
+    uint32_t childCount = 0;
+    for (uint32_t o = 0; o < 8; o++) {
+        offsets[o] = running;
+        running += counts[o];
+        if (counts[o] > 0) childCount++;
+    }
+
+    for (uint32_t k = begin; k < end; k++) {
+        const uint32_t i = m_Order[k];
+        m_Scratch[offsets[Octant(m_X[i], m_Y[i], m_Z[i], cx, cy, cz)]++] = i;
+    }
+    std::copy(m_Scratch.begin() + begin, m_Scratch.begin() + end, m_Order.begin() + begin);
+
+    const uint32_t firstChild = static_cast<uint32_t>(m_Nodes.size());
+    m_Nodes.resize(m_Nodes.size() + childCount);
+    m_Nodes[nodeIndex].firstChild = firstChild;
+    m_Nodes[nodeIndex].childCount = childCount;
+
+    uint32_t child = firstChild;
+    uint32_t childBegin = begin;
+    for (uint32_t o = 0; o < 8; o++) {
+        if (counts[o] == 0) continue;
+
+        Node& node = m_Nodes[child++];
+        node.centerX = cx + ((o & 1u) ? childHalfSize : -childHalfSize);
+        node.centerY = cy + ((o & 2u) ? childHalfSize : -childHalfSize);
+        node.centerZ = cz + ((o & 4u) ? childHalfSize : -childHalfSize);
+        node.halfSize = childHalfSize;
+        node.firstBody = childBegin;
+        node.bodyCount = counts[o];
+        childBegin += counts[o];
+    }
+
+    double mu = 0.0, mx = 0.0, my = 0.0, mz = 0.0;
+    for (uint32_t c = firstChild; c < firstChild + childCount; c++) {
+        BuildNode(c, depth + 1);
+
+        const Node& node = m_Nodes[c];
+        mu += node.mu;
+        mx += static_cast<double>(node.mu) * node.comX;
+        my += static_cast<double>(node.mu) * node.comY;
+        mz += static_cast<double>(node.mu) * node.comZ;
+    }
+
+    Node& node = m_Nodes[nodeIndex];
+    node.mu = static_cast<float>(mu);
+    if (mu > 0.0) {
+        node.comX = static_cast<float>(mx / mu);
+        node.comY = static_cast<float>(my / mu);
+        node.comZ = static_cast<float>(mz / mu);
+    } else {
+        node.comX = cx;
+        node.comY = cy;
+        node.comZ = cz;
+    }
+}
+
+void BarnesHutTree::AccumulateDirect(const size_t body, float& ax, float& ay, float& az) const {
+    const float px = m_X[body], py = m_Y[body], pz = m_Z[body];
+    for (size_t j = 0; j < m_X.size(); j++) {
+        const float dx = m_X[j] - px;
+        const float dy = m_Y[j] - py;
+        const float dz = m_Z[j] - pz;
+        const float r2 = dx * dx + dy * dy + dz * dz;
+        if (j == body || r2 <= 0.0f) continue;
+
+        const float invR = 1.0f / std::sqrt(r2);
+        const float s = m_Mu[j] * invR * invR * invR;
+        ax += dx * s;
+        ay += dy * s;
+        az += dz * s;
+    }
+}
+
+void BarnesHutTree::AccumulateTree(const size_t body, const float thetaSq, float& ax, float& ay, float& az) const {
+    const float px = m_X[body], py = m_Y[body], pz = m_Z[body];
+
+    // Every opened cell replaces itself with at most 8 children
+    std::array<uint32_t, MAX_DEPTH * 8 + 8> stack;
+    size_t top = 0;
+    stack[top++] = 0;
+
+    while (top > 0) {
+        const Node& node = m_Nodes[stack[--top]];
+        if (node.mu <= 0.0f) continue;
+
+        if (node.childCount == 0) {
+            for (uint32_t j = node.firstBody; j < node.firstBody + node.bodyCount; j++) {
+                const float dx = m_X[j] - px;
+                const float dy = m_Y[j] - py;
+                const float dz = m_Z[j] - pz;
+                const float r2 = dx * dx + dy * dy + dz * dz;
+                if (j == body || r2 <= 0.0f) continue;
+
+                const float invR = 1.0f / std::sqrt(r2);
+                const float s = m_Mu[j] * invR * invR * invR;
+                ax += dx * s;
+                ay += dy * s;
+                az += dz * s;
+            }
+            continue;
+        }
+
+        const float dx = node.comX - px;
+        const float dy = node.comY - py;
+        const float dz = node.comZ - pz;
+        const float r2 = dx * dx + dy * dy + dz * dz;
+        const float size = 2.0f * node.halfSize;
+
+        // A cell containing the body is always opened: its own mass must not pull on it
+        const bool inside = std::abs(px - node.centerX) <= node.halfSize &&
+                            std::abs(py - node.centerY) <= node.halfSize &&
+                            std::abs(pz - node.centerZ) <= node.halfSize;
+
+        if (!inside && r2 > 0.0f && size * size < thetaSq * r2) {
+            const float invR = 1.0f / std::sqrt(r2);
+            const float s = node.mu * invR * invR * invR;
+            ax += dx * s;
+            ay += dy * s;
+            az += dz * s;
+        } else {
+            for (uint32_t c = 0; c < node.childCount; c++) {
+                stack[top++] = node.firstChild + c;
+            }
+        }
+    }
+}
+
+void BarnesHutTree::ComputeAccelerations(const float theta, float* ax, float* ay, float* az) const {
+    const size_t count = m_X.size();
+
+    if (m_Nodes.empty()) {
+        for (size_t i = 0; i < count; i++) {
+            ax[i] = ay[i] = az[i] = 0.0f;
+            AccumulateDirect(i, ax[i], ay[i], az[i]);
+        }
+        return;
+    }
+
+    const float thetaSq = theta * theta;
+    // Bodies are walked in tree order so neighbouring iterations visit the same cells
+    ThreadPool::Global().ParallelFor(0, count, ACCELERATION_GRAIN, [&](size_t begin, size_t end) {
+        for (size_t k = begin; k < end; k++) {
+            float x = 0.0f, y = 0.0f, z = 0.0f;
+            AccumulateTree(k, thetaSq, x, y, z);
+
+            const uint32_t i = m_Order[k];
+            ax[i] = x;
+            ay[i] = y;
+            az[i] = z;
+        }
+    });
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Barnes–Hut octree for O(N log N) Newtonian gravity
+ *
+ * Built once per physics step from an SoA snapshot of positions and gravitational parameters
+ * (mu = G * m, so solar-mass bodies never overflow float once summed into a cell). Bodies are
+ * copied in tree order, so every leaf is a contiguous run and bodies that are close in space
+ * are close in memory while the tree is walked. Accelerations are evaluated in parallel on the
+ * global ThreadPool.
+ *
+ * A cell is used as a point mass when size / distance < theta and the body lies outside of it;
+ * theta = 0 opens every cell and gives the exact direct sum. Up to DIRECT_SUM_MAX_BODIES no tree
+ * is built and the exact O(N^2) sum is used, which is also faster at that size.
+ */
+class BarnesHutTree {
+public:
+    static constexpr size_t DIRECT_SUM_MAX_BODIES = 64;
+
+    void Build(const float* x, const float* y, const float* z, const float* mu, size_t count);
+
+    /**
+     * @brief Gravitational acceleration on every body from all other bodies
+     *
+     * Output arrays are indexed like the arrays passed to Build. Bodies at the exact same
+     * position do not attract each other instead of producing infinities.
+     */
+    void ComputeAccelerations(float theta, float* ax, float* ay, float* az) const;
+
+    size_t GetBodyCount() const { return m_X.size(); }
+    size_t GetNodeCount() const { return m_Nodes.size(); }
+
+private:
+    static constexpr uint32_t LEAF_MAX_BODIES = 8;
+    static constexpr int MAX_DEPTH = 32;  // Bounds coincident bodies that can never be separated
+
+    struct Node {
+        float centerX = 0.0f, centerY = 0.0f, centerZ = 0.0f;
+        float halfSize = 0.0f;
+        float comX = 0.0f, comY = 0.0f, comZ = 0.0f;  // Center of mass
+        float mu = 0.0f;                              // Summed G * m of the cell
+        uint32_t firstChild = 0;                      // Non-empty children are stored contiguously
+        uint32_t childCount = 0;
+        uint32_t firstBody = 0;                       // Range in tree order
+        uint32_t bodyCount = 0;
+    };
+
+    void BuildNode(uint32_t nodeIndex, int depth);
+    void AccumulateDirect(size_t body, float& ax, float& ay, float& az) const;
+    void AccumulateTree(size_t body, float thetaSq, float& ax, float& ay, float& az) const;
+
+    std::vector<Node> m_Nodes;
+
+    // Bodies in tree order; m_Order maps them back to the caller's indices
+    std::vector<float> m_X, m_Y, m_Z, m_Mu;
+    std::vector<uint32_t> m_Order;
+    std::vector<uint32_t> m_Scratch;
+};
@@ -0,0 +1,90 @@
+#include "BodyStore.h"
+
+namespace {
+    template <typename Column>
+    void SwapRemove(Column& column, const size_t index) {
+        column[index] = column.back();
+        column.pop_back();
+    }
+}
+
+BodyHandle BodyStore::Add(physx::PxRigidDynamic* actor, const size_t sceneIndex, const glm::vec3& position,
+                          const glm::quat& rotation, const glm::vec3& velocity, const float mass, const float radius) {
+    uint32_t slot;
+    if (!m_FreeSlots.empty()) {
+        slot = m_FreeSlots.back();
+        m_FreeSlots.pop_back();
+    } else {
+        slot = static_cast<uint32_t>(m_SlotToIndex.size());
+        m_SlotToIndex.push_back(0);
+        m_Generations.push_back(0);
+    }
+
+    const auto index = static_cast<uint32_t>(Size());
+    m_SlotToIndex[slot] = index;
+    m_IndexToSlot.push_back(slot);
+
+    x.push_back(position.x);
+    y.push_back(position.y);
+    z.push_back(position.z);
+    vx.push_back(velocity.x);
+    vy.push_back(velocity.y);
+    vz.push_back(velocity.z);
+    this->mass.push_back(mass);
+    this->radius.push_back(radius);
+    this->rotation.push_back(rotation);
+    actors.push_back(actor);
+    sceneIndices.push_back(sceneIndex);
+
+    return {slot, m_Generations[slot]};
+}
+
+size_t BodyStore::IndexOf(const BodyHandle handle) const {
+    if (handle.slot >= m_SlotToIndex.size() || m_Generations[handle.slot] != handle.generation) {
+        return INVALID_INDEX;
+    }
+    return m_SlotToIndex[handle.slot];
+}
+
+bool BodyStore::Remove(const BodyHandle handle) {
+    const size_t index = IndexOf(handle);
+    if (index == INVALID_INDEX) {
+        return false;
+    }
+
+    const uint32_t movedSlot = m_IndexToSlot.back();
+    m_SlotToIndex[movedSlot] = static_cast<uint32_t>(index);
+    SwapRemove(m_IndexToSlot, index);
+
+    SwapRemove(x, index);
+    SwapRemove(y, index);
+    SwapRemove(z, index);
+    SwapRemove(vx, index);
+    SwapRemove(vy, index);
+    SwapRemove(vz, index);
+    SwapRemove(mass, index);
+    SwapRemove(radius, index);
+    SwapRemove(rotation, index);
+    SwapRemove(actors, index);
+    SwapRemove(sceneIndices, index);
+
+    m_Generations[handle.slot]++;
+    m_FreeSlots.push_back(handle.slot);
+    return true;
+}
+
+void BodyStore::Clear() {
+    for (uint32_t slot : m_IndexToSlot) {
+        m_Generations[slot]++;
+        m_FreeSlots.push_back(slot);
+    }
+    m_IndexToSlot.clear();
+
+    x.clear(); y.clear(); z.clear();
+    vx.clear(); vy.clear(); vz.clear();
+    mass.clear();
+    radius.clear();
+    rotation.clear();
+    actors.clear();
+    sceneIndices.clear();
+}
@@ -0,0 +1,108 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+namespace physx { class PxRigidDynamic; }
+
+// Minimal allocator handing out cache-line aligned storage, so SoA columns can be streamed with SIMD loads
+template <typename T, size_t Alignment = 64>
+struct AlignedAllocator {
+    using value_type = T;
+
+    template <typename U>
+    struct rebind { using other = AlignedAllocator<U, Alignment>; };
+
+    AlignedAllocator() = default;
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) {}
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Alignment)));
+    }
+    void deallocate(T* p, size_t) {
+        ::operator delete(p, std::align_val_t(Alignment));
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Alignment>&) const { return true; }
+};
+
+/**
+ * @brief Stable reference to a body in a BodyStore
+ *
+ * Survives removals of other bodies. The generation is bumped whenever a slot is freed, so a
+ * handle to a removed body never resolves to the body that later reuses its slot.
+ */
+struct BodyHandle {
+    static constexpr uint32_t INVALID_SLOT = 0xFFFFFFFFu;
+
+    uint32_t slot = INVALID_SLOT;
+    uint32_t generation = 0;
+
+    bool IsValid() const { return slot != INVALID_SLOT; }
+    bool operator==(const BodyHandle&) const = default;
+
+    // Packed into PxActor::userData so contact callbacks resolve their body without a search
+    void* ToUserData() const {
+        return reinterpret_cast<void*>(static_cast<uintptr_t>(generation) << 32 | slot);
+    }
+    static BodyHandle FromUserData(const void* userData) {
+        const auto bits = reinterpret_cast<uintptr_t>(userData);
+        return {static_cast<uint32_t>(bits), static_cast<uint32_t>(bits >> 32)};
+    }
+};
+
+static_assert(sizeof(void*) >= 8, "BodyHandle is packed into a 64-bit PxActor::userData");
+
+/**
+ * @brief Dense structure-of-arrays storage for all dynamic physics bodies
+ *
+ * Hot per-body state lives in separate aligned columns that are all Size() long and indexed by
+ * the same dense index, so gravity, path recording and uploads stream over contiguous memory.
+ * The PhysX actor and scene object of every body are kept as side tables in the same order.
+ *
+ * Removal swaps the last body into the freed index, so dense indices are only valid until the
+ * next Remove(); hold on to BodyHandles across frames instead.
+ */
+class BodyStore {
+public:
+    template <typename T>
+    using Column = std::vector<T, AlignedAllocator<T>>;
+
+    static constexpr size_t INVALID_INDEX = static_cast<size_t>(-1);
+
+    BodyHandle Add(physx::PxRigidDynamic* actor, size_t sceneIndex, const glm::vec3& position,
+                   const glm::quat& rotation, const glm::vec3& velocity, float mass, float radius);
+
+    // Swap-and-pop removal; returns false for handles that are invalid or already removed
+    bool Remove(BodyHandle handle);
+    void Clear();
+
+    bool Contains(BodyHandle handle) const { return IndexOf(handle) != INVALID_INDEX; }
+    size_t IndexOf(BodyHandle handle) const;
+    BodyHandle HandleAt(size_t index) const { return {m_IndexToSlot[index], m_Generations[m_IndexToSlot[index]]}; }
+
+    size_t Size() const { return actors.size(); }
+    bool Empty() const { return actors.empty(); }
+
+    // Columns are resized only through Add / Remove / Clear
+    Column<float> x, y, z;
+    Column<float> vx, vy, vz;
+    Column<float> mass;
+    Column<float> radius;
+    Column<glm::quat> rotation;
+
+    std::vector<physx::PxRigidDynamic*> actors;
+    std::vector<size_t> sceneIndices;
+
+private:
+    std::vector<uint32_t> m_SlotToIndex;
+    std::vector<uint32_t> m_IndexToSlot;
+    std::vector<uint32_t> m_Generations;
+    std::vector<uint32_t> m_FreeSlots;
+};
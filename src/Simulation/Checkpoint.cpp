@@ -0,0 +1,204 @@
+#include "Checkpoint.h"
+#include <charconv>
+#include <fstream>
+#include <string>
+#include <spdlog/spdlog.h>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+    constexpr uint32_t SPILL_MAGIC = 0x4B43484D;  // "MHCK"
+
+    struct SpillHeader {
+        uint32_t magic = SPILL_MAGIC;
+        uint32_t reserved = 0;
+        uint64_t fingerprint = 0;
+        uint64_t step = 0;
+        uint64_t size = 0;
+    };
+
+    uint64_t CurrentProcessId() {
+#ifdef _WIN32
+        return GetCurrentProcessId();
+#else
+        return static_cast<uint64_t>(getpid());
+#endif
+    }
+}
+
+void CheckpointStore::Reset(const uint64_t fingerprint, const size_t memoryBudget, const std::filesystem::path& spillDirectory) {
+    Clear();
+    m_Fingerprint = fingerprint;
+    m_MemoryBudget = memoryBudget;
+    m_SpillDirectory = spillDirectory;
+
+    if (m_SpillDirectory.empty()) return;
+
+    std::error_code error;
+    std::filesystem::create_directories(m_SpillDirectory, error);
+    if (error) {
+        spdlog::warn("Cannot create checkpoint directory {}: {}, keeping checkpoints in memory only",
+                     m_SpillDirectory.string(), error.message());
+        m_SpillDirectory.clear();
+        return;
+    }
+
+    // <fingerprint>-<step>.ckpt
+    const std::string prefix = fmt::format("{:016x}-", m_Fingerprint);
+    for (const auto& file : std::filesystem::directory_iterator(m_SpillDirectory, error)) {
+        if (file.path().extension() != ".ckpt") continue;
+
+        const std::string stem = file.path().stem().string();
+        if (!stem.starts_with(prefix)) continue;
+
+        uint64_t step = 0;
+        const char* begin = stem.data() + prefix.size();
+        const char* end = stem.data() + stem.size();
+        if (const auto [ptr, parseError] = std::from_chars(begin, end, step); parseError == std::errc() && ptr == end) {
+            m_SpilledSteps.insert(step);
+        }
+    }
+
+    if (!m_SpilledSteps.empty()) {
+        spdlog::info("Found {} checkpoints of this run in {} (up to step {})",
+                     m_SpilledSteps.size(), m_SpillDirectory.string(), *m_SpilledSteps.rbegin());
+    }
+}
+
+void CheckpointStore::Clear() {
+    m_Entries.clear();
+    m_Recent.clear();
+    m_SpilledSteps.clear();
+    m_Bytes = 0;
+}
+
+void CheckpointStore::Store(const uint64_t step, std::vector<uint8_t> data) {
+    if (!m_SpillDirectory.empty() && !m_SpilledSteps.contains(step) && Spill(step, data)) {
+        m_SpilledSteps.insert(step);
+    }
+    Insert(step, std::move(data));
+}
+
+std::optional<CheckpointStore::Checkpoint> CheckpointStore::FindAtOrBefore(const uint64_t step) {
+    std::optional<uint64_t> inMemory;
+    if (auto it = m_Entries.upper_bound(step); it != m_Entries.begin()) {
+        inMemory = std::prev(it)->first;
+    }
+
+    // A later checkpoint on disk is still cheaper to load than the steps between the two
+    std::optional<uint64_t> onDisk;
+    if (auto it = m_SpilledSteps.upper_bound(step); it != m_SpilledSteps.begin()) {
+        onDisk = *std::prev(it);
+    }
+
+    if (onDisk && (!inMemory || *onDisk > *inMemory)) {
+        if (auto data = LoadSpilled(*onDisk)) {
+            Insert(*onDisk, *data);
+            return Checkpoint{*onDisk, std::move(*data)};
+        }
+        // Unreadable file, forget it and fall back to memory or earlier files
+        m_SpilledSteps.erase(*onDisk);
+        return FindAtOrBefore(step);
+    }
+
+    if (!inMemory) {
+        return std::nullopt;
+    }
+    Entry& entry = m_Entries.at(*inMemory);
+    Touch(entry);
+    return Checkpoint{*inMemory, entry.data};
+}
+
+void CheckpointStore::Insert(const uint64_t step, std::vector<uint8_t> data) {
+    if (auto it = m_Entries.find(step); it != m_Entries.end()) {
+        m_Bytes -= it->second.data.size();
+        m_Recent.erase(it->second.recent);
+        m_Entries.erase(it);
+    }
+
+    m_Bytes += data.size();
+    m_Recent.push_front(step);
+    m_Entries.emplace(step, Entry{std::move(data), m_Recent.begin()});
+    Evict();
+}
+
+void CheckpointStore::Touch(Entry& entry) {
+    m_Recent.splice(m_Recent.begin(), m_Recent, entry.recent);
+}
+
+void CheckpointStore::Evict() {
+    // The most recent snapshot always stays, even when it alone is over budget
+    while (m_Bytes > m_MemoryBudget && m_Recent.size() > 1) {
+        const uint64_t step = m_Recent.back();
+        m_Recent.pop_back();
+
+        const auto it = m_Entries.find(step);
+        m_Bytes -= it->second.data.size();
+        m_Entries.erase(it);
+    }
+}
+
+std::filesystem::path CheckpointStore::SpillPath(const uint64_t step) const {
+    return m_SpillDirectory / fmt::format("{:016x}-{}.ckpt", m_Fingerprint, step);
+}
+
+bool CheckpointStore::Spill(const uint64_t step, const std::vector<uint8_t>& data) const {
+    const std::filesystem::path path = SpillPath(step);
+    // Export workers can share a checkpoint directory and spill the same step, so each process writes its own temporary
+    std::filesystem::path temporary = path;
+    temporary += fmt::format(".{}.tmp", CurrentProcessId());
+
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        SpillHeader header;
+        header.fingerprint = m_Fingerprint;
+        header.step = step;
+        header.size = data.size();
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+        if (!file) {
+            spdlog::warn("Failed to write checkpoint {}", temporary.string());
+            return false;
+        }
+    }
+
+    // Renamed into place once complete, so a crash mid-write never leaves a truncated checkpoint behind
+    std::error_code error;
+    std::filesystem::rename(temporary, path, error);
+    if (error) {
+        spdlog::warn("Failed to store checkpoint {}: {}", path.string(), error.message());
+        std::filesystem::remove(temporary, error);
+        return false;
+    }
+    return true;
+}
+
+std::optional<std::vector<uint8_t>> CheckpointStore::LoadSpilled(const uint64_t step) const {
+    const std::filesystem::path path = SpillPath(step);
+    std::ifstream file(path, std::ios::binary);
+
+    SpillHeader header;
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!file || header.magic != SPILL_MAGIC || header.fingerprint != m_Fingerprint || header.step != step) {
+        spdlog::warn("Ignoring invalid checkpoint file {}", path.string());
+        return std::nullopt;
+    }
+
+    std::vector<uint8_t> data(header.size);
+    file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size()));
+    if (!file) {
+        spdlog::warn("Ignoring truncated checkpoint file {}", path.string());
+        return std::nullopt;
+    }
+    return data;
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <list>
+#include <map>
+#include <optional>
+#include <set>
+#include <vector>
+
+/**
+ * @brief Simulation snapshots keyed by step, so any step is reached by replaying at most one
+ * checkpoint interval
+ *
+ * Snapshots are kept in memory up to a byte budget, evicting the least recently used. With a spill
+ * directory every snapshot is also written through to disk, named after the run fingerprint and the
+ * step; evicted steps are then loaded back on demand, and a new process for the same run (a resumed
+ * or parallel export) picks up the files of earlier ones. The fingerprint identifies the initial
+ * state and step size, so files of a different run are never mistaken for this one.
+ */
+class CheckpointStore {
+public:
+    struct Checkpoint {
+        uint64_t step = 0;
+        std::vector<uint8_t> data;
+    };
+
+    // Drops all snapshots in memory and indexes the spill files matching fingerprint
+    void Reset(uint64_t fingerprint, size_t memoryBudget, const std::filesystem::path& spillDirectory);
+    void Clear();
+
+    void Store(uint64_t step, std::vector<uint8_t> data);
+    bool Contains(uint64_t step) const { return m_Entries.contains(step) || m_SpilledSteps.contains(step); }
+
+    // Latest snapshot at or before step, nullopt when there is none
+    std::optional<Checkpoint> FindAtOrBefore(uint64_t step);
+
+    size_t GetMemoryUsage() const { return m_Bytes; }
+
+private:
+    struct Entry {
+        std::vector<uint8_t> data;
+        std::list<uint64_t>::iterator recent;
+    };
+
+    std::map<uint64_t, Entry> m_Entries;
+    std::list<uint64_t> m_Recent;  // Most recently used first
+    std::set<uint64_t> m_SpilledSteps;
+    size_t m_Bytes = 0;
+    size_t m_MemoryBudget = 0;
+    uint64_t m_Fingerprint = 0;
+    std::filesystem::path m_SpillDirectory;
+
+    void Insert(uint64_t step, std::vector<uint8_t> data);
+    void Touch(Entry& entry);
+    void Evict();
+    std::filesystem::path SpillPath(uint64_t step) const;
+    bool Spill(uint64_t step, const std::vector<uint8_t>& data) const;
+    std::optional<std::vector<uint8_t>> LoadSpilled(uint64_t step) const;
+};
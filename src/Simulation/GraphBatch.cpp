@@ -0,0 +1,102 @@
+#include "GraphBatch.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "Application/ThreadPool.h"
+
+namespace GraphBatch {
+namespace {
+    // Below this many elements a batch is cheaper to run on the calling thread
+    constexpr size_t PARALLEL_MIN_ELEMENTS = 16384;
+    constexpr size_t PARALLEL_GRAIN = 4096;
+
+    // Broadcasts are hoisted out of the loop so each variant is a straight vectorizable loop
+    template<typename F>
+    void Apply(const Lane a, const Lane b, float* __restrict out, const size_t begin, const size_t end, F f) {
+        const float* __restrict pa = a.data;
+        const float* __restrict pb = b.data;
+        if (!a.broadcast && !b.broadcast) {
+            for (size_t i = begin; i < end; i++) out[i] = f(pa[i], pb[i]);
+        } else if (!a.broadcast) {
+            const float sb = pb[0];
+            for (size_t i = begin; i < end; i++) out[i] = f(pa[i], sb);
+        } else if (!b.broadcast) {
+            const float sa = pa[0];
+            for (size_t i = begin; i < end; i++) out[i] = f(sa, pb[i]);
+        } else {
+            std::fill(out + begin, out + end, f(pa[0], pb[0]));
+        }
+    }
+
+    template<typename F>
+    void Apply(const Lane a, float* __restrict out, const size_t begin, const size_t end, F f) {
+        const float* __restrict pa = a.data;
+        if (!a.broadcast) {
+            for (size_t i = begin; i < end; i++) out[i] = f(pa[i]);
+        } else {
+            std::fill(out + begin, out + end, f(pa[0]));
+        }
+    }
+}
+
+void ForEachChunk(const size_t count, const std::function<void(size_t, size_t)>& fn) {
+    if (count < PARALLEL_MIN_ELEMENTS) {
+        fn(0, count);
+        return;
+    }
+    ThreadPool::Global().ParallelFor(0, count, PARALLEL_GRAIN, fn);
+}
+
+void Binary(const BinaryOp op, const Lane a, const Lane b, float* out, const size_t count) {
+    ForEachChunk(count, [&](const size_t begin, const size_t end) {
+        switch (op) {
+            case BinaryOp::Add: Apply(a, b, out, begin, end, [](float x, float y) { return x + y; }); break;
+            case BinaryOp::Sub: Apply(a, b, out, begin, end, [](float x, float y) { return x - y; }); break;
+            case BinaryOp::Mul: Apply(a, b, out, begin, end, [](float x, float y) { return x * y; }); break;
+            // A zero divisor gives 0, like the scalar Div node
+            case BinaryOp::Div: Apply(a, b, out, begin, end, [](float x, float y) { return y != 0.0f ? x / y : 0.0f; }); break;
+            case BinaryOp::Min: Apply(a, b, out, begin, end, [](float x, float y) { return std::min(x, y); }); break;
+            case BinaryOp::Max: Apply(a, b, out, begin, end, [](float x, float y) { return std::max(x, y); }); break;
+        }
+    });
+}
+
+void Unary(const UnaryOp op, const Lane a, float* out, const size_t count) {
+    ForEachChunk(count, [&](const size_t begin, const size_t end) {
+        switch (op) {
+            case UnaryOp::Negate: Apply(a, out, begin, end, [](float x) { return -x; }); break;
+            case UnaryOp::Sqrt: Apply(a, out, begin, end, [](float x) { return std::sqrt(std::max(0.0f, x)); }); break;
+            case UnaryOp::Sin: Apply(a, out, begin, end, [](float x) { return std::sin(x); }); break;
+            case UnaryOp::Cos: Apply(a, out, begin, end, [](float x) { return std::cos(x); }); break;
+            case UnaryOp::Tan: Apply(a, out, begin, end, [](float x) { return std::tan(x); }); break;
+        }
+    });
+}
+
+void Lerp(const Lane a, const Lane b, const Lane t, float* out, const size_t count) {
+    ForEachChunk(count, [&](const size_t begin, const size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            const float x = a[i];
+            out[i] = x + (b[i] - x) * t[i];
+        }
+    });
+}
+
+void Clamp(const Lane value, const Lane lo, const Lane hi, float* out, const size_t count) {
+    ForEachChunk(count, [&](const size_t begin, const size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            out[i] = std::min(std::max(value[i], lo[i]), hi[i]);
+        }
+    });
+}
+
+void Length(const Lane x, const Lane y, const Lane z, float* out, const size_t count) {
+    ForEachChunk(count, [&](const size_t begin, const size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            const float px = x[i], py = y[i], pz = z[i];
+            out[i] = std::sqrt(px * px + py * py + pz * pz);
+        }
+    });
+}
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+/**
+ * @brief Array values and kernels for the animation graph's batch nodes
+ *
+ * A batch carries one value per scene object of a class. Vectors are stored as separate x / y / z
+ * columns so every kernel is a plain loop over contiguous floats that the compiler vectorizes.
+ * Large batches are split across the global ThreadPool.
+ */
+namespace GraphBatch {
+    struct FloatArray {
+        std::vector<float> values;
+
+        size_t Size() const { return values.size(); }
+        bool operator==(const FloatArray&) const = default;
+    };
+
+    struct Vec3Array {
+        std::vector<float> x, y, z;
+
+        size_t Size() const { return x.size(); }
+        void Resize(size_t count) { x.resize(count); y.resize(count); z.resize(count); }
+        bool operator==(const Vec3Array&) const = default;
+    };
+
+    // Scene object indices of a batch, in scene order
+    struct ObjectBatch {
+        std::vector<uint32_t> indices;
+
+        size_t Size() const { return indices.size(); }
+        bool operator==(const ObjectBatch&) const = default;
+    };
+
+    // One component of an operand: an array, or a single scalar broadcast to every element
+    struct Lane {
+        const float* data = nullptr;
+        bool broadcast = false;
+
+        float operator[](size_t i) const { return broadcast ? data[0] : data[i]; }
+    };
+
+    // Runs fn over [0, count) in chunks; small batches stay on the calling thread
+    void ForEachChunk(size_t count, const std::function<void(size_t, size_t)>& fn);
+
+    enum class BinaryOp { Add, Sub, Mul, Div, Min, Max };
+    enum class UnaryOp { Negate, Sqrt, Sin, Cos, Tan };
+
+    void Binary(BinaryOp op, Lane a, Lane b, float* out, size_t count);
+    void Unary(UnaryOp op, Lane a, float* out, size_t count);
+    void Lerp(Lane a, Lane b, Lane t, float* out, size_t count);
+    void Clamp(Lane value, Lane lo, Lane hi, float* out, size_t count);
+
+    // Euclidean length of (x, y, z) per element
+    void Length(Lane x, Lane y, Lane z, float* out, size_t count);
+}
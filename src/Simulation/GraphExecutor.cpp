@@ -2,8 +2,125 @@
 #include <spdlog/spdlog.h>
 #include <glm/gtc/constants.hpp>
 #include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <unordered_map>
 #include "Renderer/Camera.h"
+#include "Snapshot.h"
+
+namespace {
+    using NodeType = AnimationGraph::NodeType;
+    using NodeSubType = AnimationGraph::NodeSubType;
+
+    constexpr uint32_t NO_INSTRUCTION = 0xFFFFFFFFu;
+
+    // Component-wise division where a zero divisor gives 0, matching the float Div node and the batch path
+    template<typename Vec>
+    Vec SafeDivide(const Vec& a, const Vec& b) {
+        Vec result(0.0f);
+        for (glm::length_t i = 0; i < Vec::length(); ++i) {
+            result[i] = b[i] != 0.0f ? a[i] / b[i] : 0.0f;
+        }
+        return result;
+    }
+
+    // Nodes evaluated for their output values
+    bool IsDataNode(NodeType type, NodeSubType subType) {
+        switch (type) {
+            case NodeType::Constant:
+            case NodeType::Function:
+            case NodeType::Decomposer:
+            case NodeType::Other:
+                return true;
+            case NodeType::Variable:
+                return subType == NodeSubType::VariableGet;
+            default:
+                return false;
+        }
+    }
+
+    // Nodes run when flow reaches one of their input pins
+    bool IsFlowNode(NodeType type, NodeSubType subType) {
+        switch (type) {
+            case NodeType::Print:
+            case NodeType::Control:
+            case NodeType::Setter:
+                return true;
+            case NodeType::Variable:
+                return subType == NodeSubType::VariableSet;
+            default:
+                return false;
+        }
+    }
+
+    bool IsBatch(const GraphExecutor::Value& value) {
+        return std::holds_alternative<GraphBatch::FloatArray>(value) || std::holds_alternative<GraphBatch::Vec3Array>(value);
+    }
+
+    // A batch operand split into x / y / z lanes; floats use the same lane for every component
+    struct BatchOperand {
+        GraphBatch::Lane lanes[3];
+        size_t size = SIZE_MAX;  // Element count, SIZE_MAX for broadcast scalars
+        bool vector = false;
+        bool valid = false;
+    };
+
+    BatchOperand ToBatchOperand(const GraphExecutor::Value& value, float& scalarStorage) {
+        BatchOperand op;
+        if (const auto* v = std::get_if<GraphBatch::Vec3Array>(&value)) {
+            op.lanes[0] = {v->x.data(), false};
+            op.lanes[1] = {v->y.data(), false};
+            op.lanes[2] = {v->z.data(), false};
+            op.size = v->Size();
+            op.vector = true;
+        } else if (const auto* f = std::get_if<GraphBatch::FloatArray>(&value)) {
+            op.lanes[0] = op.lanes[1] = op.lanes[2] = {f->values.data(), false};
+            op.size = f->Size();
+        } else if (const auto* v3 = std::get_if<glm::vec3>(&value)) {
+            op.lanes[0] = {&v3->x, true};
+            op.lanes[1] = {&v3->y, true};
+            op.lanes[2] = {&v3->z, true};
+            op.vector = true;
+        } else if (const auto* s = std::get_if<float>(&value)) {
+            op.lanes[0] = op.lanes[1] = op.lanes[2] = {s, true};
+        } else if (const auto* i = std::get_if<int>(&value)) {
+            scalarStorage = static_cast<float>(*i);
+            op.lanes[0] = op.lanes[1] = op.lanes[2] = {&scalarStorage, true};
+        } else {
+            return op;
+        }
+        op.valid = true;
+        return op;
+    }
+
+    // One component of an element-wise math node; false for operations without a batch form
+    bool RunElementwise(const NodeSubType subType, const BatchOperand* ops, const size_t c, float* out, const size_t count) {
+        using GraphBatch::BinaryOp;
+        using GraphBatch::UnaryOp;
+        switch (subType) {
+            case NodeSubType::Add: GraphBatch::Binary(BinaryOp::Add, ops[0].lanes[c], ops[1].lanes[c], out, count); return true;
+            case NodeSubType::Sub: GraphBatch::Binary(BinaryOp::Sub, ops[0].lanes[c], ops[1].lanes[c], out, count); return true;
+            case NodeSubType::Mul: GraphBatch::Binary(BinaryOp::Mul, ops[0].lanes[c], ops[1].lanes[c], out, count); return true;
+            case NodeSubType::Div: GraphBatch::Binary(BinaryOp::Div, ops[0].lanes[c], ops[1].lanes[c], out, count); return true;
+            case NodeSubType::Min: GraphBatch::Binary(BinaryOp::Min, ops[0].lanes[c], ops[1].lanes[c], out, count); return true;
+            case NodeSubType::Max: GraphBatch::Binary(BinaryOp::Max, ops[0].lanes[c], ops[1].lanes[c], out, count); return true;
+            case NodeSubType::Negate: GraphBatch::Unary(UnaryOp::Negate, ops[0].lanes[c], out, count); return true;
+            case NodeSubType::Sqrt: GraphBatch::Unary(UnaryOp::Sqrt, ops[0].lanes[c], out, count); return true;
+            case NodeSubType::Sin: GraphBatch::Unary(UnaryOp::Sin, ops[0].lanes[c], out, count); return true;
+            case NodeSubType::Cos: GraphBatch::Unary(UnaryOp::Cos, ops[0].lanes[c], out, count); return true;
+            case NodeSubType::Tan: GraphBatch::Unary(UnaryOp::Tan, ops[0].lanes[c], out, count); return true;
+            case NodeSubType::Lerp: GraphBatch::Lerp(ops[0].lanes[c], ops[1].lanes[c], ops[2].lanes[c], out, count); return true;
+            case NodeSubType::Clamp: GraphBatch::Clamp(ops[0].lanes[c], ops[1].lanes[c], ops[2].lanes[c], out, count); return true;
+            default: return false;
+        }
+    }
+
+    template<typename T>
+    T ReadField(const SceneObject& obj, const HotField field, const T& fallback) {
+        const T* typed = obj.Find<T>(field);
+        return typed ? *typed : fallback;
+    }
+}
 
 GraphExecutor::GraphExecutor(AnimationGraph* graph, Scene* scene)
     : m_pGraph(graph), m_pScene(scene) {
@@ -12,177 +129,438 @@ GraphExecutor::GraphExecutor(AnimationGraph* graph, Scene* scene)
 void GraphExecutor::ExecuteStartEvent() {
     if (!m_pGraph) return;
 
-    for (auto& node : m_pGraph->GetNodes()) {
-        if (node.Type == AnimationGraph::NodeType::Event &&
-            node.SubType == AnimationGraph::NodeSubType::Start) {
-            if (!node.Outputs.empty()) {
-                ExecuteFlowFromPin(node.Outputs[0].Id, 0.0f);
-            }
-        }
+    EnsureCompiled();
+
+    for (const uint32_t flow : m_StartEntries) {
+        ExecuteFlow(flow);
     }
 }
 
 void GraphExecutor::ExecuteTickEvent(float deltaTime) {
     if (!m_pGraph) return;
 
-    m_PinValues.clear();
+    EnsureCompiled();
 
-    // spdlog::debug("[GraphExecutor] ExecuteTickEvent called with deltaTime={}", deltaTime);
+    for (const TickEntry& entry : m_TickEntries) {
+        Write(entry.deltaTimeRegister, deltaTime);
+        ExecuteFlow(entry.flow);
+    }
+}
 
-    for (auto& node : m_pGraph->GetNodes()) {
-        if (node.Type == AnimationGraph::NodeType::Event &&
-            node.SubType == AnimationGraph::NodeSubType::Tick) {
-            if (!node.Outputs.empty()) {
-                m_PinValues[node.Outputs[1].Id.Get()] = deltaTime;
-                spdlog::debug("[GraphExecutor] Found Tick node, storing deltaTime in pin {}", node.Outputs[1].Id.Get());
-                ExecuteFlowFromPin(node.Outputs[0].Id, deltaTime);
-            }
-        }
+void GraphExecutor::WriteVariables(SnapshotWriter& writer) const {
+    writer.Write(static_cast<uint32_t>(m_VariableNames.size()));
+    for (size_t v = 0; v < m_VariableNames.size(); v++) {
+        const Value& value = m_VariableValues[v];
+        writer.WriteString(m_VariableNames[v]);
+        writer.Write(static_cast<uint8_t>(value.index()));
+
+        std::visit([&](const auto& payload) {
+            using T = std::decay_t<decltype(payload)>;
+            if constexpr (std::is_same_v<T, std::string>) {
+                writer.WriteString(payload);
+            } else if constexpr (std::is_same_v<T, SceneObject*>) {
+                uint64_t index = UINT64_MAX;
+                if (payload && m_pScene && !m_pScene->objects.empty() &&
+                    payload >= m_pScene->objects.data() && payload < m_pScene->objects.data() + m_pScene->objects.size()) {
+                    index = static_cast<uint64_t>(payload - m_pScene->objects.data());
+                }
+                writer.Write(index);
+            } else if constexpr (std::is_same_v<T, Camera*>) {
+                writer.Write(static_cast<uint8_t>(payload != nullptr));
+            } else if constexpr (std::is_same_v<T, bool> || std::is_same_v<T, int> || std::is_same_v<T, float> ||
+                                 std::is_same_v<T, glm::vec2> || std::is_same_v<T, glm::vec3> ||
+                                 std::is_same_v<T, glm::vec4> || std::is_same_v<T, glm::quat>) {
+                writer.Write(payload);
+            }
+        }, value);
     }
 }
 
-void GraphExecutor::ExecuteFlowFromPin(ax::NodeEditor::PinId pinId, float deltaTime) {
-    for (const auto& link : m_pGraph->GetLinks()) {
-        if (link.StartPinId == pinId) {
-            if (auto* targetNode = FindNodeByInputPin(link.EndPinId)) {
-                ExecuteNode(targetNode, link.EndPinId, deltaTime);
+void GraphExecutor::ReadVariables(SnapshotReader& reader) {
+    if (m_pGraph) {
+        EnsureCompiled();
+    }
+
+    const uint32_t count = reader.Read<uint32_t>();
+    for (uint32_t i = 0; i < count; i++) {
+        const std::string name = reader.ReadString();
+        const uint8_t index = reader.Read<uint8_t>();
+
+        // Alternatives by their index in Value
+        static_assert(std::variant_size_v<Value> == 14, "Snapshot encoding of Value is out of date");
+        Value value;
+        switch (index) {
+            case 1: value = static_cast<bool>(reader.Read<uint8_t>()); break;
+            case 2: value = reader.Read<int>(); break;
+            case 3: value = reader.Read<float>(); break;
+            case 4: value = reader.Read<glm::vec2>(); break;
+            case 5: value = reader.Read<glm::vec3>(); break;
+            case 6: value = reader.Read<glm::vec4>(); break;
+            case 7: value = reader.Read<glm::quat>(); break;
+            case 8: value = reader.ReadString(); break;
+            case 9: {
+                const auto objectIndex = reader.Read<uint64_t>();
+                if (m_pScene && objectIndex < m_pScene->objects.size()) {
+                    value = &m_pScene->objects[objectIndex];
+                } else {
+                    value = static_cast<SceneObject*>(nullptr);
+                }
+                break;
             }
+            case 10: value = reader.Read<uint8_t>() && m_pScene ? m_pScene->camera : nullptr; break;
+            default: break;
         }
+
+        // Variables the graph no longer has are dropped, the same as on a recompile
+        const auto it = std::find(m_VariableNames.begin(), m_VariableNames.end(), name);
+        if (it == m_VariableNames.end()) continue;
+
+        const auto slot = static_cast<size_t>(it - m_VariableNames.begin());
+        m_VariableValues[slot] = std::move(value);
+        MarkDirty(m_VariableReaderRanges[slot], m_VariableReaders);
     }
 }
 
-void GraphExecutor::ExecuteNode(AnimationGraph::Node* node, ax::NodeEditor::PinId entryPin, float deltaTime) {
-    switch (node->Type) {
-        case AnimationGraph::NodeType::Print:
-            ExecutePrint(node, deltaTime);
-            if (!node->Outputs.empty()) {
-                ExecuteFlowFromPin(node->Outputs[0].Id, deltaTime);
+void GraphExecutor::EnsureCompiled() {
+    if (m_CompiledRevision != m_pGraph->GetRevision()) {
+        Compile();
+        m_CompiledRevision = m_pGraph->GetRevision();
+    }
+}
+
+void GraphExecutor::Compile() {
+    const auto tStart = std::chrono::steady_clock::now();
+    const auto& nodes = m_pGraph->GetNodes();
+    const auto& links = m_pGraph->GetLinks();
+    const auto nodeCount = static_cast<uint32_t>(nodes.size());
+
+    m_Instructions.assign(nodeCount, Instruction{});
+    m_Operands.clear();
+    m_FlowRanges.clear();
+    m_FlowTargets.clear();
+    m_Prelude.clear();
+    m_Consumers.clear();
+    m_VariableReaders.clear();
+    m_StartEntries.clear();
+    m_TickEntries.clear();
+
+    // Assign one register per output pin; pin ids are only hashed here, never while executing
+    uint32_t registerCount = UNCONNECTED_REGISTER + 1;
+    std::unordered_map<uintptr_t, uint32_t> outputRegisters;
+    std::unordered_map<uintptr_t, uint32_t> inputOwners;
+    std::unordered_map<std::string, uint32_t> variableSlots;
+    std::vector<std::string> variableNames;
+
+    for (uint32_t i = 0; i < nodeCount; i++) {
+        const auto& node = nodes[i];
+        Instruction& inst = m_Instructions[i];
+        inst.type = node.Type;
+        inst.subType = node.SubType;
+        inst.node = i;
+        inst.outputs = {registerCount, registerCount + static_cast<uint32_t>(node.Outputs.size())};
+        registerCount = inst.outputs.end;
+
+        for (size_t k = 0; k < node.Outputs.size(); k++) {
+            outputRegisters.emplace(node.Outputs[k].Id.Get(), inst.outputs.begin + static_cast<uint32_t>(k));
+        }
+        for (const auto& pin : node.Inputs) {
+            inputOwners.emplace(pin.Id.Get(), i);
+        }
+
+        if (node.Type == NodeType::Variable) {
+            const auto [it, inserted] = variableSlots.try_emplace(node.VariableName, static_cast<uint32_t>(variableNames.size()));
+            if (inserted) {
+                variableNames.push_back(node.VariableName);
             }
-            break;
-        case AnimationGraph::NodeType::Control:
-            ExecuteControlFlow(node, entryPin, deltaTime);
-            break;
-        case AnimationGraph::NodeType::Setter:
-            ExecuteSetter(node, deltaTime);
-            if (!node->Outputs.empty()) {
-                ExecuteFlowFromPin(node->Outputs[0].Id, deltaTime);
+            inst.variable = it->second;
+        }
+    }
+
+    // An input reads the first link ending on it; flow pins fan out to every linked flow node in link order
+    std::unordered_map<uintptr_t, uint32_t> inputSources;
+    std::unordered_map<uintptr_t, std::vector<uint32_t>> flowTargets;
+    for (const auto& link : links) {
+        if (const auto source = outputRegisters.find(link.StartPinId.Get()); source != outputRegisters.end()) {
+            inputSources.try_emplace(link.EndPinId.Get(), source->second);
+        }
+        if (const auto target = inputOwners.find(link.EndPinId.Get()); target != inputOwners.end()) {
+            const Instruction& targetInst = m_Instructions[target->second];
+            if (IsFlowNode(targetInst.type, targetInst.subType)) {
+                flowTargets[link.StartPinId.Get()].push_back(target->second);
             }
-            break;
-        case AnimationGraph::NodeType::Variable:
-            if (node->SubType == AnimationGraph::NodeSubType::VariableSet) {
-                ExecuteVariableSet(node, deltaTime);
-                if (!node->Outputs.empty()) {
-                    ExecuteFlowFromPin(node->Outputs[0].Id, deltaTime);
+        }
+    }
+
+    std::vector<uint32_t> producers(registerCount, NO_INSTRUCTION);
+    for (uint32_t i = 0; i < nodeCount; i++) {
+        const auto& node = nodes[i];
+        Instruction& inst = m_Instructions[i];
+
+        inst.operands.begin = static_cast<uint32_t>(m_Operands.size());
+        for (const auto& pin : node.Inputs) {
+            const auto source = inputSources.find(pin.Id.Get());
+            m_Operands.push_back(source != inputSources.end() ? source->second : UNCONNECTED_REGISTER);
+        }
+        inst.operands.end = static_cast<uint32_t>(m_Operands.size());
+
+        inst.flows.begin = static_cast<uint32_t>(m_FlowRanges.size());
+        for (const auto& pin : node.Outputs) {
+            Range range{static_cast<uint32_t>(m_FlowTargets.size()), 0};
+            if (pin.Type == AnimationGraph::PinType::Flow) {
+                if (const auto targets = flowTargets.find(pin.Id.Get()); targets != flowTargets.end()) {
+                    m_FlowTargets.insert(m_FlowTargets.end(), targets->second.begin(), targets->second.end());
                 }
             }
-            break;
-        default:
-            break;
+            range.end = static_cast<uint32_t>(m_FlowTargets.size());
+            m_FlowRanges.push_back(range);
+        }
+        inst.flows.end = static_cast<uint32_t>(m_FlowRanges.size());
+
+        for (uint32_t r = inst.outputs.begin; r < inst.outputs.end; r++) {
+            producers[r] = i;
+        }
     }
-}
 
-GraphExecutor::Value GraphExecutor::EvaluatePinValue(ax::NodeEditor::PinId pinId, float deltaTime) {
-    spdlog::debug("[GraphExecutor] EvaluatePinValue for pin {}", pinId.Get());
+    // Prelude of every flow node: its data dependencies in post-order, so each node runs after its inputs.
+    // Cycles between data nodes are cut where they are first revisited.
+    std::vector<uint32_t> visitMarks(nodeCount, 0);
+    std::vector<std::pair<uint32_t, uint32_t>> stack;
+    uint32_t visitGeneration = 0;
+
+    auto visit = [&](const uint32_t reg) {
+        const uint32_t index = producers[reg];
+        if (index == NO_INSTRUCTION || visitMarks[index] == visitGeneration) return;
+        const Instruction& inst = m_Instructions[index];
+        if (!IsDataNode(inst.type, inst.subType)) return;
+        visitMarks[index] = visitGeneration;
+        stack.emplace_back(index, 0);
+    };
 
-    if (m_PinValues.contains(pinId.Get())) {
-        auto& val = m_PinValues[pinId.Get()];
-        spdlog::debug("[GraphExecutor] Pin {} found in cache: {}", pinId.Get(), ValueToString(val));
-        return val;
+    for (uint32_t i = 0; i < nodeCount; i++) {
+        Instruction& root = m_Instructions[i];
+        if (!IsFlowNode(root.type, root.subType)) continue;
+
+        visitGeneration++;
+        root.prelude.begin = static_cast<uint32_t>(m_Prelude.size());
+        for (uint32_t o = root.operands.begin; o < root.operands.end; o++) {
+            visit(m_Operands[o]);
+            while (!stack.empty()) {
+                const uint32_t index = stack.back().first;
+                const Instruction& inst = m_Instructions[index];
+                if (stack.back().second < inst.operands.Size()) {
+                    visit(m_Operands[inst.operands.begin + stack.back().second++]);
+                } else {
+                    m_Prelude.push_back(index);
+                    stack.pop_back();
+                }
+            }
+        }
+        root.prelude.end = static_cast<uint32_t>(m_Prelude.size());
+    }
+
+    // Reverse edges used to push changes: data nodes reading each register, VariableGets of each slot
+    std::vector<std::vector<uint32_t>> consumers(registerCount);
+    std::vector<std::vector<uint32_t>> variableReaders(variableNames.size());
+    for (uint32_t i = 0; i < nodeCount; i++) {
+        const Instruction& inst = m_Instructions[i];
+        if (!IsDataNode(inst.type, inst.subType)) continue;
+        for (uint32_t o = inst.operands.begin; o < inst.operands.end; o++) {
+            consumers[m_Operands[o]].push_back(i);
+        }
+        if (inst.variable != NO_VARIABLE) {
+            variableReaders[inst.variable].push_back(i);
+        }
     }
 
-    auto outputPin = GetConnectedOutputPin(pinId);
-    if (outputPin.Get() == 0) {
-        spdlog::debug("[GraphExecutor] Pin {} has no connection", pinId.Get());
-        return std::monostate{};
+    m_ConsumerRanges.resize(registerCount);
+    for (uint32_t r = 0; r < registerCount; r++) {
+        m_ConsumerRanges[r].begin = static_cast<uint32_t>(m_Consumers.size());
+        m_Consumers.insert(m_Consumers.end(), consumers[r].begin(), consumers[r].end());
+        m_ConsumerRanges[r].end = static_cast<uint32_t>(m_Consumers.size());
+    }
+    m_VariableReaderRanges.resize(variableReaders.size());
+    for (size_t v = 0; v < variableReaders.size(); v++) {
+        m_VariableReaderRanges[v].begin = static_cast<uint32_t>(m_VariableReaders.size());
+        m_VariableReaders.insert(m_VariableReaders.end(), variableReaders[v].begin(), variableReaders[v].end());
+        m_VariableReaderRanges[v].end = static_cast<uint32_t>(m_VariableReaders.size());
     }
 
-    spdlog::debug("[GraphExecutor] Pin {} connected to output pin {}", pinId.Get(), outputPin.Get());
+    for (uint32_t i = 0; i < nodeCount; i++) {
+        const Instruction& inst = m_Instructions[i];
+        if (inst.type != NodeType::Event || inst.flows.Size() == 0) continue;
 
-    if (m_PinValues.contains(outputPin.Get())) {
-        auto& val = m_PinValues[outputPin.Get()];
-        spdlog::debug("[GraphExecutor] Output pin {} found in cache: {}", outputPin.Get(), ValueToString(val));
-        return val;
+        if (inst.subType == NodeSubType::Start) {
+            m_StartEntries.push_back(inst.flows.begin);
+        } else if (inst.subType == NodeSubType::Tick && inst.outputs.Size() > 1) {
+            m_TickEntries.push_back({inst.flows.begin, inst.outputs.begin + 1});
+        }
     }
 
-    auto* sourceNode = FindNodeByOutputPin(outputPin);
-    if (!sourceNode) {
-        spdlog::debug("[GraphExecutor] No source node found for output pin {}", outputPin.Get());
-        return std::monostate{};
+    // Variables keep their values across recompiles
+    std::vector<Value> variableValues(variableNames.size());
+    for (size_t v = 0; v < m_VariableNames.size(); v++) {
+        if (const auto slot = variableSlots.find(m_VariableNames[v]); slot != variableSlots.end()) {
+            variableValues[slot->second] = std::move(m_VariableValues[v]);
+        }
     }
+    m_VariableNames = std::move(variableNames);
+    m_VariableValues = std::move(variableValues);
 
-    spdlog::debug("[GraphExecutor] Source node: {}", sourceNode->Name);
+    // Everything starts dirty, so the first tick evaluates each reachable node once
+    m_Registers.assign(registerCount, std::monostate{});
+    m_Dirty.assign(nodeCount, 1);
+    m_ObservedVersions.assign(nodeCount, 0);
 
-    if (sourceNode->Type == AnimationGraph::NodeType::Decomposer) {
-        spdlog::debug("[GraphExecutor] Executing decomposer node");
-        ExecuteDecomposer(sourceNode, deltaTime);
-        if (m_PinValues.contains(outputPin.Get())) {
-            auto& val = m_PinValues[outputPin.Get()];
-            spdlog::debug("[GraphExecutor] Decomposer result for pin {}: {}", outputPin.Get(), ValueToString(val));
-            return val;
-        }
-        spdlog::debug("[GraphExecutor] Decomposer did not produce value for pin {}", outputPin.Get());
-        return std::monostate{};
+    const auto tEnd = std::chrono::steady_clock::now();
+    const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(tEnd - tStart).count();
+    spdlog::debug("[GraphExecutor] Compiled {} nodes into {} registers in {} ms", nodeCount, registerCount, ms);
+}
+
+void GraphExecutor::ExecuteFlow(const uint32_t flowRange) {
+    const Range targets = m_FlowRanges[flowRange];
+    for (uint32_t t = targets.begin; t < targets.end; t++) {
+        ExecuteInstruction(m_FlowTargets[t]);
     }
+}
 
-    auto result = EvaluateNode(sourceNode, deltaTime);
-    m_PinValues[outputPin.Get()] = result;
-    spdlog::debug("[GraphExecutor] Evaluated node result for pin {}: {}", outputPin.Get(), ValueToString(result));
-    return result;
+void GraphExecutor::FollowFlow(const Instruction& inst, const size_t outputIndex) {
+    if (outputIndex < inst.flows.Size()) {
+        ExecuteFlow(inst.flows.begin + static_cast<uint32_t>(outputIndex));
+    }
 }
 
-GraphExecutor::Value GraphExecutor::EvaluateNode(AnimationGraph::Node* node, float deltaTime) {
-    switch (node->Type) {
-        case AnimationGraph::NodeType::Constant:
-            return ExecuteConstant(node);
-        case AnimationGraph::NodeType::Function:
-            return ExecuteMathOperation(node, deltaTime);
-        case AnimationGraph::NodeType::Decomposer:
-            return ExecuteDecomposer(node, deltaTime);
-        case AnimationGraph::NodeType::Other:
-            return ExecuteSceneGetter(node);
-        case AnimationGraph::NodeType::Variable:
-            if (node->SubType == AnimationGraph::NodeSubType::VariableGet) {
-                return ExecuteVariableGet(node);
-            }
+void GraphExecutor::ExecuteInstruction(const uint32_t index) {
+    const Instruction& inst = m_Instructions[index];
+    EvaluatePrelude(inst);
+
+    switch (inst.type) {
+        case NodeType::Print:
+            ExecutePrint(inst);
+            FollowFlow(inst, 0);
+            break;
+        case NodeType::Control:
+            ExecuteControlFlow(inst);
+            break;
+        case NodeType::Setter:
+            ExecuteSetter(inst);
+            FollowFlow(inst, 0);
+            break;
+        case NodeType::Variable:
+            ExecuteVariableSet(inst);
+            FollowFlow(inst, 0);
             break;
         default:
             break;
     }
-    return std::monostate{};
 }
 
-AnimationGraph::Node* GraphExecutor::FindNodeByOutputPin(ax::NodeEditor::PinId pinId) const {
-    for (auto& node : m_pGraph->GetNodes()) {
-        for (const auto& pin : node.Outputs) {
-            if (pin.Id == pinId) {
-                return &node;
-            }
-        }
+void GraphExecutor::EvaluatePrelude(const Instruction& inst) {
+    for (uint32_t p = inst.prelude.begin; p < inst.prelude.end; p++) {
+        const uint32_t index = m_Prelude[p];
+        const Instruction& data = m_Instructions[index];
+        if (!m_Dirty[index] && !PollSource(data)) continue;
+
+        m_Dirty[index] = 0;
+        EvaluateData(data);
     }
-    return nullptr;
 }
 
-AnimationGraph::Node* GraphExecutor::FindNodeByInputPin(ax::NodeEditor::PinId pinId) const {
-    for (auto& node : m_pGraph->GetNodes()) {
-        for (const auto& pin : node.Inputs) {
-            if (pin.Id == pinId) {
-                return &node;
-            }
+bool GraphExecutor::PollSource(const Instruction& inst) const {
+    switch (inst.type) {
+        case NodeType::Constant:
+        case NodeType::Other:
+            if (inst.subType == NodeSubType::ForEachGet) {
+                return ClassSignature(BatchClass(inst)) != m_ObservedVersions[inst.node];
+            }
+            // Constants are edited in place and getters follow the scene; both are cheap to re-read
+            return true;
+        case NodeType::Decomposer: {
+            const Value& input = Input(inst, 0);
+            if (const auto* obj = std::get_if<SceneObject*>(&input)) {
+                return (*obj)->GetVersion() != m_ObservedVersions[inst.node];
+            }
+            // Cameras carry no change counter
+            return std::holds_alternative<Camera*>(input);
         }
+        default:
+            return false;
     }
-    return nullptr;
 }
 
-ax::NodeEditor::PinId GraphExecutor::GetConnectedOutputPin(ax::NodeEditor::PinId inputPinId) const {
-    for (const auto& link : m_pGraph->GetLinks()) {
-        if (link.EndPinId == inputPinId) {
-            return link.StartPinId;
-        }
+ObjectClassId GraphExecutor::BatchClass(const Instruction& inst) const {
+    const auto* className = std::get_if<std::string>(&m_pGraph->GetNodes()[inst.node].Value);
+    return className ? FindObjectClass(*className) : INVALID_OBJECT_CLASS;
+}
+
+uint64_t GraphExecutor::ClassSignature(const ObjectClassId classId) const {
+    // FNV-1a over the index and change counter of every object of the class
+    const auto& indices = m_pScene->ObjectsOf(classId);
+    uint64_t hash = 14695981039346656037ull;
+    for (const uint32_t index : indices) {
+        hash = (hash ^ index) * 1099511628211ull;
+        hash = (hash ^ m_pScene->objects[index].GetVersion()) * 1099511628211ull;
     }
-    return ax::NodeEditor::PinId(0);
+    return (hash ^ indices.size()) * 1099511628211ull;
 }
 
-GraphExecutor::Value GraphExecutor::ExecuteConstant(AnimationGraph::Node* node) {
+void GraphExecutor::MarkDirty(const Range readers, const std::vector<uint32_t>& pool) {
+    for (uint32_t i = readers.begin; i < readers.end; i++) {
+        m_Dirty[pool[i]] = 1;
+    }
+}
+
+void GraphExecutor::Write(const uint32_t reg, Value value) {
+    if (m_Registers[reg] == value) return;
+
+    m_Registers[reg] = std::move(value);
+    MarkDirty(m_ConsumerRanges[reg], m_Consumers);
+}
+
+void GraphExecutor::SwapOutput(const Instruction& inst, const size_t outputIndex) {
+    const uint32_t reg = inst.outputs.begin + static_cast<uint32_t>(outputIndex);
+    if (m_Registers[reg] == m_BatchScratch) return;
+
+    std::swap(m_Registers[reg], m_BatchScratch);
+    MarkDirty(m_ConsumerRanges[reg], m_Consumers);
+}
+
+void GraphExecutor::EvaluateData(const Instruction& inst) {
+    if (inst.type == NodeType::Decomposer) {
+        ExecuteDecomposer(inst);
+        return;
+    }
+    if (inst.outputs.Size() == 0) return;
+
+    switch (inst.type) {
+        case NodeType::Constant:
+            WriteOutput(inst, 0, ExecuteConstant(inst));
+            break;
+        case NodeType::Function:
+            for (uint32_t o = inst.operands.begin; o < inst.operands.end; o++) {
+                if (IsBatch(m_Registers[m_Operands[o]])) {
+                    ExecuteBatchMath(inst);
+                    return;
+                }
+            }
+            WriteOutput(inst, 0, ExecuteMathOperation(inst));
+            break;
+        case NodeType::Other:
+            if (inst.subType == NodeSubType::ForEachGet) {
+                ExecuteBatchGetter(inst);
+            } else {
+                WriteOutput(inst, 0, ExecuteSceneGetter(inst));
+            }
+            break;
+        case NodeType::Variable:
+            WriteOutput(inst, 0, m_VariableValues[inst.variable]);
+            break;
+        default:
+            break;
+    }
+}
+
+GraphExecutor::Value GraphExecutor::ExecuteConstant(const Instruction& inst) const {
+    const auto* node = &m_pGraph->GetNodes()[inst.node];
     if (std::holds_alternative<std::string>(node->Value)) {
         return std::get<std::string>(node->Value);
     }
@@ -204,11 +582,11 @@ GraphExecutor::Value GraphExecutor::ExecuteConstant(AnimationGraph::Node* node)
     return std::monostate{};
 }
 
-GraphExecutor::Value GraphExecutor::ExecuteMathOperation(AnimationGraph::Node* node, float deltaTime) {
-    switch (node->SubType) {
+GraphExecutor::Value GraphExecutor::ExecuteMathOperation(const Instruction& inst) {
+    switch (inst.subType) {
         case AnimationGraph::NodeSubType::Add: {
-            auto a = EvaluatePinValue(node->Inputs[0].Id, deltaTime);
-            auto b = EvaluatePinValue(node->Inputs[1].Id, deltaTime);
+            const Value& a = Input(inst, 0);
+            const Value& b = Input(inst, 1);
             if (std::holds_alternative<float>(a) && std::holds_alternative<float>(b)) {
                 return std::get<float>(a) + std::get<float>(b);
             }
@@ -224,8 +602,8 @@ GraphExecutor::Value GraphExecutor::ExecuteMathOperation(AnimationGraph::Node* n
             break;
         }
         case AnimationGraph::NodeSubType::Sub: {
-            auto a = EvaluatePinValue(node->Inputs[0].Id, deltaTime);
-            auto b = EvaluatePinValue(node->Inputs[1].Id, deltaTime);
+            const Value& a = Input(inst, 0);
+            const Value& b = Input(inst, 1);
             if (std::holds_alternative<float>(a) && std::holds_alternative<float>(b)) {
                 return std::get<float>(a) - std::get<float>(b);
             }
@@ -241,8 +619,8 @@ GraphExecutor::Value GraphExecutor::ExecuteMathOperation(AnimationGraph::Node* n
             break;
         }
         case AnimationGraph::NodeSubType::Mul: {
-            auto a = EvaluatePinValue(node->Inputs[0].Id, deltaTime);
-            auto b = EvaluatePinValue(node->Inputs[1].Id, deltaTime);
+            const Value& a = Input(inst, 0);
+            const Value& b = Input(inst, 1);
             if (std::holds_alternative<float>(a) && std::holds_alternative<float>(b)) {
                 return std::get<float>(a) * std::get<float>(b);
             }
@@ -258,26 +636,26 @@ GraphExecutor::Value GraphExecutor::ExecuteMathOperation(AnimationGraph::Node* n
             break;
         }
         case AnimationGraph::NodeSubType::Div: {
-            auto a = EvaluatePinValue(node->Inputs[0].Id, deltaTime);
-            auto b = EvaluatePinValue(node->Inputs[1].Id, deltaTime);
+            const Value& a = Input(inst, 0);
+            const Value& b = Input(inst, 1);
             if (std::holds_alternative<float>(a) && std::holds_alternative<float>(b)) {
                 float divisor = std::get<float>(b);
                 return divisor != 0.0f ? std::get<float>(a) / divisor : 0.0f;
             }
             if (std::holds_alternative<glm::vec2>(a) && std::holds_alternative<glm::vec2>(b)) {
-                return std::get<glm::vec2>(a) / std::get<glm::vec2>(b);
+                return SafeDivide(std::get<glm::vec2>(a), std::get<glm::vec2>(b));
             }
             if (std::holds_alternative<glm::vec3>(a) && std::holds_alternative<glm::vec3>(b)) {
-                return std::get<glm::vec3>(a) / std::get<glm::vec3>(b);
+                return SafeDivide(std::get<glm::vec3>(a), std::get<glm::vec3>(b));
             }
             if (std::holds_alternative<glm::vec4>(a) && std::holds_alternative<glm::vec4>(b)) {
-                return std::get<glm::vec4>(a) / std::get<glm::vec4>(b);
+                return SafeDivide(std::get<glm::vec4>(a), std::get<glm::vec4>(b));
             }
             break;
         }
         case AnimationGraph::NodeSubType::Min: {
-            auto a = EvaluatePinValue(node->Inputs[0].Id, deltaTime);
-            auto b = EvaluatePinValue(node->Inputs[1].Id, deltaTime);
+            const Value& a = Input(inst, 0);
+            const Value& b = Input(inst, 1);
             if (std::holds_alternative<float>(a) && std::holds_alternative<float>(b)) {
                 return std::min(std::get<float>(a), std::get<float>(b));
             }
@@ -293,8 +671,8 @@ GraphExecutor::Value GraphExecutor::ExecuteMathOperation(AnimationGraph::Node* n
             break;
         }
         case AnimationGraph::NodeSubType::Max: {
-            auto a = EvaluatePinValue(node->Inputs[0].Id, deltaTime);
-            auto b = EvaluatePinValue(node->Inputs[1].Id, deltaTime);
+            const Value& a = Input(inst, 0);
+            const Value& b = Input(inst, 1);
             if (std::holds_alternative<float>(a) && std::holds_alternative<float>(b)) {
                 return std::max(std::get<float>(a), std::get<float>(b));
             }
@@ -310,28 +688,28 @@ GraphExecutor::Value GraphExecutor::ExecuteMathOperation(AnimationGraph::Node* n
             break;
         }
         case AnimationGraph::NodeSubType::Sin: {
-            auto val = EvaluatePinValue(node->Inputs[0].Id, deltaTime);
+            const Value& val = Input(inst, 0);
             if (std::holds_alternative<float>(val)) {
                 return std::sin(std::get<float>(val));
             }
             break;
         }
         case AnimationGraph::NodeSubType::Cos: {
-            auto val = EvaluatePinValue(node->Inputs[0].Id, deltaTime);
+            const Value& val = Input(inst, 0);
             if (std::holds_alternative<float>(val)) {
                 return std::cos(std::get<float>(val));
             }
             break;
         }
         case AnimationGraph::NodeSubType::Tan: {
-            auto val = EvaluatePinValue(node->Inputs[0].Id, deltaTime);
+            const Value& val = Input(inst, 0);
             if (std::holds_alternative<float>(val)) {
                 return std::tan(std::get<float>(val));
             }
             break;
         }
         case AnimationGraph::NodeSubType::Sqrt: {
-            auto val = EvaluatePinValue(node->Inputs[0].Id, deltaTime);
+            const Value& val = Input(inst, 0);
             if (std::holds_alternative<float>(val)) {
                 return std::sqrt(std::max(0.0f, std::get<float>(val)));
             }
@@ -347,7 +725,7 @@ GraphExecutor::Value GraphExecutor::ExecuteMathOperation(AnimationGraph::Node* n
             break;
         }
         case AnimationGraph::NodeSubType::Negate: {
-            auto val = EvaluatePinValue(node->Inputs[0].Id, deltaTime);
+            const Value& val = Input(inst, 0);
             if (std::holds_alternative<float>(val)) {
                 return -std::get<float>(val);
             }
@@ -363,7 +741,7 @@ GraphExecutor::Value GraphExecutor::ExecuteMathOperation(AnimationGraph::Node* n
             break;
         }
         case AnimationGraph::NodeSubType::Length: {
-            auto val = EvaluatePinValue(node->Inputs[0].Id, deltaTime);
+            const Value& val = Input(inst, 0);
             if (std::holds_alternative<glm::vec2>(val)) {
                 return glm::length(std::get<glm::vec2>(val));
             }
@@ -376,8 +754,8 @@ GraphExecutor::Value GraphExecutor::ExecuteMathOperation(AnimationGraph::Node* n
             break;
         }
         case AnimationGraph::NodeSubType::Distance: {
-            auto a = EvaluatePinValue(node->Inputs[0].Id, deltaTime);
-            auto b = EvaluatePinValue(node->Inputs[1].Id, deltaTime);
+            const Value& a = Input(inst, 0);
+            const Value& b = Input(inst, 1);
             if (std::holds_alternative<glm::vec2>(a) && std::holds_alternative<glm::vec2>(b)) {
                 return glm::distance(std::get<glm::vec2>(a), std::get<glm::vec2>(b));
             }
@@ -390,9 +768,9 @@ GraphExecutor::Value GraphExecutor::ExecuteMathOperation(AnimationGraph::Node* n
             break;
         }
         case AnimationGraph::NodeSubType::Lerp: {
-            auto a = EvaluatePinValue(node->Inputs[0].Id, deltaTime);
-            auto b = EvaluatePinValue(node->Inputs[1].Id, deltaTime);
-            auto t = EvaluatePinValue(node->Inputs[2].Id, deltaTime);
+            const Value& a = Input(inst, 0);
+            const Value& b = Input(inst, 1);
+            const Value& t = Input(inst, 2);
             float tVal = GetValueAs<float>(t, 0.0f);
             if (std::holds_alternative<float>(a) && std::holds_alternative<float>(b)) {
                 return glm::mix(std::get<float>(a), std::get<float>(b), tVal);
@@ -409,9 +787,9 @@ GraphExecutor::Value GraphExecutor::ExecuteMathOperation(AnimationGraph::Node* n
             break;
         }
         case AnimationGraph::NodeSubType::Clamp: {
-            auto val = EvaluatePinValue(node->Inputs[0].Id, deltaTime);
-            auto minVal = EvaluatePinValue(node->Inputs[1].Id, deltaTime);
-            auto maxVal = EvaluatePinValue(node->Inputs[2].Id, deltaTime);
+            const Value& val = Input(inst, 0);
+            const Value& minVal = Input(inst, 1);
+            const Value& maxVal = Input(inst, 2);
             if (std::holds_alternative<float>(val) && std::holds_alternative<float>(minVal) && std::holds_alternative<float>(maxVal)) {
                 return glm::clamp(std::get<float>(val), std::get<float>(minVal), std::get<float>(maxVal));
             }
@@ -427,13 +805,13 @@ GraphExecutor::Value GraphExecutor::ExecuteMathOperation(AnimationGraph::Node* n
             break;
         }
         case AnimationGraph::NodeSubType::And: {
-            auto a = EvaluatePinValue(node->Inputs[0].Id, deltaTime);
-            auto b = EvaluatePinValue(node->Inputs[1].Id, deltaTime);
+            const Value& a = Input(inst, 0);
+            const Value& b = Input(inst, 1);
             return GetValueAs<bool>(a, false) && GetValueAs<bool>(b, false);
         }
         case AnimationGraph::NodeSubType::Or: {
-            auto a = EvaluatePinValue(node->Inputs[0].Id, deltaTime);
-            auto b = EvaluatePinValue(node->Inputs[1].Id, deltaTime);
+            const Value& a = Input(inst, 0);
+            const Value& b = Input(inst, 1);
             return GetValueAs<bool>(a, false) || GetValueAs<bool>(b, false);
         }
         default:
@@ -442,66 +820,259 @@ GraphExecutor::Value GraphExecutor::ExecuteMathOperation(AnimationGraph::Node* n
     return std::monostate{};
 }
 
-GraphExecutor::Value GraphExecutor::ExecuteDecomposer(AnimationGraph::Node* node, float deltaTime) {
-    auto inputVal = EvaluatePinValue(node->Inputs[0].Id, deltaTime);
+void GraphExecutor::ExecuteBatchMath(const Instruction& inst) {
+    const size_t operandCount = std::min<size_t>(inst.operands.Size(), 3);
+    float scalars[3] = {};
+    BatchOperand ops[3];
+    size_t count = SIZE_MAX;
+    bool vector = false;
+    for (size_t k = 0; k < operandCount; k++) {
+        ops[k] = ToBatchOperand(Input(inst, k), scalars[k]);
+        if (!ops[k].valid) {
+            WriteOutput(inst, 0, std::monostate{});
+            return;
+        }
+        count = std::min(count, ops[k].size);
+        vector |= ops[k].vector;
+    }
 
-    spdlog::debug("[GraphExecutor] ExecuteDecomposer for node: {}", node->Name);
+    if (inst.subType == NodeSubType::Length || inst.subType == NodeSubType::Distance) {
+        // Like the scalar nodes, only defined on vectors; a broadcast float would count as (x, x, x)
+        for (size_t k = 0; k < operandCount; k++) {
+            if (!ops[k].vector) {
+                WriteOutput(inst, 0, std::monostate{});
+                return;
+            }
+        }
+        auto& out = BatchScratch<GraphBatch::FloatArray>();
+        out.values.resize(count);
+        if (inst.subType == NodeSubType::Length) {
+            GraphBatch::Length(ops[0].lanes[0], ops[0].lanes[1], ops[0].lanes[2], out.values.data(), count);
+        } else {
+            m_BatchTemp.Resize(count);
+            float* diff[3] = {m_BatchTemp.x.data(), m_BatchTemp.y.data(), m_BatchTemp.z.data()};
+            for (size_t c = 0; c < 3; c++) {
+                GraphBatch::Binary(GraphBatch::BinaryOp::Sub, ops[0].lanes[c], ops[1].lanes[c], diff[c], count);
+            }
+            GraphBatch::Length({diff[0], false}, {diff[1], false}, {diff[2], false}, out.values.data(), count);
+        }
+        SwapOutput(inst, 0);
+        return;
+    }
 
-    if (node->SubType == AnimationGraph::NodeSubType::Blackhole && std::holds_alternative<SceneObject*>(inputVal)) {
-        SceneObject* obj = std::get<SceneObject*>(inputVal);
+    float* outLanes[3] = {};
+    if (vector) {
+        auto& out = BatchScratch<GraphBatch::Vec3Array>();
+        out.Resize(count);
+        outLanes[0] = out.x.data();
+        outLanes[1] = out.y.data();
+        outLanes[2] = out.z.data();
+    } else {
+        auto& out = BatchScratch<GraphBatch::FloatArray>();
+        out.values.resize(count);
+        outLanes[0] = out.values.data();
+    }
+
+    for (size_t c = 0; c < (vector ? 3 : 1); c++) {
+        if (!RunElementwise(inst.subType, ops, c, outLanes[c], count)) {
+            WriteOutput(inst, 0, std::monostate{});
+            return;
+        }
+    }
+    SwapOutput(inst, 0);
+}
+
+bool GraphExecutor::CheckBatchMath() {
+    struct Case {
+        NodeSubType subType;
+        const char* name;
+        size_t operandCount;
+        bool vectorOperands;  // vec3 / Vec3Array operands instead of float / FloatArray
+    };
+    const Case cases[] = {
+        {NodeSubType::Add, "Add", 2, false}, {NodeSubType::Sub, "Sub", 2, false},
+        {NodeSubType::Mul, "Mul", 2, false}, {NodeSubType::Div, "Div", 2, false},
+        {NodeSubType::Min, "Min", 2, false}, {NodeSubType::Max, "Max", 2, false},
+        {NodeSubType::Negate, "Negate", 1, false}, {NodeSubType::Sqrt, "Sqrt", 1, false},
+        {NodeSubType::Sin, "Sin", 1, false}, {NodeSubType::Cos, "Cos", 1, false},
+        {NodeSubType::Tan, "Tan", 1, false}, {NodeSubType::Lerp, "Lerp", 3, false},
+        {NodeSubType::Clamp, "Clamp", 3, false},
+        {NodeSubType::Length, "Length", 1, false}, {NodeSubType::Distance, "Distance", 2, false},
+        {NodeSubType::Length, "Length", 1, true}, {NodeSubType::Distance, "Distance", 2, true},
+    };
+    const float floats[3] = {2.5f, -0.75f, 4.0f};
+    const glm::vec3 vectors[3] = {{2.5f, -1.0f, 0.5f}, {-0.75f, 3.0f, 1.5f}, {4.0f, 0.25f, -2.0f}};
+
+    // Register 0 stays unconnected, 1-3 hold the operands and 4 the result
+    GraphExecutor executor(nullptr, nullptr);
+    executor.m_Registers.resize(5);
+    executor.m_ConsumerRanges.resize(5);
+    executor.m_Operands = {1, 2, 3};
+
+    const auto evaluate = [&](const Case& c, const uint32_t batchMask) {
+        for (size_t k = 0; k < c.operandCount; k++) {
+            const bool batch = (batchMask >> k) & 1;
+            Value& operand = executor.m_Registers[1 + k];
+            if (c.vectorOperands && batch) {
+                GraphBatch::Vec3Array array;
+                array.Resize(1);
+                array.x[0] = vectors[k].x;
+                array.y[0] = vectors[k].y;
+                array.z[0] = vectors[k].z;
+                operand = std::move(array);
+            } else if (c.vectorOperands) {
+                operand = vectors[k];
+            } else if (batch) {
+                GraphBatch::FloatArray array;
+                array.values = {floats[k]};
+                operand = std::move(array);
+            } else {
+                operand = floats[k];
+            }
+        }
+        Instruction inst{};
+        inst.type = NodeType::Function;
+        inst.subType = c.subType;
+        inst.operands = {0, static_cast<uint32_t>(c.operandCount)};
+        inst.outputs = {4, 5};
+        executor.m_Registers[4] = std::monostate{};
+        executor.EvaluateData(inst);
+        return executor.m_Registers[4];
+    };
+    const auto agrees = [](const float a, const float b) {
+        return std::abs(a - b) <= 1e-5f * std::max(1.0f, std::abs(a));
+    };
+
+    bool passed = true;
+    for (const Case& c : cases) {
+        const Value scalar = evaluate(c, 0);
+        for (uint32_t mask = 1; mask < (1u << c.operandCount); mask++) {
+            const Value batch = evaluate(c, mask);
+            bool same = false;
+            if (std::holds_alternative<std::monostate>(scalar)) {
+                same = std::holds_alternative<std::monostate>(batch);
+            } else if (const auto* f = std::get_if<float>(&scalar)) {
+                const auto* array = std::get_if<GraphBatch::FloatArray>(&batch);
+                same = array && array->Size() == 1 && agrees(*f, array->values[0]);
+            } else if (const auto* v = std::get_if<glm::vec3>(&scalar)) {
+                const auto* array = std::get_if<GraphBatch::Vec3Array>(&batch);
+                same = array && array->Size() == 1 && agrees(v->x, array->x[0]) && agrees(v->y, array->y[0]) &&
+                       agrees(v->z, array->z[0]);
+            }
+            if (!same) {
+                spdlog::error("Batch {} on {} operands (batch mask {:#x}) disagrees with the scalar node: {} vs {}",
+                              c.name, c.vectorOperands ? "vec3" : "float", mask, ValueToString(batch), ValueToString(scalar));
+                passed = false;
+            }
+        }
+    }
+    spdlog::info("Batch math check {}", passed ? "passed" : "FAILED");
+    return passed;
+}
+
+void GraphExecutor::ExecuteBatchGetter(const Instruction& inst) {
+    if (inst.outputs.Size() < 6) return;
+
+    const ObjectClassId classId = BatchClass(inst);
+    m_ObservedVersions[inst.node] = ClassSignature(classId);
+
+    auto& batch = BatchScratch<GraphBatch::ObjectBatch>();
+    batch.indices = m_pScene->ObjectsOf(classId);
+    SwapOutput(inst, 0);
+
+    const auto& indices = std::get<GraphBatch::ObjectBatch>(m_Registers[inst.outputs.begin]).indices;
+    const size_t count = indices.size();
+    WriteOutput(inst, 1, static_cast<int>(count));
+
+    auto gatherVec3 = [&](const HotField field, const size_t outputIndex) {
+        auto& out = BatchScratch<GraphBatch::Vec3Array>();
+        out.Resize(count);
+        for (size_t n = 0; n < count; n++) {
+            const glm::vec3 v = ReadField(m_pScene->objects[indices[n]], field, glm::vec3(0.0f));
+            out.x[n] = v.x;
+            out.y[n] = v.y;
+            out.z[n] = v.z;
+        }
+        SwapOutput(inst, outputIndex);
+    };
+    auto gatherFloat = [&](const HotField field, const size_t outputIndex) {
+        auto& out = BatchScratch<GraphBatch::FloatArray>();
+        out.values.resize(count);
+        for (size_t n = 0; n < count; n++) {
+            out.values[n] = ReadField(m_pScene->objects[indices[n]], field, 0.0f);
+        }
+        SwapOutput(inst, outputIndex);
+    };
+
+    gatherVec3(HotField::Position, 2);
+    gatherVec3(HotField::Velocity, 3);
+    gatherFloat(HotField::Mass, 4);
+    gatherFloat(HotField::Radius, 5);
+}
 
-        auto mass = std::get<float>(obj->GetParameter(ParameterHandle("Physics.Mass")));
-        auto position = std::get<glm::vec3>(obj->GetParameter(ParameterHandle("Transform.Position")));
+void GraphExecutor::ExecuteDecomposer(const Instruction& inst) {
+    const Value& inputVal = Input(inst, 0);
+    const size_t outputCount = inst.outputs.Size();
 
-        spdlog::debug("[GraphExecutor] Decomposing BlackHole - mass={}, position=({},{},{})",
-                     mass, position.x, position.y, position.z);
-        for (size_t i = 0; i < node->Outputs.size(); ++i) {
+    // Outputs the object does not provide read as unconnected
+    if (inst.subType == AnimationGraph::NodeSubType::Blackhole && std::holds_alternative<SceneObject*>(inputVal)) {
+        SceneObject* obj = std::get<SceneObject*>(inputVal);
+        m_ObservedVersions[inst.node] = obj->GetVersion();
+
+        for (size_t i = 0; i < outputCount; ++i) {
             switch (i) {
-                case 0: m_PinValues[node->Outputs[i].Id.Get()] = mass;
-                        spdlog::debug("[GraphExecutor] Stored mass {} in pin {}", mass, node->Outputs[i].Id.Get());
-                        break;
-                case 1: m_PinValues[node->Outputs[i].Id.Get()] = position; break;
-                case 6: {
+                case 0:
+                    WriteOutput(inst, i, std::get<float>(obj->GetParameter(ParameterHandle("Physics.Mass"))));
+                    break;
+                case 1:
+                    WriteOutput(inst, i, std::get<glm::vec3>(obj->GetParameter(ParameterHandle("Transform.Position"))));
+                    break;
+                case 6:
                     if (obj->HasParameter(ParameterHandle("BlackHole.Spin"))) {
-                        m_PinValues[node->Outputs[i].Id.Get()] = std::get<float>(obj->GetParameter(ParameterHandle("BlackHole.Spin")));
+                        WriteOutput(inst, i, std::get<float>(obj->GetParameter(ParameterHandle("BlackHole.Spin"))));
+                    } else {
+                        WriteOutput(inst, i, std::monostate{});
                     }
                     break;
-                }
-                case 7: {
+                case 7:
                     if (obj->HasParameter(ParameterHandle("BlackHole.SpinAxis"))) {
-                        m_PinValues[node->Outputs[i].Id.Get()] = std::get<glm::vec3>(obj->GetParameter(ParameterHandle("BlackHole.SpinAxis")));
+                        WriteOutput(inst, i, std::get<glm::vec3>(obj->GetParameter(ParameterHandle("BlackHole.SpinAxis"))));
+                    } else {
+                        WriteOutput(inst, i, std::monostate{});
                     }
                     break;
-                }
+                default:
+                    WriteOutput(inst, i, std::monostate{});
+                    break;
             }
         }
-    } else if (node->SubType == AnimationGraph::NodeSubType::Camera && std::holds_alternative<Camera*>(inputVal)) {
+    } else if (inst.subType == AnimationGraph::NodeSubType::Camera && std::holds_alternative<Camera*>(inputVal)) {
         Camera* cam = std::get<Camera*>(inputVal);
-        spdlog::debug("[GraphExecutor] Decomposing Camera - position=({},{},{})",
-                     cam->GetPosition().x, cam->GetPosition().y, cam->GetPosition().z);
-        for (size_t i = 0; i < node->Outputs.size(); ++i) {
+        for (size_t i = 0; i < outputCount; ++i) {
             switch (i) {
-                case 0: m_PinValues[node->Outputs[i].Id.Get()] = cam->GetPosition(); break;
-                case 1: m_PinValues[node->Outputs[i].Id.Get()] = cam->GetYaw(); break;
-                case 2: m_PinValues[node->Outputs[i].Id.Get()] = cam->GetPitch(); break;
-                case 3: m_PinValues[node->Outputs[i].Id.Get()] = cam->GetFov(); break;
-                case 4: m_PinValues[node->Outputs[i].Id.Get()] = cam->GetFront(); break;
-                case 5: m_PinValues[node->Outputs[i].Id.Get()] = cam->GetUp(); break;
+                case 0: WriteOutput(inst, i, cam->GetPosition()); break;
+                case 1: WriteOutput(inst, i, cam->GetYaw()); break;
+                case 2: WriteOutput(inst, i, cam->GetPitch()); break;
+                case 3: WriteOutput(inst, i, cam->GetFov()); break;
+                case 4: WriteOutput(inst, i, cam->GetFront()); break;
+                case 5: WriteOutput(inst, i, cam->GetUp()); break;
+                default: WriteOutput(inst, i, std::monostate{}); break;
             }
         }
     } else {
-        spdlog::debug("[GraphExecutor] Decomposer input is not a valid pointer");
+        for (size_t i = 0; i < outputCount; ++i) {
+            WriteOutput(inst, i, std::monostate{});
+        }
     }
-
-    return std::monostate{};
 }
 
-GraphExecutor::Value GraphExecutor::ExecuteSceneGetter(AnimationGraph::Node* node) {
-    if (node->SubType == AnimationGraph::NodeSubType::Blackhole) {
-        if (node->SceneObjectIndex >= 0 && node->SceneObjectIndex < static_cast<int>(m_pScene->objects.size())) {
-            return &m_pScene->objects[node->SceneObjectIndex];
+GraphExecutor::Value GraphExecutor::ExecuteSceneGetter(const Instruction& inst) const {
+    const auto& node = m_pGraph->GetNodes()[inst.node];
+    if (inst.subType == AnimationGraph::NodeSubType::Blackhole) {
+        if (node.SceneObjectIndex >= 0 && node.SceneObjectIndex < static_cast<int>(m_pScene->objects.size())) {
+            return &m_pScene->objects[node.SceneObjectIndex];
         }
-    } else if (node->SubType == AnimationGraph::NodeSubType::Camera) {
+    } else if (inst.subType == AnimationGraph::NodeSubType::Camera) {
         if (m_pScene->camera) {
             return m_pScene->camera;
         }
@@ -509,170 +1080,164 @@ GraphExecutor::Value GraphExecutor::ExecuteSceneGetter(AnimationGraph::Node* nod
     return std::monostate{};
 }
 
-void GraphExecutor::ExecuteSetter(AnimationGraph::Node* node, float deltaTime) {
-    spdlog::debug("[GraphExecutor] ExecuteSetter for node: {}", node->Name);
+void GraphExecutor::ExecuteSetter(const Instruction& inst) {
+    if (inst.subType == AnimationGraph::NodeSubType::ForEachSet) {
+        ExecuteBatchSetter(inst);
+        return;
+    }
+
+    const size_t inputCount = inst.operands.Size();
 
-    if (node->SubType == AnimationGraph::NodeSubType::Blackhole) {
-        auto bhVal = EvaluatePinValue(node->Inputs[1].Id, deltaTime);
+    if (inst.subType == AnimationGraph::NodeSubType::Blackhole) {
+        const Value& bhVal = Input(inst, 1);
         if (!std::holds_alternative<SceneObject*>(bhVal)) {
-            spdlog::debug("[GraphExecutor] ExecuteSetter: BlackHole input is not valid");
             return;
         }
 
         SceneObject* obj = std::get<SceneObject*>(bhVal);
-        spdlog::debug("[GraphExecutor] ExecuteSetter: Setting properties on SceneObject at {}", (void*)obj);
 
-        for (size_t i = 2; i < node->Inputs.size(); ++i) {
-            auto val = EvaluatePinValue(node->Inputs[i].Id, deltaTime);
+        for (size_t i = 2; i < inputCount; ++i) {
+            const Value& val = Input(inst, i);
             if (std::holds_alternative<std::monostate>(val)) {
-                spdlog::debug("[GraphExecutor] ExecuteSetter: Input {} has no value (not connected)", i);
                 continue;
             }
 
             switch (i) {
                 case 2: {
                     float oldMass = std::get<float>(obj->GetParameter(ParameterHandle("Physics.Mass")));
-                    float newMass = GetValueAs<float>(val, oldMass);
-                    spdlog::debug("[GraphExecutor] ExecuteSetter: Setting mass from {} to {}", oldMass, newMass);
-                    obj->SetParameter(ParameterHandle("Physics.Mass"), newMass);
+                    obj->SetParameter(ParameterHandle("Physics.Mass"), GetValueAs<float>(val, oldMass));
                     break;
                 }
                 case 3: {
                     glm::vec3 oldPos = std::get<glm::vec3>(obj->GetParameter(ParameterHandle("Transform.Position")));
-                    glm::vec3 newPos = GetValueAs<glm::vec3>(val, oldPos);
-                    spdlog::debug("[GraphExecutor] ExecuteSetter: Setting position from ({},{},{}) to ({},{},{})",
-                                 oldPos.x, oldPos.y, oldPos.z, newPos.x, newPos.y, newPos.z);
-                    obj->SetParameter(ParameterHandle("Transform.Position"), newPos);
+                    obj->SetParameter(ParameterHandle("Transform.Position"), GetValueAs<glm::vec3>(val, oldPos));
                     break;
                 }
                 case 8: {
                     if (obj->HasParameter(ParameterHandle("BlackHole.Spin"))) {
                         float oldSpin = std::get<float>(obj->GetParameter(ParameterHandle("BlackHole.Spin")));
-                        float newSpin = GetValueAs<float>(val, oldSpin);
-                        spdlog::debug("[GraphExecutor] ExecuteSetter: Setting spin from {} to {}", oldSpin, newSpin);
-                        obj->SetParameter(ParameterHandle("BlackHole.Spin"), newSpin);
+                        obj->SetParameter(ParameterHandle("BlackHole.Spin"), GetValueAs<float>(val, oldSpin));
                     }
                     break;
                 }
                 case 9: {
                     if (obj->HasParameter(ParameterHandle("BlackHole.SpinAxis"))) {
                         glm::vec3 oldSpinAxis = std::get<glm::vec3>(obj->GetParameter(ParameterHandle("BlackHole.SpinAxis")));
-                        glm::vec3 newSpinAxis = GetValueAs<glm::vec3>(val, oldSpinAxis);
-                        spdlog::debug("[GraphExecutor] ExecuteSetter: Setting spinAxis from ({},{},{}) to ({},{},{})",
-                                     oldSpinAxis.x, oldSpinAxis.y, oldSpinAxis.z,
-                                     newSpinAxis.x, newSpinAxis.y, newSpinAxis.z);
-                        obj->SetParameter(ParameterHandle("BlackHole.SpinAxis"), newSpinAxis);
+                        obj->SetParameter(ParameterHandle("BlackHole.SpinAxis"), GetValueAs<glm::vec3>(val, oldSpinAxis));
                     }
                     break;
                 }
             }
         }
 
-        if (node->Outputs.size() > 1) {
-            m_PinValues[node->Outputs[1].Id.Get()] = obj;
+        if (inst.outputs.Size() > 1) {
+            WriteOutput(inst, 1, obj);
         }
-    } else if (node->SubType == AnimationGraph::NodeSubType::Camera) {
-        auto camVal = EvaluatePinValue(node->Inputs[1].Id, deltaTime);
+    } else if (inst.subType == AnimationGraph::NodeSubType::Camera) {
+        const Value& camVal = Input(inst, 1);
         if (!std::holds_alternative<Camera*>(camVal)) {
-            spdlog::debug("[GraphExecutor] ExecuteSetter: Camera input is not valid");
             return;
         }
 
         Camera* cam = std::get<Camera*>(camVal);
-        spdlog::debug("[GraphExecutor] ExecuteSetter: Setting properties on Camera at {}", (void*)cam);
 
-        for (size_t i = 2; i < node->Inputs.size(); ++i) {
-            auto val = EvaluatePinValue(node->Inputs[i].Id, deltaTime);
+        for (size_t i = 2; i < inputCount; ++i) {
+            const Value& val = Input(inst, i);
             if (std::holds_alternative<std::monostate>(val)) {
-                spdlog::debug("[GraphExecutor] ExecuteSetter: Input {} has no value (not connected)", i);
                 continue;
             }
 
             switch (i) {
-                case 2: {
-                    glm::vec3 newPos = GetValueAs<glm::vec3>(val, cam->GetPosition());
-                    spdlog::debug("[GraphExecutor] ExecuteSetter: Setting camera position from ({},{},{}) to ({},{},{})",
-                                 cam->GetPosition().x, cam->GetPosition().y, cam->GetPosition().z,
-                                 newPos.x, newPos.y, newPos.z);
-                    cam->SetPosition(newPos);
+                case 2:
+                    cam->SetPosition(GetValueAs<glm::vec3>(val, cam->GetPosition()));
                     break;
-                }
-                case 3: {
-                    float newYaw = GetValueAs<float>(val, cam->GetYaw());
-                    spdlog::debug("[GraphExecutor] ExecuteSetter: Setting camera yaw from {} to {}", cam->GetYaw(), newYaw);
-                    cam->SetYawPitch(newYaw, cam->GetPitch());
+                case 3:
+                    cam->SetYawPitch(GetValueAs<float>(val, cam->GetYaw()), cam->GetPitch());
                     break;
-                }
-                case 4: {
-                    float newPitch = GetValueAs<float>(val, cam->GetPitch());
-                    spdlog::debug("[GraphExecutor] ExecuteSetter: Setting camera pitch from {} to {}", cam->GetPitch(), newPitch);
-                    cam->SetYawPitch(cam->GetYaw(), newPitch);
+                case 4:
+                    cam->SetYawPitch(cam->GetYaw(), GetValueAs<float>(val, cam->GetPitch()));
                     break;
-                }
-                case 5: {
-                    float newFov = GetValueAs<float>(val, cam->GetFov());
-                    spdlog::debug("[GraphExecutor] ExecuteSetter: Setting camera FOV from {} to {}", cam->GetFov(), newFov);
-                    cam->SetFov(newFov);
+                case 5:
+                    cam->SetFov(GetValueAs<float>(val, cam->GetFov()));
                     break;
-                }
             }
         }
 
-        if (node->Outputs.size() > 1) {
-            m_PinValues[node->Outputs[1].Id.Get()] = cam;
+        if (inst.outputs.Size() > 1) {
+            WriteOutput(inst, 1, cam);
         }
     }
 }
 
-void GraphExecutor::ExecuteControlFlow(AnimationGraph::Node* node, ax::NodeEditor::PinId entryPin, float deltaTime) {
-    if (node->SubType == AnimationGraph::NodeSubType::Branch || node->SubType == AnimationGraph::NodeSubType::If) {
-        auto condition = EvaluatePinValue(node->Inputs[1].Id, deltaTime);
-        bool condResult = GetValueAs<bool>(condition, false);
+void GraphExecutor::ExecuteBatchSetter(const Instruction& inst) {
+    const auto* batch = std::get_if<GraphBatch::ObjectBatch>(&Input(inst, 1));
+    if (!batch) return;
 
-        if (condResult && !node->Outputs.empty()) {
-            ExecuteFlowFromPin(node->Outputs[0].Id, deltaTime);
-        } else if (!condResult && node->Outputs.size() > 1) {
-            ExecuteFlowFromPin(node->Outputs[1].Id, deltaTime);
-        }
-    } else if (node->SubType == AnimationGraph::NodeSubType::For) {
-        auto startVal = EvaluatePinValue(node->Inputs[1].Id, deltaTime);
-        auto endVal = EvaluatePinValue(node->Inputs[2].Id, deltaTime);
+    // Inputs 2..5: position, velocity, mass, radius; unconnected columns are left untouched
+    float scalars[4] = {};
+    BatchOperand columns[4];
+    size_t count = batch->Size();
+    for (size_t k = 0; k < 4; k++) {
+        columns[k] = ToBatchOperand(Input(inst, k + 2), scalars[k]);
+        if (columns[k].valid) count = std::min(count, columns[k].size);
+    }
 
-        int start = GetValueAs<int>(startVal, 0);
-        int end = GetValueAs<int>(endVal, 0);
+    // Batch indices are unique, so chunks never touch the same object
+    auto& objects = m_pScene->objects;
+    GraphBatch::ForEachChunk(count, [&](const size_t begin, const size_t end) {
+        for (size_t n = begin; n < end; n++) {
+            if (batch->indices[n] >= objects.size()) continue;
+            SceneObject& obj = objects[batch->indices[n]];
 
-        for (int i = start; i < end; ++i) {
-            if (node->Outputs.size() > 1) {
-                m_PinValues[node->Outputs[1].Id.Get()] = i;
+            if (columns[0].valid) {
+                obj.Set(HotField::Position, glm::vec3(columns[0].lanes[0][n], columns[0].lanes[1][n], columns[0].lanes[2][n]));
             }
-            if (!node->Outputs.empty()) {
-                ExecuteFlowFromPin(node->Outputs[0].Id, deltaTime);
+            if (columns[1].valid) {
+                obj.Set(HotField::Velocity, glm::vec3(columns[1].lanes[0][n], columns[1].lanes[1][n], columns[1].lanes[2][n]));
+            }
+            if (columns[2].valid) {
+                obj.Set(HotField::Mass, columns[2].lanes[0][n]);
+            }
+            if (columns[3].valid) {
+                obj.Set(HotField::Radius, columns[3].lanes[0][n]);
             }
         }
+    });
 
-        if (node->Outputs.size() > 2) {
-            ExecuteFlowFromPin(node->Outputs[2].Id, deltaTime);
-        }
+    if (inst.outputs.Size() > 1) {
+        WriteOutput(inst, 1, *batch);
     }
 }
 
-void GraphExecutor::ExecutePrint(AnimationGraph::Node* node, float deltaTime) {
-    auto val = EvaluatePinValue(node->Inputs[1].Id, deltaTime);
-    std::string output = ValueToString(val);
-    spdlog::info("[Graph Print] {}", output);
-}
+void GraphExecutor::ExecuteControlFlow(const Instruction& inst) {
+    if (inst.subType == AnimationGraph::NodeSubType::Branch || inst.subType == AnimationGraph::NodeSubType::If) {
+        const bool condResult = GetValueAs<bool>(Input(inst, 1), false);
+        FollowFlow(inst, condResult ? 0 : 1);
+    } else if (inst.subType == AnimationGraph::NodeSubType::For) {
+        const int start = GetValueAs<int>(Input(inst, 1), 0);
+        const int end = GetValueAs<int>(Input(inst, 2), 0);
+
+        for (int i = start; i < end; ++i) {
+            if (inst.outputs.Size() > 1) {
+                WriteOutput(inst, 1, i);
+            }
+            FollowFlow(inst, 0);
+        }
 
-GraphExecutor::Value GraphExecutor::ExecuteVariableGet(AnimationGraph::Node* node) {
-    auto it = m_Variables.find(node->VariableName);
-    if (it != m_Variables.end()) {
-        return it->second;
+        FollowFlow(inst, 2);
     }
-    return std::monostate{};
 }
 
-void GraphExecutor::ExecuteVariableSet(AnimationGraph::Node* node, float deltaTime) {
-    auto val = EvaluatePinValue(node->Inputs[1].Id, deltaTime);
-    m_Variables[node->VariableName] = val;
+void GraphExecutor::ExecutePrint(const Instruction& inst) {
+    spdlog::info("[Graph Print] {}", ValueToString(Input(inst, 1)));
+}
+
+void GraphExecutor::ExecuteVariableSet(const Instruction& inst) {
+    const Value& value = Input(inst, 1);
+    if (m_VariableValues[inst.variable] == value) return;
+
+    m_VariableValues[inst.variable] = value;
+    MarkDirty(m_VariableReaderRanges[inst.variable], m_VariableReaders);
 }
 
 std::string GraphExecutor::ValueToString(const Value& val) {
@@ -704,6 +1269,15 @@ std::string GraphExecutor::ValueToString(const Value& val) {
         auto q = std::get<glm::quat>(val);
         return "quat(" + std::to_string(q.w) + ", " + std::to_string(q.x) + ", " + std::to_string(q.y) + ", " + std::to_string(q.z) + ")";
     }
+    if (const auto* f = std::get_if<GraphBatch::FloatArray>(&val)) {
+        return "[" + std::to_string(f->Size()) + " floats]";
+    }
+    if (const auto* v = std::get_if<GraphBatch::Vec3Array>(&val)) {
+        return "[" + std::to_string(v->Size()) + " vec3]";
+    }
+    if (const auto* b = std::get_if<GraphBatch::ObjectBatch>(&val)) {
+        return "[" + std::to_string(b->Size()) + " objects]";
+    }
     return "<empty>";
 }
 
@@ -1,7 +1,9 @@
 #pragma once
 #include "../Application/AnimationGraph.h"
+#include "Simulation/GraphBatch.h"
 #include "Simulation/Scene.h"
-#include <unordered_map>
+#include <cstdint>
+#include <string>
 #include <variant>
 #include <vector>
 #include <glm/glm.hpp>
@@ -9,41 +11,140 @@
 
 class Camera;
 class SceneObject;
+class SnapshotWriter;
+class SnapshotReader;
 
+/**
+ * @brief Runs an AnimationGraph against a scene
+ *
+ * The graph is compiled into a flat execution plan whenever its revision changes. Every output
+ * pin owns a dense register, every input pin is resolved to the register it is linked to, and
+ * every flow node carries the data nodes it depends on in topological order. A tick is then a
+ * walk over precomputed index ranges without any searching or hashing.
+ *
+ * Data nodes are re-evaluated incrementally. Writing a register only counts as a change when the
+ * value differs, and a change marks the nodes reading that register dirty; clean nodes keep their
+ * outputs across ticks. Nodes without graph inputs (constants, scene getters, decomposers) poll
+ * their source instead: decomposers of scene objects compare the object's change counter. The
+ * work per tick therefore follows what actually changed, not the size of the graph.
+ *
+ * Batch nodes (ForEach getters / setters and math on array pins) carry one value per object of a
+ * class in GraphBatch arrays, so a whole class of objects costs one node evaluation per tick.
+ */
 class GraphExecutor {
 public:
-    using Value = std::variant<std::monostate, bool, int, float, glm::vec2, glm::vec3, glm::vec4, glm::quat, std::string, SceneObject*, Camera*>;
+    using Value = std::variant<std::monostate, bool, int, float, glm::vec2, glm::vec3, glm::vec4, glm::quat, std::string, SceneObject*, Camera*,
+                               GraphBatch::FloatArray, GraphBatch::Vec3Array, GraphBatch::ObjectBatch>;
 
     GraphExecutor(AnimationGraph* graph, Scene* scene);
 
     void ExecuteStartEvent();
     void ExecuteTickEvent(float deltaTime);
 
+    // Graph variables by name, the only executor state that outlives a tick. Object references are
+    // stored as scene indices; batches are rebuilt by the next tick and come back empty.
+    void WriteVariables(SnapshotWriter& writer) const;
+    void ReadVariables(SnapshotReader& reader);
+
+    // Runs every batch math node on one-element arrays next to the scalar node on the same floats
+    // and vectors, logging each case where they disagree. False on any disagreement.
+    static bool CheckBatchMath();
+
 private:
+    // Half-open range into one of the plan pools
+    struct Range {
+        uint32_t begin = 0;
+        uint32_t end = 0;
+
+        uint32_t Size() const { return end - begin; }
+    };
+
+    struct Instruction {
+        AnimationGraph::NodeType type;
+        AnimationGraph::NodeSubType subType;
+        uint32_t node = 0;                // Index into AnimationGraph::GetNodes()
+        uint32_t variable = NO_VARIABLE;  // Slot in m_VariableValues for variable nodes
+        Range operands;                   // m_Operands: source register of every input pin
+        Range outputs;                    // Registers of every output pin
+        Range flows;                      // m_FlowRanges: successors of every output pin
+        Range prelude;                    // m_Prelude: data dependencies in evaluation order
+    };
+
+    struct TickEntry {
+        uint32_t flow;
+        uint32_t deltaTimeRegister;
+    };
+
+    static constexpr uint32_t NO_VARIABLE = 0xFFFFFFFFu;
+    static constexpr uint32_t UNCONNECTED_REGISTER = 0;  // Never written, always monostate
+
     AnimationGraph* m_pGraph;
     Scene* m_pScene;
-    std::unordered_map<std::string, Value> m_Variables;
-    std::unordered_map<int, Value> m_PinValues;
-
-    void ExecuteFlowFromPin(ax::NodeEditor::PinId pinId, float deltaTime = 0.0f);
-    void ExecuteNode(AnimationGraph::Node* node, ax::NodeEditor::PinId entryPin, float deltaTime);
-
-    Value EvaluatePinValue(ax::NodeEditor::PinId pinId, float deltaTime);
-    Value EvaluateNode(AnimationGraph::Node* node, float deltaTime);
-
-    AnimationGraph::Node* FindNodeByOutputPin(ax::NodeEditor::PinId pinId) const;
-    AnimationGraph::Node* FindNodeByInputPin(ax::NodeEditor::PinId pinId) const;
-    ax::NodeEditor::PinId GetConnectedOutputPin(ax::NodeEditor::PinId inputPinId) const;
-
-    Value ExecuteMathOperation(AnimationGraph::Node* node, float deltaTime);
-    Value ExecuteConstant(AnimationGraph::Node* node);
-    Value ExecuteDecomposer(AnimationGraph::Node* node, float deltaTime);
-    Value ExecuteSceneGetter(AnimationGraph::Node* node);
-    void ExecuteSetter(AnimationGraph::Node* node, float deltaTime);
-    void ExecuteControlFlow(AnimationGraph::Node* node, ax::NodeEditor::PinId entryPin, float deltaTime);
-    void ExecutePrint(AnimationGraph::Node* node, float deltaTime);
-    Value ExecuteVariableGet(AnimationGraph::Node* node);
-    void ExecuteVariableSet(AnimationGraph::Node* node, float deltaTime);
+
+    // Execution plan, rebuilt by Compile()
+    uint64_t m_CompiledRevision = UINT64_MAX;
+    std::vector<Instruction> m_Instructions;
+    std::vector<uint32_t> m_Operands;
+    std::vector<Range> m_FlowRanges;
+    std::vector<uint32_t> m_FlowTargets;
+    std::vector<uint32_t> m_Prelude;
+    std::vector<Range> m_ConsumerRanges;        // Per register: data nodes reading it, in m_Consumers
+    std::vector<uint32_t> m_Consumers;
+    std::vector<Range> m_VariableReaderRanges;  // Per variable slot: VariableGet nodes, in m_VariableReaders
+    std::vector<uint32_t> m_VariableReaders;
+    std::vector<uint32_t> m_StartEntries;
+    std::vector<TickEntry> m_TickEntries;
+
+    // Runtime state
+    std::vector<Value> m_Registers;
+    std::vector<uint8_t> m_Dirty;
+    std::vector<uint64_t> m_ObservedVersions;  // SceneObject change counter seen by each decomposer
+    std::vector<std::string> m_VariableNames;
+    std::vector<Value> m_VariableValues;
+    Value m_BatchScratch;                      // Batch results are built here and swapped into their register
+    GraphBatch::Vec3Array m_BatchTemp;
+
+    void EnsureCompiled();
+    void Compile();
+
+    void ExecuteFlow(uint32_t flowRange);
+    void FollowFlow(const Instruction& inst, size_t outputIndex);
+    void ExecuteInstruction(uint32_t index);
+    void EvaluatePrelude(const Instruction& inst);
+    bool PollSource(const Instruction& inst) const;
+    ObjectClassId BatchClass(const Instruction& inst) const;
+    uint64_t ClassSignature(ObjectClassId classId) const;
+    void EvaluateData(const Instruction& inst);
+    void MarkDirty(Range readers, const std::vector<uint32_t>& pool);
+    void Write(uint32_t reg, Value value);
+
+    const Value& Input(const Instruction& inst, size_t inputIndex) const {
+        return inputIndex < inst.operands.Size() ? m_Registers[m_Operands[inst.operands.begin + inputIndex]]
+                                                 : m_Registers[UNCONNECTED_REGISTER];
+    }
+    void WriteOutput(const Instruction& inst, size_t outputIndex, Value value) {
+        Write(inst.outputs.begin + static_cast<uint32_t>(outputIndex), std::move(value));
+    }
+
+    template<typename T>
+    T& BatchScratch() {
+        if (!std::holds_alternative<T>(m_BatchScratch)) m_BatchScratch.emplace<T>();
+        return std::get<T>(m_BatchScratch);
+    }
+    // Publishes m_BatchScratch as an output; the register's previous storage becomes the next scratch
+    void SwapOutput(const Instruction& inst, size_t outputIndex);
+
+    Value ExecuteMathOperation(const Instruction& inst);
+    Value ExecuteConstant(const Instruction& inst) const;
+    void ExecuteDecomposer(const Instruction& inst);
+    Value ExecuteSceneGetter(const Instruction& inst) const;
+    void ExecuteBatchMath(const Instruction& inst);
+    void ExecuteBatchGetter(const Instruction& inst);
+    void ExecuteBatchSetter(const Instruction& inst);
+    void ExecuteSetter(const Instruction& inst);
+    void ExecuteControlFlow(const Instruction& inst);
+    void ExecutePrint(const Instruction& inst);
+    void ExecuteVariableSet(const Instruction& inst);
 
     static std::string ValueToString(const Value& val);
 
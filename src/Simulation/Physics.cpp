@@ -1,8 +1,12 @@
 #include "Physics.h"
 
 #include <algorithm>
+#include <cmath>
+#include <thread>
 #include <spdlog/spdlog.h>
 
+#include "Snapshot.h"
+#include "Application/Application.h"
 #include "Application/Parameters.h"
 #include "Renderer/Renderer.h"
 #include "Renderer/GLTFMesh.h"
@@ -54,7 +58,12 @@ void Physics::Init() {
         return;
     }
 
-    m_Dispatcher = PxDefaultCpuDispatcherCreate(2);
+    int workerThreads = Application::Params().Get(Params::PhysicsWorkerThreads, 0);
+    if (workerThreads <= 0) {
+        workerThreads = static_cast<int>(std::max(std::thread::hardware_concurrency(), 1u));
+    }
+    m_Dispatcher = PxDefaultCpuDispatcherCreate(static_cast<PxU32>(workerThreads));
+    spdlog::info("PhysX dispatcher running {} worker threads", workerThreads);
 
     PxSceneDesc sceneDesc(m_Physics->getTolerancesScale());
     sceneDesc.gravity = PxVec3(0.0f, 0.0f, 0.0f);
@@ -77,13 +86,8 @@ void Physics::Init() {
 
 void Physics::Shutdown() {
     if (m_Scene) {
-        for (auto &body: m_Bodies) {
-            if (body.actor) {
-                m_Scene->removeActor(*body.actor);
-                body.actor->release();
-            }
-        }
-        m_Bodies.clear();
+        DiscardStep();
+        ReleaseBodies();
 
         for (auto &bh: m_BlackHoles) {
             if (bh.actor) {
@@ -140,15 +144,12 @@ void Physics::Shutdown() {
 }
 
 void Physics::SetScene(Scene *scene) {
+    DiscardStep();
     m_CurrentScene = scene;
+    m_TimeAccumulator = 0.0f;
+    m_AccelerationsValid = false;
 
-    for (auto &body: m_Bodies) {
-        if (body.actor) {
-            m_Scene->removeActor(*body.actor);
-            body.actor->release();
-        }
-    }
-    m_Bodies.clear();
+    ReleaseBodies();
 
     for (auto &bh: m_BlackHoles) {
         if (bh.actor) {
@@ -163,156 +164,317 @@ void Physics::SetScene(Scene *scene) {
     }
 
     for (size_t i = 0; i < scene->objects.size(); ++i) {
-        auto &obj = scene->objects[i];
+        if (const auto bodyData = BodyDataFor(scene->objects[i], i)) {
+            CreatePhysicsBody(*bodyData);
+        }
+    }
 
-        if (obj.HasClass("BlackHole")) {
-            PhysicsBodyData bodyData;
-            bodyData.sceneIndex = i;
-            bodyData.isSphere = false;
+    spdlog::info("Loaded {} black holes and {} physics bodies from scene", m_BlackHoles.size(), m_Bodies.Size());
+}
 
-            auto posHandle = Field::Entity::Position;
-            auto rotHandle = Field::Entity::Rotation;
-            auto radiusHandle = Field::Sphere::Radius;
-            auto massHandle = Field::Physics::Mass;
-            auto velHandle = Field::Physics::Velocity;
+std::optional<PhysicsBodyData> Physics::BodyDataFor(const SceneObject& obj, const size_t sceneIndex) {
+    PhysicsBodyData bodyData;
+    bodyData.sceneIndex = sceneIndex;
 
-            if (obj.HasParameter(posHandle)) {
-                bodyData.position = std::get<glm::vec3>(obj.GetParameter(Field::Entity::Position));
-            }
-            if (obj.HasParameter(rotHandle)) {
-                bodyData.rotation = std::get<glm::quat>(obj.GetParameter(Field::Entity::Rotation));
-            }
-            if (obj.HasParameter(radiusHandle)) {
-                bodyData.radius = std::get<float>(obj.GetParameter(Field::Sphere::Radius));
-            }
-            if (obj.HasParameter(massHandle)) {
-                bodyData.mass = std::get<float>(obj.GetParameter(Field::Physics::Mass));
-            }
-            if (obj.HasParameter(velHandle)) {
-                bodyData.initialVelocity = std::get<glm::vec3>(obj.GetParameter(Field::Physics::Velocity));
-            }
+    if (obj.HasClass(ObjectClasses::BlackHole)) {
+        bodyData.isSphere = false;
 
-            CreatePhysicsBody(bodyData);
-        }
-        else if (obj.HasClass("Mesh")) {
-            PhysicsBodyData bodyData;
-            bodyData.sceneIndex = i;
-            bodyData.isSphere = false;
-
-            auto posHandle = Field::Entity::Position;
-            auto rotHandle = Field::Entity::Rotation;
-            auto scaleHandle = Field::Entity::Scale;
-            auto massHandle = Field::Physics::Mass;
-            auto pathHandle = Field::Mesh::FilePath;
-            auto velHandle = Field::Physics::Velocity;
-
-            if (obj.HasParameter(posHandle)) {
-                bodyData.position = std::get<glm::vec3>(obj.GetParameter(posHandle));
-            }
-            if (obj.HasParameter(rotHandle)) {
-                bodyData.rotation = std::get<glm::quat>(obj.GetParameter(rotHandle));
-            }
-            if (obj.HasParameter(scaleHandle)) {
-                bodyData.scale = std::get<glm::vec3>(obj.GetParameter(scaleHandle));
-            }
-            if (obj.HasParameter(massHandle)) {
-                bodyData.mass = std::get<float>(obj.GetParameter(massHandle));
-            }
-            if (obj.HasParameter(pathHandle)) {
-                bodyData.meshPath = std::get<std::string>(obj.GetParameter(pathHandle));
-            }
-            if (obj.HasParameter(velHandle)) {
-                bodyData.initialVelocity = std::get<glm::vec3>(obj.GetParameter(velHandle));
-            }
+        if (const auto* position = obj.Find<glm::vec3>(HotField::Position)) bodyData.position = *position;
+        if (const auto* rotation = obj.Find<glm::quat>(HotField::Rotation)) bodyData.rotation = *rotation;
+        if (const auto* radius = obj.Find<float>(HotField::Radius)) bodyData.radius = *radius;
+        if (const auto* mass = obj.Find<float>(HotField::Mass)) bodyData.mass = *mass;
+        if (const auto* velocity = obj.Find<glm::vec3>(HotField::Velocity)) bodyData.initialVelocity = *velocity;
+    }
+    else if (obj.HasClass(ObjectClasses::Mesh)) {
+        bodyData.isSphere = false;
 
-            bodyData.radius = glm::length(bodyData.scale) * 0.5f;
+        if (const auto* position = obj.Find<glm::vec3>(HotField::Position)) bodyData.position = *position;
+        if (const auto* rotation = obj.Find<glm::quat>(HotField::Rotation)) bodyData.rotation = *rotation;
+        if (const auto* scale = obj.Find<glm::vec3>(HotField::Scale)) bodyData.scale = *scale;
+        if (const auto* mass = obj.Find<float>(HotField::Mass)) bodyData.mass = *mass;
+        if (const auto* path = obj.Find<std::string>(Field::Mesh::FilePath)) bodyData.meshPath = *path;
+        if (const auto* velocity = obj.Find<glm::vec3>(HotField::Velocity)) bodyData.initialVelocity = *velocity;
 
-            CreatePhysicsBody(bodyData);
-        }
-        else if (obj.HasClass("Sphere")) {
-            PhysicsBodyData bodyData;
-            bodyData.sceneIndex = i;
-            bodyData.isSphere = true;
-
-            auto posHandle = Field::Entity::Position;
-            auto rotHandle = Field::Entity::Rotation;
-            auto radiusHandle = Field::Sphere::Radius;
-            auto massHandle = Field::Physics::Mass;
-            auto velHandle = Field::Physics::Velocity;
-
-            if (obj.HasParameter(posHandle)) {
-                bodyData.position = std::get<glm::vec3>(obj.GetParameter(Field::Entity::Position));
-            }
-            if (obj.HasParameter(rotHandle)) {
-                bodyData.rotation = std::get<glm::quat>(obj.GetParameter(Field::Entity::Rotation));
-            }
-            if (obj.HasParameter(radiusHandle)) {
-                bodyData.radius = std::get<float>(obj.GetParameter(Field::Sphere::Radius));
-            }
-            if (obj.HasParameter(massHandle)) {
-                bodyData.mass = std::get<float>(obj.GetParameter(Field::Physics::Mass));
-            }
-            if (obj.HasParameter(velHandle)) {
-                bodyData.initialVelocity = std::get<glm::vec3>(obj.GetParameter(Field::Physics::Velocity));
-            }
+        bodyData.radius = glm::length(bodyData.scale) * 0.5f;
+    }
+    else if (obj.HasClass(ObjectClasses::Sphere)) {
+        bodyData.isSphere = true;
 
-            bodyData.scale = glm::vec3(bodyData.radius * 2.0f);
+        if (const auto* position = obj.Find<glm::vec3>(HotField::Position)) bodyData.position = *position;
+        if (const auto* rotation = obj.Find<glm::quat>(HotField::Rotation)) bodyData.rotation = *rotation;
+        if (const auto* radius = obj.Find<float>(HotField::Radius)) bodyData.radius = *radius;
+        if (const auto* mass = obj.Find<float>(HotField::Mass)) bodyData.mass = *mass;
+        if (const auto* velocity = obj.Find<glm::vec3>(HotField::Velocity)) bodyData.initialVelocity = *velocity;
 
-            CreatePhysicsBody(bodyData);
+        bodyData.scale = glm::vec3(bodyData.radius * 2.0f);
+    }
+    else {
+        return std::nullopt;
+    }
+    return bodyData;
+}
+
+void Physics::WriteState(SnapshotWriter& writer) {
+    FinishStep();
+
+    writer.Write(m_TimeAccumulator);
+    writer.Write(static_cast<uint8_t>(m_AccelerationsValid));
+
+    // Live actor state, which is ahead of the published poses when a step was still in flight
+    const size_t count = m_Bodies.Size();
+    writer.Write(static_cast<uint32_t>(count));
+    for (size_t i = 0; i < count; ++i) {
+        const PxRigidDynamic* actor = m_Bodies.actors[i];
+        const PxTransform pose = actor ? actor->getGlobalPose() : PxTransform(PxIdentity);
+        const PxVec3 linear = actor ? actor->getLinearVelocity() : PxVec3(m_Bodies.vx[i], m_Bodies.vy[i], m_Bodies.vz[i]);
+        const PxVec3 angular = actor ? actor->getAngularVelocity() : PxVec3(0.0f);
+
+        writer.Write(static_cast<uint64_t>(m_Bodies.sceneIndices[i]));
+        writer.Write(glm::vec3(pose.p.x, pose.p.y, pose.p.z));
+        writer.Write(glm::quat(pose.q.w, pose.q.x, pose.q.y, pose.q.z));
+        writer.Write(glm::vec3(linear.x, linear.y, linear.z));
+        writer.Write(glm::vec3(angular.x, angular.y, angular.z));
+    }
+
+    // Leapfrog opens the next step with these; recomputing them after a restore would not match bit for bit
+    if (m_AccelerationsValid) {
+        writer.WriteArray(m_GravitySnapshot.ax);
+        writer.WriteArray(m_GravitySnapshot.ay);
+        writer.WriteArray(m_GravitySnapshot.az);
+    }
+}
+
+void Physics::ReadState(SnapshotReader& reader, Scene* scene) {
+    SetScene(nullptr);
+    m_CurrentScene = scene;
+
+    const float timeAccumulator = reader.Read<float>();
+    const bool hasAccelerations = reader.Read<uint8_t>() != 0;
+    bool complete = true;
+
+    // Bodies are recreated in their recorded order, so the gravity solver visits them as the original run did
+    const uint32_t count = reader.Read<uint32_t>();
+    for (uint32_t i = 0; i < count; ++i) {
+        const auto sceneIndex = static_cast<size_t>(reader.Read<uint64_t>());
+        const auto position = reader.Read<glm::vec3>();
+        const auto rotation = reader.Read<glm::quat>();
+        const auto linear = reader.Read<glm::vec3>();
+        const auto angular = reader.Read<glm::vec3>();
+
+        std::optional<PhysicsBodyData> bodyData;
+        if (scene && sceneIndex < scene->objects.size()) {
+            bodyData = BodyDataFor(scene->objects[sceneIndex], sceneIndex);
+        }
+        const size_t created = m_Bodies.Size();
+        if (bodyData) {
+            bodyData->position = position;
+            bodyData->rotation = rotation;
+            bodyData->initialVelocity = linear;
+            CreatePhysicsBody(*bodyData);
+        }
+        if (m_Bodies.Size() == created) {
+            spdlog::warn("Checkpoint body of scene object {} could not be restored", sceneIndex);
+            complete = false;
+            continue;
         }
+        m_Bodies.actors.back()->setAngularVelocity(PxVec3(angular.x, angular.y, angular.z));
     }
 
-    spdlog::info("Loaded {} black holes and {} physics bodies from scene", m_BlackHoles.size(), m_Bodies.size());
+    if (hasAccelerations) {
+        auto& snapshot = m_GravitySnapshot;
+        reader.ReadArray(snapshot.ax);
+        reader.ReadArray(snapshot.ay);
+        reader.ReadArray(snapshot.az);
+        snapshot.Resize(m_Bodies.Size());
+    }
+
+    m_TimeAccumulator = timeAccumulator;
+    m_AccelerationsValid = hasAccelerations && complete;
+    CapturePoses();
+}
+
+void Physics::ReleaseBodies() {
+    for (PxRigidDynamic* actor : m_Bodies.actors) {
+        if (actor) {
+            m_Scene->removeActor(*actor);
+            actor->release();
+        }
+    }
+    m_Bodies.Clear();
+    m_PublishedPoses = {};
 }
 
 void Physics::Apply() {
     if (!m_CurrentScene) return;
 
-    constexpr auto posHandle = Field::Entity::Position;
-    constexpr auto rotHandle = Field::Entity::Rotation;
+    // Reads the poses captured after the last completed step; PhysX may still be simulating the next one
+    const auto& poses = m_PublishedPoses;
+    for (size_t i = 0; i < poses.sceneIndices.size(); ++i) {
+        if (poses.sceneIndices[i] < m_CurrentScene->objects.size()) {
+            auto& obj = m_CurrentScene->objects[poses.sceneIndices[i]];
+            obj.Set(HotField::Position, poses.positions[i]);
+            obj.Set(HotField::Rotation, poses.rotations[i]);
+        }
+    }
+
+    for (const auto& bh : m_BlackHoles) {
+        if (!bh.actor) continue;
 
-    for (auto& body : m_Bodies) {
-        if (!body.actor) continue;
+        if (bh.sceneIndex < m_CurrentScene->objects.size()) {
+            m_CurrentScene->objects[bh.sceneIndex].Set(HotField::Position, bh.position);
+        }
+    }
+}
 
-        PxTransform transform = body.actor->getGlobalPose();
+void Physics::Update(const float deltaTime, Scene* scene) {
+    // One consistent set of values for every sub-step of this update
+    const auto params = Application::Params().Snapshot();
+    const auto integrator = static_cast<GravityIntegrator>(std::clamp(params->Get(Params::PhysicsIntegrator, 1), 0, 2));
+    const bool async = params->Get(Params::PhysicsAsyncSimulation, false);
+    const float openingAngle = params->Get(Params::PhysicsGravityOpeningAngle, 0.5f);
+
+    // The step left running by the previous frame overlapped with its graph execution and rendering
+    FinishStep();
+
+    int stepCount = 1;
+    float stepSize = deltaTime;
+    if (params->Get(Params::PhysicsFixedTimestepEnabled, true)) {
+        stepSize = std::max(params->Get(Params::PhysicsFixedTimestep, 1.0f / 240.0f), 1e-5f);
+        const int maxSubSteps = std::max(params->Get(Params::PhysicsMaxSubSteps, 64), 1);
+
+        m_TimeAccumulator += deltaTime;
+        stepCount = 0;
+        while (m_TimeAccumulator >= stepSize && stepCount < maxSubSteps) {
+            m_TimeAccumulator -= stepSize;
+            stepCount++;
+        }
 
-        body.position = glm::vec3(transform.p.x, transform.p.y, transform.p.z);
-        body.rotation = glm::quat(transform.q.w, transform.q.x, transform.q.y, transform.q.z);
+        if (m_TimeAccumulator >= stepSize) {
+            // Slow frame: fall behind real time instead of spiralling into ever longer frames
+            spdlog::debug("Physics dropped {} s of simulated time after {} sub-steps", m_TimeAccumulator, stepCount);
+            m_TimeAccumulator = std::fmod(m_TimeAccumulator, stepSize);
+        }
+    }
 
-        if (body.sceneIndex < m_CurrentScene->objects.size()) {
-            auto& obj = m_CurrentScene->objects[body.sceneIndex];
-            if (obj.HasParameter(posHandle)) {
-                obj.SetParameter(posHandle, body.position);
-            }
-            if (obj.HasParameter(rotHandle)) {
-                obj.SetParameter(rotHandle, body.rotation);
-            }
+    for (int i = 0; i < stepCount; ++i) {
+        if (async && i == stepCount - 1) {
+            // Publish the last completed state, then leave the final sub-step running until the next frame
+            CapturePoses();
+            BeginStep(stepSize, integrator, openingAngle, scene);
+            return;
         }
+        BeginStep(stepSize, integrator, openingAngle, scene);
+        FinishStep();
     }
 
-    for (auto& bh : m_BlackHoles) {
-        if (!bh.actor) continue;
+    CapturePoses();
+}
 
-        PxTransform transform = bh.actor->getGlobalPose();
-        bh.position = glm::vec3(transform.p.x, transform.p.y, transform.p.z);
+void Physics::BeginStep(const float dt, const GravityIntegrator integrator, const float openingAngle, Scene* scene) {
+    if (dt <= 0.0f) return;
 
-        if (bh.sceneIndex < m_CurrentScene->objects.size()) {
-            auto& obj = m_CurrentScene->objects[bh.sceneIndex];
-            if (obj.HasParameter(posHandle)) {
-                obj.SetParameter(posHandle, bh.position);
-            }
+    const size_t count = m_Bodies.Size();
+    auto& bodies = m_Bodies;
+    const auto& snapshot = m_GravitySnapshot;
+
+    m_InFlight.dt = dt;
+    m_InFlight.scene = scene;
+    m_InFlight.gravity = count >= 2;
+
+    if (m_InFlight.gravity) {
+        GatherGravitySnapshot();
+        IntegrateGravity(dt, integrator, openingAngle);
+
+        // PhysX moves every body along the chord of the step, so contacts are still found on the way
+        for (size_t i = 0; i < count; ++i) {
+            if (!bodies.actors[i]) continue;
+            bodies.actors[i]->setLinearVelocity(PxVec3(bodies.x[i] - snapshot.startX[i],
+                                                       bodies.y[i] - snapshot.startY[i],
+                                                       bodies.z[i] - snapshot.startZ[i]) / dt);
         }
     }
+
+    m_Scene->simulate(dt);
+    m_InFlight.running = true;
 }
 
-void Physics::Update(const float deltaTime, Scene* scene) {
-    ApplyGravitationalForces(deltaTime, scene);
-    m_Scene->simulate(deltaTime);
+void Physics::FinishStep() {
+    if (!m_InFlight.running) return;
+
     m_Scene->fetchResults(true);
+    m_InFlight.running = false;
+
+    if (m_InFlight.gravity) {
+        auto& bodies = m_Bodies;
+        const auto& snapshot = m_GravitySnapshot;
+        const float dt = m_InFlight.dt;
+        Scene* scene = m_InFlight.scene;
+
+        for (size_t i = 0; i < bodies.Size(); ++i) {
+            PxRigidDynamic* actor = bodies.actors[i];
+            if (!actor) continue;
+
+            const PxVec3 chord = PxVec3(bodies.x[i] - snapshot.startX[i],
+                                        bodies.y[i] - snapshot.startY[i],
+                                        bodies.z[i] - snapshot.startZ[i]) / dt;
+            // Contact impulses show up as a change of the chord velocity; keep them on top of the integrated one
+            const PxVec3 impulse = actor->getLinearVelocity() - chord;
+            if (!impulse.isZero()) {
+                m_AccelerationsValid = false;
+            }
+
+            bodies.vx[i] += impulse.x;
+            bodies.vy[i] += impulse.y;
+            bodies.vz[i] += impulse.z;
+            actor->setLinearVelocity(PxVec3(bodies.vx[i], bodies.vy[i], bodies.vz[i]));
+
+            const size_t sceneIndex = bodies.sceneIndices[i];
+            if (scene && sceneIndex < scene->objects.size()) {
+                scene->objects[sceneIndex].Set(HotField::Velocity, glm::vec3(bodies.vx[i], bodies.vy[i], bodies.vz[i]));
+            }
+        }
+    }
+
     ProcessDeletedBodies();
 }
 
-void Physics::CreatePhysicsBody(PhysicsBodyData &data) {
+void Physics::DiscardStep() {
+    if (m_InFlight.running) {
+        m_Scene->fetchResults(true);
+        m_InFlight.running = false;
+    }
+    m_BodiesToDelete.clear();
+}
+
+void Physics::CapturePoses() {
+    auto& poses = m_PublishedPoses;
+    const size_t count = m_Bodies.Size();
+    poses.positions.resize(count);
+    poses.rotations.resize(count);
+    poses.sceneIndices.assign(m_Bodies.sceneIndices.begin(), m_Bodies.sceneIndices.end());
+
+    for (size_t i = 0; i < count; ++i) {
+        if (!m_Bodies.actors[i]) continue;
+
+        const PxTransform transform = m_Bodies.actors[i]->getGlobalPose();
+        m_Bodies.x[i] = transform.p.x;
+        m_Bodies.y[i] = transform.p.y;
+        m_Bodies.z[i] = transform.p.z;
+        m_Bodies.rotation[i] = glm::quat(transform.q.w, transform.q.x, transform.q.y, transform.q.z);
+
+        poses.positions[i] = glm::vec3(transform.p.x, transform.p.y, transform.p.z);
+        poses.rotations[i] = m_Bodies.rotation[i];
+    }
+
+    for (auto& bh : m_BlackHoles) {
+        if (!bh.actor) continue;
+
+        const PxTransform transform = bh.actor->getGlobalPose();
+        bh.position = glm::vec3(transform.p.x, transform.p.y, transform.p.z);
+    }
+}
+
+void Physics::CreatePhysicsBody(const PhysicsBodyData &data) {
     PxTransform transform(
         PxVec3(data.position.x, data.position.y, data.position.z),
         PxQuat(data.rotation.x, data.rotation.y, data.rotation.z, data.rotation.w)
@@ -365,36 +527,103 @@ void Physics::CreatePhysicsBody(PhysicsBodyData &data) {
     body->setActorFlag(PxActorFlag::eVISUALIZATION, true);
 
     m_Scene->addActor(*body);
-    data.actor = body;
-    m_Bodies.push_back(data);
+    const BodyHandle handle = m_Bodies.Add(body, data.sceneIndex, data.position, data.rotation,
+                                           data.initialVelocity, data.mass, data.radius);
+    body->userData = handle.ToUserData();
 }
 
 
-void Physics::ApplyGravitationalForces(const float dt, Scene* scene) const
-{
-    for (size_t i = 0; i < m_Bodies.size(); ++i) {
-        if (!m_Bodies[i].actor) continue;
-
-        PxTransform p_i = m_Bodies[i].actor->getGlobalPose();
-        PxVec3 v_i = m_Bodies[i].actor->getLinearVelocity();
-
-        for (size_t j = 0; j < m_Bodies.size(); ++j) {
-            if (i == j) continue;
+void Physics::GatherGravitySnapshot() {
+    const size_t count = m_Bodies.Size();
+    auto& snapshot = m_GravitySnapshot;
+    if (snapshot.mu.size() != count) {
+        m_AccelerationsValid = false;
+    }
+    snapshot.Resize(count);
+
+    // Sync once per step: PhysX pose reads are far too slow for the inner loop of an N-body solver
+    for (size_t i = 0; i < count; ++i) {
+        PxRigidDynamic* actor = m_Bodies.actors[i];
+        if (actor) {
+            const PxVec3 p = actor->getGlobalPose().p;
+            const PxVec3 v = actor->getLinearVelocity();
+            m_Bodies.x[i] = p.x;
+            m_Bodies.y[i] = p.y;
+            m_Bodies.z[i] = p.z;
+            m_Bodies.vx[i] = v.x;
+            m_Bodies.vy[i] = v.y;
+            m_Bodies.vz[i] = v.z;
+        }
 
-            PxTransform p_j = m_Bodies[j].actor->getGlobalPose();
-            const float m_j = m_Bodies[j].mass;
+        snapshot.startX[i] = m_Bodies.x[i];
+        snapshot.startY[i] = m_Bodies.y[i];
+        snapshot.startZ[i] = m_Bodies.z[i];
+        snapshot.mu[i] = actor ? G * m_Bodies.mass[i] : 0.0f;
+    }
+}
 
-            PxVec3 a = G * m_j / (p_j.p - p_i.p).magnitudeSquared() * (p_j.p - p_i.p).getNormalized();
+void Physics::ComputeGravity(const float theta) {
+    auto& snapshot = m_GravitySnapshot;
+    m_GravityTree.Build(m_Bodies.x.data(), m_Bodies.y.data(), m_Bodies.z.data(), snapshot.mu.data(), m_Bodies.Size());
+    m_GravityTree.ComputeAccelerations(theta, snapshot.ax.data(), snapshot.ay.data(), snapshot.az.data());
+}
 
-            // update velocity
-            v_i = v_i + a * dt;
-            m_Bodies[i].actor->setLinearVelocity(v_i);
-            scene->objects[i].SetParameter(Field::Physics::Velocity, glm::vec3(v_i.x, v_i.y, v_i.z));
+void Physics::IntegrateGravity(const float dt, const GravityIntegrator integrator, const float theta) {
+    auto& bodies = m_Bodies;
+    const auto& snapshot = m_GravitySnapshot;
+    const size_t count = bodies.Size();
 
-            // update position
-            p_i.p = p_i.p + v_i * dt;
-            m_Bodies[i].actor->setGlobalPose(p_i);
-            scene->objects[i].SetParameter(Field::Entity::Position, glm::vec3(p_i.p.x, p_i.p.y, p_i.p.z));
+    const auto kick = [&](const float h) {
+        for (size_t i = 0; i < count; ++i) {
+            bodies.vx[i] += snapshot.ax[i] * h;
+            bodies.vy[i] += snapshot.ay[i] * h;
+            bodies.vz[i] += snapshot.az[i] * h;
+        }
+    };
+    const auto drift = [&](const float h) {
+        for (size_t i = 0; i < count; ++i) {
+            bodies.x[i] += bodies.vx[i] * h;
+            bodies.y[i] += bodies.vy[i] * h;
+            bodies.z[i] += bodies.vz[i] * h;
+        }
+    };
+
+    switch (integrator) {
+        case GravityIntegrator::SymplecticEuler:
+            ComputeGravity(theta);
+            kick(dt);
+            drift(dt);
+            m_AccelerationsValid = false;
+            break;
+
+        case GravityIntegrator::Leapfrog:
+            // The closing kick's accelerations are the opening kick's of the next step
+            if (!m_AccelerationsValid) {
+                ComputeGravity(theta);
+            }
+            kick(0.5f * dt);
+            drift(dt);
+            ComputeGravity(theta);
+            kick(0.5f * dt);
+            m_AccelerationsValid = true;
+            break;
+
+        case GravityIntegrator::Yoshida4: {
+            // Yoshida (1990): w1 = 1 / (2 - 2^(1/3)), w0 = -2^(1/3) * w1
+            constexpr double CBRT2 = 1.2599210498948732;
+            constexpr double W1 = 1.0 / (2.0 - CBRT2);
+            constexpr double W0 = -CBRT2 * W1;
+            constexpr float DRIFT[4] = {float(0.5 * W1), float(0.5 * (W0 + W1)), float(0.5 * (W0 + W1)), float(0.5 * W1)};
+            constexpr float KICK[3] = {float(W1), float(W0), float(W1)};
+
+            for (int k = 0; k < 3; ++k) {
+                drift(DRIFT[k] * dt);
+                ComputeGravity(theta);
+                kick(KICK[k] * dt);
+            }
+            drift(DRIFT[3] * dt);
+            m_AccelerationsValid = false;
+            break;
         }
     }
 }
@@ -521,12 +750,10 @@ void Physics::onContact(const PxContactPairHeader& pairHeader, const PxContactPa
         }
 
         if (dynamicBody) {
-            for (size_t j = 0; j < m_Bodies.size(); ++j) {
-                if (m_Bodies[j].actor == dynamicBody) {
-                    m_BodiesToDelete.push_back(j);
-                    spdlog::info("Object collided with black hole - marking for deletion");
-                    break;
-                }
+            const BodyHandle handle = BodyHandle::FromUserData(dynamicBody->userData);
+            if (m_Bodies.Contains(handle)) {
+                m_BodiesToDelete.push_back(handle);
+                spdlog::info("Object collided with black hole - marking for deletion");
             }
         }
     }
@@ -535,77 +762,47 @@ void Physics::onContact(const PxContactPairHeader& pairHeader, const PxContactPa
 void Physics::ProcessDeletedBodies() {
     if (m_BodiesToDelete.empty() || !m_CurrentScene) return;
 
-    std::sort(m_BodiesToDelete.rbegin(), m_BodiesToDelete.rend());
+    size_t removedCount = 0;
+    for (const BodyHandle handle : m_BodiesToDelete) {
+        // A body touching several black holes is queued more than once; later handles are stale
+        const size_t idx = m_Bodies.IndexOf(handle);
+        if (idx == BodyStore::INVALID_INDEX) continue;
 
-    for (size_t idx : m_BodiesToDelete) {
-        if (idx >= m_Bodies.size()) continue;
-
-        auto& body = m_Bodies[idx];
-
-        if (body.actor) {
-            m_Scene->removeActor(*body.actor);
-            body.actor->release();
+        if (PxRigidDynamic* actor = m_Bodies.actors[idx]) {
+            m_Scene->removeActor(*actor);
+            actor->release();
         }
 
-        // switch (body.objectType) {
-        //     case Scene::ObjectType::Mesh:
-        //         if (body.sceneIndex < m_CurrentScene->meshes.size()) {
-        //             m_CurrentScene->meshes.erase(m_CurrentScene->meshes.begin() + static_cast<std::ptrdiff_t>(body.sceneIndex));
-        //         }
-        //         break;
-        //     case Scene::ObjectType::Sphere:
-        //         if (body.sceneIndex < m_CurrentScene->spheres.size()) {
-        //             m_CurrentScene->spheres.erase(m_CurrentScene->spheres.begin() + static_cast<std::ptrdiff_t>(body.sceneIndex));
-        //         }
-        //         break;
-        //     default:
-        //         break;
-        // }
-
-        m_Bodies.erase(m_Bodies.begin() + static_cast<std::ptrdiff_t>(idx));
+        // Only the body goes away. The scene object stays where it is: animation graphs, executor
+        // variables and path histories all refer to scene objects by index or pointer.
+        m_Bodies.Remove(handle);
+        removedCount++;
     }
-
     m_BodiesToDelete.clear();
 
-    for (size_t i = 0; i < m_Bodies.size(); ++i) {
-        size_t newSceneIndex = 0;
-        // switch (m_Bodies[i].objectType) {
-        //     case Scene::ObjectType::Mesh:
-        //         for (size_t j = 0; j < i; ++j) {
-        //             if (m_Bodies[j].objectType == Scene::ObjectType::Mesh) {
-        //                 newSceneIndex++;
-        //             }
-        //         }
-        //         m_Bodies[i].sceneIndex = newSceneIndex;
-        //         break;
-        //     case Scene::ObjectType::Sphere:
-        //         for (size_t j = 0; j < i; ++j) {
-        //             if (m_Bodies[j].objectType == Scene::ObjectType::Sphere) {
-        //                 newSceneIndex++;
-        //             }
-        //         }
-        //         m_Bodies[i].sceneIndex = newSceneIndex;
-        //         break;
-        //     default:
-        //         break;
-        // }
-    }
+    if (removedCount == 0) return;
+    m_AccelerationsValid = false;
+
+    spdlog::debug("Removed {} bodies swallowed by black holes", removedCount);
 }
 
 const PxRenderBuffer* Physics::GetDebugRenderBuffer() const {
-    if (!m_Scene) {
+    // The render buffer must not be read while a step is simulating in the background
+    if (!m_Scene || m_InFlight.running) {
         return nullptr;
     }
     return &m_Scene->getRenderBuffer();
 }
 
 void Physics::SetVisualizationParameter(PxVisualizationParameter::Enum param, float value) {
+    FinishStep();
     if (m_Scene) {
         m_Scene->setVisualizationParameter(param, value);
     }
 }
 
 void Physics::SetVisualizationScale(float scale) {
+    FinishStep();
     if (m_Scene) {
         m_Scene->setVisualizationParameter(PxVisualizationParameter::eSCALE, scale);
     }
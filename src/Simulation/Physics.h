@@ -1,5 +1,8 @@
 #pragma once
 #include "Scene.h"
+#include "BarnesHut.h"
+#include "BodyStore.h"
+#include <optional>
 #include <vector>
 #include <unordered_map>
 
@@ -13,9 +16,9 @@ using namespace physx;
 
 class Renderer;
 
+// Everything needed to create a dynamic body; the live state is kept in the BodyStore
 struct PhysicsBodyData {
     float mass = 0.0f;
-    PxRigidDynamic* actor = nullptr;
     glm::vec3 position = glm::vec3(0.0f);
     glm::quat rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
     glm::vec3 scale = glm::vec3(1.0f);
@@ -34,6 +37,34 @@ struct BlackHoleBodyData {
     glm::vec3 initialVelocity = glm::vec3(0.0f);
 };
 
+// Integrators for N-body gravity, in the order of the Physics.Integrator enum
+enum class GravityIntegrator {
+    SymplecticEuler = 0,
+    Leapfrog = 1,   // Kick-drift-kick velocity Verlet, one force evaluation per step
+    Yoshida4 = 2    // Fourth order composition of three leapfrog steps, three force evaluations
+};
+
+// Per-step gravity scratch for the bodies in a BodyStore, indexed like its columns
+struct GravitySnapshot {
+    std::vector<float> mu;                          // G * m
+    std::vector<float> ax, ay, az;
+    std::vector<float> startX, startY, startZ;      // Positions at the start of the step
+
+    void Resize(size_t count) {
+        for (auto* v : {&mu, &ax, &ay, &az, &startX, &startY, &startZ}) {
+            v->resize(count);
+        }
+    }
+};
+
+// Body poses after the last completed step, what Apply() publishes to the scene while PhysX may already
+// be simulating the next step into the actors
+struct PublishedPoses {
+    std::vector<glm::vec3> positions;
+    std::vector<glm::quat> rotations;
+    std::vector<size_t> sceneIndices;
+};
+
 class Physics : public PxSimulationEventCallback {
 public:
     void Init();
@@ -42,6 +73,11 @@ public:
 
     void SetScene(Scene* scene);
     void Apply();
+
+    // Body state for simulation checkpoints. WriteState() settles a step still in flight; ReadState()
+    // rebuilds the bodies of a scene that was restored from the same checkpoint.
+    void WriteState(SnapshotWriter& writer);
+    void ReadState(SnapshotReader& reader, Scene* scene);
     void SetRenderer(Renderer* renderer) { m_Renderer = renderer; }
 
     void onConstraintBreak(PxConstraintInfo* constraints, PxU32 count) override {}
@@ -51,6 +87,8 @@ public:
     void onTrigger(PxTriggerPair* pairs, PxU32 count) override {}
     void onAdvance(const PxRigidBody*const* bodyBuffer, const PxTransform* poseBuffer, const PxU32 count) override {}
 
+    const BodyStore& GetBodies() const { return m_Bodies; }
+
     const PxRenderBuffer* GetDebugRenderBuffer() const;
     void SetVisualizationParameter(PxVisualizationParameter::Enum param, float value);
     void SetVisualizationScale(float scale);
@@ -71,15 +109,36 @@ private:
     PxCooking* m_Cooking = nullptr;
     Renderer* m_Renderer = nullptr;
 
-    std::vector<PhysicsBodyData> m_Bodies;
+    BodyStore m_Bodies;
     std::vector<BlackHoleBodyData> m_BlackHoles;
     std::unordered_map<std::string, PxConvexMesh*> m_MeshCache;
     Scene* m_CurrentScene = nullptr;
-    std::vector<size_t> m_BodiesToDelete;
+    std::vector<BodyHandle> m_BodiesToDelete;
+    GravitySnapshot m_GravitySnapshot;
+    BarnesHutTree m_GravityTree;
+    float m_TimeAccumulator = 0.0f;
+    bool m_AccelerationsValid = false;  // Leapfrog reuses the closing kick's accelerations
+    PublishedPoses m_PublishedPoses;
+
+    // Step between simulate() and fetchResults(); outlives Update() with Physics.AsyncSimulation
+    struct {
+        bool running = false;
+        bool gravity = false;
+        float dt = 0.0f;
+        Scene* scene = nullptr;
+    } m_InFlight;
 
-    void CreatePhysicsBody(PhysicsBodyData& data);
+    static std::optional<PhysicsBodyData> BodyDataFor(const SceneObject& obj, size_t sceneIndex);
+    void CreatePhysicsBody(const PhysicsBodyData& data);
     void CreateBlackHoleBody(BlackHoleBodyData& data);
-    void ApplyGravitationalForces(float dt, Scene* scene) const;
+    void BeginStep(float dt, GravityIntegrator integrator, float openingAngle, Scene* scene);
+    void FinishStep();
+    void DiscardStep();
+    void CapturePoses();
+    void GatherGravitySnapshot();
+    void ReleaseBodies();
+    void ComputeGravity(float theta);
+    void IntegrateGravity(float dt, GravityIntegrator integrator, float theta);
     void UpdatePhysicsBodies();
     void ProcessDeletedBodies();
     PxConvexMesh* LoadConvexMesh(const std::string& path);
@@ -1,32 +1,256 @@
 #include "Scene.h"
 
+#include <algorithm>
 #include <filesystem>
 #include <fstream>
 #include <yaml-cpp/yaml.h>
 #include <nfd.h>
 #include <spdlog/spdlog.h>
 #include <limits>
+#include <bit>
 #include <cmath>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
 
 #include "Application/Application.h"
+#include "Application/Parameters.h"
 #include "Simulation.h"
+#include "Snapshot.h"
+#include "Renderer/Camera.h"
+
+namespace {
+    // Handles behind each HotField, in enum order
+    constexpr std::array<ParameterHandle, static_cast<size_t>(HotField::Count)> HOT_FIELD_HANDLES = {
+        Field::Entity::Name,
+        Field::Entity::Position,
+        Field::Entity::Rotation,
+        Field::Entity::Scale,
+        Field::Physics::Velocity,
+        Field::Physics::Mass,
+        Field::Sphere::Radius,
+    };
+
+    ComponentKind ComponentKindOf(const ParameterMetadata& meta) {
+        switch (meta.type) {
+            case ParameterType::Bool: return ComponentKind::Bool;
+            case ParameterType::Int: return ComponentKind::Int;
+            case ParameterType::Float: return ComponentKind::Float;
+            case ParameterType::String: return ComponentKind::String;
+            case ParameterType::Vec3: return ComponentKind::Vec3;
+            case ParameterType::Quat: return ComponentKind::Quat;
+            case ParameterType::StringVector: return ComponentKind::StringVector;
+            default: return static_cast<ComponentKind>(meta.defaultValue.index());
+        }
+    }
+
+    // Appends a slot for the value to the row and returns its index
+    uint32_t Append(ComponentRow& columns, const ComponentKind kind, const ParameterValue& value) {
+        const auto push = [&]<typename T>(std::vector<T>& column) {
+            const T* typed = std::get_if<T>(&value);
+            column.push_back(typed ? *typed : T{});
+            return static_cast<uint32_t>(column.size() - 1);
+        };
+
+        switch (kind) {
+            case ComponentKind::Bool: {
+                const bool* typed = std::get_if<bool>(&value);
+                columns.bools.push_back(typed && *typed);
+                return static_cast<uint32_t>(columns.bools.size() - 1);
+            }
+            case ComponentKind::Int: return push(columns.ints);
+            case ComponentKind::Float: return push(columns.floats);
+            case ComponentKind::String: return push(columns.strings);
+            case ComponentKind::Vec3: return push(columns.vec3s);
+            case ComponentKind::Quat: return push(columns.quats);
+            case ComponentKind::StringVector: return push(columns.stringVectors);
+        }
+        return ComponentField::INVALID;
+    }
+
+    bool IsDefault(const ParameterValue& value, const ParameterValue& defaultValue) {
+        if (value.index() != defaultValue.index()) return false;
+        if (const float* f = std::get_if<float>(&value)) {
+            return std::abs(*f - std::get<float>(defaultValue)) < 0.0001f;
+        }
+        if (const glm::vec3* v = std::get_if<glm::vec3>(&value)) {
+            return glm::length(*v - std::get<glm::vec3>(defaultValue)) < 0.0001f;
+        }
+        return value == defaultValue;
+    }
+
+    // Calls f with a std::type_identity of every component storage type
+    template<typename F>
+    void ForEachComponentType(F&& f) {
+        f(std::type_identity<uint8_t>{});
+        f(std::type_identity<int>{});
+        f(std::type_identity<float>{});
+        f(std::type_identity<std::string>{});
+        f(std::type_identity<glm::vec3>{});
+        f(std::type_identity<glm::quat>{});
+        f(std::type_identity<std::vector<std::string>>{});
+    }
+}
+
+namespace {
+    // Class names indexed by id; there are only a handful, so a linear search beats hashing
+    struct ObjectClassTable {
+        std::mutex mutex;
+        std::vector<std::string> names;
+
+        ObjectClassId Find(const std::string_view name) const {
+            for (size_t i = 0; i < names.size(); i++) {
+                if (names[i] == name) return static_cast<ObjectClassId>(i);
+            }
+            return INVALID_OBJECT_CLASS;
+        }
+    };
+
+    ObjectClassTable& ClassTable() {
+        static ObjectClassTable table;
+        return table;
+    }
+}
 
-SceneObject::SceneObject() = default;
+ObjectClassId InternObjectClass(const std::string_view name) {
+    auto& table = ClassTable();
+    std::lock_guard lock(table.mutex);
+    if (const ObjectClassId id = table.Find(name); id != INVALID_OBJECT_CLASS) return id;
 
-SceneObject::SceneObject(const std::vector<std::string>& classNames) {
+    if (table.names.size() >= MAX_OBJECT_CLASSES) {
+        spdlog::error("SceneObject: More than {} object classes, '{}' cannot be indexed", MAX_OBJECT_CLASSES, name);
+        return INVALID_OBJECT_CLASS;
+    }
+    table.names.emplace_back(name);
+    return static_cast<ObjectClassId>(table.names.size() - 1);
+}
+
+ObjectClassId FindObjectClass(const std::string_view name) {
+    auto& table = ClassTable();
+    std::lock_guard lock(table.mutex);
+    return table.Find(name);
+}
+
+const ObjectArchetype* ObjectArchetype::Intern(const std::vector<ObjectClass*>& classes) {
+    // Archetypes are never freed, objects keep raw pointers to them
+    static std::mutex mutex;
+    static std::vector<std::unique_ptr<ObjectArchetype>> archetypes;
+
+    std::lock_guard lock(mutex);
+    for (const auto& archetype : archetypes) {
+        if (archetype->classes == classes) return archetype.get();
+    }
+
+    auto archetype = std::make_unique<ObjectArchetype>();
+    archetype->classes = classes;
+    for (const auto* objClass : classes) {
+        if (const ObjectClassId id = InternObjectClass(objClass->name); id != INVALID_OBJECT_CLASS) {
+            archetype->classMask |= ObjectClassMask{1} << id;
+        }
+        for (const auto& [id, metadata] : objClass->meta) {
+            if (archetype->meta.contains(id)) continue;
+            archetype->meta[id] = metadata;
+
+            const ComponentKind kind = ComponentKindOf(metadata);
+            archetype->fields[id] = {kind, Append(archetype->defaults, kind, metadata.defaultValue)};
+        }
+    }
+    for (size_t i = 0; i < HOT_FIELD_HANDLES.size(); i++) {
+        archetype->hot[i] = archetype->FieldOf(HOT_FIELD_HANDLES[i]);
+    }
+
+    archetypes.push_back(std::move(archetype));
+    return archetypes.back().get();
+}
+
+ArchetypeTable::ArchetypeTable(const ObjectArchetype* archetype) : m_Archetype(archetype) {
+    ForEachComponentType([&]<typename T>(std::type_identity<T>) {
+        m_Columns.Of<T>().resize(archetype->defaults.Of<T>().size());
+    });
+}
+
+uint32_t ArchetypeTable::AddRow(const ComponentRow& values) {
+    ForEachComponentType([&]<typename T>(std::type_identity<T>) {
+        auto& columns = m_Columns.Of<T>();
+        const auto& row = values.Of<T>();
+        for (size_t i = 0; i < columns.size(); i++) {
+            columns[i].push_back(row[i]);
+        }
+    });
+    return m_RowCount++;
+}
+
+ComponentRow ArchetypeTable::GetRow(const uint32_t row) const {
+    ComponentRow values;
+    ForEachComponentType([&]<typename T>(std::type_identity<T>) {
+        const auto& columns = m_Columns.Of<T>();
+        auto& out = values.Of<T>();
+        out.reserve(columns.size());
+        for (const auto& column : columns) {
+            out.push_back(column[row]);
+        }
+    });
+    return values;
+}
+
+void ArchetypeTable::MoveRow(const uint32_t from, const uint32_t to) {
+    if (from == to) return;
+    ForEachComponentType([&]<typename T>(std::type_identity<T>) {
+        for (auto& column : m_Columns.Of<T>()) {
+            column[to] = std::move(column[from]);
+        }
+    });
+}
+
+void ArchetypeTable::Truncate(const uint32_t count) {
+    if (count >= m_RowCount) return;
+    ForEachComponentType([&]<typename T>(std::type_identity<T>) {
+        for (auto& column : m_Columns.Of<T>()) {
+            column.resize(count);
+        }
+    });
+    m_RowCount = count;
+}
+
+SceneObject::SceneObject() {
+    const ObjectArchetype* archetype = ObjectArchetype::Intern({});
+    SetOwnRow(archetype, archetype->defaults);
+}
+
+SceneObject::SceneObject(const std::vector<std::string>& classNames) : SceneObject() {
     for (const auto& className : classNames) {
         AddClass(className);
     }
 }
 
+SceneObject::SceneObject(const SceneObject& other) : m_Version(other.m_Version) {
+    SetOwnRow(other.m_Archetype, other.m_Table->GetRow(other.m_Row));
+}
+
+SceneObject& SceneObject::operator=(const SceneObject& other) {
+    if (this != &other) {
+        SetOwnRow(other.m_Archetype, other.m_Table->GetRow(other.m_Row));
+        m_Version = other.m_Version;
+    }
+    return *this;
+}
+
+void SceneObject::SetOwnRow(const ObjectArchetype* archetype, const ComponentRow& values) {
+    m_OwnTable = std::make_unique<ArchetypeTable>(archetype);
+    m_Table = m_OwnTable.get();
+    m_Row = m_Table->AddRow(values);
+    m_Archetype = archetype;
+}
+
 void SceneObject::AddClass(const std::string& className) {
     auto& simulation = Application::Instance().GetSimulation();
     const auto& objectClasses = simulation.GetObjectClasses();
 
     for (auto& objClass : objectClasses) {
         if (objClass.name == className) {
-            m_Classes.push_back(const_cast<ObjectClass*>(&objClass));
-            RebuildMetadata();
+            auto classes = m_Archetype->classes;
+            classes.push_back(const_cast<ObjectClass*>(&objClass));
+            SetArchetype(ObjectArchetype::Intern(classes));
             return;
         }
     }
@@ -34,38 +258,87 @@ void SceneObject::AddClass(const std::string& className) {
     spdlog::warn("SceneObject: Unknown class '{}'", className);
 }
 
-bool SceneObject::HasClass(const std::string& className) const {
-    for (const auto* objClass : m_Classes) {
-        if (objClass->name == className) {
-            return true;
-        }
+void SceneObject::SetArchetype(const ObjectArchetype* archetype) {
+    // The object moves to a table of its own with the new layout, starting from its defaults and
+    // carrying over every value the old layout also has
+    const ObjectArchetype* previous = m_Archetype;
+    const ComponentRow previousValues = m_Table->GetRow(m_Row);
+
+    SetOwnRow(archetype, archetype->defaults);
+    m_Version++;
+
+    for (const auto& [id, field] : previous->fields) {
+        const auto it = archetype->fields.find(id);
+        if (it == archetype->fields.end() || it->second.kind != field.kind) continue;
+
+        StoreValue(it->second, ValueAt(previousValues, field));
     }
-    return false;
 }
 
-void SceneObject::RebuildMetadata() {
-    m_AggregatedMeta.clear();
+ParameterValue SceneObject::ValueAt(const ComponentField field) const {
+    switch (field.kind) {
+        case ComponentKind::Bool: return m_Table->Column<uint8_t>(field)[m_Row] != 0;
+        case ComponentKind::Int: return m_Table->Column<int>(field)[m_Row];
+        case ComponentKind::Float: return m_Table->Column<float>(field)[m_Row];
+        case ComponentKind::String: return m_Table->Column<std::string>(field)[m_Row];
+        case ComponentKind::Vec3: return m_Table->Column<glm::vec3>(field)[m_Row];
+        case ComponentKind::Quat: return m_Table->Column<glm::quat>(field)[m_Row];
+        case ComponentKind::StringVector: return m_Table->Column<std::vector<std::string>>(field)[m_Row];
+    }
+    return 0.0f;
+}
 
-    for (const auto* objClass : m_Classes) {
-        for (const auto& [id, metadata] : objClass->meta) {
-            if (!m_AggregatedMeta.contains(id)) {
-                m_AggregatedMeta[id] = metadata;
+ParameterValue SceneObject::ValueAt(const ComponentRow& values, const ComponentField field) {
+    switch (field.kind) {
+        case ComponentKind::Bool: return values.bools[field.index] != 0;
+        case ComponentKind::Int: return values.ints[field.index];
+        case ComponentKind::Float: return values.floats[field.index];
+        case ComponentKind::String: return values.strings[field.index];
+        case ComponentKind::Vec3: return values.vec3s[field.index];
+        case ComponentKind::Quat: return values.quats[field.index];
+        case ComponentKind::StringVector: return values.stringVectors[field.index];
+    }
+    return 0.0f;
+}
+
+bool SceneObject::StoreValue(const ComponentField field, const ParameterValue& value) {
+    if (static_cast<ComponentKind>(value.index()) != field.kind) return false;
+
+    const auto store = [&]<typename T>(std::type_identity<T>) {
+        T& slot = m_Table->Column<T>(field)[m_Row];
+        const T& typed = std::get<T>(value);
+        if (slot == typed) return;
+        slot = typed;
+        m_Version++;
+    };
+
+    switch (field.kind) {
+        case ComponentKind::Bool: {
+            uint8_t& slot = m_Table->Column<uint8_t>(field)[m_Row];
+            const uint8_t typed = std::get<bool>(value) ? 1 : 0;
+            if (slot != typed) {
+                slot = typed;
+                m_Version++;
             }
+            break;
         }
+        case ComponentKind::Int: store(std::type_identity<int>{}); break;
+        case ComponentKind::Float: store(std::type_identity<float>{}); break;
+        case ComponentKind::String: store(std::type_identity<std::string>{}); break;
+        case ComponentKind::Vec3: store(std::type_identity<glm::vec3>{}); break;
+        case ComponentKind::Quat: store(std::type_identity<glm::quat>{}); break;
+        case ComponentKind::StringVector: store(std::type_identity<std::vector<std::string>>{}); break;
     }
+    return true;
 }
 
 bool SceneObject::HasParameter(const ParameterHandle& handle) const {
-    return m_AggregatedMeta.contains(handle.m_Id);
+    return m_Archetype->fields.contains(handle.m_Id);
 }
 
 ParameterValue SceneObject::GetParameter(const ParameterHandle& handle) const {
-    if (auto it = m_Parameters.find(handle.m_Id); it != m_Parameters.end()) {
-        return it->second;
-    }
-
-    if (auto metaIt = m_AggregatedMeta.find(handle.m_Id); metaIt != m_AggregatedMeta.end()) {
-        return metaIt->second.defaultValue;
+    if (const ComponentField field = m_Archetype->FieldOf(handle); field.IsValid()) {
+        return ValueAt(field);
     }
 
     spdlog::warn("SceneObject::GetParameter: Parameter '{}' not available in this object's classes", handle.m_Id);
@@ -73,84 +346,40 @@ ParameterValue SceneObject::GetParameter(const ParameterHandle& handle) const {
 }
 
 void SceneObject::SetParameter(const ParameterHandle& handle, const ParameterValue& value) {
-    if (!HasParameter(handle)) {
+    const ComponentField field = m_Archetype->FieldOf(handle);
+    if (!field.IsValid()) {
         spdlog::warn("SceneObject::SetParameter: Parameter '{}' not available in this object's classes", handle.m_Id);
         return;
     }
 
-    m_Parameters[handle.m_Id] = value;
+    if (!StoreValue(field, value)) {
+        spdlog::warn("SceneObject::SetParameter: Parameter '{}' has a different type, ignoring value", handle.m_Id);
+    }
 }
 
 void SceneObject::SerializeToYAML(YAML::Emitter& out) const {
     out << YAML::BeginMap;
 
     out << YAML::Key << "classes" << YAML::Value << YAML::BeginSeq;
-    for (const auto* objClass : m_Classes) {
+    for (const auto* objClass : m_Archetype->classes) {
         out << objClass->name;
     }
     out << YAML::EndSeq;
 
-    bool hasNonDefaultParams = false;
-    for (const auto& [id, value] : m_Parameters) {
-        auto metaIt = m_AggregatedMeta.find(id);
-        if (metaIt == m_AggregatedMeta.end()) {
-            continue;
-        }
-
-        const auto& meta = metaIt->second;
-
-        bool isDefault = false;
-        if (std::holds_alternative<bool>(value) && std::holds_alternative<bool>(meta.defaultValue)) {
-            isDefault = std::get<bool>(value) == std::get<bool>(meta.defaultValue);
-        } else if (std::holds_alternative<int>(value) && std::holds_alternative<int>(meta.defaultValue)) {
-            isDefault = std::get<int>(value) == std::get<int>(meta.defaultValue);
-        } else if (std::holds_alternative<float>(value) && std::holds_alternative<float>(meta.defaultValue)) {
-            isDefault = std::abs(std::get<float>(value) - std::get<float>(meta.defaultValue)) < 0.0001f;
-        } else if (std::holds_alternative<std::string>(value) && std::holds_alternative<std::string>(meta.defaultValue)) {
-            isDefault = std::get<std::string>(value) == std::get<std::string>(meta.defaultValue);
-        } else if (std::holds_alternative<glm::vec3>(value) && std::holds_alternative<glm::vec3>(meta.defaultValue)) {
-            auto v1 = std::get<glm::vec3>(value);
-            auto v2 = std::get<glm::vec3>(meta.defaultValue);
-            isDefault = glm::length(v1 - v2) < 0.0001f;
-        }
-
-        if (!isDefault) {
-            hasNonDefaultParams = true;
-            break;
+    std::vector<std::pair<const ParameterMetadata*, ParameterValue>> nonDefault;
+    for (const auto& [id, field] : m_Archetype->fields) {
+        const auto& meta = m_Archetype->meta.at(id);
+        ParameterValue value = ValueAt(field);
+        if (!IsDefault(value, meta.defaultValue)) {
+            nonDefault.emplace_back(&meta, std::move(value));
         }
     }
 
-    if (hasNonDefaultParams) {
+    if (!nonDefault.empty()) {
         out << YAML::Key << "parameters" << YAML::Value << YAML::BeginMap;
 
-        for (const auto& [id, value] : m_Parameters) {
-            auto metaIt = m_AggregatedMeta.find(id);
-            if (metaIt == m_AggregatedMeta.end()) {
-                continue;
-            }
-
-            const auto& meta = metaIt->second;
-
-            bool isDefault = false;
-            if (std::holds_alternative<bool>(value) && std::holds_alternative<bool>(meta.defaultValue)) {
-                isDefault = std::get<bool>(value) == std::get<bool>(meta.defaultValue);
-            } else if (std::holds_alternative<int>(value) && std::holds_alternative<int>(meta.defaultValue)) {
-                isDefault = std::get<int>(value) == std::get<int>(meta.defaultValue);
-            } else if (std::holds_alternative<float>(value) && std::holds_alternative<float>(meta.defaultValue)) {
-                isDefault = std::abs(std::get<float>(value) - std::get<float>(meta.defaultValue)) < 0.0001f;
-            } else if (std::holds_alternative<std::string>(value) && std::holds_alternative<std::string>(meta.defaultValue)) {
-                isDefault = std::get<std::string>(value) == std::get<std::string>(meta.defaultValue);
-            } else if (std::holds_alternative<glm::vec3>(value) && std::holds_alternative<glm::vec3>(meta.defaultValue)) {
-                auto v1 = std::get<glm::vec3>(value);
-                auto v2 = std::get<glm::vec3>(meta.defaultValue);
-                isDefault = glm::length(v1 - v2) < 0.0001f;
-            }
-
-            if (isDefault) {
-                continue;
-            }
-
-            out << YAML::Key << meta.name << YAML::Value;
+        for (const auto& [meta, value] : nonDefault) {
+            out << YAML::Key << meta->name << YAML::Value;
 
             if (std::holds_alternative<bool>(value)) {
                 out << std::get<bool>(value);
@@ -163,6 +392,9 @@ void SceneObject::SerializeToYAML(YAML::Emitter& out) const {
             } else if (std::holds_alternative<glm::vec3>(value)) {
                 auto v = std::get<glm::vec3>(value);
                 out << YAML::Flow << YAML::BeginSeq << v.x << v.y << v.z << YAML::EndSeq;
+            } else if (std::holds_alternative<glm::quat>(value)) {
+                auto q = std::get<glm::quat>(value);
+                out << YAML::Flow << YAML::BeginSeq << q.w << q.x << q.y << q.z << YAML::EndSeq;
             } else if (std::holds_alternative<std::vector<std::string>>(value)) {
                 auto vec = std::get<std::vector<std::string>>(value);
                 out << YAML::BeginSeq;
@@ -180,8 +412,7 @@ void SceneObject::SerializeToYAML(YAML::Emitter& out) const {
 }
 
 void SceneObject::DeserializeFromYAML(const YAML::Node& node) {
-    m_Classes.clear();
-    m_Parameters.clear();
+    SetArchetype(ObjectArchetype::Intern({}));
 
     if (node["classes"]) {
         for (const auto& classNode : node["classes"]) {
@@ -194,17 +425,19 @@ void SceneObject::DeserializeFromYAML(const YAML::Node& node) {
             std::string paramName = param.first.as<std::string>();
             ParameterHandle handle(paramName.c_str());
 
-            auto metaIt = m_AggregatedMeta.find(handle.m_Id);
-            if (metaIt == m_AggregatedMeta.end()) {
+            const ComponentField field = m_Archetype->FieldOf(handle);
+            if (!field.IsValid()) {
                 spdlog::warn("SceneObject: Parameter '{}' not available in object's classes, skipping", paramName);
                 continue;
             }
 
-            const auto& meta = metaIt->second;
+            const auto& meta = m_Archetype->meta.at(handle.m_Id);
 
             try {
                 ParameterValue value = ParameterRegistry::ParseValueNode(param.second, meta.type);
-                m_Parameters[handle.m_Id] = value;
+                if (!StoreValue(field, value)) {
+                    spdlog::warn("SceneObject: Parameter '{}' has an unexpected type, skipping", paramName);
+                }
             } catch (const std::exception& e) {
                 spdlog::warn("SceneObject: Failed to parse parameter '{}': {}", paramName, e.what());
             }
@@ -212,6 +445,233 @@ void SceneObject::DeserializeFromYAML(const YAML::Node& node) {
     }
 }
 
+Scene::Scene(const Scene& other) {
+    *this = other;
+}
+
+Scene& Scene::operator=(const Scene& other) {
+    if (this == &other) return *this;
+
+    name = other.name;
+    currentPath = other.currentPath;
+    camera = other.camera;
+    reloadSkybox = other.reloadSkybox;
+    selectedObject = other.selectedObject;
+
+    ClearObjects();
+    objects.reserve(other.objects.size());
+    for (const auto& object : other.objects) {
+        AddObject(object);
+    }
+    return *this;
+}
+
+ArchetypeTable& Scene::TableFor(const ObjectArchetype* archetype) {
+    // A scene uses a handful of layouts, a linear search is enough
+    for (const auto& table : m_Tables) {
+        if (table->GetArchetype() == archetype) return *table;
+    }
+    return *m_Tables.emplace_back(std::make_unique<ArchetypeTable>(archetype));
+}
+
+void Scene::AddObject(SceneObject object) {
+    const auto index = static_cast<uint32_t>(objects.size());
+    for (ObjectClassMask mask = object.GetClassMask(); mask != 0; mask &= mask - 1) {
+        m_ClassIndices[std::countr_zero(mask)].push_back(index);
+    }
+
+    ArchetypeTable& table = TableFor(object.m_Archetype);
+    const uint32_t row = table.AddRow(object.m_Table->GetRow(object.m_Row));
+    object.m_Table = &table;
+    object.m_Row = row;
+    object.m_OwnTable.reset();
+    objects.push_back(std::move(object));
+}
+
+void Scene::RemoveObject(const size_t index) {
+    if (index >= objects.size()) return;
+    std::vector<bool> remove(objects.size(), false);
+    remove[index] = true;
+    RemoveObjects(remove);
+}
+
+std::vector<size_t> Scene::RemoveObjects(const std::vector<bool>& remove) {
+    std::vector<size_t> remap(objects.size(), REMOVED_OBJECT);
+    size_t kept = 0;
+    for (size_t i = 0; i < objects.size(); ++i) {
+        if (i < remove.size() && remove[i]) continue;
+        if (kept != i) {
+            objects[kept] = std::move(objects[i]);
+        }
+        remap[i] = kept++;
+    }
+    objects.erase(objects.begin() + static_cast<std::ptrdiff_t>(kept), objects.end());
+
+    // Rows were appended in scene order, so the kept rows of each table move front to back as well
+    std::unordered_map<const ArchetypeTable*, uint32_t> rowCounts;
+    for (const auto& table : m_Tables) {
+        rowCounts[table.get()] = 0;
+    }
+    for (auto& object : objects) {
+        const auto it = rowCounts.find(object.m_Table);
+        if (it == rowCounts.end()) continue;
+
+        const uint32_t row = it->second++;
+        object.m_Table->MoveRow(object.m_Row, row);
+        object.m_Row = row;
+    }
+    for (const auto& table : m_Tables) {
+        table->Truncate(rowCounts[table.get()]);
+    }
+
+    // Removal keeps the order, so every list stays sorted after remapping in place
+    for (auto& indices : m_ClassIndices) {
+        size_t out = 0;
+        for (const uint32_t index : indices) {
+            if (remap[index] != REMOVED_OBJECT) {
+                indices[out++] = static_cast<uint32_t>(remap[index]);
+            }
+        }
+        indices.resize(out);
+    }
+    return remap;
+}
+
+void Scene::ClearObjects() {
+    objects.clear();
+    m_Tables.clear();
+    for (auto& indices : m_ClassIndices) {
+        indices.clear();
+    }
+}
+
+void SceneObject::WriteSnapshot(SnapshotWriter& writer) const {
+    const ComponentRow values = m_Table->GetRow(m_Row);
+    writer.Write(m_Version);
+    writer.WriteArray(values.bools);
+    writer.WriteArray(values.ints);
+    writer.WriteArray(values.floats);
+    writer.WriteStrings(values.strings);
+    writer.WriteArray(values.vec3s);
+    writer.WriteArray(values.quats);
+    writer.Write(static_cast<uint32_t>(values.stringVectors.size()));
+    for (const auto& strings : values.stringVectors) {
+        writer.WriteStrings(strings);
+    }
+}
+
+void SceneObject::ReadSnapshot(SnapshotReader& reader, const ObjectArchetype* archetype) {
+    const auto version = reader.Read<uint64_t>();
+    ComponentRow values;
+    reader.ReadArray(values.bools);
+    reader.ReadArray(values.ints);
+    reader.ReadArray(values.floats);
+    reader.ReadStrings(values.strings);
+    reader.ReadArray(values.vec3s);
+    reader.ReadArray(values.quats);
+    values.stringVectors.resize(reader.Read<uint32_t>());
+    for (auto& strings : values.stringVectors) {
+        reader.ReadStrings(strings);
+    }
+
+    bool matchesLayout = true;
+    ForEachComponentType([&]<typename T>(std::type_identity<T>) {
+        matchesLayout = matchesLayout && values.Of<T>().size() == archetype->defaults.Of<T>().size();
+    });
+    if (!matchesLayout) {
+        throw std::runtime_error("Corrupt simulation snapshot");
+    }
+
+    SetOwnRow(archetype, values);
+    m_Version = version;
+}
+
+void Scene::WriteSnapshot(SnapshotWriter& writer) const {
+    // Archetype table first, objects refer to it by index
+    std::vector<const ObjectArchetype*> archetypes;
+    std::unordered_map<const ObjectArchetype*, uint32_t> archetypeIndices;
+    std::vector<uint32_t> objectArchetypes;
+    objectArchetypes.reserve(objects.size());
+    for (const auto& obj : objects) {
+        const auto [it, inserted] = archetypeIndices.try_emplace(obj.GetArchetype(), static_cast<uint32_t>(archetypes.size()));
+        if (inserted) {
+            archetypes.push_back(obj.GetArchetype());
+        }
+        objectArchetypes.push_back(it->second);
+    }
+
+    writer.Write(static_cast<uint32_t>(archetypes.size()));
+    for (const ObjectArchetype* archetype : archetypes) {
+        writer.Write(static_cast<uint32_t>(archetype->classes.size()));
+        for (const ObjectClass* objectClass : archetype->classes) {
+            writer.WriteString(objectClass->name);
+        }
+    }
+
+    writer.WriteArray(objectArchetypes);
+    for (const auto& obj : objects) {
+        obj.WriteSnapshot(writer);
+    }
+
+    // Camera setter nodes animate the camera, so its pose is simulated state as well
+    writer.Write(static_cast<uint8_t>(camera != nullptr));
+    if (camera) {
+        writer.Write(camera->GetPosition());
+        writer.Write(camera->GetYaw());
+        writer.Write(camera->GetPitch());
+        writer.Write(camera->GetFov());
+    }
+}
+
+void Scene::ReadSnapshot(SnapshotReader& reader) {
+    const auto& objectClasses = Application::Instance().GetSimulation().GetObjectClasses();
+
+    std::vector<const ObjectArchetype*> archetypes(reader.Read<uint32_t>());
+    for (auto& archetype : archetypes) {
+        std::vector<ObjectClass*> classes(reader.Read<uint32_t>());
+        for (auto& objectClass : classes) {
+            const std::string className = reader.ReadString();
+            const auto it = std::find_if(objectClasses.begin(), objectClasses.end(),
+                                         [&](const ObjectClass& c) { return c.name == className; });
+            if (it == objectClasses.end()) {
+                throw std::runtime_error("Snapshot refers to unknown object class '" + className + "'");
+            }
+            objectClass = const_cast<ObjectClass*>(&*it);
+        }
+        archetype = ObjectArchetype::Intern(classes);
+    }
+
+    std::vector<uint32_t> objectArchetypes;
+    reader.ReadArray(objectArchetypes);
+
+    ClearObjects();
+    objects.reserve(objectArchetypes.size());
+    for (const uint32_t archetypeIndex : objectArchetypes) {
+        if (archetypeIndex >= archetypes.size()) {
+            throw std::runtime_error("Corrupt simulation snapshot");
+        }
+        SceneObject object;
+        object.ReadSnapshot(reader, archetypes[archetypeIndex]);
+        AddObject(std::move(object));
+    }
+
+    if (reader.Read<uint8_t>() != 0) {
+        const auto position = reader.Read<glm::vec3>();
+        const auto yaw = reader.Read<float>();
+        const auto pitch = reader.Read<float>();
+        const auto fov = reader.Read<float>();
+        if (camera) {
+            camera->SetPosition(position);
+            camera->SetYawPitch(yaw, pitch);
+            camera->SetFov(fov);
+        }
+    }
+
+    if (selectedObject && selectedObject->index >= objects.size()) {
+        ClearSelection();
+    }
+}
+
 void Scene::Serialize(const std::filesystem::path &path) {
     currentPath = path;
     YAML::Emitter out;
@@ -238,7 +698,7 @@ void Scene::Deserialize(const std::filesystem::path &path, bool setCurrentPath)
         currentPath = path;
     }
 
-    objects.clear();
+    ClearObjects();
 
     YAML::Node root = YAML::LoadFile(path.string());
 
@@ -252,7 +712,7 @@ void Scene::Deserialize(const std::filesystem::path &path, bool setCurrentPath)
         for (const auto &objNode: root["objects"]) {
             SceneObject obj;
             obj.DeserializeFromYAML(objNode);
-            objects.push_back(std::move(obj));
+            AddObject(std::move(obj));
         }
         spdlog::info("Loaded {} dynamic objects from scene", objects.size());
     }
@@ -1,16 +1,41 @@
 #pragma once
+#include <array>
 #include <vector>
 #include <filesystem>
 #include <glm/vec3.hpp>
 #include <glm/mat4x4.hpp>
 #include <glm/gtc/quaternion.hpp>
+#include <memory>
 #include <string>
+#include <string_view>
 #include <optional>
+#include <type_traits>
 #include <unordered_map>
 #include "Application/AnimationGraph.h"
 #include "Application/ParameterRegistry.h"
 
 class Camera;
+class SnapshotWriter;
+class SnapshotReader;
+
+// Small integer id of an object class name; ids are handed out on first use and never change
+using ObjectClassId = uint8_t;
+using ObjectClassMask = uint64_t;
+
+inline constexpr size_t MAX_OBJECT_CLASSES = 64;
+inline constexpr ObjectClassId INVALID_OBJECT_CLASS = 0xFF;
+
+// Returns the id of a class name, assigning the next free one to names not seen before
+ObjectClassId InternObjectClass(std::string_view name);
+// Returns the id of a class name, or INVALID_OBJECT_CLASS when no object ever used it
+ObjectClassId FindObjectClass(std::string_view name);
+
+// Classes the engine itself iterates every frame
+namespace ObjectClasses {
+    inline const ObjectClassId BlackHole = InternObjectClass("BlackHole");
+    inline const ObjectClassId Mesh = InternObjectClass("Mesh");
+    inline const ObjectClassId Sphere = InternObjectClass("Sphere");
+}
 
 struct ObjectClass {
     std::string name;
@@ -25,38 +50,222 @@ struct SceneObjectDefinition {
     std::unordered_map<uint64_t, ParameterMetadata> meta;
 };
 
+// Column a parameter is stored in; same order as the ParameterValue alternatives
+enum class ComponentKind : uint8_t { Bool, Int, Float, String, Vec3, Quat, StringVector };
+
+// Parameters read every frame by physics and renderers, resolved once per archetype
+enum class HotField : uint8_t { Name, Position, Rotation, Scale, Velocity, Mass, Radius, Count };
+
+// Location of a parameter inside an archetype's layout: its kind and its slot among the parameters of that kind
+struct ComponentField {
+    static constexpr uint32_t INVALID = 0xFFFFFFFFu;
+
+    ComponentKind kind = ComponentKind::Bool;
+    uint32_t index = INVALID;
+
+    bool IsValid() const { return index != INVALID; }
+};
+
+// Per-parameter storage grouped by type, indexed by ComponentField::index; bools are stored as bytes
+template<template<typename> typename Slot>
+struct ComponentStorage {
+    std::vector<Slot<uint8_t>> bools;
+    std::vector<Slot<int>> ints;
+    std::vector<Slot<float>> floats;
+    std::vector<Slot<std::string>> strings;
+    std::vector<Slot<glm::vec3>> vec3s;
+    std::vector<Slot<glm::quat>> quats;
+    std::vector<Slot<std::vector<std::string>>> stringVectors;
+
+    template<typename T>
+    auto& Of() {
+        if constexpr (std::is_same_v<T, uint8_t>) return bools;
+        else if constexpr (std::is_same_v<T, int>) return ints;
+        else if constexpr (std::is_same_v<T, float>) return floats;
+        else if constexpr (std::is_same_v<T, std::string>) return strings;
+        else if constexpr (std::is_same_v<T, glm::vec3>) return vec3s;
+        else if constexpr (std::is_same_v<T, glm::quat>) return quats;
+        else if constexpr (std::is_same_v<T, std::vector<std::string>>) return stringVectors;
+        else static_assert(sizeof(T) == 0, "Bools are only reachable through ParameterValue");
+    }
+    template<typename T>
+    const auto& Of() const { return const_cast<ComponentStorage*>(this)->Of<T>(); }
+};
+
+template<typename T>
+using ComponentValue = T;
+template<typename T>
+using ComponentColumn = std::vector<T>;
+
+// One value per parameter: the values of a single object
+using ComponentRow = ComponentStorage<ComponentValue>;
+// One column per parameter, holding the value of every object in an ArchetypeTable
+using ComponentColumns = ComponentStorage<ComponentColumn>;
+
+/**
+ * @brief Parameter layout shared by every scene object with the same list of classes
+ *
+ * Each parameter of the classes gets a slot among the parameters of its type, and the hot fields
+ * are resolved up front. Archetypes are interned and live for the whole program, so tables and
+ * objects only keep a pointer to theirs.
+ */
+struct ObjectArchetype {
+    std::vector<ObjectClass*> classes;
+    ObjectClassMask classMask = 0;
+    std::unordered_map<uint64_t, ParameterMetadata> meta;
+    std::unordered_map<uint64_t, ComponentField> fields;
+    std::array<ComponentField, static_cast<size_t>(HotField::Count)> hot;
+    ComponentRow defaults;
+
+    static const ObjectArchetype* Intern(const std::vector<ObjectClass*>& classes);
+
+    ComponentField FieldOf(const ParameterHandle& handle) const {
+        const auto it = fields.find(handle.m_Id);
+        return it != fields.end() ? it->second : ComponentField{};
+    }
+};
+
+/**
+ * @brief Parameter values of every object that shares one archetype
+ *
+ * Each parameter has a column of its own with one value per row, so reading a field across the
+ * objects of a layout walks contiguous memory. A Scene owns one table per archetype its objects
+ * use and appends rows in scene order; objects outside a scene own a single-row table.
+ */
+class ArchetypeTable {
+public:
+    explicit ArchetypeTable(const ObjectArchetype* archetype);
+
+    const ObjectArchetype* GetArchetype() const { return m_Archetype; }
+    uint32_t GetRowCount() const { return m_RowCount; }
+
+    // Column of one parameter; the caller checks that the field's kind matches T
+    template<typename T>
+    std::vector<T>& Column(const ComponentField field) { return m_Columns.Of<T>()[field.index]; }
+    template<typename T>
+    const std::vector<T>& Column(const ComponentField field) const { return m_Columns.Of<T>()[field.index]; }
+
+    uint32_t AddRow(const ComponentRow& values);
+    ComponentRow GetRow(uint32_t row) const;
+    // Copies row from over row to, for compacting the table front to back
+    void MoveRow(uint32_t from, uint32_t to);
+    // Drops every row from count on
+    void Truncate(uint32_t count);
+
+private:
+    const ObjectArchetype* m_Archetype;
+    uint32_t m_RowCount = 0;
+    ComponentColumns m_Columns;
+};
+
+/**
+ * @brief Object in a scene, described by its classes and their parameters
+ *
+ * A SceneObject is a row in the ArchetypeTable of its layout. GetParameter / SetParameter adapt
+ * the typed columns to ParameterValue for serialization, the UI and the animation graph; per-frame
+ * code reads through Find<T>() instead, which neither hashes (for hot fields) nor copies. Pointers
+ * returned by Find<T>() stay valid until the Scene adds or removes objects.
+ */
 class SceneObject {
 public:
     SceneObject();
     explicit SceneObject(const std::vector<std::string>& classNames);
+    // Copies get a table of their own until they are added to a scene
+    SceneObject(const SceneObject& other);
+    SceneObject& operator=(const SceneObject& other);
+    SceneObject(SceneObject&&) noexcept = default;
+    SceneObject& operator=(SceneObject&&) noexcept = default;
     virtual ~SceneObject() = default;
 
+    // Meant for objects that are not in a scene yet; the scene's class index lists do not follow class changes
     void AddClass(const std::string& className);
-    bool HasClass(const std::string& className) const;
-    const std::vector<ObjectClass*>& GetClasses() const { return m_Classes; }
+    bool HasClass(const std::string& className) const { return HasClass(FindObjectClass(className)); }
+    bool HasClass(const ObjectClassId id) const { return id < MAX_OBJECT_CLASSES && (m_Archetype->classMask >> id & 1) != 0; }
+    ObjectClassMask GetClassMask() const { return m_Archetype->classMask; }
+    const std::vector<ObjectClass*>& GetClasses() const { return m_Archetype->classes; }
 
     bool HasParameter(const ParameterHandle& handle) const;
     ParameterValue GetParameter(const ParameterHandle& handle) const;
     void SetParameter(const ParameterHandle& handle, const ParameterValue& value);
 
-    const std::unordered_map<uint64_t, ParameterValue>& GetAllParameters() const { return m_Parameters; }
-    const std::unordered_map<uint64_t, ParameterMetadata>& GetAllMetadata() const { return m_AggregatedMeta; }
+    // Typed access without copies; nullptr when the classes do not provide the parameter as a T
+    template<typename T>
+    const T* Find(const ParameterHandle& handle) const { return Lookup<T>(m_Archetype->FieldOf(handle)); }
+    template<typename T>
+    const T* Find(const HotField field) const { return Lookup<T>(m_Archetype->hot[static_cast<size_t>(field)]); }
+
+    // Typed write of a hot field; ignored when the classes do not provide it as a T
+    template<typename T>
+    void Set(const HotField field, const T& value) {
+        const ComponentField location = m_Archetype->hot[static_cast<size_t>(field)];
+        if (!location.IsValid() || location.kind != KindOf<T>()) return;
+
+        T& slot = m_Table->Column<T>(location)[m_Row];
+        if (slot == value) return;
+        slot = value;
+        m_Version++;
+    }
+
+    // Change counter bumped whenever a parameter value or the class set changes
+    uint64_t GetVersion() const { return m_Version; }
+
+    const std::unordered_map<uint64_t, ParameterMetadata>& GetAllMetadata() const { return m_Archetype->meta; }
 
     void SerializeToYAML(YAML::Emitter& out) const;
     void DeserializeFromYAML(const YAML::Node& node);
 
+    // Binary row state for simulation checkpoints; the Scene records the archetype once per layout
+    const ObjectArchetype* GetArchetype() const { return m_Archetype; }
+    void WriteSnapshot(SnapshotWriter& writer) const;
+    void ReadSnapshot(SnapshotReader& reader, const ObjectArchetype* archetype);
+
+    template<typename T>
+    static constexpr ComponentKind KindOf() {
+        if constexpr (std::is_same_v<T, bool>) return ComponentKind::Bool;
+        else if constexpr (std::is_same_v<T, int>) return ComponentKind::Int;
+        else if constexpr (std::is_same_v<T, float>) return ComponentKind::Float;
+        else if constexpr (std::is_same_v<T, std::string>) return ComponentKind::String;
+        else if constexpr (std::is_same_v<T, glm::vec3>) return ComponentKind::Vec3;
+        else if constexpr (std::is_same_v<T, glm::quat>) return ComponentKind::Quat;
+        else return ComponentKind::StringVector;
+    }
+
 private:
-    std::vector<ObjectClass*> m_Classes;
-    std::unordered_map<uint64_t, ParameterValue> m_Parameters;
-    std::unordered_map<uint64_t, ParameterMetadata> m_AggregatedMeta;
+    friend struct Scene;
+
+    const ObjectArchetype* m_Archetype;
+    ArchetypeTable* m_Table;
+    uint32_t m_Row = 0;
+    uint64_t m_Version = 0;
+    // Table of an object that is not in a scene; null once a Scene has taken the row over
+    std::unique_ptr<ArchetypeTable> m_OwnTable;
+
+    void SetArchetype(const ObjectArchetype* archetype);
+    void SetOwnRow(const ObjectArchetype* archetype, const ComponentRow& values);
+    ParameterValue ValueAt(ComponentField field) const;
+    static ParameterValue ValueAt(const ComponentRow& values, ComponentField field);
+    bool StoreValue(ComponentField field, const ParameterValue& value);
 
-    void RebuildMetadata();
+    template<typename T>
+    const T* Lookup(const ComponentField field) const {
+        if (!field.IsValid() || field.kind != KindOf<T>()) return nullptr;
+        return &m_Table->Column<T>(field)[m_Row];
+    }
 };
 
 enum class ObjectType { BlackHole, Mesh, Sphere, DynamicObject };
 
 struct Scene {
+    Scene() = default;
+    // Copies rebuild the archetype tables, the objects of the copy are rows in its own tables
+    Scene(const Scene& other);
+    Scene& operator=(const Scene& other);
+    Scene(Scene&&) noexcept = default;
+    Scene& operator=(Scene&&) noexcept = default;
+
     std::string name;
+    // Elements may be modified in place; objects are added and removed through the Scene so the class
+    // index lists and the archetype tables holding their parameter values stay in sync
     std::vector<SceneObject> objects;
 
     std::filesystem::path currentPath;
@@ -74,8 +283,25 @@ struct Scene {
     };
     std::optional<SelectedObject> selectedObject;
 
+    // Indices into objects of every object with the class, in scene order
+    const std::vector<uint32_t>& ObjectsOf(const ObjectClassId id) const {
+        static const std::vector<uint32_t> none;
+        return id < MAX_OBJECT_CLASSES ? m_ClassIndices[id] : none;
+    }
+
+    void AddObject(SceneObject object);
+    void RemoveObject(size_t index);
+    // Removes every object flagged in remove, keeping the order of the rest; returns the new index of every old index
+    std::vector<size_t> RemoveObjects(const std::vector<bool>& remove);
+    void ClearObjects();
+
     void Serialize(const std::filesystem::path& path);
     void Deserialize(const std::filesystem::path& path, bool setCurrentPath = true);
+
+    // Objects and their parameter values in binary, for simulation checkpoints. Name, path and
+    // selection are not part of the simulated state and are left alone by ReadSnapshot().
+    void WriteSnapshot(SnapshotWriter& writer) const;
+    void ReadSnapshot(SnapshotReader& reader);
     static std::filesystem::path ShowFileDialog(bool save);
 
     void SelectObject(ObjectType type, size_t index);
@@ -87,4 +313,13 @@ struct Scene {
     std::string GetSelectedObjectName() const;
 
     std::optional<SelectedObject> PickObject(const glm::vec3& rayOrigin, const glm::vec3& rayDirection) const;
+
+    static constexpr size_t REMOVED_OBJECT = static_cast<size_t>(-1);
+
+private:
+    std::array<std::vector<uint32_t>, MAX_OBJECT_CLASSES> m_ClassIndices;
+    // One table per archetype in use; objects point into them, so tables are never moved
+    std::vector<std::unique_ptr<ArchetypeTable>> m_Tables;
+
+    ArchetypeTable& TableFor(const ObjectArchetype* archetype);
 };
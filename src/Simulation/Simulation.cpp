@@ -2,16 +2,57 @@
 #include <spdlog/spdlog.h>
 #include <yaml-cpp/yaml.h>
 #include <algorithm>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
 #include "GraphExecutor.h"
+#include "Snapshot.h"
 #include "Application/AnimationGraph.h"
 #include "Application/Application.h"
+#include "Application/Fnv1a.h"
 #include "Application/Parameters.h"
 
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#endif
+
+namespace {
+    constexpr uint32_t SNAPSHOT_VERSION = 1;
+
+    // Tells builds apart, so spilled checkpoints of another build are never reused: the size and
+    // modification time of the running executable where it can be found, the build time otherwise
+    std::string BuildId() {
+        std::filesystem::path executable;
+#ifdef _WIN32
+        wchar_t buffer[MAX_PATH];
+        const DWORD length = GetModuleFileNameW(nullptr, buffer, MAX_PATH);
+        if (length > 0 && length < MAX_PATH) executable = std::wstring(buffer, length);
+#else
+        std::error_code linkError;
+        executable = std::filesystem::read_symlink("/proc/self/exe", linkError);
+#endif
+        std::string id = __DATE__ " " __TIME__;
+        std::error_code error;
+        if (executable.empty()) return id;
+        const auto size = std::filesystem::file_size(executable, error);
+        if (error) return id;
+        const auto modified = std::filesystem::last_write_time(executable, error);
+        if (error) return id;
+        id += " " + std::to_string(size) + " " + std::to_string(modified.time_since_epoch().count());
+        return id;
+    }
+}
+
 Simulation::Simulation() : m_State(State::Stopped), m_SimulationTime(0.0f), m_AnimationGraph(nullptr), m_StartEventExecuted(false) {
     m_Scene = std::make_unique<Scene>();
     m_SavedScene = std::make_unique<Scene>();
     m_Physics = std::make_unique<Physics>();
-    m_Physics->Init();
 }
 
 Simulation::~Simulation() {
@@ -24,6 +65,9 @@ Simulation::~Simulation() {
 void Simulation::Initialize() {
     spdlog::info("Initializing Simulation");
 
+    // After the parameter registry is loaded: the dispatcher is sized from Physics.WorkerThreads
+    m_Physics->Init();
+
     LoadObjectClasses("../assets/config/classes.yaml");
     LoadObjectDefinitions("../assets/config/base_objects.yaml");
 
@@ -44,8 +88,165 @@ void Simulation::Initialize() {
 
 void Simulation::Update(float deltaTime) {
     if (m_State == State::Running) {
-        UpdateSimulation(deltaTime);
-        m_SimulationTime += deltaTime;
+        Step(deltaTime);
+    }
+}
+
+void Simulation::Step(const float deltaTime) {
+    if (m_StepIndex == 0 && deltaTime != m_CheckpointDeltaTime) {
+        BeginCheckpoints(deltaTime);
+    } else if (m_CheckpointsEnabled && deltaTime != m_CheckpointDeltaTime) {
+        // Checkpoints are addressed by step count, which only means something at a constant step size
+        spdlog::debug("Step size changed at step {}, no further checkpoints for this run", m_StepIndex);
+        m_CheckpointsEnabled = false;
+        m_Checkpoints.Clear();
+    }
+
+    UpdateSimulation(deltaTime);
+    m_SimulationTime += deltaTime;
+    ++m_StepIndex;
+
+    const int interval = Application::Params().Get(Params::PhysicsCheckpointInterval, 60);
+    if (m_CheckpointsEnabled && interval > 0 && m_StepIndex % interval == 0 && !m_Checkpoints.Contains(m_StepIndex)) {
+        m_Checkpoints.Store(m_StepIndex, CaptureState());
+    }
+}
+
+void Simulation::BeginCheckpoints(const float deltaTime) {
+    auto& params = Application::Params();
+    m_CheckpointDeltaTime = deltaTime;
+    m_CheckpointsEnabled = params.Get(Params::PhysicsCheckpointInterval, 60) > 0;
+    m_Checkpoints.Clear();
+    m_InitialState.clear();
+    if (!m_CheckpointsEnabled) return;
+
+    m_InitialState = CaptureState();
+
+    // The run is identified by its initial state and everything else that decides how it steps
+    std::vector<uint8_t> key = m_InitialState;
+    SnapshotWriter writer(key);
+    writer.Write(deltaTime);
+    writer.Write(params.Get(Params::PhysicsIntegrator, 1));
+    writer.Write(params.Get(Params::PhysicsGravityOpeningAngle, 0.5f));
+    writer.Write(params.Get(Params::PhysicsFixedTimestepEnabled, true));
+    writer.Write(params.Get(Params::PhysicsFixedTimestep, 1.0f / 240.0f));
+    writer.Write(params.Get(Params::PhysicsMaxSubSteps, 64));
+    writer.Write(params.Get(Params::PhysicsAsyncSimulation, false));
+    writer.Write(SNAPSHOT_VERSION);
+    static const std::string buildId = BuildId();
+    writer.WriteString(buildId);
+
+    // The graph drives the scene every step, so its structure and constants are part of the run too
+    if (m_AnimationGraph) {
+        YAML::Emitter graph;
+        graph << YAML::BeginMap;
+        m_AnimationGraph->Serialize(graph);
+        graph << YAML::EndMap;
+        writer.WriteString(graph.c_str());
+    } else {
+        writer.WriteString("");
+    }
+    const uint64_t fingerprint = RuntimeFnv1a(std::string_view(reinterpret_cast<const char*>(key.data()), key.size()));
+
+    const auto memoryBudget = static_cast<size_t>(std::max(params.Get(Params::PhysicsCheckpointMemoryMB, 256), 0)) * 1024 * 1024;
+    m_Checkpoints.Reset(fingerprint, memoryBudget, params.Get(Params::PhysicsCheckpointDirectory, std::string("")));
+}
+
+void Simulation::SeekToStep(const uint64_t step, const float deltaTime) {
+    if (m_State == State::Stopped) {
+        spdlog::warn("Cannot seek a stopped simulation");
+        return;
+    }
+    const State state = m_State;
+
+    // A fresh run indexes its checkpoints here, so the spill directory of an earlier process is used right away
+    if (m_StepIndex == 0 && deltaTime != m_CheckpointDeltaTime) {
+        BeginCheckpoints(deltaTime);
+    }
+
+    bool restart = false;
+    if (m_CheckpointsEnabled && deltaTime == m_CheckpointDeltaTime) {
+        auto checkpoint = m_Checkpoints.FindAtOrBefore(step);
+        if (!checkpoint) {
+            checkpoint = CheckpointStore::Checkpoint{0, m_InitialState};
+        }
+
+        // Only worth it when the checkpoint skips steps: going back, or ahead of the current step
+        if (step < m_StepIndex || checkpoint->step > m_StepIndex) {
+            try {
+                RestoreState(checkpoint->data);
+                spdlog::info("Restored checkpoint at step {}, replaying {} steps", checkpoint->step, step - checkpoint->step);
+            } catch (const std::exception& e) {
+                spdlog::error("Failed to restore checkpoint at step {}: {}", checkpoint->step, e.what());
+                restart = true;
+            }
+        }
+    } else if (step < m_StepIndex) {
+        restart = true;
+    }
+
+    if (restart) {
+        spdlog::info("Replaying the simulation from the start to step {}", step);
+        Stop();
+        Start();
+    }
+
+    while (m_StepIndex < step) {
+        Step(deltaTime);
+    }
+    m_State = state;
+}
+
+std::vector<uint8_t> Simulation::CaptureState() const {
+    // First: settling a physics step still in flight writes body velocities back into the scene
+    std::vector<uint8_t> physicsState;
+    SnapshotWriter physicsWriter(physicsState);
+    m_Physics->WriteState(physicsWriter);
+
+    std::vector<uint8_t> data;
+    SnapshotWriter writer(data);
+    writer.Write(SNAPSHOT_VERSION);
+    writer.Write(m_StepIndex);
+    writer.Write(m_SimulationTime);
+    m_Scene->WriteSnapshot(writer);
+    writer.WriteArray(physicsState);
+
+    writer.Write(static_cast<uint8_t>(m_GraphExecutor != nullptr));
+    if (m_GraphExecutor) {
+        m_GraphExecutor->WriteVariables(writer);
+    }
+    return data;
+}
+
+void Simulation::RestoreState(const std::vector<uint8_t>& data) {
+    SnapshotReader reader(data);
+    if (reader.Read<uint32_t>() != SNAPSHOT_VERSION) {
+        throw std::runtime_error("Unsupported simulation snapshot version");
+    }
+    const auto step = reader.Read<uint64_t>();
+    const auto time = reader.Read<float>();
+
+    m_Scene->ReadSnapshot(reader);
+
+    std::vector<uint8_t> physicsState;
+    reader.ReadArray(physicsState);
+    SnapshotReader physicsReader(physicsState);
+    m_Physics->ReadState(physicsReader, m_Scene.get());
+
+    // A fresh executor recompiles the graph; only its variables carry state from tick to tick
+    m_GraphExecutor.reset();
+    m_StartEventExecuted = reader.Read<uint8_t>() != 0;
+    if (m_StartEventExecuted && m_AnimationGraph) {
+        m_GraphExecutor = std::make_unique<GraphExecutor>(m_AnimationGraph, m_Scene.get());
+        m_GraphExecutor->ReadVariables(reader);
+    }
+
+    m_StepIndex = step;
+    m_SimulationTime = time;
+
+    auto& renderer = Application::GetRenderer();
+    if (auto* pathsRenderer = renderer.GetObjectPathsRenderer()) {
+        pathsRenderer->ClearHistories();
     }
 }
 
@@ -54,6 +255,11 @@ void Simulation::Start() {
         SaveSceneState();
         m_SimulationTime = 0.0f;
         m_StartEventExecuted = false;
+        m_StepIndex = 0;
+        m_CheckpointDeltaTime = 0.0f;
+        m_CheckpointsEnabled = false;
+        m_Checkpoints.Clear();
+        m_InitialState.clear();
 
         if (m_AnimationGraph) {
             m_GraphExecutor = std::make_unique<GraphExecutor>(m_AnimationGraph, m_Scene.get());
@@ -76,6 +282,8 @@ void Simulation::Stop() {
         m_State = State::Stopped;
         m_StartEventExecuted = false;
         m_GraphExecutor.reset();
+        m_Checkpoints.Clear();
+        m_InitialState.clear();
         
         auto& renderer = Application::GetRenderer();
         if (auto* pathsRenderer = renderer.GetObjectPathsRenderer()) {
@@ -100,6 +308,8 @@ void Simulation::Reset() {
         m_State = State::Stopped;
         m_StartEventExecuted = false;
         m_GraphExecutor.reset();
+        m_Checkpoints.Clear();
+        m_InitialState.clear();
         
         auto& renderer = Application::GetRenderer();
         if (auto* pathsRenderer = renderer.GetObjectPathsRenderer()) {
@@ -140,7 +350,7 @@ void Simulation::SaveScene(const std::filesystem::path& path) {
 
 void Simulation::NewScene() {
     if (m_Scene) {
-        m_Scene->objects.clear();
+        m_Scene->ClearObjects();
         m_Scene->name = "New Scene";
         m_Scene->currentPath.clear();
         Application::Params().Set(Params::AppLastOpenScene, std::string(""));
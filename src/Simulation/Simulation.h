@@ -1,9 +1,11 @@
 #pragma once
+#include <cstdint>
 #include <memory>
 #include <filesystem>
 
 #include "Scene.h"
 #include "Physics.h"
+#include "Checkpoint.h"
 
 class AnimationGraph;
 class GraphExecutor;
@@ -38,6 +40,12 @@ public:
 
     Scene* GetScene() const;
     float GetSimulationTime() const { return m_SimulationTime; }
+    uint64_t GetStepIndex() const { return m_StepIndex; }
+
+    // Brings a started simulation to the state after step updates of deltaTime each, restoring the
+    // nearest checkpoint at or before it and replaying the rest. Checkpoints are only taken while
+    // every update of a run uses the same deltaTime (video export); otherwise this replays from the start.
+    void SeekToStep(uint64_t step, float deltaTime);
 
     void SetAnimationGraph(AnimationGraph* graph);
     Physics* GetPhysics() const { return m_Physics.get(); }
@@ -55,12 +63,23 @@ private:
     float m_SimulationTime;
     bool m_StartEventExecuted;
 
+    // Checkpoints of the current run, every Physics.CheckpointInterval updates
+    CheckpointStore m_Checkpoints;
+    std::vector<uint8_t> m_InitialState;  // Step 0, never evicted
+    uint64_t m_StepIndex = 0;
+    float m_CheckpointDeltaTime = 0.0f;   // Step size of all updates so far, 0 before the first
+    bool m_CheckpointsEnabled = false;
+
     std::vector<ObjectClass> m_ObjectClasses;
     std::vector<SceneObjectDefinition> m_ObjectDefinitions;
 
     void SaveSceneState() const;
     void RestoreSceneState() const;
     void UpdateSimulation(float deltaTime) const;
+    void Step(float deltaTime);
+    void BeginCheckpoints(float deltaTime);
+    std::vector<uint8_t> CaptureState() const;
+    void RestoreState(const std::vector<uint8_t>& data);
     void LoadObjectClasses(const std::filesystem::path& path);
     void LoadObjectDefinitions(const std::filesystem::path& path);
 };
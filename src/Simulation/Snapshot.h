@@ -0,0 +1,110 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief Appends values to a binary simulation snapshot
+ *
+ * Values are stored in native byte order and layout: snapshots are only read back by the same
+ * build on the same machine (checkpoints), never exchanged. Containers are prefixed with their
+ * element count.
+ */
+class SnapshotWriter {
+public:
+    explicit SnapshotWriter(std::vector<uint8_t>& out) : m_Out(out) {}
+
+    template<typename T>
+    void Write(const T& value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        const auto* bytes = reinterpret_cast<const uint8_t*>(&value);
+        m_Out.insert(m_Out.end(), bytes, bytes + sizeof(T));
+    }
+
+    void WriteString(const std::string& value) {
+        Write(static_cast<uint32_t>(value.size()));
+        m_Out.insert(m_Out.end(), value.begin(), value.end());
+    }
+
+    template<typename Container>
+    void WriteArray(const Container& values) {
+        using T = typename Container::value_type;
+        static_assert(std::is_trivially_copyable_v<T>);
+        Write(static_cast<uint32_t>(values.size()));
+        const auto* bytes = reinterpret_cast<const uint8_t*>(values.data());
+        m_Out.insert(m_Out.end(), bytes, bytes + values.size() * sizeof(T));
+    }
+
+    void WriteStrings(const std::vector<std::string>& values) {
+        Write(static_cast<uint32_t>(values.size()));
+        for (const auto& value : values) {
+            WriteString(value);
+        }
+    }
+
+private:
+    std::vector<uint8_t>& m_Out;
+};
+
+/**
+ * @brief Reads a snapshot written by SnapshotWriter, throws std::runtime_error when it is truncated
+ */
+class SnapshotReader {
+public:
+    SnapshotReader(const uint8_t* data, size_t size) : m_Data(data), m_Size(size) {}
+    explicit SnapshotReader(const std::vector<uint8_t>& data) : SnapshotReader(data.data(), data.size()) {}
+
+    template<typename T>
+    T Read() {
+        static_assert(std::is_trivially_copyable_v<T>);
+        T value;
+        std::memcpy(&value, Take(sizeof(T)), sizeof(T));
+        return value;
+    }
+
+    std::string ReadString() {
+        const uint32_t size = Read<uint32_t>();
+        const auto* bytes = reinterpret_cast<const char*>(Take(size));
+        return std::string(bytes, size);
+    }
+
+    template<typename Container>
+    void ReadArray(Container& values) {
+        using T = typename Container::value_type;
+        static_assert(std::is_trivially_copyable_v<T>);
+        const uint32_t count = Read<uint32_t>();
+        const uint8_t* bytes = Take(static_cast<size_t>(count) * sizeof(T));
+        values.resize(count);
+        if (count > 0) {
+            std::memcpy(values.data(), bytes, static_cast<size_t>(count) * sizeof(T));
+        }
+    }
+
+    void ReadStrings(std::vector<std::string>& values) {
+        const uint32_t count = Read<uint32_t>();
+        values.clear();
+        values.reserve(count);
+        for (uint32_t i = 0; i < count; ++i) {
+            values.push_back(ReadString());
+        }
+    }
+
+    bool AtEnd() const { return m_Offset == m_Size; }
+
+private:
+    const uint8_t* Take(size_t size) {
+        if (size > m_Size - m_Offset) {
+            throw std::runtime_error("Truncated simulation snapshot");
+        }
+        const uint8_t* bytes = m_Data + m_Offset;
+        m_Offset += size;
+        return bytes;
+    }
+
+    const uint8_t* m_Data;
+    size_t m_Size;
+    size_t m_Offset = 0;
+};
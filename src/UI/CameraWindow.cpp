@@ -125,9 +125,7 @@ void Render(UI* ui, Scene* scene) {
             ui->MarkConfigDirty();
         }
         if (scene) {
-            for (size_t i = 0; i < scene->objects.size(); ++i) {
-                if (!scene->objects[i].HasClass("Mesh")) continue;
-
+            for (const uint32_t i : scene->ObjectsOf(ObjectClasses::Mesh)) {
                 ParameterHandle nameHandle("Entity.Name");
                 auto nameValue = scene->objects[i].GetParameter(nameHandle);
                 if (!std::holds_alternative<std::string>(nameValue)) continue;
@@ -148,10 +148,11 @@ void RenderObjectTypeSection(UI* ui, Scene* scene, const std::string& objectType
     // Track which objects are expanded in the accordion
     static std::unordered_map<std::string, bool> expandedObjects;
 
+    const ObjectClassId classId = FindObjectClass(objectTypeName);
     int objIdx = 0;
     for (size_t i = 0; i < scene->objects.size(); ) {
         auto& obj = scene->objects[i];
-        if (!obj.HasClass(objectTypeName)) {
+        if (!obj.HasClass(classId)) {
             ++i;
             continue;
         }
@@ -306,7 +307,7 @@ void RenderObjectTypeSection(UI* ui, Scene* scene, const std::string& objectType
                 scene->ClearSelection();
             }
             expandedObjects.erase(objId);
-            scene->objects.erase(scene->objects.begin() + static_cast<ptrdiff_t>(i));
+            scene->RemoveObject(i);
             if (!scene->currentPath.empty()) {
                 scene->Serialize(scene->currentPath);
             }
@@ -343,7 +344,7 @@ static std::function<void()> CreateObjectFactory(Scene* scene, const SceneObject
         newObj.SetParameter(ParameterHandle("Entity.Name"), definition.name);
         newObj.SetParameter(ParameterHandle("Entity.Position"), glm::vec3(0.0f, 0.0f, -5.0f));
 
-        scene->objects.push_back(std::move(newObj));
+        scene->AddObject(std::move(newObj));
         if (!scene->currentPath.empty()) {
             scene->Serialize(scene->currentPath);
         }
@@ -123,12 +123,12 @@ void Render(UI* ui, Scene* scene) {
         if (auto massParam = obj.GetParameter(Field::Physics::Mass); std::holds_alternative<float>(massParam))
             lines.push_back({"Mass", FloatStr(std::get<float>(massParam))});
 
-        if (obj.HasClass("BlackHole")) {
+        if (obj.HasClass(ObjectClasses::BlackHole)) {
             if (auto spinParam = obj.GetParameter(Field::BlackHole::Spin); std::holds_alternative<float>(spinParam))
                 lines.push_back({"Spin", FloatStr(std::get<float>(spinParam))});
         }
 
-        if (obj.HasClass("Sphere")) {
+        if (obj.HasClass(ObjectClasses::Sphere)) {
             if (auto spinParam = obj.GetParameter(Field::Sphere::Spin); std::holds_alternative<float>(spinParam))
                 lines.push_back({"Spin", FloatStr(std::get<float>(spinParam))});
         }
@@ -1,10 +1,40 @@
 #include <spdlog/spdlog.h>
 #include "Application/Application.h"
+#include "Application/CommandLineArgs.h"
+#include "Application/ExportWorkers.h"
+#include "Renderer/FrameConversion.h"
+#include "Renderer/KerrGeodesicLUTGenerator.h"
+#include "Simulation/GraphExecutor.h"
 
 int main(int argc, char* argv[]) {
     spdlog::set_level(spdlog::level::debug);
     spdlog::set_pattern("[%H:%M:%S.%e] [%^%l%$] %v");
 
+    {
+        // Pure CPU work, runs before any window or GL context is created
+        CommandLineArgs args;
+        args.Parse(argc, argv);
+        if (args.ShouldRunKerrBenchmark()) {
+            MoleHole::KerrGeodesicLUTGenerator::runBenchmark();
+            return 0;
+        }
+        if (args.ShouldRunFrameConversionBenchmark()) {
+            MoleHole::FrameConversion::RunBenchmark();
+            return 0;
+        }
+        if (args.ShouldRunGraphBatchCheck()) {
+            return GraphExecutor::CheckBatchMath() ? 0 : 1;
+        }
+
+        // Split exports coordinate worker processes and never open a window themselves
+        if (args.GetValue("concat-video").has_value()) {
+            return ExportWorkers::Concatenate(args);
+        }
+        if (args.GetValue("export-video").has_value() && args.GetValueInt("export-workers", 1) > 1) {
+            return ExportWorkers::RunVideoExport(args, argc, argv);
+        }
+    }
+
     auto& app = Application::Instance();
 
     if (!app.Initialize(argc, argv)) {
@@ -12,12 +42,17 @@ int main(int argc, char* argv[]) {
         return -1;
     }
 
-    if (Application::Args().IsHeadless()) {
-        app.RunHeadless();
+    int exitCode = 0;
+    if (Application::Args().ShouldRunUniformBenchmark()) {
+        // Needs the GL context and scene of an initialized application
+        Application::GetRenderer().RunUniformBenchmark(Application::GetSimulation().GetScene());
+    } else if (Application::Args().IsHeadless()) {
+        // Export workers are judged by their exit code, see ExportWorkers
+        exitCode = app.RunHeadless() ? 0 : 1;
     } else {
         app.Run();
     }
 
     app.Shutdown();
-    return 0;
+    return exitCode;
 }